@@ -39,6 +39,20 @@ namespace RadarConfig
     static int  s_borderColorG = 0;
     static int  s_borderColorB = 0;
     static int  s_borderColorA = 255;
+    static bool s_mapStreaming     = false;
+    static int  s_mapBudgetTiles   = 64;
+    static int  s_mapBudgetMB      = 0;    // 0 = без лимита по памяти
+    static int  s_mapUploadsPerFrame = 4;
+    static int  s_mapUploadBudgetUs  = 2000; // 0 = без лимита по времени
+    static bool s_mapLod           = true;
+    static bool s_mapCache         = true;
+    static bool s_mapCompression   = false;
+    static bool s_mapAtlas         = true;
+    static int  s_mapPrefetchMs    = 1500; // 0 = без упреждающей загрузки
+    static std::string s_mapPack;          // пусто = radar/map.txd
+    static bool s_mapVirtual       = false;
+    static bool s_hotReload        = false;
+    static bool s_nativeTxd        = true;
 
     static bool IsSystemLanguageRussian()
     {
@@ -100,6 +114,20 @@ namespace RadarConfig
             if (strcmp(key, "BackgroundColor") == 0) return "# Фоновый цвет радара в формате RGBA (по умолчанию: 123, 196, 249, 255 - голубой непрозрачный)";
             if (strcmp(key, "CircleColor") == 0) return "# Цвет круга/квадрата радара в формате RGBA (по умолчанию: 255, 255, 255, 255 - белый непрозрачный)";
             if (strcmp(key, "BorderColor") == 0) return "# Цвет обводки радара в формате RGBA (по умолчанию: 0, 0, 0, 255 - чёрный непрозрачный)";
+            if (strcmp(key, "MapStreaming") == 0) return "# Потоковая загрузка карты (в памяти только видимые тайлы): 1=да, 0=нет";
+            if (strcmp(key, "MapBudgetTiles") == 0) return "# Лимит тайлов карты в памяти при потоковой загрузке (от 4, не больше числа тайлов карты)";
+            if (strcmp(key, "MapBudgetMB") == 0) return "# Лимит памяти тайлов карты в МБ при потоковой загрузке (0 = без лимита)";
+            if (strcmp(key, "MapUploadsPerFrame") == 0) return "# Сколько тайлов карты загружать в видеопамять за кадр (1-64)";
+            if (strcmp(key, "MapUploadBudgetUs") == 0) return "# Лимит времени загрузки тайлов за кадр в микросекундах (0 = без лимита)";
+            if (strcmp(key, "MapLod") == 0) return "# Укрупнённые тайлы карты (6x6, 3x3) при большой высоте камеры: 1=да, 0=нет";
+            if (strcmp(key, "MapCache") == 0) return "# Кэш готовых тайлов карты (radar/map.cache) для быстрого запуска: 1=да, 0=нет";
+            if (strcmp(key, "MapCompression") == 0) return "# Сжатие тайлов карты в DXT1/DXT5 (в 4-8 раз меньше памяти, чуть ниже качество): 1=да, 0=нет";
+            if (strcmp(key, "MapAtlas") == 0) return "# Тайлы карты в общих атласах, карта рисуется 1-2 вызовами отрисовки: 1=да, 0=нет";
+            if (strcmp(key, "MapPrefetchMs") == 0) return "# Стриминг: заранее загружать тайлы по пути движения на столько миллисекунд вперёд (0 = выкл.)";
+            if (strcmp(key, "MapPack") == 0) return "# Папка с набором тайлов карты (manifest.txt + PNG/DDS) внутри radar/; пусто = map.txd";
+            if (strcmp(key, "MapVirtual") == 0) return "# Уровень детализации для каждого тайла по удалённости от камеры, полные тайлы грузятся только вблизи (нужен MapLod): 1=да, 0=нет";
+            if (strcmp(key, "HotReload") == 0) return "# Перезагружать map.txd / набор тайлов и blip.txd при их изменении, без перезапуска игры: 1=да, 0=нет";
+            if (strcmp(key, "NativeTxd") == 0) return "# Читать текстуры map.txd / blip.txd прямо из файла, без RwImage (неподдерживаемые форматы - через RenderWare): 1=да, 0=нет";
         }
         else
         {
@@ -115,6 +143,20 @@ namespace RadarConfig
             if (strcmp(key, "BackgroundColor") == 0) return "# Radar background color in RGBA format (default: 123, 196, 249, 255 - light blue opaque)";
             if (strcmp(key, "CircleColor") == 0) return "# Radar circle/square color in RGBA format (default: 255, 255, 255, 255 - white opaque)";
             if (strcmp(key, "BorderColor") == 0) return "# Radar border color in RGBA format (default: 0, 0, 0, 255 - black opaque)";
+            if (strcmp(key, "MapStreaming") == 0) return "# Map streaming (keep only visible tiles in memory): 1=yes, 0=no";
+            if (strcmp(key, "MapBudgetTiles") == 0) return "# Max resident map tiles in streaming mode (4 or more, up to the tile count of the map)";
+            if (strcmp(key, "MapBudgetMB") == 0) return "# Max map tile memory in MB in streaming mode (0 = no limit)";
+            if (strcmp(key, "MapUploadsPerFrame") == 0) return "# Map tiles uploaded to the GPU per frame (1-64)";
+            if (strcmp(key, "MapUploadBudgetUs") == 0) return "# Per-frame map tile upload time budget in microseconds (0 = no limit)";
+            if (strcmp(key, "MapLod") == 0) return "# Merged low-detail map tiles (6x6, 3x3) at high camera altitude: 1=yes, 0=no";
+            if (strcmp(key, "MapCache") == 0) return "# Cache of converted map tiles (radar/map.cache) for faster startup: 1=yes, 0=no";
+            if (strcmp(key, "MapCompression") == 0) return "# Compress map tiles to DXT1/DXT5 (4-8x less memory, slightly lower quality): 1=yes, 0=no";
+            if (strcmp(key, "MapAtlas") == 0) return "# Pack map tiles into shared atlas textures, map drawn in 1-2 draw calls: 1=yes, 0=no";
+            if (strcmp(key, "MapPrefetchMs") == 0) return "# Streaming: prefetch tiles along the predicted path this many milliseconds ahead (0 = off)";
+            if (strcmp(key, "MapPack") == 0) return "# Map tile pack folder (manifest.txt + PNG/DDS tiles) inside radar/; empty = map.txd";
+            if (strcmp(key, "MapVirtual") == 0) return "# Pick the detail level per tile from its distance to the camera, full tiles only load up close (needs MapLod): 1=yes, 0=no";
+            if (strcmp(key, "HotReload") == 0) return "# Reload map.txd / the tile pack and blip.txd when they change, without restarting the game: 1=yes, 0=no";
+            if (strcmp(key, "NativeTxd") == 0) return "# Read map.txd / blip.txd textures straight from the file, without RwImage (unsupported formats go through RenderWare): 1=yes, 0=no";
         }
         return "";
     }
@@ -148,6 +190,20 @@ namespace RadarConfig
         fprintf(f, "%s\nBorderColor = %d, %d, %d, %d\n\n",
             GetDesc("BorderColor", ru),
             s_borderColorR, s_borderColorG, s_borderColorB, s_borderColorA);
+        fprintf(f, "%s\nMapStreaming = %d\n\n", GetDesc("MapStreaming", ru), s_mapStreaming ? 1 : 0);
+        fprintf(f, "%s\nMapBudgetTiles = %d\n\n", GetDesc("MapBudgetTiles", ru), s_mapBudgetTiles);
+        fprintf(f, "%s\nMapBudgetMB = %d\n\n", GetDesc("MapBudgetMB", ru), s_mapBudgetMB);
+        fprintf(f, "%s\nMapUploadsPerFrame = %d\n\n", GetDesc("MapUploadsPerFrame", ru), s_mapUploadsPerFrame);
+        fprintf(f, "%s\nMapUploadBudgetUs = %d\n\n", GetDesc("MapUploadBudgetUs", ru), s_mapUploadBudgetUs);
+        fprintf(f, "%s\nMapLod = %d\n\n", GetDesc("MapLod", ru), s_mapLod ? 1 : 0);
+        fprintf(f, "%s\nMapCache = %d\n\n", GetDesc("MapCache", ru), s_mapCache ? 1 : 0);
+        fprintf(f, "%s\nMapCompression = %d\n\n", GetDesc("MapCompression", ru), s_mapCompression ? 1 : 0);
+        fprintf(f, "%s\nMapAtlas = %d\n\n", GetDesc("MapAtlas", ru), s_mapAtlas ? 1 : 0);
+        fprintf(f, "%s\nMapPrefetchMs = %d\n\n", GetDesc("MapPrefetchMs", ru), s_mapPrefetchMs);
+        fprintf(f, "%s\nMapPack = %s\n\n", GetDesc("MapPack", ru), s_mapPack.c_str());
+        fprintf(f, "%s\nMapVirtual = %d\n\n", GetDesc("MapVirtual", ru), s_mapVirtual ? 1 : 0);
+        fprintf(f, "%s\nHotReload = %d\n\n", GetDesc("HotReload", ru), s_hotReload ? 1 : 0);
+        fprintf(f, "%s\nNativeTxd = %d\n\n", GetDesc("NativeTxd", ru), s_nativeTxd ? 1 : 0);
 
         fclose(f);
         return true;
@@ -358,6 +414,83 @@ namespace RadarConfig
                 }
             }
         }
+
+        it = s_values.find("MapStreaming");
+        if (it != s_values.end())
+            s_mapStreaming = (atoi(it->second.c_str()) != 0);
+
+        it = s_values.find("MapBudgetTiles");
+        if (it != s_values.end())
+        {
+            // No fixed maximum: map packs go up to 255x255 tiles, MapChunkManager clamps to the tile count
+            int v = atoi(it->second.c_str());
+            if (v >= 4)
+                s_mapBudgetTiles = v;
+        }
+
+        it = s_values.find("MapBudgetMB");
+        if (it != s_values.end())
+        {
+            int v = atoi(it->second.c_str());
+            if (v >= 0 && v <= 4096)
+                s_mapBudgetMB = v;
+        }
+
+        it = s_values.find("MapUploadsPerFrame");
+        if (it != s_values.end())
+        {
+            int v = atoi(it->second.c_str());
+            if (v >= 1 && v <= 64)
+                s_mapUploadsPerFrame = v;
+        }
+
+        it = s_values.find("MapUploadBudgetUs");
+        if (it != s_values.end())
+        {
+            int v = atoi(it->second.c_str());
+            if (v >= 0 && v <= 100000)
+                s_mapUploadBudgetUs = v;
+        }
+
+        it = s_values.find("MapLod");
+        if (it != s_values.end())
+            s_mapLod = (atoi(it->second.c_str()) != 0);
+
+        it = s_values.find("MapCache");
+        if (it != s_values.end())
+            s_mapCache = (atoi(it->second.c_str()) != 0);
+
+        it = s_values.find("MapCompression");
+        if (it != s_values.end())
+            s_mapCompression = (atoi(it->second.c_str()) != 0);
+
+        it = s_values.find("MapAtlas");
+        if (it != s_values.end())
+            s_mapAtlas = (atoi(it->second.c_str()) != 0);
+
+        it = s_values.find("MapPrefetchMs");
+        if (it != s_values.end())
+        {
+            int v = atoi(it->second.c_str());
+            if (v >= 0 && v <= 10000)
+                s_mapPrefetchMs = v;
+        }
+
+        it = s_values.find("MapPack");
+        if (it != s_values.end())
+            s_mapPack = it->second;
+
+        it = s_values.find("MapVirtual");
+        if (it != s_values.end())
+            s_mapVirtual = (atoi(it->second.c_str()) != 0);
+
+        it = s_values.find("HotReload");
+        if (it != s_values.end())
+            s_hotReload = (atoi(it->second.c_str()) != 0);
+
+        it = s_values.find("NativeTxd");
+        if (it != s_values.end())
+            s_nativeTxd = (atoi(it->second.c_str()) != 0);
     }
 
     void Load()
@@ -425,6 +558,20 @@ namespace RadarConfig
         fprintf(f, "%s\nBorderColor = %d, %d, %d, %d\n\n",
             GetDesc("BorderColor", ru),
             s_borderColorR, s_borderColorG, s_borderColorB, s_borderColorA);
+        fprintf(f, "%s\nMapStreaming = %d\n\n", GetDesc("MapStreaming", ru), s_mapStreaming ? 1 : 0);
+        fprintf(f, "%s\nMapBudgetTiles = %d\n\n", GetDesc("MapBudgetTiles", ru), s_mapBudgetTiles);
+        fprintf(f, "%s\nMapBudgetMB = %d\n\n", GetDesc("MapBudgetMB", ru), s_mapBudgetMB);
+        fprintf(f, "%s\nMapUploadsPerFrame = %d\n\n", GetDesc("MapUploadsPerFrame", ru), s_mapUploadsPerFrame);
+        fprintf(f, "%s\nMapUploadBudgetUs = %d\n\n", GetDesc("MapUploadBudgetUs", ru), s_mapUploadBudgetUs);
+        fprintf(f, "%s\nMapLod = %d\n\n", GetDesc("MapLod", ru), s_mapLod ? 1 : 0);
+        fprintf(f, "%s\nMapCache = %d\n\n", GetDesc("MapCache", ru), s_mapCache ? 1 : 0);
+        fprintf(f, "%s\nMapCompression = %d\n\n", GetDesc("MapCompression", ru), s_mapCompression ? 1 : 0);
+        fprintf(f, "%s\nMapAtlas = %d\n\n", GetDesc("MapAtlas", ru), s_mapAtlas ? 1 : 0);
+        fprintf(f, "%s\nMapPrefetchMs = %d\n\n", GetDesc("MapPrefetchMs", ru), s_mapPrefetchMs);
+        fprintf(f, "%s\nMapPack = %s\n\n", GetDesc("MapPack", ru), s_mapPack.c_str());
+        fprintf(f, "%s\nMapVirtual = %d\n\n", GetDesc("MapVirtual", ru), s_mapVirtual ? 1 : 0);
+        fprintf(f, "%s\nHotReload = %d\n\n", GetDesc("HotReload", ru), s_hotReload ? 1 : 0);
+        fprintf(f, "%s\nNativeTxd = %d\n\n", GetDesc("NativeTxd", ru), s_nativeTxd ? 1 : 0);
 
         fclose(f);
     }
@@ -444,6 +591,20 @@ namespace RadarConfig
     int  GetBorderThickness() { return s_borderThickness; }
     int  GetOffsetX() { return s_offsetX; }
     int  GetOffsetY() { return s_offsetY; }
+    bool GetMapStreaming() { return s_mapStreaming; }
+    int  GetMapBudgetTiles() { return s_mapBudgetTiles; }
+    int  GetMapBudgetMB() { return s_mapBudgetMB; }
+    int  GetMapUploadsPerFrame() { return s_mapUploadsPerFrame; }
+    int  GetMapUploadBudgetUs() { return s_mapUploadBudgetUs; }
+    bool GetMapLod() { return s_mapLod; }
+    bool GetMapCache() { return s_mapCache; }
+    bool GetMapCompression() { return s_mapCompression; }
+    bool GetMapAtlas() { return s_mapAtlas; }
+    int  GetMapPrefetchMs() { return s_mapPrefetchMs; }
+    const char* GetMapPack() { return s_mapPack.c_str(); }
+    bool GetMapVirtual() { return s_mapVirtual; }
+    bool GetHotReload() { return s_hotReload; }
+    bool GetNativeTxd() { return s_nativeTxd; }
     
     void GetBackgroundColor(int& outR, int& outG, int& outB)
     {
@@ -509,4 +670,38 @@ namespace RadarConfig
         if (value >= 0 && value <= 1000)
             s_offsetY = value;
     }
+    void SetMapStreaming(bool value) { s_mapStreaming = value; }
+    void SetMapBudgetTiles(int value)
+    {
+        if (value >= 4)
+            s_mapBudgetTiles = value;
+    }
+    void SetMapBudgetMB(int value)
+    {
+        if (value >= 0 && value <= 4096)
+            s_mapBudgetMB = value;
+    }
+    void SetMapUploadsPerFrame(int value)
+    {
+        if (value >= 1 && value <= 64)
+            s_mapUploadsPerFrame = value;
+    }
+    void SetMapUploadBudgetUs(int value)
+    {
+        if (value >= 0 && value <= 100000)
+            s_mapUploadBudgetUs = value;
+    }
+    void SetMapLod(bool value) { s_mapLod = value; }
+    void SetMapCache(bool value) { s_mapCache = value; }
+    void SetMapCompression(bool value) { s_mapCompression = value; }
+    void SetMapAtlas(bool value) { s_mapAtlas = value; }
+    void SetMapPrefetchMs(int value)
+    {
+        if (value >= 0 && value <= 10000)
+            s_mapPrefetchMs = value;
+    }
+    void SetMapPack(const char* value) { s_mapPack = value ? value : ""; }
+    void SetMapVirtual(bool value) { s_mapVirtual = value; }
+    void SetHotReload(bool value) { s_hotReload = value; }
+    void SetNativeTxd(bool value) { s_nativeTxd = value; }
 }
@@ -22,6 +22,20 @@ namespace RadarConfig
     int  GetBorderThickness();
     int  GetOffsetX();
     int  GetOffsetY();
+    bool GetMapStreaming();
+    int  GetMapBudgetTiles();
+    int  GetMapBudgetMB();
+    int  GetMapUploadsPerFrame();
+    int  GetMapUploadBudgetUs();
+    bool GetMapLod();
+    bool GetMapCache();
+    bool GetMapCompression();
+    bool GetMapAtlas();
+    int  GetMapPrefetchMs();
+    const char* GetMapPack();
+    bool GetMapVirtual();
+    bool GetHotReload();
+    bool GetNativeTxd();
     void GetBackgroundColor(int& outR, int& outG, int& outB);
     void GetBackgroundColor(int& outR, int& outG, int& outB, int& outA);
     void GetCircleColor(int& outR, int& outG, int& outB, int& outA);
@@ -36,4 +50,18 @@ namespace RadarConfig
     void SetBorderThickness(int value);
     void SetOffsetX(int value);
     void SetOffsetY(int value);
+    void SetMapStreaming(bool value);
+    void SetMapBudgetTiles(int value);
+    void SetMapBudgetMB(int value);
+    void SetMapUploadsPerFrame(int value);
+    void SetMapUploadBudgetUs(int value);
+    void SetMapLod(bool value);
+    void SetMapCache(bool value);
+    void SetMapCompression(bool value);
+    void SetMapAtlas(bool value);
+    void SetMapPrefetchMs(int value);
+    void SetMapPack(const char* value);
+    void SetMapVirtual(bool value);
+    void SetHotReload(bool value);
+    void SetNativeTxd(bool value);
 }
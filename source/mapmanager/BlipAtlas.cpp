@@ -0,0 +1,223 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/mapmanager/BlipAtlas.cpp
+ *****************************************************************************/
+
+#include "BlipAtlas.h"
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <vector>
+
+// White block: 2 x 2 texels plus the gutter, sampled in its middle
+static const int WHITE_ID = -1;
+static const int WHITE_SIZE = 2;
+
+namespace
+{
+    struct Item
+    {
+        int id;
+        int width, height;  // without the gutter
+        int x, y;           // gutter corner in the atlas
+    };
+}
+
+static int NextPow2(int value)
+{
+    int pow2 = 1;
+    while (pow2 < value)
+        pow2 <<= 1;
+    return pow2;
+}
+
+// Shelves left to right, tallest first (items are sorted); returns the height used
+static int PackShelves(std::vector<Item>& items, int width)
+{
+    int x = 0, y = 0, shelfHeight = 0;
+    for (Item& item : items)
+    {
+        const int cellWidth = item.width + 2, cellHeight = item.height + 2;
+        if (cellWidth > width)
+            return INT32_MAX;
+        if (x + cellWidth > width)
+        {
+            y += shelfHeight;
+            x = 0;
+            shelfHeight = 0;
+        }
+        item.x = x;
+        item.y = y;
+        x += cellWidth;
+        shelfHeight = (std::max)(shelfHeight, cellHeight);
+    }
+    return y + shelfHeight;
+}
+
+BlipAtlas::BlipAtlas()
+    : m_pTexture(nullptr)
+    , m_white(0.0f, 0.0f)
+    , m_width(0)
+    , m_height(0)
+    , m_iconCount(0)
+{
+    memset(m_inAtlas, 0, sizeof(m_inAtlas));
+}
+
+BlipAtlas::~BlipAtlas()
+{
+    Release();
+}
+
+void BlipAtlas::Release()
+{
+    if (m_pTexture)
+    {
+        m_pTexture->Release();
+        m_pTexture = nullptr;
+    }
+    memset(m_inAtlas, 0, sizeof(m_inAtlas));
+    m_width = m_height = 0;
+    m_iconCount = 0;
+}
+
+bool BlipAtlas::Build(LPDIRECT3DDEVICE9 pDevice, const LPDIRECT3DTEXTURE9* textures, int count)
+{
+    Release();
+    if (!pDevice || !textures)
+        return false;
+
+    std::vector<Item> items;
+    for (int id = 0; id < count && id < MAX_SPRITES; ++id)
+    {
+        D3DSURFACE_DESC desc;
+        if (!textures[id] || FAILED(textures[id]->GetLevelDesc(0, &desc)))
+            continue;
+        if (desc.Width == 0 || desc.Height == 0 || desc.Width > MAX_ICON_SIZE || desc.Height > MAX_ICON_SIZE)
+            continue;
+        Item item = { id, (int)desc.Width, (int)desc.Height, 0, 0 };
+        items.push_back(item);
+    }
+    if (items.empty())
+        return false;
+    Item white = { WHITE_ID, WHITE_SIZE, WHITE_SIZE, 0, 0 };
+    items.push_back(white);
+    std::stable_sort(items.begin(), items.end(), [](const Item& a, const Item& b) { return a.height > b.height; });
+
+    D3DCAPS9 caps;
+    if (FAILED(pDevice->GetDeviceCaps(&caps)))
+        return false;
+    const int maxSize = (std::min)((int)(std::min)(caps.MaxTextureWidth, caps.MaxTextureHeight), MAX_SIZE);
+
+    // Narrowest power-of-two width whose packing is no taller than wide
+    int width = 0, height = 0;
+    for (int tryWidth = 64; tryWidth <= maxSize; tryWidth <<= 1)
+    {
+        const int used = PackShelves(items, tryWidth);
+        if (used != INT32_MAX && NextPow2(used) <= tryWidth)
+        {
+            width = tryWidth;
+            height = NextPow2(used);
+            break;
+        }
+    }
+    if (width == 0)
+        return false;
+
+    if (FAILED(pDevice->CreateTexture((UINT)width, (UINT)height, 1, 0, D3DFMT_A8R8G8B8, D3DPOOL_MANAGED, &m_pTexture, nullptr)) || !m_pTexture)
+    {
+        m_pTexture = nullptr;
+        return false;
+    }
+
+    D3DLOCKED_RECT locked;
+    if (FAILED(m_pTexture->LockRect(0, &locked, nullptr, 0)))
+    {
+        Release();
+        return false;
+    }
+    for (int y = 0; y < height; ++y)
+        memset((uint8_t*)locked.pBits + (size_t)y * locked.Pitch, 0, (size_t)width * 4);
+    m_pTexture->UnlockRect(0);
+
+    // D3DX converts every source format (DXT, X8R8G8B8) to A8R8G8B8 on the way in
+    IDirect3DSurface9* atlasSurface = nullptr;
+    if (FAILED(m_pTexture->GetSurfaceLevel(0, &atlasSurface)))
+    {
+        Release();
+        return false;
+    }
+    for (const Item& item : items)
+    {
+        if (item.id == WHITE_ID)
+            continue;
+        IDirect3DSurface9* iconSurface = nullptr;
+        if (FAILED(textures[item.id]->GetSurfaceLevel(0, &iconSurface)))
+            continue;
+        RECT dest = { item.x + 1, item.y + 1, item.x + 1 + item.width, item.y + 1 + item.height };
+        if (SUCCEEDED(D3DXLoadSurfaceFromSurface(atlasSurface, nullptr, &dest, iconSurface, nullptr, nullptr, D3DX_FILTER_NONE, 0)))
+            m_inAtlas[item.id] = true;
+        iconSurface->Release();
+    }
+    atlasSurface->Release();
+
+    if (FAILED(m_pTexture->LockRect(0, &locked, nullptr, 0)))
+    {
+        Release();
+        return false;
+    }
+    for (const Item& item : items)
+    {
+        uint32_t* origin = (uint32_t*)((uint8_t*)locked.pBits + (size_t)item.y * locked.Pitch) + item.x;
+        auto row = [&](int y) { return (uint32_t*)((uint8_t*)origin + (size_t)y * locked.Pitch); };
+        if (item.id == WHITE_ID)
+        {
+            for (int y = 0; y < item.height + 2; ++y)
+                for (int x = 0; x < item.width + 2; ++x)
+                    row(y)[x] = 0xFFFFFFFF;
+            continue;
+        }
+        if (!m_inAtlas[item.id])
+            continue;
+        // Edge columns, then the full top and bottom rows (corners included)
+        for (int y = 1; y <= item.height; ++y)
+        {
+            row(y)[0] = row(y)[1];
+            row(y)[item.width + 1] = row(y)[item.width];
+        }
+        memcpy(row(0), row(1), (size_t)(item.width + 2) * 4);
+        memcpy(row(item.height + 1), row(item.height), (size_t)(item.width + 2) * 4);
+    }
+    m_pTexture->UnlockRect(0);
+
+    const float invWidth = 1.0f / (float)width, invHeight = 1.0f / (float)height;
+    for (const Item& item : items)
+    {
+        if (item.id == WHITE_ID)
+        {
+            m_white = D3DXVECTOR2((item.x + 1 + WHITE_SIZE * 0.5f) * invWidth, (item.y + 1 + WHITE_SIZE * 0.5f) * invHeight);
+            continue;
+        }
+        if (!m_inAtlas[item.id])
+            continue;
+        m_regions[item.id] = D3DXVECTOR4((item.x + 1) * invWidth, (item.y + 1) * invHeight,
+                                         (item.x + 1 + item.width) * invWidth, (item.y + 1 + item.height) * invHeight);
+        ++m_iconCount;
+    }
+    if (m_iconCount == 0)
+    {
+        Release();
+        return false;
+    }
+    m_width = width;
+    m_height = height;
+    return true;
+}
+
+bool BlipAtlas::GetRegion(int spriteId, D3DXVECTOR4& outRegion) const
+{
+    if (!m_pTexture || spriteId < 0 || spriteId >= MAX_SPRITES || !m_inAtlas[spriteId])
+        return false;
+    outRegion = m_regions[spriteId];
+    return true;
+}
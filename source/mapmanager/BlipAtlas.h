@@ -0,0 +1,46 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/mapmanager/BlipAtlas.h
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <d3d9.h>
+#include <d3dx9.h>
+
+// blip.txd icons and the More Icons packed into one A8R8G8B8 texture, so the 2D icon pass binds a single texture.
+// Icons keep their own size, each with a 1 px replicated edge (bilinear filtering clamps like a texture of its
+// own); a white block serves untextured shapes. Built by BlipManager::LoadTextures, main thread only.
+class BlipAtlas
+{
+public:
+    static const int MAX_SPRITES = 70;      // BlipManager::GetBlipTexture ids: 0-63 txd, 64-69 More Icons
+    static const int MAX_ICON_SIZE = 256;   // larger icons stay out and are drawn on their own
+    static const int MAX_SIZE = 2048;
+
+    BlipAtlas();
+    ~BlipAtlas();
+
+    // textures[id] for id < count, nullptr where there is no icon. False (no atlas) if nothing fits or the
+    // texture cannot be created; callers then draw every icon with its own texture.
+    bool Build(LPDIRECT3DDEVICE9 pDevice, const LPDIRECT3DTEXTURE9* textures, int count);
+    void Release();
+
+    LPDIRECT3DTEXTURE9 GetTexture() const { return m_pTexture; }
+    // Icon area (u0, v0, u1, v1); false if the sprite is not in the atlas
+    bool               GetRegion(int spriteId, D3DXVECTOR4& outRegion) const;
+    // Texcoord of a white texel, for untextured shapes in the same batch
+    D3DXVECTOR2        GetWhite() const { return m_white; }
+    int                GetIconCount() const { return m_iconCount; }
+    size_t             GetBytes() const { return (size_t)m_width * (size_t)m_height * 4; }
+
+private:
+    LPDIRECT3DTEXTURE9  m_pTexture;
+    D3DXVECTOR4         m_regions[MAX_SPRITES];
+    bool                m_inAtlas[MAX_SPRITES];
+    D3DXVECTOR2         m_white;
+    int                 m_width;
+    int                 m_height;
+    int                 m_iconCount;
+};
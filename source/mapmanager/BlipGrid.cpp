@@ -0,0 +1,87 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/mapmanager/BlipGrid.cpp
+ *****************************************************************************/
+
+#include "BlipGrid.h"
+
+const float BlipGrid::CELL_SIZE = 6000.0f / BlipGrid::CELLS;
+const float BlipGrid::LOOSENESS = BlipGrid::CELL_SIZE * 0.5f;
+const float BlipGrid::ORIGIN_X = 0.0f;
+const float BlipGrid::ORIGIN_Y = -6000.0f;
+
+BlipGrid::BlipGrid()
+{
+}
+
+int BlipGrid::CellCoord(float offset)
+{
+    // NaN lands in cell 0 like anything below the map
+    const float c = offset / CELL_SIZE;
+    if (!(c >= 0.0f))
+        return 0;
+    if (c >= (float)CELLS)
+        return CELLS - 1;
+    return (int)c;
+}
+
+// Border cells reach out to infinity on their outer side, matching the clamp in CellCoord
+bool BlipGrid::InsideLooseCell(int cell, float x, float y) const
+{
+    const int cx = cell % CELLS, cy = cell / CELLS;
+    const float minX = ORIGIN_X + cx * CELL_SIZE - LOOSENESS, maxX = ORIGIN_X + (cx + 1) * CELL_SIZE + LOOSENESS;
+    const float minY = ORIGIN_Y + cy * CELL_SIZE - LOOSENESS, maxY = ORIGIN_Y + (cy + 1) * CELL_SIZE + LOOSENESS;
+    return (cx == 0 || x >= minX) && (cx == CELLS - 1 || x <= maxX)
+        && (cy == 0 || y >= minY) && (cy == CELLS - 1 || y <= maxY);
+}
+
+void BlipGrid::Insert(uint32_t slot, float x, float y)
+{
+    if (slot >= m_slotCell.size())
+    {
+        m_slotCell.resize(slot + 1, -1);
+        m_slotPos.resize(slot + 1, 0);
+    }
+    const int cell = CellCoord(y - ORIGIN_Y) * CELLS + CellCoord(x - ORIGIN_X);
+    m_slotCell[slot] = cell;
+    m_slotPos[slot] = (uint32_t)m_cells[cell].size();
+    m_cells[cell].push_back((uint16_t)slot);
+}
+
+void BlipGrid::Move(uint32_t slot, float x, float y)
+{
+    if (slot >= m_slotCell.size() || m_slotCell[slot] < 0)
+    {
+        Insert(slot, x, y);
+        return;
+    }
+    const int cell = m_slotCell[slot];
+    if (InsideLooseCell(cell, x, y))
+        return;
+    const int newCell = CellCoord(y - ORIGIN_Y) * CELLS + CellCoord(x - ORIGIN_X);
+    if (newCell == cell)
+        return;
+    Remove(slot);
+    Insert(slot, x, y);
+}
+
+void BlipGrid::Remove(uint32_t slot)
+{
+    if (slot >= m_slotCell.size() || m_slotCell[slot] < 0)
+        return;
+    // Swap with the last entry of the cell; order inside a cell does not matter
+    std::vector<uint16_t>& list = m_cells[m_slotCell[slot]];
+    const uint32_t pos = m_slotPos[slot];
+    const uint16_t last = list.back();
+    list[pos] = last;
+    m_slotPos[last] = pos;
+    list.pop_back();
+    m_slotCell[slot] = -1;
+}
+
+void BlipGrid::Clear()
+{
+    for (std::vector<uint16_t>& list : m_cells)
+        list.clear();
+    m_slotCell.assign(m_slotCell.size(), -1);
+}
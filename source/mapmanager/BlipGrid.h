@@ -0,0 +1,59 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/mapmanager/BlipGrid.h
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Loose uniform grid over the 6000 x 6000 radar space (x 0..6000, y -6000..0), keyed by BlipStore slot.
+// An entry stays in its cell until it leaves the cell widened by LOOSENESS on each side, so blips that follow
+// a vehicle rarely change cells; queries widen their rect by the same amount instead. Positions outside the
+// map land in the border cells.
+class BlipGrid
+{
+public:
+    static const int   CELLS = 32;
+    static const float CELL_SIZE;
+    static const float LOOSENESS;
+
+    BlipGrid();
+
+    void Insert(uint32_t slot, float x, float y);
+    void Move(uint32_t slot, float x, float y);
+    void Remove(uint32_t slot);
+    void Clear();
+
+    // Cell index cy * CELLS + cx of a slot, -1 if not in the grid; and the slots filed under a cell
+    int  GetCell(uint32_t slot) const { return (slot < m_slotCell.size()) ? m_slotCell[slot] : -1; }
+    const std::vector<uint16_t>& GetCellSlots(int cell) const { return m_cells[cell]; }
+
+    // Slots whose cells can hold a point inside the rect; the caller tests the exact position
+    template<typename Visit>
+    void Query(float minX, float minY, float maxX, float maxY, Visit&& visit) const
+    {
+        const int x0 = CellCoord(minX - LOOSENESS - ORIGIN_X), x1 = CellCoord(maxX + LOOSENESS - ORIGIN_X);
+        const int y0 = CellCoord(minY - LOOSENESS - ORIGIN_Y), y1 = CellCoord(maxY + LOOSENESS - ORIGIN_Y);
+        for (int cy = y0; cy <= y1; ++cy)
+        {
+            for (int cx = x0; cx <= x1; ++cx)
+            {
+                for (uint16_t slot : m_cells[cy * CELLS + cx])
+                    visit(slot);
+            }
+        }
+    }
+
+private:
+    static const float ORIGIN_X;
+    static const float ORIGIN_Y;
+
+    static int CellCoord(float offset);
+    bool       InsideLooseCell(int cell, float x, float y) const;
+
+    std::vector<uint16_t> m_cells[CELLS * CELLS];
+    std::vector<int>      m_slotCell;       // -1: not in the grid
+    std::vector<uint32_t> m_slotPos;        // position in its cell list
+};
@@ -14,6 +14,8 @@
 #include "CVehicle.h"
 #include "CEntryExit.h"
 #include "CRadar.h"
+#include "PixelConvert.h"
+#include <chrono>
 #include <cstring>
 
 static LPDIRECT3DTEXTURE9 RwTextureToD3D9(LPDIRECT3DDEVICE9 pDevice, RwTexture* rwTex)
@@ -59,22 +61,7 @@ static LPDIRECT3DTEXTURE9 RwTextureToD3D9(LPDIRECT3DDEVICE9 pDevice, RwTexture*
     D3DLOCKED_RECT locked;
     if (SUCCEEDED(d3dTex->LockRect(0, &locked, nullptr, 0)))
     {
-        RwUInt8* src = RwImageGetPixels(img);
-        int srcStride = RwImageGetStride(img);
-        int dstStride = locked.Pitch;
-        for (int y = 0; y < h; y++)
-        {
-            RwUInt8* rowSrc = src + y * srcStride;
-            RwUInt8* rowDst = (RwUInt8*)locked.pBits + y * dstStride;
-            for (int x = 0; x < w; x++)
-            {
-                int off = x * 4;
-                rowDst[off + 0] = rowSrc[off + 2];
-                rowDst[off + 1] = rowSrc[off + 1];
-                rowDst[off + 2] = rowSrc[off + 0];
-                rowDst[off + 3] = rowSrc[off + 3];
-            }
-        }
+        PixelConvert::SwapRedBlue(RwImageGetPixels(img), RwImageGetStride(img), (uint8_t*)locked.pBits, locked.Pitch, w, h);
         d3dTex->UnlockRect(0);
     }
 
@@ -83,9 +70,42 @@ static LPDIRECT3DTEXTURE9 RwTextureToD3D9(LPDIRECT3DDEVICE9 pDevice, RwTexture*
     return d3dTex;
 }
 
+// NativeTxd: level 0 copied from the mapped TXD into the texture as it is, DXT blocks included; no RwImage
+static LPDIRECT3DTEXTURE9 NativeToD3D9(LPDIRECT3DDEVICE9 pDevice, const TxdNativeReader::Texture& texture)
+{
+    D3DFORMAT format;
+    switch (texture.format)
+    {
+    case TxdNativeReader::TXD_FORMAT_A8R8G8B8: format = D3DFMT_A8R8G8B8; break;
+    case TxdNativeReader::TXD_FORMAT_X8R8G8B8: format = D3DFMT_X8R8G8B8; break;
+    case TxdNativeReader::TXD_FORMAT_DXT1:     format = D3DFMT_DXT1; break;
+    case TxdNativeReader::TXD_FORMAT_DXT3:     format = D3DFMT_DXT3; break;
+    case TxdNativeReader::TXD_FORMAT_DXT5:     format = D3DFMT_DXT5; break;
+    default:                                   return nullptr;
+    }
+
+    LPDIRECT3DTEXTURE9 d3dTex = nullptr;
+    HRESULT hr = pDevice->CreateTexture((UINT)texture.width, (UINT)texture.height, 1, 0, format, D3DPOOL_MANAGED, &d3dTex, nullptr);
+    if (FAILED(hr) || !d3dTex)
+        return nullptr;
+
+    D3DLOCKED_RECT locked;
+    if (FAILED(d3dTex->LockRect(0, &locked, nullptr, 0)))
+    {
+        d3dTex->Release();
+        return nullptr;
+    }
+    // Pitch is per block row for DXT formats, like the native payload
+    for (int y = 0; y < texture.rows; ++y)
+        memcpy((uint8_t*)locked.pBits + (size_t)y * locked.Pitch, texture.data + (size_t)y * texture.pitch, (size_t)texture.rowBytes);
+    d3dTex->UnlockRect(0);
+    return d3dTex;
+}
+
 BlipManager::BlipManager(LPDIRECT3DDEVICE9 pDevice)
     : m_pDevice(pDevice)
     , m_pBlipTxd(nullptr)
+    , m_blipsViewVersion(0)
     , m_lastUpdateTime(0)
     , m_pMoreIconsManager(nullptr)
 {
@@ -132,8 +152,17 @@ bool BlipManager::LoadTextures()
     CleanupTextures();
 
     const char* path = PLUGIN_PATH("radar/blip.txd");
-    m_pBlipTxd = CFileLoader::LoadTexDictionary(path);
-    if (!m_pBlipTxd)
+    m_txdWatch.Reset(FileWatch::GetFileStamp(path));
+
+    // Mapped natives first; the RenderWare TXD only for formats they cannot be created from.
+    // A mapped file cannot be overwritten, so HotReload keeps to RenderWare.
+    const bool native = RadarConfig::GetNativeTxd() && !RadarConfig::GetHotReload() && m_txdNative.Open(path);
+    bool needTxd = !native;
+    for (int i = 0; native && !needTxd && i < m_txdNative.GetTextureCount(); ++i)
+        needTxd = m_txdNative.GetTexture(i).format == TxdNativeReader::TXD_FORMAT_UNSUPPORTED;
+    if (needTxd)
+        m_pBlipTxd = CFileLoader::LoadTexDictionary(path);
+    if (!m_pBlipTxd && !native)
         return false;
 
     bool allLoaded = true;
@@ -142,15 +171,7 @@ bool BlipManager::LoadTextures()
         char texName[16];
         sprintf_s(texName, "%d", i);
 
-        RwTexture* rwTex = RwTexDictionaryFindNamedTexture(m_pBlipTxd, texName);
-        if (!rwTex)
-        {
-            m_textures[i] = nullptr;
-            allLoaded = false;
-            continue;
-        }
-
-        m_textures[i] = RwTextureToD3D9(m_pDevice, rwTex);
+        m_textures[i] = LoadTextureFromTxd(texName);
         if (!m_textures[i])
             allLoaded = false;
     }
@@ -162,15 +183,24 @@ bool BlipManager::LoadTextures()
     if (!m_textures[49])
         m_textures[49] = LoadTextureFromTxd("dateDrink");
 
+    LPDIRECT3DTEXTURE9 atlasIcons[BlipAtlas::MAX_SPRITES];
+    for (int i = 0; i < BlipAtlas::MAX_SPRITES; ++i)
+        atlasIcons[i] = GetBlipTexture(i);
+    m_atlas.Build(m_pDevice, atlasIcons, BlipAtlas::MAX_SPRITES);
+
     return allLoaded;
 }
 
 LPDIRECT3DTEXTURE9 BlipManager::LoadTextureFromTxd(const char* texName) const
 {
-    if (!m_pBlipTxd || !m_pDevice || !texName)
+    if (!m_pDevice || !texName)
         return nullptr;
 
-    RwTexture* rwTex = RwTexDictionaryFindNamedTexture(m_pBlipTxd, texName);
+    const TxdNativeReader::Texture* native = m_txdNative.Find(texName);
+    if (native && native->format != TxdNativeReader::TXD_FORMAT_UNSUPPORTED)
+        return NativeToD3D9(m_pDevice, *native);
+
+    RwTexture* rwTex = m_pBlipTxd ? RwTexDictionaryFindNamedTexture(m_pBlipTxd, texName) : nullptr;
     if (!rwTex)
         return nullptr;
 
@@ -203,8 +233,31 @@ void BlipManager::CleanupMoreIconTextures()
     }
 }
 
+bool BlipManager::ReloadIfChanged()
+{
+    if (!RadarConfig::GetHotReload() || !m_txdWatch.IsPollDue())
+        return false;
+    if (!m_txdWatch.Update(FileWatch::GetFileStamp(PLUGIN_PATH("radar/blip.txd"))))
+        return false;
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    LoadTextures();
+    int icons = 0;
+    for (int i = 0; i <= MAX_BLIP_ID; ++i)
+        if (m_textures[i])
+            ++icons;
+    const unsigned int millis = (unsigned int)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+
+    char message[96];
+    sprintf_s(message, "Radar: blip.txd reloaded in %u ms, %d icons\n", millis, icons);
+    OutputDebugStringA(message);
+    return true;
+}
+
 void BlipManager::CleanupTextures()
 {
+    m_atlas.Release();
     CleanupMoreIconTextures();
     for (int i = 0; i <= MAX_BLIP_ID; ++i)
     {
@@ -220,6 +273,21 @@ void BlipManager::CleanupTextures()
         RwTexDictionaryDestroy(m_pBlipTxd);
         m_pBlipTxd = nullptr;
     }
+    m_txdNative.Close();
+    // Blips were built against these textures (sprite fallbacks)
+    m_traceSync.Invalidate();
+}
+
+const std::vector<Blip>& BlipManager::GetBlips() const
+{
+    if (m_blipsViewVersion != m_store.GetVersion())
+    {
+        m_blipsView.resize(m_store.GetCount());
+        for (int i = 0; i < m_store.GetCount(); ++i)
+            m_blipsView[i] = m_store.Get(i);
+        m_blipsViewVersion = m_store.GetVersion();
+    }
+    return m_blipsView;
 }
 
 void BlipManager::UpdateFromGame()
@@ -229,16 +297,135 @@ void BlipManager::UpdateFromGame()
         return;
 
     m_lastUpdateTime = currentTime;
-    m_blips.clear();
-    ParseRadarBlipSprites();
+    if (!SyncTraceSlots())
+    {
+        ResetStore();
+        return;
+    }
+    SyncMoreIcons();
+    // Once for every blip removed by both syncs
+    m_store.Compact();
 }
 
-void BlipManager::ParseRadarBlipSprites()
+// Drops every blip; the next sync adds them all again
+void BlipManager::ResetStore()
+{
+    m_store.Clear();
+    m_traceSync.Invalidate();
+    m_edgeBlips.clear();
+    m_moreIconHandles.clear();
+    m_moreIconBlips.clear();
+}
+
+// BuildTraceBlip for changed traces (enex, sprite checks). Unchanged vehicle blips just follow the vehicle;
+// one that appeared in or left the pool changes the sprite, so that slot is rebuilt.
+struct BlipManager::TraceSource
+{
+    const BlipManager& manager;
+
+    bool Build(int, const uint8_t* record, Blip& outBlip, bool& outFollows) const
+    {
+        return manager.BuildTraceBlip(*(const tRadarTrace*)record, outBlip, outFollows);
+    }
+
+    BlipSlotSync::FollowResult Follow(int, const uint8_t* record, bool hasVehicle, D3DXVECTOR3& outPosition) const
+    {
+        const tRadarTrace& trace = *(const tRadarTrace*)record;
+        if (!trace.m_bInUse || trace.m_nBlipType != BLIP_CAR || trace.m_nEntityHandle == 0)
+            return BlipSlotSync::FOLLOW_STATIC;
+
+        CVehicle* vehicle = nullptr;
+        try
+        {
+            vehicle = CPools::GetVehicle(trace.m_nEntityHandle);
+        }
+        catch (...) {}
+        if ((vehicle != nullptr) != hasVehicle)
+            return BlipSlotSync::FOLLOW_REBUILD;
+        if (!vehicle || trace.m_pEntryExit)
+            return BlipSlotSync::FOLLOW_STATIC;
+
+        CVector vehiclePos = vehicle->GetPosition();
+        outPosition = D3DXVECTOR3(vehiclePos.x + 3000.0f, vehiclePos.y - 3000.0f, 0.1f);
+        return BlipSlotSync::FOLLOW_AT;
+    }
+};
+
+// A slot that gains a blip adds it at the end of the store
+bool BlipManager::SyncTraceSlots()
+{
+    tRadarTrace* traces = CRadar::ms_RadarTrace;
+    if (!traces || !CRadar::RadarBlipSprites)
+        return false;
+
+    if (m_traceSync.GetSlotCount() != MAX_RADAR_TRACES)
+        m_traceSync.Reset(MAX_RADAR_TRACES, sizeof(tRadarTrace));
+    if (!m_traceSync.IsValid())
+        ResetStore();
+
+    TraceSource source = { *this };
+    if (m_traceSync.Sync((const uint8_t*)traces, m_store, source))
+    {
+        m_edgeBlips.clear();
+        for (int i = 0; i < m_traceSync.GetSlotCount(); ++i)
+        {
+            const int index = m_store.GetIndex(m_traceSync.GetHandle(i));
+            if (index >= 0 && m_store.GetIcon()[index] == RADAR_SPRITE_WAYPOINT)
+                m_edgeBlips.push_back(m_traceSync.GetHandle(i));
+        }
+    }
+    return true;
+}
+
+static bool SameBlip(const Blip& a, const Blip& b)
+{
+    return a.position == b.position && a.iconId == b.iconId && a.size == b.size && a.color == b.color
+        && a.enabled == b.enabled && a.shortRange == b.shortRange;
+}
+
+// MoreIcons come from fixed tables and the enex / respawn lists, so they rarely change; the store is only
+// touched when the output differs from the last one
+void BlipManager::SyncMoreIcons()
+{
+    m_moreIconScratch.clear();
+    if (RadarConfig::GetModeMoreIcon() && m_pMoreIconsManager)
+        m_pMoreIconsManager->GetBlips(m_moreIconScratch);
+
+    if (m_moreIconScratch.size() == m_moreIconBlips.size())
+    {
+        for (size_t i = 0; i < m_moreIconScratch.size(); ++i)
+        {
+            if (!SameBlip(m_moreIconScratch[i], m_moreIconBlips[i]))
+                m_store.Set(m_moreIconHandles[i], m_moreIconScratch[i]);
+        }
+    }
+    else
+    {
+        for (size_t i = m_moreIconHandles.size(); i-- > 0;)
+            m_store.Remove(m_moreIconHandles[i]);
+        m_moreIconHandles.clear();
+        for (const Blip& blip : m_moreIconScratch)
+            m_moreIconHandles.push_back(m_store.Add(blip));
+    }
+    m_moreIconBlips.swap(m_moreIconScratch);
+}
+
+// The blip of one trace; false if the trace shows none on this radar
+bool BlipManager::BuildTraceBlip(const tRadarTrace& gameBlip, Blip& outBlip, bool& outHasVehicle) const
 {
-    tRadarTrace* ms_RadarTrace = CRadar::ms_RadarTrace;
     CSprite2d* RadarBlipSprites = CRadar::RadarBlipSprites;
-    if (!ms_RadarTrace || !RadarBlipSprites)
-        return;
+
+    // Looked up whatever the outcome: SyncTraceSlots rebuilds the slot when this changes
+    CVehicle* vehicle = nullptr;
+    if (gameBlip.m_bInUse && gameBlip.m_nEntityHandle != 0 && gameBlip.m_nBlipType == BLIP_CAR)
+    {
+        try
+        {
+            vehicle = CPools::GetVehicle(gameBlip.m_nEntityHandle);
+        }
+        catch (...) {}
+    }
+    outHasVehicle = vehicle != nullptr;
 
     auto spriteValid = [this, RadarBlipSprites](unsigned char id, CSprite2d*& outSprite) -> bool {
         if (id >= MAX_RADAR_SPRITES)
@@ -250,94 +437,76 @@ void BlipManager::ParseRadarBlipSprites()
         return true;
     };
 
-    for (unsigned int i = 0; i < MAX_RADAR_TRACES; i++)
-    {
-        tRadarTrace& gameBlip = ms_RadarTrace[i];
-        if (!gameBlip.m_bInUse
-            || gameBlip.m_nRadarSprite == RADAR_SPRITE_NORTH
-            || gameBlip.m_nRadarSprite == RADAR_SPRITE_CJ
-            || gameBlip.m_nBlipDisplay == BLIP_DISPLAY_NEITHER)
-            continue;
-
-        eBlipType blipType = (eBlipType)gameBlip.m_nBlipType;
-        if (blipType == BLIP_OBJECT)
-            continue;
-
-        // Skip BLIP_CHAR unless it's a legend sprite (story characters like Sweet, Ryder, etc.)
-        if (blipType == BLIP_CHAR && !IsLegendSprite(gameBlip.m_nRadarSprite))
-            continue;
-
-        bool isMissionMarker = (blipType == BLIP_COORD || blipType == BLIP_CONTACTPOINT || blipType == BLIP_SPOTLIGHT);
-        unsigned char spriteId = gameBlip.m_nRadarSprite;
-        if (spriteId >= MAX_RADAR_SPRITES && isMissionMarker)
-            spriteId = RADAR_SPRITE_WAYPOINT;
-        if (spriteId >= MAX_RADAR_SPRITES)
-            continue;
-
-        CSprite2d* sprite = nullptr;
-        if (!spriteValid(spriteId, sprite) && isMissionMarker)
-        {
-            spriteId = RADAR_SPRITE_WAYPOINT;
-            if (!spriteValid(spriteId, sprite))
-                continue;
-        }
-        else if (!sprite)
-            continue;
+    if (!gameBlip.m_bInUse
+        || gameBlip.m_nRadarSprite == RADAR_SPRITE_NORTH
+        || gameBlip.m_nRadarSprite == RADAR_SPRITE_CJ
+        || gameBlip.m_nBlipDisplay == BLIP_DISPLAY_NEITHER)
+        return false;
 
-        Blip blip;
-        CVector blipPos = gameBlip.m_vecPos;
+    eBlipType blipType = (eBlipType)gameBlip.m_nBlipType;
+    if (blipType == BLIP_OBJECT)
+        return false;
 
-        if (gameBlip.m_nEntityHandle != 0 && blipType == BLIP_CAR)
-        {
-            try
-            {
-                CVehicle* vehicle = CPools::GetVehicle(gameBlip.m_nEntityHandle);
-                if (vehicle)
-                {
-                    blipPos = vehicle->GetPosition();
-                    spriteId = 0;
-                    if (!spriteValid(spriteId, sprite))
-                        continue;
-                }
-            }
-            catch (...) {}
-        }
+    // Skip BLIP_CHAR unless it's a legend sprite (story characters like Sweet, Ryder, etc.)
+    if (blipType == BLIP_CHAR && !IsLegendSprite(gameBlip.m_nRadarSprite))
+        return false;
 
-        // Skip blips associated with interior exits - only show exterior entrances
-        if (gameBlip.m_pEntryExit)
-        {
-            try
-            {
-                CEntryExit* enex = gameBlip.m_pEntryExit;
-                // Skip interior exits - only show exterior entrances (like More Radar Icons CLEO script)
-                if (enex->m_nArea != 0)
-                    continue;
-                blipPos.x = (enex->m_recEntrance.left + enex->m_recEntrance.right) * 0.5f;
-                blipPos.y = (enex->m_recEntrance.top + enex->m_recEntrance.bottom) * 0.5f;
-            }
-            catch (...) {}
-        }
+    bool isMissionMarker = (blipType == BLIP_COORD || blipType == BLIP_CONTACTPOINT || blipType == BLIP_SPOTLIGHT);
+    unsigned char spriteId = gameBlip.m_nRadarSprite;
+    if (spriteId >= MAX_RADAR_SPRITES && isMissionMarker)
+        spriteId = RADAR_SPRITE_WAYPOINT;
+    if (spriteId >= MAX_RADAR_SPRITES)
+        return false;
 
-        // Skip sprite 50 (restaurant fork&knife) - it's added by MoreIconsManager only when Enex found
-        // Game creates this sprite for various locations but CLEO More Radar Icons doesn't show them
-        //if (spriteId == 50)
-        //    continue;
-
-        int w = RwRasterGetWidth(sprite->m_pTexture->raster);
-        int h = RwRasterGetHeight(sprite->m_pTexture->raster);
-        blip.position = D3DXVECTOR3(blipPos.x + 3000.0f, blipPos.y - 3000.0f, 0.1f);
-        blip.iconId = spriteId;
-        blip.size = (w + h) > 0 ? (float)((w + h) / 2) : 16.0f;
-        blip.color = ConvertBlipColorToDWORD(gameBlip.m_nColour, gameBlip.m_bBright, gameBlip.m_bFriendly);
-        blip.enabled = true;
-        blip.shortRange = gameBlip.m_bShortRange ? true : false;
-        m_blips.push_back(blip);
+    CSprite2d* sprite = nullptr;
+    if (!spriteValid(spriteId, sprite) && isMissionMarker)
+    {
+        spriteId = RADAR_SPRITE_WAYPOINT;
+        if (!spriteValid(spriteId, sprite))
+            return false;
     }
+    else if (!sprite)
+        return false;
 
-    if (RadarConfig::GetModeMoreIcon() && m_pMoreIconsManager)
+    CVector blipPos = gameBlip.m_vecPos;
+
+    if (vehicle)
     {
-        m_pMoreIconsManager->GetBlips(m_blips);
+        blipPos = vehicle->GetPosition();
+        spriteId = 0;
+        if (!spriteValid(spriteId, sprite))
+            return false;
     }
+
+    // Skip blips associated with interior exits - only show exterior entrances
+    if (gameBlip.m_pEntryExit)
+    {
+        try
+        {
+            CEntryExit* enex = gameBlip.m_pEntryExit;
+            // Skip interior exits - only show exterior entrances (like More Radar Icons CLEO script)
+            if (enex->m_nArea != 0)
+                return false;
+            blipPos.x = (enex->m_recEntrance.left + enex->m_recEntrance.right) * 0.5f;
+            blipPos.y = (enex->m_recEntrance.top + enex->m_recEntrance.bottom) * 0.5f;
+        }
+        catch (...) {}
+    }
+
+    // Skip sprite 50 (restaurant fork&knife) - it's added by MoreIconsManager only when Enex found
+    // Game creates this sprite for various locations but CLEO More Radar Icons doesn't show them
+    //if (spriteId == 50)
+    //    return false;
+
+    int w = RwRasterGetWidth(sprite->m_pTexture->raster);
+    int h = RwRasterGetHeight(sprite->m_pTexture->raster);
+    outBlip.position = D3DXVECTOR3(blipPos.x + 3000.0f, blipPos.y - 3000.0f, 0.1f);
+    outBlip.iconId = spriteId;
+    outBlip.size = (w + h) > 0 ? (float)((w + h) / 2) : 16.0f;
+    outBlip.color = ConvertBlipColorToDWORD(gameBlip.m_nColour, gameBlip.m_bBright, gameBlip.m_bFriendly);
+    outBlip.enabled = true;
+    outBlip.shortRange = gameBlip.m_bShortRange ? true : false;
+    return true;
 }
 
 LPDIRECT3DTEXTURE9 BlipManager::GetBlipTexture(int spriteId) const
@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <d3d9.h>
 #include <d3dx9.h>
 #include <vector>
@@ -12,6 +13,11 @@
 #include "CRadar.h"
 #include "RenderWare.h"
 #include "BlipTypes.h"
+#include "BlipStore.h"
+#include "BlipSlotSync.h"
+#include "BlipAtlas.h"
+#include "FileWatch.h"
+#include "TxdNativeReader.h"
 
 class MoreIconsManager;
 
@@ -26,10 +32,22 @@ public:
 
     bool LoadTextures();
     void CleanupTextures();
+    // HotReload: reloads the textures once blip.txd has changed; true if it did, borrowed textures are then stale
+    bool ReloadIfChanged();
     void UpdateFromGame();
 
-    const std::vector<Blip>& GetBlips() const { return m_blips; }
+    // Trace-backed blips of the last update that ran; MoreIcons blips are not counted
+    typedef BlipSlotSync::Stats SyncStats;
+
+    const BlipStore&         GetBlipStore() const { return m_store; }
+    // Waypoint blips: drawn on the orbit edge when out of view, so culling by area must keep them
+    const std::vector<BlipHandle>& GetEdgeBlips() const { return m_edgeBlips; }
+    // Array of structs built from the store when it changed; for code not on the columns yet
+    const std::vector<Blip>& GetBlips() const;
+    const SyncStats&         GetSyncStats() const { return m_traceSync.GetStats(); }
     LPDIRECT3DTEXTURE9       GetBlipTexture(int spriteId) const;  // 0-63 txd, 64-69 more icons (PNG)
+    // The same icons in one texture, rebuilt with them; sprite ids as for GetBlipTexture
+    const BlipAtlas&         GetBlipAtlas() const { return m_atlas; }
 
     enum MoreIconId
     {
@@ -49,18 +67,35 @@ public:
     static DWORD                TraceColorToD3D(unsigned int blipColour, bool bright, bool friendly);
 
 private:
-    void  ParseRadarBlipSprites();
+    // BlipSlotSync source over CRadar::ms_RadarTrace
+    struct TraceSource;
+
+    void  ResetStore();
+    bool  SyncTraceSlots();
+    void  SyncMoreIcons();
+    bool  BuildTraceBlip(const tRadarTrace& trace, Blip& outBlip, bool& outHasVehicle) const;
+
     void  LoadMoreIconTextures();
     void  CleanupMoreIconTextures();
 
     DWORD ConvertBlipColorToDWORD(unsigned int blipColour, bool bright, bool friendly) const;
 
     LPDIRECT3DDEVICE9   m_pDevice;
-    RwTexDictionary*    m_pBlipTxd;
+    RwTexDictionary*    m_pBlipTxd;         // only loaded when NativeTxd is off or some texture needs RenderWare
+    TxdNativeReader     m_txdNative;
     LPDIRECT3DTEXTURE9  m_textures[MAX_BLIP_ID + 1];
     LPDIRECT3DTEXTURE9  m_moreIconTextures[6];  // store, donuts, intrack, casino, dateNude, train
+    BlipAtlas           m_atlas;
     std::string         m_iconPaths[RADAR_SPRITE_COUNT];
-    std::vector<Blip>   m_blips;
+    BlipStore           m_store;            // trace blips and MoreIcons
+    BlipSlotSync        m_traceSync;        // one slot per trace, index and m_nCounter included in the compare
+    std::vector<BlipHandle> m_edgeBlips;
+    std::vector<BlipHandle> m_moreIconHandles;
+    std::vector<Blip>      m_moreIconBlips;     // MoreIconsManager output behind m_moreIconHandles
+    std::vector<Blip>      m_moreIconScratch;
+    mutable std::vector<Blip> m_blipsView;      // GetBlips
+    mutable uint32_t       m_blipsViewVersion;
     unsigned int        m_lastUpdateTime;
     MoreIconsManager*   m_pMoreIconsManager;
+    FileWatch           m_txdWatch;
 };
@@ -0,0 +1,48 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/mapmanager/BlipSlotSync.cpp
+ *****************************************************************************/
+
+#include "BlipSlotSync.h"
+#include <intrin.h>
+
+BlipSlotSync::BlipSlotSync()
+    : m_recordSize(0)
+    , m_valid(false)
+    , m_stats()
+{
+}
+
+void BlipSlotSync::Reset(int slotCount, size_t recordSize)
+{
+    const Slot empty = { 0, false };
+    m_slots.assign(slotCount, empty);
+    m_records.assign((size_t)slotCount * recordSize, 0);
+    m_dirty.assign((slotCount + 31) / 32, 0);
+    m_recordSize = recordSize;
+    m_valid = false;
+    m_stats = Stats();
+}
+
+void BlipSlotSync::Invalidate()
+{
+    for (Slot& slot : m_slots)
+        slot.handle = 0;
+    m_valid = false;
+}
+
+int BlipSlotSync::PopDirty(int from)
+{
+    for (size_t word = (size_t)from >> 5; word < m_dirty.size(); ++word)
+    {
+        // Bits below from in its word were popped already
+        const uint32_t bits = (word == ((size_t)from >> 5)) ? m_dirty[word] & (~0u << (from & 31)) : m_dirty[word];
+        if (!bits)
+            continue;
+        unsigned long bit;
+        _BitScanForward(&bit, bits);
+        m_dirty[word] &= ~(1u << bit);
+        return (int)(word * 32 + bit);
+    }
+    return -1;
+}
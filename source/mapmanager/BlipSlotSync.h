@@ -0,0 +1,137 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/mapmanager/BlipSlotSync.h
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "BlipStore.h"
+
+// Blips of a fixed array of game records (CRadar::ms_RadarTrace), kept in a BlipStore across updates.
+// Every slot keeps a copy of the record its blip was built from; Sync compares them whole and only rebuilds
+// the changed slots. A blip that follows an entity is moved without a rebuild.
+class BlipSlotSync
+{
+public:
+    // Last Sync, per slot
+    struct Stats
+    {
+        int added;      // slot got a blip
+        int removed;    // slot lost its blip
+        int updated;    // slot rebuilt, or its entity moved
+        int untouched;
+    };
+
+    // Source::Follow for a slot whose record did not change
+    enum FollowResult
+    {
+        FOLLOW_STATIC,      // the blip stays where it was built
+        FOLLOW_AT,          // the blip belongs at outPosition
+        FOLLOW_REBUILD,     // something the record does not show changed (entity appeared / left): build again
+    };
+
+    BlipSlotSync();
+
+    // slotCount records of recordSize bytes; no slot has a blip, all are built on the next Sync
+    void Reset(int slotCount, size_t recordSize);
+    // The store was cleared: every slot is built again on the next Sync
+    void Invalidate();
+
+    bool         IsValid() const { return m_valid; }
+    int          GetSlotCount() const { return (int)m_slots.size(); }
+    BlipHandle   GetHandle(int slot) const { return m_slots[slot].handle; }
+    const Stats& GetStats() const { return m_stats; }
+
+    // records: the slotCount records as they are now.
+    //   source.Build(slot, record, outBlip, outFollows): the slot's blip, false for none; outFollows is passed
+    //     back to Follow while the record stays the same
+    //   source.Follow(slot, record, follows, outPosition) -> FollowResult
+    // Returns true if any record changed (blips added, removed or rebuilt). Removed blips stay tombstones
+    // until store.Compact().
+    template<typename Source>
+    bool Sync(const uint8_t* records, BlipStore& store, Source& source)
+    {
+        m_stats = Stats();
+        const int count = GetSlotCount();
+        for (int i = 0; i < count; ++i)
+        {
+            const uint8_t* record = records + (size_t)i * m_recordSize;
+            Slot& slot = m_slots[i];
+            if (!m_valid || memcmp(&m_records[(size_t)i * m_recordSize], record, m_recordSize) != 0)
+            {
+                MarkDirty(i);
+                continue;
+            }
+
+            D3DXVECTOR3 position;
+            const FollowResult follow = source.Follow(i, record, slot.follows, position);
+            if (follow == FOLLOW_REBUILD)
+            {
+                MarkDirty(i);
+                continue;
+            }
+            const int index = store.GetIndex(slot.handle);
+            if (follow == FOLLOW_AT && index >= 0 && (position.x != store.GetX()[index] || position.y != store.GetY()[index]))
+            {
+                store.SetPosition(slot.handle, position);
+                ++m_stats.updated;
+            }
+            else
+                ++m_stats.untouched;
+        }
+        m_valid = true;
+
+        bool anyDirty = false;
+        for (int i = PopDirty(0); i >= 0; i = PopDirty(i + 1))
+        {
+            anyDirty = true;
+            Slot& slot = m_slots[i];
+            const uint8_t* record = records + (size_t)i * m_recordSize;
+            memcpy(&m_records[(size_t)i * m_recordSize], record, m_recordSize);
+
+            Blip blip;
+            const bool hasBlip = source.Build(i, record, blip, slot.follows);
+            if (hasBlip && slot.handle)
+            {
+                store.Set(slot.handle, blip);
+                ++m_stats.updated;
+            }
+            else if (hasBlip)
+            {
+                slot.handle = store.Add(blip);
+                ++m_stats.added;
+            }
+            else if (slot.handle)
+            {
+                store.Remove(slot.handle);
+                slot.handle = 0;
+                ++m_stats.removed;
+            }
+            else
+                ++m_stats.untouched;
+        }
+        return anyDirty;
+    }
+
+private:
+    struct Slot
+    {
+        BlipHandle handle;      // 0: the record shows no blip
+        bool       follows;     // Build's outFollows
+    };
+
+    void MarkDirty(int slot) { m_dirty[slot >> 5] |= 1u << (slot & 31); }
+    // First dirty slot >= from, cleared; -1 if none
+    int  PopDirty(int from);
+
+    std::vector<Slot>     m_slots;
+    std::vector<uint8_t>  m_records;    // slot i at i * m_recordSize
+    std::vector<uint32_t> m_dirty;      // one bit per slot
+    size_t                m_recordSize;
+    bool                  m_valid;      // false: every slot is built on the next Sync
+    Stats                 m_stats;
+};
@@ -0,0 +1,219 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/mapmanager/BlipStore.cpp
+ *****************************************************************************/
+
+#include "BlipStore.h"
+#include <algorithm>
+
+static const uint32_t MAX_SLOTS = 0xFFFF;
+static const uint16_t NO_SLOT = 0xFFFF;
+
+static inline uint32_t HandleSlot(BlipHandle handle) { return handle & 0xFFFF; }
+static inline uint16_t HandleGeneration(BlipHandle handle) { return (uint16_t)(handle >> 16); }
+
+BlipStore::BlipStore()
+    : m_removedCount(0)
+    , m_firstRemoved(0)
+    , m_version(0)
+{
+}
+
+BlipHandle BlipStore::Add(const Blip& blip)
+{
+    uint16_t slot;
+    if (!m_freeSlots.empty())
+    {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    }
+    else
+    {
+        if (m_slotIndex.size() >= MAX_SLOTS)
+            return 0;
+        slot = (uint16_t)m_slotIndex.size();
+        m_slotIndex.push_back(-1);
+        m_slotGeneration.push_back(1);
+    }
+
+    const int index = GetCount();
+    m_x.push_back(0.0f);
+    m_y.push_back(0.0f);
+    m_z.push_back(0.0f);
+    m_icon.push_back(0);
+    m_size.push_back(0.0f);
+    m_color.push_back(0);
+    m_flags.push_back(0);
+    m_liveSlot.push_back(slot);
+    m_slotIndex[slot] = index;
+    Write(index, blip);
+    m_grid.Insert(slot, blip.position.x, blip.position.y);
+    return ((BlipHandle)m_slotGeneration[slot] << 16) | slot;
+}
+
+bool BlipStore::Set(BlipHandle handle, const Blip& blip)
+{
+    const int index = GetIndex(handle);
+    if (index < 0)
+        return false;
+    Write(index, blip);
+    m_grid.Move(HandleSlot(handle), blip.position.x, blip.position.y);
+    return true;
+}
+
+bool BlipStore::SetPosition(BlipHandle handle, const D3DXVECTOR3& position)
+{
+    const int index = GetIndex(handle);
+    if (index < 0)
+        return false;
+    m_x[index] = position.x;
+    m_y[index] = position.y;
+    m_z[index] = position.z;
+    m_grid.Move(HandleSlot(handle), position.x, position.y);
+    ++m_version;
+    return true;
+}
+
+bool BlipStore::Remove(BlipHandle handle)
+{
+    const int index = GetIndex(handle);
+    if (index < 0)
+        return false;
+
+    const uint32_t slot = HandleSlot(handle);
+    m_slotIndex[slot] = -1;
+    // Generation 0 would make handle 0 valid
+    if (++m_slotGeneration[slot] == 0)
+        m_slotGeneration[slot] = 1;
+    m_freeSlots.push_back((uint16_t)slot);
+    m_grid.Remove(slot);
+
+    // Tombstone: the gap is closed by Compact, once for all removals of an update
+    m_flags[index] = 0;
+    m_liveSlot[index] = NO_SLOT;
+    if (m_removedCount == 0 || index < m_firstRemoved)
+        m_firstRemoved = index;
+    ++m_removedCount;
+    ++m_version;
+    return true;
+}
+
+void BlipStore::Compact()
+{
+    if (m_removedCount == 0)
+        return;
+
+    const int count = GetCount();
+    int out = m_firstRemoved;
+    for (int i = m_firstRemoved; i < count; ++i)
+    {
+        const uint16_t slot = m_liveSlot[i];
+        if (slot == NO_SLOT)
+            continue;
+        m_x[out] = m_x[i];
+        m_y[out] = m_y[i];
+        m_z[out] = m_z[i];
+        m_icon[out] = m_icon[i];
+        m_size[out] = m_size[i];
+        m_color[out] = m_color[i];
+        m_flags[out] = m_flags[i];
+        m_liveSlot[out] = slot;
+        m_slotIndex[slot] = out;
+        ++out;
+    }
+    m_x.resize(out);
+    m_y.resize(out);
+    m_z.resize(out);
+    m_icon.resize(out);
+    m_size.resize(out);
+    m_color.resize(out);
+    m_flags.resize(out);
+    m_liveSlot.resize(out);
+    m_removedCount = 0;
+    ++m_version;
+}
+
+void BlipStore::Clear()
+{
+    for (uint16_t slot : m_liveSlot)
+    {
+        if (slot == NO_SLOT)
+            continue;
+        m_slotIndex[slot] = -1;
+        if (++m_slotGeneration[slot] == 0)
+            m_slotGeneration[slot] = 1;
+        m_freeSlots.push_back(slot);
+    }
+    m_x.clear();
+    m_y.clear();
+    m_z.clear();
+    m_icon.clear();
+    m_size.clear();
+    m_color.clear();
+    m_flags.clear();
+    m_liveSlot.clear();
+    m_removedCount = 0;
+    m_grid.Clear();
+    ++m_version;
+}
+
+bool BlipStore::IsValid(BlipHandle handle) const
+{
+    return GetIndex(handle) >= 0;
+}
+
+int BlipStore::GetIndex(BlipHandle handle) const
+{
+    const uint32_t slot = HandleSlot(handle);
+    if (slot >= m_slotIndex.size() || m_slotGeneration[slot] != HandleGeneration(handle))
+        return -1;
+    return m_slotIndex[slot];
+}
+
+Blip BlipStore::Get(int index) const
+{
+    Blip blip;
+    blip.position = D3DXVECTOR3(m_x[index], m_y[index], m_z[index]);
+    blip.iconId = m_icon[index];
+    blip.size = m_size[index];
+    blip.color = m_color[index];
+    blip.enabled = (m_flags[index] & FLAG_ENABLED) != 0;
+    blip.shortRange = (m_flags[index] & FLAG_SHORT_RANGE) != 0;
+    return blip;
+}
+
+void BlipStore::QueryRect(float minX, float minY, float maxX, float maxY, std::vector<int>& outIndices) const
+{
+    const size_t first = outIndices.size();
+    m_grid.Query(minX, minY, maxX, maxY, [&](uint16_t slot) {
+        const int index = m_slotIndex[slot];
+        if (m_x[index] >= minX && m_x[index] <= maxX && m_y[index] >= minY && m_y[index] <= maxY)
+            outIndices.push_back(index);
+    });
+    std::sort(outIndices.begin() + first, outIndices.end());
+}
+
+void BlipStore::QueryRadius(float x, float y, float radius, std::vector<int>& outIndices) const
+{
+    const size_t first = outIndices.size();
+    const float radiusSq = radius * radius;
+    m_grid.Query(x - radius, y - radius, x + radius, y + radius, [&](uint16_t slot) {
+        const int index = m_slotIndex[slot];
+        const float dx = m_x[index] - x, dy = m_y[index] - y;
+        if (dx * dx + dy * dy <= radiusSq)
+            outIndices.push_back(index);
+    });
+    std::sort(outIndices.begin() + first, outIndices.end());
+}
+
+void BlipStore::Write(int index, const Blip& blip)
+{
+    m_x[index] = blip.position.x;
+    m_y[index] = blip.position.y;
+    m_z[index] = blip.position.z;
+    m_icon[index] = blip.iconId;
+    m_size[index] = blip.size;
+    m_color[index] = blip.color;
+    m_flags[index] = (uint8_t)((blip.enabled ? FLAG_ENABLED : 0) | (blip.shortRange ? FLAG_SHORT_RANGE : 0));
+    ++m_version;
+}
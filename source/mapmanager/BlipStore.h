@@ -0,0 +1,82 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/mapmanager/BlipStore.h
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <d3d9.h>
+#include <d3dx9.h>
+#include "BlipTypes.h"
+#include "BlipGrid.h"
+
+// Blip handle: slot in the low 16 bits, generation of the slot in the high 16; 0 is never a valid handle
+typedef uint32_t BlipHandle;
+
+// Blips as structure-of-arrays columns over one range [0, GetCount()), so per-frame loops read only the fields
+// they test. Handles stay valid until their blip is removed. Remove leaves a tombstone (flags 0, so it is never
+// enabled) and Compact closes all the gaps in one pass, keeping the order, which is the draw order; the live
+// index of a blip only moves there. Call it once per update after the removals.
+// A BlipGrid follows every change, so area queries do not walk all blips.
+class BlipStore
+{
+public:
+    enum BlipFlags : uint8_t
+    {
+        FLAG_ENABLED     = 1 << 0,
+        FLAG_SHORT_RANGE = 1 << 1,
+    };
+
+    BlipStore();
+
+    BlipHandle Add(const Blip& blip);
+    bool       Set(BlipHandle handle, const Blip& blip);
+    bool       SetPosition(BlipHandle handle, const D3DXVECTOR3& position);
+    bool       Remove(BlipHandle handle);
+    // Drops the tombstones left by Remove
+    void       Compact();
+    void       Clear();
+
+    bool       IsValid(BlipHandle handle) const;
+    int        GetIndex(BlipHandle handle) const;   // live index, -1 for a stale handle
+    Blip       Get(int index) const;
+    // Live indices of the blips inside the rect / within radius of (x, y) (2D), appended in ascending order
+    void       QueryRect(float minX, float minY, float maxX, float maxY, std::vector<int>& outIndices) const;
+    void       QueryRadius(float x, float y, float radius, std::vector<int>& outIndices) const;
+    // Bumped by every change, for views built from the columns
+    uint32_t   GetVersion() const { return m_version; }
+
+    int            GetCount() const { return (int)m_x.size(); }    // tombstones included until Compact
+    int            GetRemovedCount() const { return m_removedCount; }
+    const float*   GetX() const { return m_x.data(); }
+    const float*   GetY() const { return m_y.data(); }
+    const float*   GetZ() const { return m_z.data(); }
+    const int*     GetIcon() const { return m_icon.data(); }
+    const float*   GetSize() const { return m_size.data(); }
+    const DWORD*   GetColor() const { return m_color.data(); }
+    const uint8_t* GetFlags() const { return m_flags.data(); }
+
+private:
+    void Write(int index, const Blip& blip);
+
+    // Live columns
+    std::vector<float>    m_x;
+    std::vector<float>    m_y;
+    std::vector<float>    m_z;
+    std::vector<int>      m_icon;
+    std::vector<float>    m_size;
+    std::vector<DWORD>    m_color;
+    std::vector<uint8_t>  m_flags;
+    std::vector<uint16_t> m_liveSlot;       // slot of each live index, NO_SLOT for a tombstone
+    int                   m_removedCount;   // tombstones
+    int                   m_firstRemoved;   // lowest tombstone index, Compact starts there
+
+    // Slots
+    std::vector<int>      m_slotIndex;      // live index, -1 when free
+    std::vector<uint16_t> m_slotGeneration;
+    std::vector<uint16_t> m_freeSlots;
+    BlipGrid              m_grid;
+    uint32_t              m_version;
+};
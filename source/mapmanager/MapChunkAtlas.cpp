@@ -0,0 +1,223 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/mapmanager/MapChunkAtlas.cpp
+ *****************************************************************************/
+
+#include "MapChunkAtlas.h"
+#include "ChunkMipChain.h"
+#include <algorithm>
+#include <cstring>
+
+// slot = page * SLOT_PAGE_STRIDE + cell
+static const int SLOT_PAGE_STRIDE = 0x10000;
+
+static D3DFORMAT ToD3DFormat(ChunkFormat format)
+{
+    if (format == CHUNK_FORMAT_DXT1)
+        return D3DFMT_DXT1;
+    if (format == CHUNK_FORMAT_DXT5)
+        return D3DFMT_DXT5;
+    return D3DFMT_A8R8G8B8;
+}
+
+MapChunkAtlas::MapChunkAtlas(LPDIRECT3DDEVICE9 pDevice)
+    : m_pDevice(pDevice)
+    , m_capacity(0)
+    , m_cellSize(0)
+    , m_levels(0)
+    , m_usedCells(0)
+{
+}
+
+MapChunkAtlas::~MapChunkAtlas()
+{
+    Release();
+}
+
+void MapChunkAtlas::Reset(int capacity)
+{
+    Release();
+    m_capacity = (capacity > 0) ? capacity : 0;
+}
+
+void MapChunkAtlas::Release()
+{
+    for (auto& page : m_pages)
+        if (page.texture)
+            page.texture->Release();
+    m_pages.clear();
+    m_cellSize = 0;
+    m_levels = 0;
+    m_usedCells = 0;
+}
+
+int MapChunkAtlas::CreatePage(ChunkFormat format)
+{
+    D3DCAPS9 caps;
+    if (FAILED(m_pDevice->GetDeviceCaps(&caps)))
+        return -1;
+
+    const int maxSize = (std::min)((int)(std::min)(caps.MaxTextureWidth, caps.MaxTextureHeight), MAX_PAGE_SIZE);
+    const int maxPerRow = maxSize / m_cellSize;
+    if (maxPerRow <= 0)
+        return -1;
+
+    // Square page for the cells still expected; later pages only take the overflow
+    const int wanted = (std::max)(m_capacity - m_usedCells, 1);
+    int perRow = 1;
+    while (perRow * perRow < wanted && perRow < maxPerRow)
+        ++perRow;
+    int size = perRow * m_cellSize;
+
+    // Mipmapped textures must be a power of two on such devices; spare cells fill the rounding
+    if (caps.TextureCaps & D3DPTEXTURECAPS_POW2)
+    {
+        int pow2 = 1;
+        while (pow2 < size)
+            pow2 <<= 1;
+        while (pow2 > maxSize)
+            pow2 >>= 1;
+        size = pow2;
+        perRow = size / m_cellSize;
+        if (perRow <= 0)
+            return -1;
+    }
+
+    Page page = {};
+    page.format = format;
+    page.size = size;
+    page.cellsPerRow = perRow;
+    HRESULT hr = m_pDevice->CreateTexture((UINT)size, (UINT)size, (UINT)m_levels, 0, ToD3DFormat(format), D3DPOOL_MANAGED, &page.texture, nullptr);
+    if (FAILED(hr) || !page.texture)
+        return -1;
+
+    // Cell 0 first
+    for (int cell = perRow * perRow - 1; cell >= 0; --cell)
+        page.freeCells.push_back(cell);
+    m_pages.push_back(std::move(page));
+    return (int)m_pages.size() - 1;
+}
+
+bool MapChunkAtlas::CopyCell(const Page& page, int cell, const uint8_t* data, int pitch, ChunkFormat format)
+{
+    const int x = (cell % page.cellsPerRow) * m_cellSize;
+    const int y = (cell / page.cellsPerRow) * m_cellSize;
+    for (int level = 0; level < m_levels; ++level)
+    {
+        // Block aligned for DXT: Insert checks that every level of a cell is a multiple of 4 texels
+        RECT rect = { x >> level, y >> level, (x + m_cellSize) >> level, (y + m_cellSize) >> level };
+        size_t rowBytes = ChunkMipChain::LevelRowBytes(m_cellSize, level, format);
+        int rows = ChunkMipChain::LevelRows(m_cellSize, level, format);
+        size_t srcPitch = (level == 0) ? (size_t)pitch : rowBytes;
+        const uint8_t* src = data + ChunkMipChain::LevelOffset(m_cellSize, m_cellSize, level, format);
+
+        D3DLOCKED_RECT locked;
+        if (FAILED(page.texture->LockRect(level, &locked, &rect, 0)))
+            return false;
+        for (int row = 0; row < rows; row++)
+            memcpy((uint8_t*)locked.pBits + row * locked.Pitch, src + (size_t)row * srcPitch, rowBytes);
+        page.texture->UnlockRect(level);
+    }
+    return true;
+}
+
+int MapChunkAtlas::Insert(const uint8_t* data, int cellSize, int pitch, int levels, ChunkFormat format)
+{
+    if (!m_pDevice || !data || cellSize <= 0 || levels <= 0)
+        return -1;
+
+    if (m_cellSize == 0)
+    {
+        // Every level must keep whole texels at the cell origins
+        if (((cellSize >> (levels - 1)) << (levels - 1)) != cellSize)
+            return -1;
+        m_cellSize = cellSize;
+        m_levels = levels;
+    }
+    if (cellSize != m_cellSize || levels < m_levels)
+        return -1;
+    if (format != CHUNK_FORMAT_BGRA8 && ((m_cellSize >> (m_levels - 1)) & 3) != 0)
+        return -1;
+
+    int pageIndex = -1;
+    for (int i = 0; i < (int)m_pages.size() && pageIndex < 0; ++i)
+        if (m_pages[i].format == format && !m_pages[i].freeCells.empty())
+            pageIndex = i;
+    if (pageIndex < 0 && (int)m_pages.size() < MAX_PAGES)
+        pageIndex = CreatePage(format);
+    if (pageIndex < 0)
+        return -1;
+
+    Page& page = m_pages[pageIndex];
+    int cell = page.freeCells.back();
+    if (!CopyCell(page, cell, data, pitch, format))
+        return -1;
+    page.freeCells.pop_back();
+    ++m_usedCells;
+    return pageIndex * SLOT_PAGE_STRIDE + cell;
+}
+
+void MapChunkAtlas::Free(int slot)
+{
+    int pageIndex = slot / SLOT_PAGE_STRIDE;
+    if (slot < 0 || pageIndex >= (int)m_pages.size())
+        return;
+    m_pages[pageIndex].freeCells.push_back(slot % SLOT_PAGE_STRIDE);
+    --m_usedCells;
+}
+
+bool MapChunkAtlas::MatchesCell(int slot, const uint8_t* data, int pitch) const
+{
+    int pageIndex = slot / SLOT_PAGE_STRIDE;
+    if (slot < 0 || pageIndex >= (int)m_pages.size() || !data)
+        return false;
+
+    const Page& page = m_pages[pageIndex];
+    const int cell = slot % SLOT_PAGE_STRIDE;
+    const int x = (cell % page.cellsPerRow) * m_cellSize;
+    const int y = (cell / page.cellsPerRow) * m_cellSize;
+    RECT rect = { x, y, x + m_cellSize, y + m_cellSize };
+    size_t rowBytes = ChunkMipChain::LevelRowBytes(m_cellSize, 0, page.format);
+    int rows = ChunkMipChain::LevelRows(m_cellSize, 0, page.format);
+
+    // Managed pages: a read-only lock reads the system memory copy, nothing goes back to the GPU
+    D3DLOCKED_RECT locked;
+    if (FAILED(page.texture->LockRect(0, &locked, &rect, D3DLOCK_READONLY)))
+        return false;
+    bool same = true;
+    for (int row = 0; row < rows && same; row++)
+        same = memcmp((const uint8_t*)locked.pBits + row * locked.Pitch, data + (size_t)row * pitch, rowBytes) == 0;
+    page.texture->UnlockRect(0);
+    return same;
+}
+
+LPDIRECT3DTEXTURE9 MapChunkAtlas::GetTexture(int slot) const
+{
+    int pageIndex = slot / SLOT_PAGE_STRIDE;
+    if (slot < 0 || pageIndex >= (int)m_pages.size())
+        return nullptr;
+    return m_pages[pageIndex].texture;
+}
+
+D3DXVECTOR4 MapChunkAtlas::GetRegion(int slot, int gutter) const
+{
+    int pageIndex = slot / SLOT_PAGE_STRIDE;
+    if (slot < 0 || pageIndex >= (int)m_pages.size())
+        return D3DXVECTOR4(0.0f, 0.0f, 1.0f, 1.0f);
+
+    const Page& page = m_pages[pageIndex];
+    const int cell = slot % SLOT_PAGE_STRIDE;
+    const float x = (float)((cell % page.cellsPerRow) * m_cellSize);
+    const float y = (float)((cell / page.cellsPerRow) * m_cellSize);
+    const float size = (float)page.size;
+    return D3DXVECTOR4((x + gutter) / size, (y + gutter) / size,
+                       (x + m_cellSize - gutter) / size, (y + m_cellSize - gutter) / size);
+}
+
+size_t MapChunkAtlas::GetBytes() const
+{
+    size_t bytes = 0;
+    for (const auto& page : m_pages)
+        bytes += ChunkMipChain::ChainSize(page.size, page.size, m_levels, page.format);
+    return bytes;
+}
@@ -0,0 +1,64 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/mapmanager/MapChunkAtlas.h
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <d3d9.h>
+#include <d3dx9.h>
+#include "ChunkTypes.h"
+
+// Map tiles packed into a few large textures so the whole map layer draws in one batch per page.
+// Cells are square tiles with replicated edge gutters (ChunkMipChain::BuildCell); pages hold one format each.
+// Main thread only.
+class MapChunkAtlas
+{
+public:
+    static const int MAX_PAGES = 4;
+    static const int MAX_PAGE_SIZE = 4096;
+
+    MapChunkAtlas(LPDIRECT3DDEVICE9 pDevice);
+    ~MapChunkAtlas();
+
+    // capacity: cells resident at once; pages are sized for it when created (on the first Insert of their format)
+    void   Reset(int capacity);
+    void   Release();
+
+    // Copies a cell chain into a free cell of a page with the same format. -1 when the cell cannot go into
+    // the atlas (other size than the first cell, fewer levels, pages full); the caller keeps its own texture then.
+    int    Insert(const uint8_t* data, int cellSize, int pitch, int levels, ChunkFormat format);
+    void   Free(int slot);
+    // Level 0 of the cell in the slot equals the given cell (tightly packed rows from pitch)
+    bool   MatchesCell(int slot, const uint8_t* data, int pitch) const;
+
+    LPDIRECT3DTEXTURE9 GetTexture(int slot) const;
+    // Tile area of the cell without its gutter: (u0, v0, u1, v1)
+    D3DXVECTOR4        GetRegion(int slot, int gutter) const;
+    int                GetPageCount() const { return (int)m_pages.size(); }
+    int                GetUsedCells() const { return m_usedCells; }
+    size_t             GetBytes() const;
+
+private:
+    struct Page
+    {
+        LPDIRECT3DTEXTURE9 texture;
+        ChunkFormat        format;
+        int                size;
+        int                cellsPerRow;
+        std::vector<int>   freeCells;
+    };
+
+    int  CreatePage(ChunkFormat format);
+    bool CopyCell(const Page& page, int cell, const uint8_t* data, int pitch, ChunkFormat format);
+
+    LPDIRECT3DDEVICE9   m_pDevice;
+    std::vector<Page>   m_pages;
+    int                 m_capacity;
+    int                 m_cellSize;     // from the first Insert
+    int                 m_levels;
+    int                 m_usedCells;
+};
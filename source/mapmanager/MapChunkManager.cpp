@@ -4,10 +4,16 @@
  *****************************************************************************/
 
 #include "MapChunkManager.h"
+#include "Config.h"
+#include "PixelConvert.h"
+#include "RadarProjection.h"
 #include "plugin.h"
 #include "CFileLoader.h"
 #include "RenderWare.h"
 #include <d3dx9.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
 #include <cstring>
 #include <cmath>
 
@@ -16,12 +22,10 @@ const float MapChunkManager::MAP_HEIGHT    = 6000.0f;
 const float MapChunkManager::MAP_CENTER_X  = 3000.0f;
 const float MapChunkManager::MAP_CENTER_Y  = -3000.0f;
 
-static LPDIRECT3DTEXTURE9 RwTextureToD3D9(LPDIRECT3DDEVICE9 pDevice, RwTexture* rwTex)
+// Main thread: RwImageSetFromRaster locks the source D3D surface, so it cannot move to a worker
+static RwImage* ReadRasterToImage(RwTexture* rwTex)
 {
-    if (!pDevice || !rwTex)
-        return nullptr;
-
-    RwRaster* raster = RwTextureGetRaster(rwTex);
+    RwRaster* raster = rwTex ? RwTextureGetRaster(rwTex) : nullptr;
     if (!raster)
         return nullptr;
 
@@ -46,50 +50,82 @@ static LPDIRECT3DTEXTURE9 RwTextureToD3D9(LPDIRECT3DDEVICE9 pDevice, RwTexture*
         RwImageDestroy(img);
         return nullptr;
     }
+    return img;
+}
 
-    LPDIRECT3DTEXTURE9 d3dTex = nullptr;
-    HRESULT hr = pDevice->CreateTexture((UINT)w, (UINT)h, 1, 0, D3DFMT_A8R8G8B8, D3DPOOL_MANAGED, &d3dTex, nullptr);
-    if (FAILED(hr) || !d3dTex)
-    {
-        RwImageFreePixels(img);
-        RwImageDestroy(img);
-        return nullptr;
-    }
-
-    D3DLOCKED_RECT locked;
-    if (SUCCEEDED(d3dTex->LockRect(0, &locked, nullptr, 0)))
-    {
-        RwUInt8* src = RwImageGetPixels(img);
-        int srcStride = RwImageGetStride(img);
-        int dstStride = locked.Pitch;
-        for (int y = 0; y < h; y++)
-        {
-            RwUInt8* rowSrc = src + y * srcStride;
-            RwUInt8* rowDst = (RwUInt8*)locked.pBits + y * dstStride;
-            for (int x = 0; x < w; x++)
-            {
-                int off = x * 4;
-                rowDst[off + 0] = rowSrc[off + 2];
-                rowDst[off + 1] = rowSrc[off + 1];
-                rowDst[off + 2] = rowSrc[off + 0];
-                rowDst[off + 3] = rowSrc[off + 3];
-            }
-        }
-        d3dTex->UnlockRect(0);
-    }
-
+static void DestroyImage(RwImage* img)
+{
     RwImageFreePixels(img);
     RwImageDestroy(img);
-    return d3dTex;
+}
+
+// Worker thread: RGBA image rows -> BGRA chunk pixels
+static bool ConvertImageToChunkPixels(const RwUInt8* src, int srcStride, int w, int h, ChunkPixels& out)
+{
+    if (!src || w <= 0 || h <= 0)
+        return false;
+
+    out.width = w;
+    out.height = h;
+    out.pitch = w * 4;
+    out.levels = 1;
+    out.format = CHUNK_FORMAT_BGRA8;
+    out.gutter = 0;
+    out.data.resize((size_t)out.pitch * h);
+    PixelConvert::SwapRedBlue(src, srcStride, out.data.data(), out.pitch, w, h);
+    return true;
+}
+
+// Worker thread: mips, pyramid contribution, atlas cell, compression and cache record of a decoded base chunk
+static bool FinishBaseChunk(ChunkPixels& out, int index, bool backgroundOnly, ChunkPyramid* pyramid, ChunkCacheWriter* cacheWriter,
+                            bool compress, int gutter)
+{
+    if (!ChunkPipeline::FinishBaseChunk(out, index, *pyramid, *cacheWriter, compress, gutter))
+        return false;
+    if (backgroundOnly)
+        out = {};
+    return true;
 }
 
 MapChunkManager::MapChunkManager(LPDIRECT3DDEVICE9 pDevice)
     : m_pDevice(pDevice)
     , m_pMapTxd(nullptr)
+    , m_gridSize(0)
+    , m_chunkCount(0)
+    , m_mapLeft(0.0f)
+    , m_mapTop(0.0f)
+    , m_mapWidth(0.0f)
+    , m_mapHeight(0.0f)
     , m_initialized(false)
+    , m_streaming(false)
+    , m_budgetChunks(MAP_CHUNKS_COUNT)
+    , m_budgetBytes(0)
+    , m_frame(1)
+    , m_queuedCount(0)
+    , m_residentCount(0)
+    , m_pendingCount(0)
+    , m_evictedCount(0)
+    , m_prefetchSeconds(0.0f)
+    , m_uploadsPerFrame(4)
+    , m_uploadBudgetMicros(2000)
+    , m_compress(false)
+    , m_baseTileTexels(0)
+    , m_lodLevel(0)
+    , m_cacheMapFailures(0)
+    , m_initMicros(0)
+    , m_tiles(pDevice)
+    , m_useAtlas(false)
+    , m_backgroundColor(0)
+    , m_skippedDraws(0)
+    , m_virtualPaging(false)
+    , m_hotReload(false)
+    , m_nativeTiles(0)
+    , m_imageTiles(0)
+    , m_imageBytes(0)
+    , m_nativeMicros(0)
+    , m_imageMicros(0)
 {
-    ZeroMemory(m_chunks, sizeof(m_chunks));
-    ZeroMemory(m_loaded, sizeof(m_loaded));
+    ZeroMemory(m_coarseReady, sizeof(m_coarseReady));
 }
 
 MapChunkManager::~MapChunkManager()
@@ -102,38 +138,821 @@ bool MapChunkManager::Initialize()
     if (m_initialized)
         return true;
 
-    const char* path = PLUGIN_PATH("radar/map.txd");
-    m_pMapTxd = CFileLoader::LoadTexDictionary(path);
-    if (!m_pMapTxd)
-        return false;
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point start = Clock::now();
+
+    // PLUGIN_PATH returns a shared buffer
+    m_txdPath = PLUGIN_PATH("radar/map.txd");
+    m_cachePath = PLUGIN_PATH("radar/map.cache");
+
+    // MapPack replaces the TXD layout with its manifest; map.txd stays the fallback
+    m_gridSize = MAP_CHUNKS_PER_ROW;
+    m_mapLeft = MAP_CENTER_X - MAP_WIDTH * 0.5f;
+    m_mapTop = MAP_CENTER_Y + MAP_HEIGHT * 0.5f;
+    m_mapWidth = MAP_WIDTH;
+    m_mapHeight = MAP_HEIGHT;
+    const std::string packName = RadarConfig::GetMapPack();
+    if (!packName.empty() && m_pack.Open(PLUGIN_PATH(("radar/" + packName).c_str())))
+    {
+        const MapPackSource::Manifest& manifest = m_pack.GetManifest();
+        m_gridSize = manifest.grid;
+        m_mapLeft = manifest.left + 3000.0f;    // world -> radar space
+        m_mapTop = manifest.top - 3000.0f;
+        m_mapWidth = manifest.width;
+        m_mapHeight = manifest.height;
+        m_cachePath = m_pack.GetDirectory() + "map.cache";
+    }
+
+    m_chunkCount = m_gridSize * m_gridSize;
+    const size_t chunkCount = (size_t)m_chunkCount;
+    m_chunks.assign(chunkCount, nullptr);
+    m_chunkTileIds.assign(chunkCount, -1);
+    m_chunkRegions.assign(chunkCount, D3DXVECTOR4(0.0f, 0.0f, 1.0f, 1.0f));
+    m_loaded.assign(chunkCount, false);
+    m_lastDrawnFrame.assign(chunkCount, 0);
+    m_requestFrame.assign(chunkCount, 0);
+    m_requestDistSq.assign(chunkCount, 0.0f);
+    m_unavailable.assign(chunkCount, false);
+    m_queued.assign(chunkCount, false);
+    m_prefetch.Reset(m_chunkCount);
+
+    m_compress = RadarConfig::GetMapCompression();
+    m_useAtlas = RadarConfig::GetMapAtlas();
+    const int gutter = m_useAtlas ? ATLAS_GUTTER : 0;
+    m_pyramid.Reset(m_gridSize, RadarConfig::GetMapLod() ? ChunkPyramid::MAX_LEVELS : 0);
+    m_pyramid.SetCompression(m_compress);
+    m_pyramid.SetCellOutput(gutter, ATLAS_LEVELS);
+    m_backgroundFeed.Reset(m_chunkCount);
+
+    // Valid cache: the TXD / pack images are never read, tiles are copied from the mapping into LockRect memory
+    ChunkCache::Key cacheKey = {};
+    const bool useCache = RadarConfig::GetMapCache() && ComputeCacheKey(gutter, cacheKey);
+    if (!useCache || !m_cache.Open(m_cachePath.c_str(), cacheKey))
+    {
+        // Pack tiles are decoded from their files on demand, nothing to load up front
+        if (!m_pack.IsOpen() && !OpenTxdSource())
+            return false;
+
+        if (useCache)
+            BeginCacheWrite(cacheKey);
+    }
+
+    m_streaming = RadarConfig::GetMapStreaming();
+    m_budgetChunks = (std::min)(RadarConfig::GetMapBudgetTiles(), m_chunkCount);
+    m_budgetBytes = (size_t)RadarConfig::GetMapBudgetMB() * 1024 * 1024;
+    m_uploadsPerFrame = RadarConfig::GetMapUploadsPerFrame();
+    m_uploadBudgetMicros = (unsigned int)RadarConfig::GetMapUploadBudgetUs();
+    m_evictedCount = 0;
+    m_pendingCount = 0;
+    m_prefetchSeconds = (float)RadarConfig::GetMapPrefetchMs() / 1000.0f;
+    m_cacheMapFailures = 0;
+    // Without coarse levels every tile would be level 0: same as the plain grid walk
+    m_virtualPaging = RadarConfig::GetMapVirtual() && m_pyramid.GetLevelCount() > 0;
+    m_pageWalker.SetLayout(m_gridSize, m_mapLeft, m_mapTop, m_mapWidth, m_mapHeight);
+    m_nativeTiles = 0;
+    m_imageTiles = 0;
+    m_imageBytes = 0;
+    m_nativeMicros = 0;
+    m_imageMicros = 0;
+
+    int coarseTiles = 0;
+    for (int level = 1; level <= ChunkPyramid::MAX_LEVELS; ++level)
+    {
+        int tiles = (level <= m_pyramid.GetLevelCount()) ? m_pyramid.GetTileCount(level) : 0;
+        m_coarseChunks[level].assign((size_t)tiles, nullptr);
+        m_coarseTileIds[level].assign((size_t)tiles, -1);
+        m_coarseRegions[level].assign((size_t)tiles, D3DXVECTOR4(0.0f, 0.0f, 1.0f, 1.0f));
+        m_coarseFinished[level].assign((size_t)tiles, false);
+        m_coarseReady[level] = 0;
+        coarseTiles += tiles;
+    }
+
+    // Room for every resident tile; streaming can overshoot the budget for one frame, those tiles get own textures
+    m_tiles.Reset(m_useAtlas ? (m_streaming ? m_budgetChunks : m_chunkCount) + coarseTiles : 0);
+
+    // Without workers RequestChunk converts inline
+    m_decodeQueue.Start();
 
     m_initialized = true;
-    LoadAllChunks();
+    if (m_cache.IsOpen())
+        LoadCoarseFromCache();
+    if (!m_streaming)
+        LoadAllChunks();
+
+    m_hotReload = RadarConfig::GetHotReload();
+    if (m_hotReload)
+        m_reload.Watch(ComputeSourceStamp());
+
+    m_initMicros = (unsigned int)std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
     return true;
 }
 
+// Packs are keyed by file stamps: hashing every image would read the whole pack on each start
+bool MapChunkManager::ComputeCacheKey(int gutter, ChunkCache::Key& outKey) const
+{
+    if (m_pack.IsOpen())
+    {
+        uint64_t packSize, packMtime, packHash;
+        if (!m_pack.ComputeStamp(packSize, packMtime, packHash))
+            return false;
+        ChunkCache::MakeKey(packSize, packMtime, packHash, m_pyramid.GetLevelCount(), m_compress, gutter, outKey);
+        return true;
+    }
+    return ChunkCache::ComputeKey(m_txdPath.c_str(), m_pyramid.GetLevelCount(), m_compress, gutter, outKey);
+}
+
+void MapChunkManager::BeginCacheWrite(const ChunkCache::Key& key)
+{
+    int levelTiles[ChunkPyramid::MAX_LEVELS + 1] = { m_chunkCount };
+    for (int level = 1; level <= m_pyramid.GetLevelCount(); ++level)
+        levelTiles[level] = m_pyramid.GetTileCount(level);
+    m_cacheWriter.Begin(m_cachePath.c_str(), key, levelTiles, m_pyramid.GetLevelCount() + 1);
+}
+
 void MapChunkManager::LoadAllChunks()
 {
     if (!m_initialized && !Initialize())
         return;
 
-    for (int index = 0; index < MAP_CHUNKS_COUNT; ++index)
+    if (m_cache.IsOpen())
     {
-        if (m_chunks[index])
-            continue;
+        for (int index = 0; index < m_chunkCount; ++index)
+            if (!m_loaded[index] && !m_unavailable[index])
+                RequestChunk(index);
+        return;
+    }
+
+    // Synchronous, but in batches so workers convert in parallel without holding every RwImage / decoded image at once
+    for (int first = 0; first < m_chunkCount; first += LOAD_ALL_BATCH)
+    {
+        int last = (first + LOAD_ALL_BATCH < m_chunkCount) ? first + LOAD_ALL_BATCH : m_chunkCount;
+        for (int index = first; index < last; ++index)
+        {
+            if (!m_loaded[index] && !m_queued[index] && !m_unavailable[index])
+                RequestChunk(index);
+        }
+        m_decodeQueue.WaitIdle();
+        m_decodeQueue.DrainUploads(*this, 0, 0);
+    }
+    // Every chunk has contributed by now
+    UploadCoarseTiles(0);
+}
+
+bool MapChunkManager::RequestChunk(int index)
+{
+    if (m_loaded[index] || m_queued[index])
+        return false;
+    if (m_cache.IsOpen())
+        return UploadFromCache(index);
+    if (!HasSource())
+        return false;
+
+    m_queued[index] = true;
+    ++m_queuedCount;
+    if (!SubmitDecode(index))
+    {
+        OnDecodeFailed(index);
+        return false;
+    }
+    return m_queued[index] || m_loaded[index];
+}
+
+// Reads the raster here and hands conversion, mips and the pyramid contribution to the workers.
+// Native TXD tiles and map packs are read and decoded on the worker as well. False if the raster is missing.
+bool MapChunkManager::SubmitDecode(int jobIndex)
+{
+    const int index = jobIndex & JOB_INDEX_MASK;
+    const bool backgroundOnly = (jobIndex & BACKGROUND_JOB_FLAG) != 0;
+    ChunkPyramid* pyramid = &m_pyramid;
+    ChunkCacheWriter* cacheWriter = &m_cacheWriter;
+    const bool compress = m_compress;
+    const int gutter = m_useAtlas ? ATLAS_GUTTER : 0;
 
+    if (m_pack.IsOpen())
+    {
+        // Only the tile being decoded is in memory; a missing or broken file fails like a missing raster
+        const MapPackSource* pack = &m_pack;
+        RunDecodeJob(jobIndex, [pack, index, backgroundOnly, pyramid, cacheWriter, compress, gutter](ChunkPixels& out) {
+            return pack->DecodeTile(index, out) && FinishBaseChunk(out, index, backgroundOnly, pyramid, cacheWriter, compress, gutter);
+        }, [] {});
+        return true;
+    }
+
+    char texName[32];
+    sprintf_s(texName, "radar%02d", index);
+
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point start = Clock::now();
+
+    // Native: the worker reads level 0 straight from the mapped TXD, nothing is copied or allocated here.
+    // The texture entry stays valid until the reader is reopened, which waits for idle workers.
+    const TxdNativeReader::Texture* native = m_txdNative.Find(texName);
+    if (native && TxdNativeReader::CanDecode(*native))
+    {
+        RunDecodeJob(jobIndex, [native, index, backgroundOnly, pyramid, cacheWriter, compress, gutter](ChunkPixels& out) {
+            return TxdNativeReader::Decode(*native, out) && FinishBaseChunk(out, index, backgroundOnly, pyramid, cacheWriter, compress, gutter);
+        }, [] {});
+        ++m_nativeTiles;
+        m_nativeMicros += (unsigned int)std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+        return true;
+    }
+
+    RwImage* img = m_pMapTxd ? ReadRasterToImage(RwTexDictionaryFindNamedTexture(m_pMapTxd, texName)) : nullptr;
+    if (!img)
+        return false;
+
+    const RwUInt8* src = RwImageGetPixels(img);
+    int srcStride = RwImageGetStride(img);
+    int w = RwImageGetWidth(img);
+    int h = RwImageGetHeight(img);
+    ++m_imageTiles;
+    m_imageBytes += (size_t)srcStride * h;
+    RunDecodeJob(jobIndex, [src, srcStride, w, h, index, backgroundOnly, pyramid, cacheWriter, compress, gutter](ChunkPixels& out) {
+        return ConvertImageToChunkPixels(src, srcStride, w, h, out) &&
+               FinishBaseChunk(out, index, backgroundOnly, pyramid, cacheWriter, compress, gutter);
+    }, [img] { DestroyImage(img); });
+    m_imageMicros += (unsigned int)std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+    return true;
+}
+
+void MapChunkManager::RunDecodeJob(int jobIndex, ChunkDecodeQueue::DecodeFunc decode, ChunkDecodeQueue::ReleaseFunc release)
+{
+    if (m_decodeQueue.Submit(jobIndex, decode, release))
+        return;
+
+    // No worker threads: convert and upload right here
+    ChunkPixels pixels = {};
+    if (!decode(pixels) || Upload(jobIndex, pixels) == CHUNK_FAILED)
+        OnDecodeFailed(jobIndex);
+    release();
+}
+
+bool MapChunkManager::OpenTxdSource()
+{
+    // Workers are stopped or idle here: no job still points into the old mapping.
+    // A mapped file cannot be overwritten, so HotReload keeps to RenderWare, which reads the TXD and lets go of it.
+    const bool native = RadarConfig::GetNativeTxd() && !RadarConfig::GetHotReload() && m_txdNative.Open(m_txdPath.c_str());
+    if (!native)
+        m_txdNative.Close();
+
+    // Palettized / 16-bit / DXT3 tiles have no native decoder: the RenderWare TXD is loaded for those
+    bool needTxd = !native;
+    for (int index = 0; index < MAP_CHUNKS_COUNT && !needTxd; ++index)
+    {
         char texName[32];
         sprintf_s(texName, "radar%02d", index);
+        const TxdNativeReader::Texture* texture = m_txdNative.Find(texName);
+        needTxd = texture && !TxdNativeReader::CanDecode(*texture);
+    }
+
+    RwTexDictionary* txd = needTxd ? CFileLoader::LoadTexDictionary(m_txdPath.c_str()) : nullptr;
+    if (needTxd && !txd && !native)
+        return false;
+    if (m_pMapTxd)
+        RwTexDictionaryDestroy(m_pMapTxd);
+    m_pMapTxd = txd;
+    return true;
+}
+
+// Decoded pixels as a tile view; every stage produces tightly packed chains
+static ChunkCache::Tile TileOf(const ChunkPixels& pixels)
+{
+    ChunkCache::Tile tile = {};
+    tile.width = pixels.width;
+    tile.height = pixels.height;
+    tile.levels = pixels.levels;
+    tile.format = pixels.format;
+    tile.gutter = pixels.gutter;
+    tile.hash = pixels.hash;
+    tile.solid = pixels.solid;
+    tile.solidColor = pixels.solidColor;
+    tile.data = pixels.data.data();
+    return tile;
+}
+
+ChunkUploadResult MapChunkManager::Upload(int index, const ChunkPixels& pixels)
+{
+    if (index & BACKGROUND_JOB_FLAG)
+    {
+        // Contributed on the worker, nothing to upload
+        m_backgroundFeed.OnJobDone();
+        return CHUNK_UPLOADED;
+    }
+    if (index & RELOAD_JOB_FLAG)
+        return ReplaceChunk(index & JOB_INDEX_MASK, pixels);
+    if (m_queued[index])
+    {
+        m_queued[index] = false;
+        --m_queuedCount;
+    }
+    // Already resident through another request, or left over from before a re-initialization
+    if (m_loaded[index] || !m_initialized)
+        return CHUNK_DROPPED;
+
+    LPDIRECT3DTEXTURE9 d3dTex = nullptr;
+    int tileId;
+    D3DXVECTOR4 region;
+    if (!m_tiles.Place(TileOf(pixels), MapTileTable::TILE_USER_CHUNK, d3dTex, tileId, region))
+        return CHUNK_FAILED;
+
+    MakeResident(index, d3dTex, tileId, region, pixels.width - 2 * pixels.gutter);
+    return CHUNK_UPLOADED;
+}
+
+bool MapChunkManager::UploadFromCache(int index)
+{
+    // The payload is mapped only while it is copied into LockRect memory
+    MappedView view;
+    ChunkCache::Tile tile;
+    if (!MapCachedTile(0, index, view, tile))
+    {
+        m_unavailable[index] = true;
+        return false;
+    }
+
+    LPDIRECT3DTEXTURE9 d3dTex = nullptr;
+    int tileId;
+    D3DXVECTOR4 region;
+    if (!m_tiles.Place(tile, MapTileTable::TILE_USER_CHUNK, d3dTex, tileId, region))
+    {
+        m_unavailable[index] = true;
+        return false;
+    }
+
+    MakeResident(index, d3dTex, tileId, region, tile.width - 2 * tile.gutter);
+    return true;
+}
+
+bool MapChunkManager::MapCachedTile(int level, int index, MappedView& view, ChunkCache::Tile& outTile)
+{
+    if (!m_cache.Find(level, index))
+        return false;
+    if (m_cache.Map(level, index, view, outTile))
+        return true;
+    // Address space exhausted or I/O error; shown in the debug overlay
+    ++m_cacheMapFailures;
+    return false;
+}
+
+void MapChunkManager::MakeResident(int index, LPDIRECT3DTEXTURE9 d3dTex, int tileId, const D3DXVECTOR4& region, int tileTexels)
+{
+    m_chunks[index] = d3dTex;
+    m_chunkTileIds[index] = tileId;
+    m_chunkRegions[index] = region;
+    m_prefetch.NoteResident(index);
+    m_loaded[index] = true;
+    m_lastDrawnFrame[index] = m_frame;  // fresh chunk must not be the first eviction candidate
+    ++m_residentCount;
+    if (m_baseTileTexels == 0)
+        m_baseTileTexels = tileTexels;
+}
+
+void MapChunkManager::LoadCoarseFromCache()
+{
+    for (int level = 1; level <= m_pyramid.GetLevelCount(); ++level)
+    {
+        for (int index = 0; index < (int)m_coarseChunks[level].size(); ++index)
+        {
+            // No entry: none of the merged chunks exist
+            if (m_cache.Find(level, index))
+            {
+                MappedView view;
+                ChunkCache::Tile tile;
+                if (!MapCachedTile(level, index, view, tile) ||
+                    !m_tiles.Place(tile, MapTileTable::TILE_USER_COARSE, m_coarseChunks[level][index], m_coarseTileIds[level][index], m_coarseRegions[level][index]))
+                    continue;
+                if (m_baseTileTexels == 0)
+                    m_baseTileTexels = tile.width - 2 * tile.gutter;
+            }
+            m_coarseFinished[level][index] = true;
+            ++m_coarseReady[level];
+        }
+    }
+}
+
+void MapChunkManager::OnDecodeFailed(int jobIndex)
+{
+    int index = jobIndex & JOB_INDEX_MASK;
+    if (jobIndex & BACKGROUND_JOB_FLAG)
+    {
+        m_backgroundFeed.OnJobDone();
+    }
+    else if (jobIndex & RELOAD_JOB_FLAG)
+    {
+        // Gone from the new source
+        m_reload.OnJobDone();
+        if (m_loaded[index])
+        {
+            UnloadChunk(index);
+            m_reload.NoteChecked(true);
+        }
+    }
+    else if (m_queued[index])
+    {
+        m_queued[index] = false;
+        --m_queuedCount;
+    }
+    m_unavailable[index] = true;
+    // Both no-ops if the chunk was recorded before failing
+    m_pyramid.MarkMissing(index);
+    m_cacheWriter.Skip(0, index);
+}
+
+void MapChunkManager::FeedBackgroundDecode()
+{
+    // One raster per frame; nothing once the tiles came from the cache
+    if (!HasSource())
+        return;
+    m_backgroundFeed.Feed(m_cache, m_pyramid, m_cacheWriter, m_queued, m_unavailable, [this](int index) {
+        if (SubmitDecode(index | BACKGROUND_JOB_FLAG))
+            return true;
+        OnDecodeFailed(index | BACKGROUND_JOB_FLAG);
+        return false;
+    });
+}
+
+void MapChunkManager::UploadCoarseTiles(int maxUploads)
+{
+    int level, index;
+    ChunkPixels pixels;
+    for (int uploads = 0; maxUploads <= 0 || uploads < maxUploads; ++uploads)
+    {
+        if (!ChunkPipeline::PopCoarseTile(m_pyramid, m_cacheWriter, level, index, pixels))
+            break;
+        if (level < 1 || level > ChunkPyramid::MAX_LEVELS || index < 0 || index >= (int)m_coarseChunks[level].size())
+            continue;
+        m_reload.OnCoarseRebuilt();
+
+        LPDIRECT3DTEXTURE9 tex = nullptr;
+        int tileId = -1;
+        D3DXVECTOR4 region(0.0f, 0.0f, 1.0f, 1.0f);
+        if (!pixels.data.empty())
+        {
+            // A rebuilt tile is placed before the old one is released, so unchanged content is not uploaded again
+            if (!m_tiles.Place(TileOf(pixels), MapTileTable::TILE_USER_COARSE, tex, tileId, region))
+                continue;  // level never completes (or keeps the old tile), drawing falls back to finer tiles
+            if (m_baseTileTexels == 0)
+                m_baseTileTexels = pixels.width - 2 * pixels.gutter;
+        }
+
+        int& oldTileId = m_coarseTileIds[level][index];
+        if (m_coarseFinished[level][index])
+            m_reload.NoteChecked(tileId != oldTileId);
+        m_tiles.ReleaseTile(m_coarseChunks[level][index], oldTileId, MapTileTable::TILE_USER_COARSE);
+        m_coarseChunks[level][index] = tex;
+        m_coarseTileIds[level][index] = tileId;
+        m_coarseRegions[level][index] = region;
+        if (!m_coarseFinished[level][index])
+        {
+            m_coarseFinished[level][index] = true;
+            ++m_coarseReady[level];
+        }
+    }
+}
+
+uint64_t MapChunkManager::ComputeSourceStamp() const
+{
+    if (m_pack.IsOpen())
+    {
+        uint64_t packSize, packMtime, packHash;
+        return m_pack.ComputeStamp(packSize, packMtime, packHash) ? packHash : 0;
+    }
+    return FileWatch::GetFileStamp(m_txdPath.c_str());
+}
+
+void MapChunkManager::PollHotReload()
+{
+    // One reload at a time; a change made meanwhile is picked up once it has finished
+    if (m_hotReload && m_reload.PollChanged([this] { return ComputeSourceStamp(); }))
+        ReloadSource();
+}
+
+void MapChunkManager::ReloadSource()
+{
+    m_reload.Start();
+
+    // Workers must be done with the old rasters / files before the source is swapped
+    m_decodeQueue.WaitIdle();
+    m_decodeQueue.DrainUploads(*this, 0, 0);
+
+    if (m_pack.IsOpen())
+    {
+        const MapPackSource::Manifest previous = m_pack.GetManifest();
+        const std::string directory = m_pack.GetDirectory();
+        const bool reopened = m_pack.Open(directory.c_str());
+        const MapPackSource::Manifest& manifest = m_pack.GetManifest();
+        if (!reopened || manifest.grid != previous.grid || manifest.left != previous.left || manifest.top != previous.top ||
+            manifest.width != previous.width || manifest.height != previous.height)
+        {
+            // New layout, or an unreadable manifest that falls back to map.txd: nothing can be kept
+            Cleanup();
+            Initialize();
+            m_reload.FinishAll(m_chunkCount);
+            return;
+        }
+    }
+    else
+    {
+        if (!OpenTxdSource())
+            return;  // deleted or unreadable: resident tiles stay until the next change
+    }
+
+    // The mapped cache and everything recorded or merged so far describe the old source
+    m_cache.Close();
+    m_cacheWriter.Abort();
+    m_pyramid.Reset(m_gridSize, m_pyramid.GetLevelCount());
+    ChunkCache::Key cacheKey = {};
+    if (RadarConfig::GetMapCache() && ComputeCacheKey(m_useAtlas ? ATLAS_GUTTER : 0, cacheKey))
+        BeginCacheWrite(cacheKey);
+    m_backgroundFeed.Rewind();
+    m_unavailable.assign(m_unavailable.size(), false);
+
+    // Streaming: only resident chunks, the others load from the new source when needed.
+    // Otherwise every chunk, so the pyramid and the cache see the whole map again.
+    std::vector<int> chunks;
+    for (int index = m_chunkCount - 1; index >= 0; --index)
+        if (m_loaded[index] || !m_streaming)
+            chunks.push_back(index);
+    int coarseTiles = 0;
+    for (int level = 1; level <= m_pyramid.GetLevelCount(); ++level)
+        coarseTiles += (int)m_coarseChunks[level].size();
+    m_reload.Begin(std::move(chunks), coarseTiles);
+}
+
+void MapChunkManager::FeedReloadJobs()
+{
+    int submitted = 0;
+    int index;
+    while (submitted < MAX_REQUESTS_PER_FRAME && m_reload.PopChunk(index))
+    {
+        if (!m_loaded[index])
+        {
+            // Evicted since the reload, or missing in the old source
+            if (!m_streaming && RequestChunk(index))
+                ++submitted;
+            continue;
+        }
+
+        m_reload.OnJobSubmitted();
+        ++submitted;
+        if (!SubmitDecode(index | RELOAD_JOB_FLAG))
+            OnDecodeFailed(index | RELOAD_JOB_FLAG);
+    }
+
+    // Reload time and changed tiles go to StreamingStats
+    m_reload.Finish();
+}
+
+ChunkUploadResult MapChunkManager::ReplaceChunk(int index, const ChunkPixels& pixels)
+{
+    m_reload.OnJobDone();
+    // Evicted while decoding: loads from the new source when it is needed again
+    if (!m_loaded[index])
+        return CHUNK_DROPPED;
+
+    // Placed before the old tile is released: unchanged content finds itself and costs no upload
+    LPDIRECT3DTEXTURE9 d3dTex = nullptr;
+    int tileId;
+    D3DXVECTOR4 region;
+    if (!m_tiles.Place(TileOf(pixels), MapTileTable::TILE_USER_CHUNK, d3dTex, tileId, region))
+        return CHUNK_DROPPED;  // the old tile stays
+    m_reload.NoteChecked(tileId != m_chunkTileIds[index]);
+    m_tiles.ReleaseTile(m_chunks[index], m_chunkTileIds[index], MapTileTable::TILE_USER_CHUNK);
+    m_chunks[index] = d3dTex;
+    m_chunkTileIds[index] = tileId;
+    m_chunkRegions[index] = region;
+    return CHUNK_UPLOADED;
+}
+
+bool MapChunkManager::IsLevelComplete(int level) const
+{
+    return level >= 1 && level <= m_pyramid.GetLevelCount() && m_coarseReady[level] >= (int)m_coarseChunks[level].size();
+}
+
+ChunkPage MapChunkManager::GetPage(int level, int index) const
+{
+    LPDIRECT3DTEXTURE9 texture = (level > 0) ? m_coarseChunks[level][index] : (m_loaded[index] ? m_chunks[index] : nullptr);
+    const D3DXVECTOR4& region = (level > 0) ? m_coarseRegions[level][index] : m_chunkRegions[index];
+    const ChunkPage page = { (ChunkTextureId)texture, { region.x, region.y, region.z, region.w },
+                             (level > 0) ? m_coarseTileIds[level][index] : m_chunkTileIds[index] };
+    return page;
+}
+
+void MapChunkManager::OnChunkMissing(int index, float distSq)
+{
+    // Without streaming every chunk is on its way already
+    if (m_streaming)
+        NoteMissingChunk(index, distSq);
+}
+
+void MapChunkManager::BeginChunkWalk()
+{
+    // Same colour RenderTarget clears to; can change at runtime
+    int r, g, b, a;
+    RadarConfig::GetBackgroundColor(r, g, b, a);
+    m_backgroundColor = (uint32_t)D3DCOLOR_ARGB(a, r, g, b);
+    m_skippedDraws = 0;
+}
+
+void MapChunkManager::NoteMissingChunk(int index, float distSq)
+{
+    m_prefetch.NoteMissing(index);
+    if (m_queued[index] || m_requestFrame[index] == m_frame)
+        return;
+    m_requestFrame[index] = m_frame;
+    m_requestDistSq[index] = distSq;
+    m_requests.push_back(index);
+}
 
-        RwTexture* rwTex = RwTexDictionaryFindNamedTexture(m_pMapTxd, texName);
-        if (!rwTex)
+void MapChunkManager::NoteDrawnChunk(int index)
+{
+    m_prefetch.NoteDrawn(index);
+    m_lastDrawnFrame[index] = m_frame;
+}
+
+int MapChunkManager::SelectLodLevel(float cameraZ, const FrustumParams* footprintParams) const
+{
+    if (!footprintParams || footprintParams->screenWidth <= 0.0f || m_baseTileTexels <= 0 || cameraZ <= 0.0f)
+        return 0;
+
+    // Tile texels per render target pixel at full resolution; level L halves the texel density L times
+    float groundWidth = 2.0f * cameraZ * tanf(footprintParams->fov * 0.5f);
+    float texelWorldSize = (m_mapWidth / m_gridSize) / (float)m_baseTileTexels;
+    float texelsPerPixel = (groundWidth / footprintParams->screenWidth) / texelWorldSize;
+
+    int level = 0;
+    while (level < m_pyramid.GetLevelCount() && texelsPerPixel >= (float)(2 << level))
+        ++level;
+
+    // Only levels with every tile uploaded
+    while (level > 0 && m_coarseReady[level] < (int)m_coarseChunks[level].size())
+        --level;
+    return level;
+}
+
+void MapChunkManager::UnloadChunk(int index)
+{
+    if (!m_loaded[index])
+        return;
+
+    m_tiles.ReleaseTile(m_chunks[index], m_chunkTileIds[index], MapTileTable::TILE_USER_CHUNK);
+    m_prefetch.NoteUnloaded(index);
+    m_loaded[index] = false;
+    --m_residentCount;
+}
+
+bool MapChunkManager::IsOverBudget() const
+{
+    if (m_residentCount > m_budgetChunks)
+        return true;
+    // A tile shared with other resident chunks frees nothing when one of them is evicted
+    return m_budgetBytes != 0 && m_tiles.GetBytes(MapTileTable::TILE_USER_CHUNK) > m_budgetBytes;
+}
+
+void MapChunkManager::EvictOverBudget()
+{
+    while (IsOverBudget())
+    {
+        // Least recently drawn; chunks drawn this frame stay even if that overshoots the budget
+        int victim = -1;
+        for (int i = 0; i < m_chunkCount; ++i)
+        {
+            if (!m_loaded[i] || m_lastDrawnFrame[i] == m_frame)
+                continue;
+            if (victim < 0 || m_lastDrawnFrame[i] < m_lastDrawnFrame[victim])
+                victim = i;
+        }
+        if (victim < 0)
+            break;
+
+        UnloadChunk(victim);
+        ++m_evictedCount;
+    }
+}
+
+void MapChunkManager::UpdateStreaming()
+{
+    if (m_initialized)
+    {
+        if (m_streaming && !m_requests.empty())
+        {
+            const float* distSq = m_requestDistSq.data();
+            std::sort(m_requests.begin(), m_requests.end(), [distSq](int a, int b) {
+                return distSq[a] < distSq[b] || (distSq[a] == distSq[b] && a < b);
+            });
+            int requested = 0;
+            for (int index : m_requests)
+            {
+                if (requested >= MAX_REQUESTS_PER_FRAME)
+                    break;
+                if (!m_loaded[index] && !m_queued[index] && !m_unavailable[index] && RequestChunk(index))
+                    ++requested;
+            }
+        }
+
+        if (m_streaming)
+            FeedBackgroundDecode();
+        if (m_reload.IsReloading())
+            FeedReloadJobs();
+
+        m_decodeQueue.DrainUploads(*this, m_uploadsPerFrame, m_uploadBudgetMicros);
+        UploadCoarseTiles(COARSE_UPLOADS_PER_FRAME);
+
+        if (m_streaming)
+        {
+            m_pendingCount = m_queuedCount;
+            for (int index : m_requests)
+                if (!m_loaded[index] && !m_queued[index] && !m_unavailable[index])
+                    ++m_pendingCount;
+
+            EvictOverBudget();
+        }
+
+        // Last: a new pack layout re-initializes, this frame's requests index the old grid
+        PollHotReload();
+    }
+    m_requests.clear();
+    ++m_frame;
+}
+
+void MapChunkManager::PrefetchAlongPath(const ChunkPrefetch::Motion& motion, float visibleRadius)
+{
+    // Coarse levels are resident as a whole; full tiles are only streamed in streaming mode
+    if (!m_initialized || !m_streaming || m_lodLevel > 0)
+        return;
+    ChunkPrefetch::Sample samples[ChunkPrefetch::STEPS];
+    const int sampleCount = ChunkPrefetch::PredictPath(motion, m_prefetchSeconds, samples);
+
+    const float chunkWorldWidth  = m_mapWidth / m_gridSize;
+    const float chunkWorldHeight = m_mapHeight / m_gridSize;
+    const float mapLeft = m_mapLeft;
+    const float mapTop  = m_mapTop;
+    const float halfW = chunkWorldWidth * 0.5f;
+    const float halfH = chunkWorldHeight * 0.5f;
+    const float radius = visibleRadius + sqrtf(halfW * halfW + halfH * halfH);
+    const float radiusSq = radius * radius;
+
+    // Same radius test as ForEachChunkInRadius around each predicted camera position, no frustum (the view turns)
+    for (int step = 1; step <= sampleCount; ++step)
+    {
+        float x = samples[step - 1].x;
+        float y = samples[step - 1].y;
+
+        int rowMin, rowMax, colMin, colMax;
+        if (!GetChunkRange(x, y, radius, rowMin, rowMax, colMin, colMax))
             continue;
 
-        m_chunks[index] = RwTextureToD3D9(m_pDevice, rwTex);
-        m_loaded[index] = (m_chunks[index] != nullptr);
+        for (int row = rowMin; row <= rowMax; ++row)
+        {
+            for (int col = colMin; col <= colMax; ++col)
+            {
+                int index = row * m_gridSize + col;
+                if (m_loaded[index] || m_queued[index] || m_unavailable[index] || m_requestFrame[index] == m_frame)
+                    continue;
+
+                float distSq = MathUtils::DistanceSq2D(mapLeft + (col + 0.5f) * chunkWorldWidth, mapTop - (row + 0.5f) * chunkWorldHeight, x, y);
+                if (distSq > radiusSq)
+                    continue;
+
+                // Visible requests have distSq <= radiusSq and go first; earlier steps before later ones
+                m_requestFrame[index] = m_frame;
+                m_requestDistSq[index] = radiusSq * (float)step + distSq;
+                m_prefetch.NoteRequested(index);
+                m_requests.push_back(index);
+            }
+        }
     }
 }
 
+void MapChunkManager::BuildFootprint(const FrustumParams& params, RadarFootprint& outFootprint)
+{
+    float aspect = params.projectionAspect;
+    if (aspect <= 0.0f)
+        aspect = (params.screenWidth > 0.0f) ? (params.screenHeight / params.screenWidth) : 1.0f;
+
+    RadarProjection projection;
+    projection.Build(*params.cameraPos, *params.cameraRot, params.fov, params.nearPlane, params.farPlane, params.screenWidth, params.screenHeight, aspect);
+    // One pixel of margin: a tile touching the render target edge stays in
+    RadarGeometry::BuildFootprint(projection, 0.0f, 1.0f, outFootprint);
+}
+
+ChunkGrid MapChunkManager::GetGrid(int gridSize) const
+{
+    const ChunkGrid grid = { m_mapLeft, m_mapTop, m_mapWidth, m_mapHeight, (gridSize > 0) ? gridSize : m_gridSize };
+    return grid;
+}
+
+bool MapChunkManager::GetChunkRange(float x, float y, float radius, int& rowMin, int& rowMax, int& colMin, int& colMax, int gridSize) const
+{
+    return GetGrid(gridSize).GetRangeInRadius(x, y, radius, rowMin, rowMax, colMin, colMax);
+}
+
+bool MapChunkManager::GetChunkRangeRect(float minX, float minY, float maxX, float maxY, int& rowMin, int& rowMax, int& colMin, int& colMax,
+                                        int gridSize) const
+{
+    return GetGrid(gridSize).GetRangeInRect(minX, minY, maxX, maxY, rowMin, rowMax, colMin, colMax);
+}
+
 float MapChunkManager::ComputeVisibleRadius(float cameraZ, float fov, float offsetY, bool isInAircraft)
 {
     float visibleRadius = cameraZ * tanf(fov * 0.5f) * 2.0f;
@@ -146,43 +965,119 @@ float MapChunkManager::ComputeVisibleRadius(float cameraZ, float fov, float offs
 
 void MapChunkManager::Cleanup()
 {
-    for (int i = 0; i < MAP_CHUNKS_COUNT; ++i)
+    // Joins the workers and frees the RwImages of jobs that never reached Upload
+    m_decodeQueue.Stop();
+    // An unfinished cache is discarded and rebuilt next time
+    m_cacheWriter.Abort();
+    m_cache.Close();
+
+    for (int i = 0; i < m_chunkCount; ++i)
+        m_tiles.ReleaseTile(m_chunks[i], m_chunkTileIds[i], MapTileTable::TILE_USER_CHUNK);
+    m_chunks.clear();
+    m_chunkTileIds.clear();
+    m_chunkRegions.clear();
+    m_loaded.clear();
+    m_lastDrawnFrame.clear();
+    m_requestFrame.clear();
+    m_requestDistSq.clear();
+    m_unavailable.clear();
+    m_queued.clear();
+    m_prefetch.Clear();
+    m_gridSize = 0;
+    m_chunkCount = 0;
+    m_requests.clear();
+    m_residentCount = 0;
+    m_pendingCount = 0;
+    m_queuedCount = 0;
+    m_reload.Cancel();
+
+    for (int level = 1; level <= ChunkPyramid::MAX_LEVELS; ++level)
     {
-        if (m_chunks[i])
-        {
-            m_chunks[i]->Release();
-            m_chunks[i] = nullptr;
-        }
-        m_loaded[i] = false;
+        for (size_t i = 0; i < m_coarseChunks[level].size(); ++i)
+            m_tiles.ReleaseTile(m_coarseChunks[level][i], m_coarseTileIds[level][i], MapTileTable::TILE_USER_COARSE);
+        m_coarseChunks[level].clear();
+        m_coarseTileIds[level].clear();
+        m_coarseRegions[level].clear();
+        m_coarseFinished[level].clear();
+        m_coarseReady[level] = 0;
     }
+    m_tiles.Release();
+    m_pyramid.Reset(0, 0);
+    m_baseTileTexels = 0;
+    m_lodLevel = 0;
+    m_backgroundFeed.Reset(0);
 
     if (m_pMapTxd)
     {
         RwTexDictionaryDestroy(m_pMapTxd);
         m_pMapTxd = nullptr;
     }
+    m_txdNative.Close();
+    m_pack.Close();
     m_initialized = false;
 }
 
 LPDIRECT3DTEXTURE9 MapChunkManager::GetChunk(int index) const
 {
-    if (index < 0 || index >= MAP_CHUNKS_COUNT)
+    if (index < 0 || index >= m_chunkCount)
         return nullptr;
     return m_chunks[index];
 }
 
 bool MapChunkManager::IsChunkLoaded(int index) const
 {
-    if (index < 0 || index >= MAP_CHUNKS_COUNT)
+    if (index < 0 || index >= m_chunkCount)
         return false;
     return m_loaded[index];
 }
 
 int MapChunkManager::GetLoadedChunksCount() const
 {
-    int count = 0;
-    for (int i = 0; i < MAP_CHUNKS_COUNT; ++i)
-        if (m_loaded[i])
-            ++count;
-    return count;
+    return m_residentCount;
+}
+
+MapChunkManager::StreamingStats MapChunkManager::GetStreamingStats() const
+{
+    StreamingStats stats = {};
+    stats.resident = m_residentCount;
+    stats.pending = m_pendingCount;
+    stats.evicted = m_evictedCount;
+    stats.residentBytes = m_tiles.GetBytes(MapTileTable::TILE_USER_CHUNK);
+    stats.budgetBytes = m_streaming ? m_budgetBytes : 0;
+    stats.budgetChunks = m_streaming ? m_budgetChunks : m_chunkCount;
+    stats.lodLevel = m_lodLevel;
+    for (int level = 1; level <= ChunkPyramid::MAX_LEVELS; ++level)
+    {
+        stats.coarseReady += m_coarseReady[level];
+        stats.coarseTotal += (int)m_coarseChunks[level].size();
+    }
+    stats.coarseBytes = m_tiles.GetBytes(MapTileTable::TILE_USER_COARSE);
+    stats.cacheHit = m_cache.IsOpen();
+    stats.cacheBuilding = m_cacheWriter.IsActive();
+    stats.cacheMapFailures = m_cacheMapFailures;
+    stats.initMicros = m_initMicros;
+    stats.atlasPages = m_tiles.GetAtlas().GetPageCount();
+    stats.atlasCells = m_tiles.GetAtlas().GetUsedCells();
+    stats.atlasBytes = m_tiles.GetAtlas().GetBytes();
+    stats.prefetchHits = m_prefetch.GetHits();
+    stats.prefetchLate = m_prefetch.GetLate();
+    stats.prefetchUnused = m_prefetch.GetUnused();
+    stats.pagesDrawn = m_pageWalker.GetPagesDrawn();
+    stats.pageMisses = m_pageWalker.GetPageMisses();
+    const MapTileTable::Stats tileStats = m_tiles.GetStats();
+    stats.sharedTiles = tileStats.sharedTiles;
+    stats.solidTiles = tileStats.solidTiles;
+    stats.dedupSavedBytes = tileStats.dedupSavedBytes;
+    stats.skippedDraws = m_skippedDraws;
+    stats.reloads = m_reload.GetReloadCount();
+    stats.reloading = m_reload.IsReloading();
+    stats.reloadTouched = m_reload.GetTouched();
+    stats.reloadChecked = m_reload.GetChecked();
+    stats.reloadMillis = m_reload.GetMillis();
+    stats.nativeTiles = m_nativeTiles;
+    stats.imageTiles = m_imageTiles;
+    stats.imageBytes = m_imageBytes;
+    stats.nativeMicros = m_nativeMicros;
+    stats.imageMicros = m_imageMicros;
+    return stats;
 }
@@ -5,21 +5,46 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cmath>
+#include <string>
+#include <vector>
 #include <d3d9.h>
 #include <d3dx9.h>
 #include "RenderWare.h"
 #include "MathUtils.h"
+#include "RadarGeometry.h"
+#include "ChunkDecodeQueue.h"
+#include "ChunkGrid.h"
+#include "ChunkPyramid.h"
+#include "ChunkCache.h"
+#include "ChunkBackgroundFeed.h"
+#include "ChunkPipeline.h"
+#include "ChunkPageWalker.h"
+#include "ChunkPrefetch.h"
+#include "ChunkReloadTracker.h"
+#include "MapTileTable.h"
+#include "MapPackSource.h"
+#include "TxdNativeReader.h"
 
-class MapChunkManager
+class MapChunkManager : private IChunkUploader, private IChunkPageSource
 {
 public:
+    // Layout of radar/map.txd; a MapPack manifest replaces grid and bounds (GetGridSize / GetChunkCount)
     static const int   MAP_CHUNKS_COUNT = 144;
     static const int   MAP_CHUNKS_PER_ROW = 12;
     static const float MAP_WIDTH;
     static const float MAP_HEIGHT;
     static const float MAP_CENTER_X;
     static const float MAP_CENTER_Y;
+    static const int   MAX_REQUESTS_PER_FRAME = 4;  // streaming: rasters handed to the decode workers per frame
+    static const int   LOAD_ALL_BATCH = 16;         // LoadAllChunks: chunks in flight at once
+    static const int   COARSE_UPLOADS_PER_FRAME = 2; // merged LOD tiles uploaded per frame
+    static const int   BACKGROUND_JOB_FLAG = 0x10000; // decode job index bit: feeds the LOD pyramid / tile cache only
+    static const int   RELOAD_JOB_FLAG = 0x20000;   // decode job index bit: HotReload, replaces a resident chunk
+    static const int   JOB_INDEX_MASK = 0xFFFF;
+    static const int   ATLAS_GUTTER = ChunkPipeline::ATLAS_GUTTER;
+    static const int   ATLAS_LEVELS = ChunkPipeline::ATLAS_LEVELS;
 
     struct FrustumParams
     {
@@ -33,6 +58,46 @@ public:
         float projectionAspect;
     };
 
+    struct StreamingStats
+    {
+        int    resident;        // chunks with a live D3D texture
+        int    pending;         // requested or decoding, not yet resident
+        int    evicted;         // total evictions since Initialize
+        size_t residentBytes;   // uploaded bytes of the tiles resident chunks show, a shared tile once
+        size_t budgetBytes;     // 0 = no MB limit
+        int    budgetChunks;
+        int    lodLevel;        // 0 = full tiles, 1 = 6x6 grid, 2 = 3x3 grid (last ForEachChunkInRadius)
+        int    coarseReady;     // merged tiles finished, all levels
+        int    coarseTotal;
+        size_t coarseBytes;     // same for coarse tiles; not counted against the streaming budget
+        bool   cacheHit;        // tiles come from the mapped tile cache, TXD not loaded
+        bool   cacheBuilding;   // tile cache is being written this session
+        int    cacheMapFailures;    // cached tiles left out because their payload could not be mapped
+        unsigned int initMicros;    // last Initialize, including LoadAllChunks
+        int    atlasPages;      // MapAtlas textures; tiles that did not fit keep their own texture
+        int    atlasCells;
+        size_t atlasBytes;
+        int    prefetchHits;    // prefetched tiles that were resident when first drawn
+        int    prefetchLate;    // tiles needed on screen before they were resident
+        int    prefetchUnused;  // prefetched tiles evicted without being drawn
+        int    pagesDrawn;      // MapVirtual: tiles of any level drawn last frame
+        int    pageMisses;      // MapVirtual: tiles drawn from a coarser level because the needed one was not resident
+        int    sharedTiles;     // tiles showing the texture of an identical tile
+        int    solidTiles;      // single colour tiles drawn from a 1x1 texture
+        size_t dedupSavedBytes; // not uploaded thanks to sharing and solid tiles
+        int    skippedDraws;    // solid tiles in the background colour left out last frame
+        int    reloads;         // HotReload: source reloads this session
+        bool   reloading;       // HotReload: resident tiles are still being compared with the new source
+        int    reloadTouched;   // tiles of the last reload whose content changed and was uploaded (or removed)
+        int    reloadChecked;   // tiles of the last reload compared with the new source
+        unsigned int reloadMillis;  // last finished reload, from the change being noticed to the last tile
+        int    nativeTiles;     // NativeTxd: map.txd tiles decoded straight from the mapped file
+        int    imageTiles;      // map.txd tiles read through an RwImage copy
+        size_t imageBytes;      // RwImage pixel memory allocated for them (native tiles allocate none)
+        unsigned int nativeMicros;  // main thread time spent handing those tiles to the workers, total
+        unsigned int imageMicros;
+    };
+
     MapChunkManager(LPDIRECT3DDEVICE9 pDevice);
     ~MapChunkManager();
 
@@ -40,97 +105,332 @@ public:
     void LoadAllChunks();
     void Cleanup();
 
-    // Distance culling (radius) + Frustum culling. Pass frustumParams=nullptr to skip frustum culling.
+    // Streaming mode: hands requested chunks (nearest first) to the decode workers and evicts
+    // least-recently-drawn chunks over budget. Both modes: uploads decoded chunks within the
+    // per-frame budget and, with HotReload, picks up changes of map.txd / the tile pack.
+    // Call once per frame after ForEachChunkInRadius.
+    void UpdateStreaming();
+
+    // Streaming mode: requests tiles around the camera positions predicted from the player motion within the
+    // MapPrefetchMs look-ahead (ChunkPrefetch::PredictPath), after the visible ones. Call after
+    // ForEachChunkInRadius, before UpdateStreaming.
+    void PrefetchAlongPath(const ChunkPrefetch::Motion& motion, float visibleRadius);
+
+    // Distance culling (radius) + footprint culling (tile rect vs the camera's ground footprint).
+    // Pass footprintParams=nullptr to skip it.
+    // Only the grid rows/columns covering the radius are visited, in row-major (index) order.
+    // Streaming mode: marks visited chunks as drawn and requests the missing ones.
+    // When the camera is high enough, a complete coarse level is drawn instead (index is then in that level's grid).
+    // MapVirtual: the level is chosen per tile from its distance to the camera instead, see ForEachVirtualPage.
+    // callback(index, pos, rot, size, texture, region): region = (u0, v0, u1, v1) of the tile inside texture,
+    // an atlas page shared by many tiles with MapAtlas.
     template<typename F>
     void ForEachChunkInRadius(const D3DXVECTOR3& cameraPos, float visibleRadius,
-                             const FrustumParams* frustumParams, F&& callback) const;
+                             const FrustumParams* footprintParams, F&& callback);
 
+    int                GetGridSize() const { return m_gridSize; }
+    int                GetChunkCount() const { return m_chunkCount; }
     LPDIRECT3DTEXTURE9 GetChunk(int index) const;
     bool               IsChunkLoaded(int index) const;
     int                GetLoadedChunksCount() const;
+    bool               IsStreaming() const { return m_streaming; }
+    bool               IsVirtualPaging() const { return m_virtualPaging; }
+    StreamingStats     GetStreamingStats() const;
+    ChunkDecodeQueue::Stats GetDecodeStats() const { return m_decodeQueue.GetStats(); }
 
     static float ComputeVisibleRadius(float cameraZ, float fov, float offsetY, bool isInAircraft);
+    // Ground footprint (z = 0, the tile plane) of the camera FrustumParams describes
+    static void  BuildFootprint(const FrustumParams& params, RadarFootprint& outFootprint);
+    // Tile grid over the map, gridSize x gridSize (0 = base grid)
+    ChunkGrid    GetGrid(int gridSize = 0) const;
+    // Inclusive row/column range of tiles (gridSize x gridSize over the map, 0 = base grid) whose centers can lie within radius of (x, y); false if empty
+    bool         GetChunkRange(float x, float y, float radius, int& rowMin, int& rowMax, int& colMin, int& colMax,
+                               int gridSize = 0) const;
+    // Same for tiles overlapping the rectangle
+    bool         GetChunkRangeRect(float minX, float minY, float maxX, float maxY, int& rowMin, int& rowMax, int& colMin, int& colMax,
+                                   int gridSize = 0) const;
 
 private:
+    // MapVirtual: the tiles the camera footprint needs, each at the pyramid level its texels need (ChunkPageWalker)
+    template<typename F>
+    void ForEachVirtualPage(const D3DXVECTOR3& cameraPos, float visibleRadius, const FrustumParams& footprintParams, F& callback);
+
+    // Level 0 tile needed this frame: not resident (queued for UpdateStreaming, nearest first) or drawn
+    void NoteMissingChunk(int index, float distSq);
+    void NoteDrawnChunk(int index);
+
+    bool HasSource() const { return m_pMapTxd || m_txdNative.IsOpen() || m_pack.IsOpen(); }
+    // map.txd: the mapped natives, plus the RenderWare TXD only if some tile needs it (or NativeTxd is off)
+    bool OpenTxdSource();
+    bool ComputeCacheKey(int gutter, ChunkCache::Key& outKey) const;
+    void BeginCacheWrite(const ChunkCache::Key& key);
+    bool RequestChunk(int index);
+    bool SubmitDecode(int jobIndex);
+    // Hands the job to the workers, or runs and uploads it right away without worker threads
+    void RunDecodeJob(int jobIndex, ChunkDecodeQueue::DecodeFunc decode, ChunkDecodeQueue::ReleaseFunc release);
+    void FeedBackgroundDecode();
+    bool UploadFromCache(int index);
+    bool MapCachedTile(int level, int index, MappedView& view, ChunkCache::Tile& outTile);
+    void LoadCoarseFromCache();
+    void MakeResident(int index, LPDIRECT3DTEXTURE9 d3dTex, int slot, const D3DXVECTOR4& region, int tileTexels);
+    void UploadCoarseTiles(int maxUploads);
+
+    // HotReload: the TXD / pack is swapped once workers are idle, resident chunks are decoded again from it a few
+    // per frame and only tiles whose content hash changed are uploaded; the rest keep their placed tile.
+    uint64_t ComputeSourceStamp() const;
+    void PollHotReload();
+    void ReloadSource();
+    void FeedReloadJobs();
+    ChunkUploadResult ReplaceChunk(int index, const ChunkPixels& pixels);
+    int  SelectLodLevel(float cameraZ, const FrustumParams* footprintParams) const;
+    // Solid tile in the render target clear colour: nothing to draw
+    bool IsBackgroundTile(int tileId) const override { return m_tiles.IsSolidColor(tileId, m_backgroundColor); }
+    void BeginChunkWalk();
+    void UnloadChunk(int index);
+    void EvictOverBudget();
+    bool IsOverBudget() const;
+
+    // IChunkUploader (main thread, from DrainUploads)
+    ChunkUploadResult Upload(int index, const ChunkPixels& pixels) override;
+    void OnDecodeFailed(int index) override;
+
+    // IChunkPageSource (ForEachVirtualPage)
+    bool      IsLevelComplete(int level) const override;
+    ChunkPage GetPage(int level, int index) const override;
+    bool      IsChunkUnavailable(int index) const override { return m_unavailable[index]; }
+    void      OnChunkMissing(int index, float distSq) override;
+    void      OnChunkDrawn(int index) override { NoteDrawnChunk(index); }
+
     LPDIRECT3DDEVICE9   m_pDevice;
     RwTexDictionary*    m_pMapTxd;
-    LPDIRECT3DTEXTURE9  m_chunks[MAP_CHUNKS_COUNT];
-    bool                m_loaded[MAP_CHUNKS_COUNT];
+    TxdNativeReader     m_txdNative;        // NativeTxd: tiles decoded from the mapped TXD without RwImage
+    std::string         m_txdPath;
+    std::string         m_cachePath;
+    MapPackSource       m_pack;             // MapPack: tiles decoded from image files instead of the TXD
+    int                 m_gridSize;         // chunks per row and column
+    int                 m_chunkCount;
+    float               m_mapLeft;          // radar space bounds of the grid
+    float               m_mapTop;
+    float               m_mapWidth;
+    float               m_mapHeight;
+    // Per chunk, sized in Initialize
+    std::vector<LPDIRECT3DTEXTURE9> m_chunks;
+    std::vector<int>    m_chunkTileIds;     // m_tiles entry, -1 = not resident
+    std::vector<D3DXVECTOR4> m_chunkRegions;
+    std::vector<bool>   m_loaded;
     bool                m_initialized;
+
+    // Streaming state
+    bool                m_streaming;
+    int                 m_budgetChunks;
+    size_t              m_budgetBytes;
+    unsigned int        m_frame;
+    std::vector<unsigned int> m_lastDrawnFrame;
+    std::vector<unsigned int> m_requestFrame;
+    std::vector<float>  m_requestDistSq;
+    std::vector<bool>   m_unavailable;      // missing in the source or failed conversion
+    std::vector<bool>   m_queued;           // handed to the decode queue, not uploaded yet
+    std::vector<int>    m_requests;                       // chunks requested during the current frame
+    int                 m_queuedCount;
+    int                 m_residentCount;
+    int                 m_pendingCount;     // requests left unserved by the last UpdateStreaming
+    int                 m_evictedCount;
+
+    // Predictive prefetch and its hit / late metric
+    float               m_prefetchSeconds;
+    ChunkPrefetch       m_prefetch;
+
+    ChunkDecodeQueue    m_decodeQueue;
+    int                 m_uploadsPerFrame;
+    unsigned int        m_uploadBudgetMicros;
+    bool                m_compress;         // DXT1 / DXT5 tiles instead of A8R8G8B8
+
+    // LOD pyramid: merged tiles built from the mips of decoded chunks
+    ChunkPyramid        m_pyramid;
+    std::vector<LPDIRECT3DTEXTURE9> m_coarseChunks[ChunkPyramid::MAX_LEVELS + 1];
+    std::vector<int>    m_coarseTileIds[ChunkPyramid::MAX_LEVELS + 1];
+    std::vector<D3DXVECTOR4> m_coarseRegions[ChunkPyramid::MAX_LEVELS + 1];
+    std::vector<bool>   m_coarseFinished[ChunkPyramid::MAX_LEVELS + 1];
+    int                 m_coarseReady[ChunkPyramid::MAX_LEVELS + 1];  // finished tiles (empty ones included)
+    int                 m_baseTileTexels;   // width of a full tile, from the first upload
+    int                 m_lodLevel;
+    ChunkBackgroundFeed m_backgroundFeed;       // streaming: chunks still to be fed into the pyramid / cache
+
+    // Pre-converted tiles: read when valid for the current TXD / pack, otherwise rebuilt during this session
+    ChunkCache          m_cache;
+    ChunkCacheWriter    m_cacheWriter;
+    int                 m_cacheMapFailures; // tile payloads whose view could not be mapped
+    unsigned int        m_initMicros;
+
+    // Textures / atlas cells by content, referenced by every chunk and coarse tile showing them.
+    // MapAtlas: tiles padded into cells of a few shared pages, drawn as one batch per page
+    MapTileTable        m_tiles;
+    bool                m_useAtlas;
+    uint32_t            m_backgroundColor;  // A8R8G8B8 render target clear colour, read per walk
+    int                 m_skippedDraws;     // background coloured tiles left out by the last walk
+
+    // MapVirtual: pyramid levels as page tables, the level of each tile picked from the camera footprint
+    bool                m_virtualPaging;
+    ChunkPageWalker     m_pageWalker;
+
+    // HotReload
+    bool                m_hotReload;
+    ChunkReloadTracker  m_reload;
+
+    // Ingestion cost of map.txd tiles by path, since Initialize
+    int                 m_nativeTiles;
+    int                 m_imageTiles;
+    size_t              m_imageBytes;
+    unsigned int        m_nativeMicros;
+    unsigned int        m_imageMicros;
 };
 
 template<typename F>
 void MapChunkManager::ForEachChunkInRadius(const D3DXVECTOR3& cameraPos, float visibleRadius,
-                                          const FrustumParams* frustumParams, F&& callback) const
+                                          const FrustumParams* footprintParams, F&& callback)
 {
-    const float chunkWorldWidth  = MAP_WIDTH / MAP_CHUNKS_PER_ROW;
-    const float chunkWorldHeight = MAP_HEIGHT / MAP_CHUNKS_PER_ROW;
+    BeginChunkWalk();
+    if (m_virtualPaging && footprintParams && footprintParams->screenWidth > 0.0f && m_baseTileTexels > 0)
+    {
+        ForEachVirtualPage(cameraPos, visibleRadius, *footprintParams, callback);
+        return;
+    }
+
+    const int lodLevel = SelectLodLevel(cameraPos.z, footprintParams);
+    const int gridSize = m_gridSize >> lodLevel;
+    m_lodLevel = lodLevel;
+    if (gridSize <= 0)
+        return;
+
+    const float chunkWorldWidth  = m_mapWidth / gridSize;
+    const float chunkWorldHeight = m_mapHeight / gridSize;
     const float halfW = chunkWorldWidth * 0.5f;
     const float halfH = chunkWorldHeight * 0.5f;
-    const float mapLeft = MAP_CENTER_X - MAP_WIDTH * 0.5f;
-    const float mapTop  = MAP_CENTER_Y + MAP_HEIGHT * 0.5f;
+    const float mapLeft = m_mapLeft;
+    const float mapTop  = m_mapTop;
 
     // Chunk visible if ANY part is in view: expand radius so chunk rect can intersect
     const float chunkHalfDiag = sqrtf(halfW * halfW + halfH * halfH);
     const float effectiveRadius = visibleRadius + chunkHalfDiag;
     const float radiusSq = effectiveRadius * effectiveRadius;
 
-    for (int index = 0; index < MAP_CHUNKS_COUNT; ++index)
+    RadarFootprint footprint;
+    const bool useFootprint = footprintParams && footprintParams->cameraPos && footprintParams->cameraRot;
+    if (useFootprint)
+        BuildFootprint(*footprintParams, footprint);
+
+    int rowMin, rowMax, colMin, colMax;
+    if (!GetChunkRange(cameraPos.x, cameraPos.y, effectiveRadius, rowMin, rowMax, colMin, colMax, gridSize))
+        return;
+    // Walk only the rows / columns under the footprint's bounds
+    if (useFootprint && footprint.valid)
     {
-        if (!m_loaded[index])
-            continue;
+        int fpRowMin, fpRowMax, fpColMin, fpColMax;
+        if (!GetChunkRangeRect(footprint.minX, footprint.minY, footprint.maxX, footprint.maxY, fpRowMin, fpRowMax, fpColMin, fpColMax, gridSize) ||
+            footprint.count == 0)
+            return;
+        rowMin = (std::max)(rowMin, fpRowMin);
+        rowMax = (std::min)(rowMax, fpRowMax);
+        colMin = (std::max)(colMin, fpColMin);
+        colMax = (std::min)(colMax, fpColMax);
+    }
 
-        LPDIRECT3DTEXTURE9 chunkTex = m_chunks[index];
-        if (!chunkTex)
-            continue;
+    for (int row = rowMin; row <= rowMax; ++row)
+    {
+        for (int col = colMin; col <= colMax; ++col)
+        {
+            int index = row * gridSize + col;
+            if (lodLevel == 0 && !m_loaded[index] && !m_streaming)
+                continue;
 
-        int row = index / MAP_CHUNKS_PER_ROW;
-        int col = index % MAP_CHUNKS_PER_ROW;
-        float chunkCenterX = mapLeft + (col + 0.5f) * chunkWorldWidth;
-        float chunkCenterY = mapTop - (row + 0.5f) * chunkWorldHeight;
+            float chunkCenterX = mapLeft + (col + 0.5f) * chunkWorldWidth;
+            float chunkCenterY = mapTop - (row + 0.5f) * chunkWorldHeight;
 
-        // Distance: chunk rect intersects visibility circle (center within effectiveRadius)
-        if (MathUtils::DistanceSq2D(chunkCenterX, chunkCenterY, cameraPos.x, cameraPos.y) > radiusSq)
-            continue;
+            // Distance: chunk rect intersects visibility circle (center within effectiveRadius)
+            float distSq = MathUtils::DistanceSq2D(chunkCenterX, chunkCenterY, cameraPos.x, cameraPos.y);
+            if (distSq > radiusSq)
+                continue;
 
-        // Frustum: at least one of 4 corners must project into view (even a tiny piece visible)
-        if (frustumParams && frustumParams->cameraPos && frustumParams->cameraRot)
-        {
-            const D3DXVECTOR3& cp = *frustumParams->cameraPos;
-            const D3DXVECTOR3& cr = *frustumParams->cameraRot;
-            float fov = frustumParams->fov;
-            float np = frustumParams->nearPlane;
-            float fp = frustumParams->farPlane;
-            float sw = frustumParams->screenWidth;
-            float sh = frustumParams->screenHeight;
-            float pa = frustumParams->projectionAspect;
-
-            float cx = chunkCenterX, cy = chunkCenterY;
-            D3DXVECTOR3 corners[4] = {
-                { cx - halfW, cy - halfH, 0.1f },
-                { cx + halfW, cy - halfH, 0.1f },
-                { cx + halfW, cy + halfH, 0.1f },
-                { cx - halfW, cy + halfH, 0.1f }
-            };
-
-            bool anyInFrustum = false;
-            for (int i = 0; i < 4; ++i)
+            // Footprint: tile rectangle against the camera's ground footprint, 2D only
+            if (useFootprint && !RadarGeometry::FootprintOverlapsRect(footprint, chunkCenterX - halfW, chunkCenterY - halfH,
+                                                                    chunkCenterX + halfW, chunkCenterY + halfH))
+                continue;
+
+            LPDIRECT3DTEXTURE9 chunkTex;
+            const D3DXVECTOR4* region;
+            int tileId;
+            if (lodLevel > 0)
+            {
+                // Coarse tiles are not streamed: the whole level is resident once selected
+                chunkTex = m_coarseChunks[lodLevel][index];
+                region = &m_coarseRegions[lodLevel][index];
+                tileId = m_coarseTileIds[lodLevel][index];
+                if (!chunkTex)
+                    continue;  // none of the merged chunks exist
+            }
+            else
             {
-                float sx, sy;
-                if (MathUtils::WorldToScreen(corners[i], cp, cr, fov, np, fp, sw, sh, sx, sy, pa))
+                chunkTex = m_chunks[index];
+                region = &m_chunkRegions[index];
+                tileId = m_chunkTileIds[index];
+                if (!m_loaded[index] || !chunkTex)
                 {
-                    anyInFrustum = true;
-                    break;
+                    if (!m_unavailable[index])
+                        NoteMissingChunk(index, distSq);
+                    continue;
                 }
+                NoteDrawnChunk(index);
             }
-            if (!anyInFrustum)
+            if (IsBackgroundTile(tileId))
+            {
+                ++m_skippedDraws;
                 continue;
-        }
+            }
 
-        D3DXVECTOR3 elementPos(chunkCenterX, chunkCenterY, 0.0f);
-        D3DXVECTOR3 elementRot(0.0f, 0.0f, 0.0f);
-        D3DXVECTOR2 elementSize(chunkWorldWidth, chunkWorldHeight);
+            D3DXVECTOR3 elementPos(chunkCenterX, chunkCenterY, 0.0f);
+            D3DXVECTOR3 elementRot(0.0f, 0.0f, 0.0f);
+            D3DXVECTOR2 elementSize(chunkWorldWidth, chunkWorldHeight);
+
+            callback(index, elementPos, elementRot, elementSize, chunkTex, *region);
+        }
+    }
+}
 
-        callback(index, elementPos, elementRot, elementSize, chunkTex);
+template<typename F>
+void MapChunkManager::ForEachVirtualPage(const D3DXVECTOR3& cameraPos, float visibleRadius, const FrustumParams& footprintParams, F& callback)
+{
+    RadarFootprint footprint;
+    ChunkPageWalker::View view;
+    view.cameraX = cameraPos.x;
+    view.cameraY = cameraPos.y;
+    view.cameraZ = cameraPos.z;
+    view.visibleRadius = visibleRadius;
+    view.pixelSizePerDistance = 2.0f * tanf(footprintParams.fov * 0.5f) / footprintParams.screenWidth;
+    view.texelSize = (m_mapWidth / m_gridSize) / (float)m_baseTileTexels;
+    view.maxLevel = ChunkPageWalker::GetTopLevel(*this);
+    view.footprint = nullptr;
+    if (footprintParams.cameraPos && footprintParams.cameraRot)
+    {
+        BuildFootprint(footprintParams, footprint);
+        view.footprint = &footprint;
     }
+
+    // Empty range when the radius misses the map: the walk still resets its stats
+    const int topGrid = m_gridSize >> view.maxLevel;
+    const float topHalfW = m_mapWidth / topGrid * 0.5f;
+    const float topHalfH = m_mapHeight / topGrid * 0.5f;
+    int rowMin = 0, rowMax = -1, colMin = 0, colMax = -1;
+    GetChunkRange(cameraPos.x, cameraPos.y, visibleRadius + sqrtf(topHalfW * topHalfW + topHalfH * topHalfH),
+                  rowMin, rowMax, colMin, colMax, topGrid);
+    // Texture ids are the D3D textures GetPage handed out
+    auto draw = [&callback](const ChunkPageDraw& page) {
+        D3DXVECTOR3 elementPos(page.centerX, page.centerY, 0.0f);
+        D3DXVECTOR3 elementRot(0.0f, 0.0f, 0.0f);
+        D3DXVECTOR2 elementSize(page.width, page.height);
+        const D3DXVECTOR4 region(page.region.u0, page.region.v0, page.region.u1, page.region.v1);
+        callback(page.index, elementPos, elementRot, elementSize, (LPDIRECT3DTEXTURE9)page.texture, region);
+    };
+    m_pageWalker.Walk(*this, view, rowMin, rowMax, colMin, colMax, draw);
+    m_lodLevel = m_pageWalker.GetFinestLevel();
+    m_skippedDraws += m_pageWalker.GetSkippedDraws();
 }
@@ -0,0 +1,250 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/mapmanager/MapTileTable.cpp
+ *****************************************************************************/
+
+#include "MapTileTable.h"
+#include "ChunkMipChain.h"
+#include <cstring>
+
+MapTileTable::MapTileTable(LPDIRECT3DDEVICE9 pDevice)
+    : m_pDevice(pDevice)
+    , m_atlas(pDevice)
+    , m_useAtlas(false)
+{
+    ZeroMemory(m_userBytes, sizeof(m_userBytes));
+}
+
+MapTileTable::~MapTileTable()
+{
+    Release();
+}
+
+void MapTileTable::Reset(int atlasCapacity)
+{
+    Release();
+    m_useAtlas = atlasCapacity > 0;
+    if (m_useAtlas)
+        m_atlas.Reset(atlasCapacity);
+}
+
+void MapTileTable::Release()
+{
+    for (PlacedTile& placed : m_tiles)
+        if (placed.refs > 0 && placed.slot < 0 && placed.texture)
+            placed.texture->Release();
+    m_tiles.clear();
+    m_freeTiles.clear();
+    m_tilesByHash.clear();
+    m_tilesBySolidColor.clear();
+    ZeroMemory(m_userBytes, sizeof(m_userBytes));
+    m_atlas.Release();
+}
+
+LPDIRECT3DTEXTURE9 MapTileTable::CreateTexture(const uint8_t* data, int width, int height, int pitch, int levels, ChunkFormat format) const
+{
+    if (!m_pDevice || !data || width <= 0 || height <= 0 || levels <= 0)
+        return nullptr;
+
+    D3DFORMAT d3dFormat = D3DFMT_A8R8G8B8;
+    if (format == CHUNK_FORMAT_DXT1)
+        d3dFormat = D3DFMT_DXT1;
+    else if (format == CHUNK_FORMAT_DXT5)
+        d3dFormat = D3DFMT_DXT5;
+
+    LPDIRECT3DTEXTURE9 d3dTex = nullptr;
+    HRESULT hr = m_pDevice->CreateTexture((UINT)width, (UINT)height, (UINT)levels, 0, d3dFormat, D3DPOOL_MANAGED, &d3dTex, nullptr);
+    if (FAILED(hr) || !d3dTex)
+        return nullptr;
+
+    for (int level = 0; level < levels; ++level)
+    {
+        // Rows are block rows for DXT; LockRect pitch is per block row too
+        size_t rowBytes = ChunkMipChain::LevelRowBytes(width, level, format);
+        int rows = ChunkMipChain::LevelRows(height, level, format);
+        size_t srcPitch = (level == 0) ? (size_t)pitch : rowBytes;
+        const uint8_t* src = data + ChunkMipChain::LevelOffset(width, height, level, format);
+
+        D3DLOCKED_RECT locked;
+        if (FAILED(d3dTex->LockRect(level, &locked, nullptr, 0)))
+        {
+            d3dTex->Release();
+            return nullptr;
+        }
+        for (int y = 0; y < rows; y++)
+            memcpy((uint8_t*)locked.pBits + y * locked.Pitch, src + (size_t)y * srcPitch, rowBytes);
+        d3dTex->UnlockRect(level);
+    }
+    return d3dTex;
+}
+
+bool MapTileTable::Place(const ChunkCache::Tile& tile, TileUser user, LPDIRECT3DTEXTURE9& outTex, int& outTileId, D3DXVECTOR4& outRegion)
+{
+    outTileId = -1;
+    if (!tile.data)
+        return false;
+
+    // Same content already placed: one more reference, no upload. Solid colours are exact keys; a hash hit
+    // is only shared when shape and level 0 bytes agree, a collision gets a tile of its own.
+    int sameId = -1;
+    if (tile.solid)
+    {
+        auto it = m_tilesBySolidColor.find(tile.solidColor);
+        if (it != m_tilesBySolidColor.end())
+            sameId = it->second;
+    }
+    else if (tile.hash != 0)
+    {
+        auto it = m_tilesByHash.find(tile.hash);
+        if (it != m_tilesByHash.end() && Matches(it->second, tile))
+            sameId = it->second;
+    }
+    if (sameId >= 0)
+    {
+        AddRef(sameId, user);
+        outTex = m_tiles[sameId].texture;
+        outRegion = m_tiles[sameId].region;
+        outTileId = sameId;
+        return true;
+    }
+
+    PlacedTile placed = {};
+    placed.slot = -1;
+    placed.hash = tile.hash;
+    placed.width = tile.width;
+    placed.height = tile.height;
+    placed.levels = tile.levels;
+    placed.format = tile.format;
+    placed.gutter = tile.gutter;
+    placed.solid = tile.solid;
+    placed.solidColor = tile.solidColor;
+    placed.bytes = ChunkMipChain::ChainSize(tile.width, tile.height, tile.levels, tile.format);
+    const int pitch = (int)ChunkMipChain::LevelRowBytes(tile.width, 0, tile.format);
+    if (tile.solid)
+    {
+        // Flat colour: a 1x1 texture stretched over the quad, shared by every tile of that colour
+        placed.texture = CreateTexture((const uint8_t*)&tile.solidColor, 1, 1, 4, 1, CHUNK_FORMAT_BGRA8);
+        placed.region = D3DXVECTOR4(0.0f, 0.0f, 1.0f, 1.0f);
+        placed.gpuBytes = 4;
+    }
+    else if (m_useAtlas && tile.gutter > 0 && tile.width == tile.height &&
+             (placed.slot = m_atlas.Insert(tile.data, tile.width, pitch, tile.levels, tile.format)) >= 0)
+    {
+        placed.texture = m_atlas.GetTexture(placed.slot);
+        placed.region = m_atlas.GetRegion(placed.slot, tile.gutter);
+        placed.gpuBytes = placed.bytes;
+    }
+    else
+    {
+        // A cell that did not fit the atlas keeps its gutter; the region skips it
+        placed.texture = CreateTexture(tile.data, tile.width, tile.height, pitch, tile.levels, tile.format);
+        float gutterU = (float)tile.gutter / (float)tile.width;
+        float gutterV = (float)tile.gutter / (float)tile.height;
+        placed.region = D3DXVECTOR4(gutterU, gutterV, 1.0f - gutterU, 1.0f - gutterV);
+        placed.gpuBytes = placed.bytes;
+    }
+    if (!placed.texture)
+        return false;
+
+    if (m_freeTiles.empty())
+    {
+        outTileId = (int)m_tiles.size();
+        m_tiles.push_back(placed);
+    }
+    else
+    {
+        outTileId = m_freeTiles.back();
+        m_freeTiles.pop_back();
+        m_tiles[outTileId] = placed;
+    }
+    // A collision keeps the first tile under the hash; later copies of the second content are not shared
+    if (placed.solid)
+        m_tilesBySolidColor.emplace(placed.solidColor, outTileId);
+    else if (placed.hash != 0)
+        m_tilesByHash.emplace(placed.hash, outTileId);
+    AddRef(outTileId, user);
+    outTex = placed.texture;
+    outRegion = placed.region;
+    return true;
+}
+
+bool MapTileTable::Matches(int tileId, const ChunkCache::Tile& tile) const
+{
+    const PlacedTile& placed = m_tiles[tileId];
+    if (placed.refs == 0 || placed.solid || placed.width != tile.width || placed.height != tile.height ||
+        placed.levels != tile.levels || placed.format != tile.format || placed.gutter != tile.gutter)
+        return false;
+
+    const size_t rowBytes = ChunkMipChain::LevelRowBytes(tile.width, 0, tile.format);
+    if (placed.slot >= 0)
+        return m_atlas.MatchesCell(placed.slot, tile.data, (int)rowBytes);
+
+    // Own texture: managed, a read-only lock reads the system memory copy
+    D3DLOCKED_RECT locked;
+    if (!placed.texture || FAILED(placed.texture->LockRect(0, &locked, nullptr, D3DLOCK_READONLY)))
+        return false;
+    const int rows = ChunkMipChain::LevelRows(tile.height, 0, tile.format);
+    bool same = true;
+    for (int row = 0; row < rows && same; row++)
+        same = memcmp((const uint8_t*)locked.pBits + row * locked.Pitch, tile.data + (size_t)row * rowBytes, rowBytes) == 0;
+    placed.texture->UnlockRect(0);
+    return same;
+}
+
+void MapTileTable::AddRef(int tileId, TileUser user)
+{
+    PlacedTile& placed = m_tiles[tileId];
+    ++placed.refs;
+    if (placed.userRefs[user]++ == 0)
+        m_userBytes[user] += placed.gpuBytes;
+}
+
+void MapTileTable::ReleaseTile(LPDIRECT3DTEXTURE9& tex, int& tileId, TileUser user)
+{
+    if (tileId >= 0 && tileId < (int)m_tiles.size())
+    {
+        PlacedTile& placed = m_tiles[tileId];
+        if (--placed.userRefs[user] == 0)
+            m_userBytes[user] -= placed.gpuBytes;
+        if (--placed.refs == 0)
+        {
+            // Only drop the lookup entry if it points here; a colliding tile does not own it
+            if (placed.solid)
+            {
+                auto it = m_tilesBySolidColor.find(placed.solidColor);
+                if (it != m_tilesBySolidColor.end() && it->second == tileId)
+                    m_tilesBySolidColor.erase(it);
+            }
+            else if (placed.hash != 0)
+            {
+                auto it = m_tilesByHash.find(placed.hash);
+                if (it != m_tilesByHash.end() && it->second == tileId)
+                    m_tilesByHash.erase(it);
+            }
+            if (placed.slot >= 0)
+                m_atlas.Free(placed.slot);  // the page is shared
+            else if (placed.texture)
+                placed.texture->Release();
+            placed = {};
+            m_freeTiles.push_back(tileId);
+        }
+    }
+    tex = nullptr;
+    tileId = -1;
+}
+
+MapTileTable::Stats MapTileTable::GetStats() const
+{
+    Stats stats = {};
+    for (const PlacedTile& placed : m_tiles)
+    {
+        if (placed.refs == 0)
+            continue;
+        if (placed.solid)
+            stats.solidTiles += placed.refs;
+        else
+            stats.sharedTiles += placed.refs - 1;
+        stats.dedupSavedBytes += placed.bytes * placed.refs - placed.gpuBytes;
+    }
+    return stats;
+}
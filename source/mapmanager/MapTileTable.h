@@ -0,0 +1,97 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/mapmanager/MapTileTable.h
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <d3d9.h>
+#include <d3dx9.h>
+#include "ChunkCache.h"
+#include "MapChunkAtlas.h"
+
+// Map tiles placed on the GPU by content: textures / atlas cells referenced by every chunk and coarse tile
+// showing them. Solid tiles of one colour share a 1x1 texture; other tiles are shared when hash, shape and
+// level 0 bytes agree. Main thread only.
+class MapTileTable
+{
+public:
+    // Who references a placed tile: level 0 chunks count against the streaming budget, coarse tiles do not
+    enum TileUser
+    {
+        TILE_USER_CHUNK,
+        TILE_USER_COARSE,
+        TILE_USER_COUNT
+    };
+
+    struct Stats
+    {
+        int    sharedTiles;     // references showing the texture of an identical tile
+        int    solidTiles;      // references to 1x1 solid colour textures
+        size_t dedupSavedBytes; // not uploaded thanks to both
+    };
+
+    MapTileTable(LPDIRECT3DDEVICE9 pDevice);
+    ~MapTileTable();
+
+    // atlasCapacity: cells for MapAtlas, 0 = every tile gets its own texture
+    void Reset(int atlasCapacity);
+    // Frees every placed tile and the atlas pages
+    void Release();
+
+    // Shares a placed tile with the same content, otherwise places a new one: 1x1 texture for solid tiles,
+    // atlas cell when possible, own texture else. The uploaded bytes are charged to the user's total on its
+    // first reference. outRegion = (u0, v0, u1, v1) of the tile inside outTex.
+    bool Place(const ChunkCache::Tile& tile, TileUser user, LPDIRECT3DTEXTURE9& outTex, int& outTileId, D3DXVECTOR4& outRegion);
+    // Clears tex and tileId; the texture / cell is freed with its last reference
+    void ReleaseTile(LPDIRECT3DTEXTURE9& tex, int& tileId, TileUser user);
+
+    bool   IsSolidColor(int tileId, uint32_t color) const
+    {
+        return tileId >= 0 && m_tiles[tileId].solid && m_tiles[tileId].solidColor == color;
+    }
+    // gpuBytes of the tiles the user references, a shared tile once
+    size_t GetBytes(TileUser user) const { return m_userBytes[user]; }
+    Stats  GetStats() const;
+    const MapChunkAtlas& GetAtlas() const { return m_atlas; }
+
+    // data: tightly packed mip chain except level 0, which uses pitch
+    LPDIRECT3DTEXTURE9 CreateTexture(const uint8_t* data, int width, int height, int pitch, int levels, ChunkFormat format) const;
+
+private:
+    struct PlacedTile
+    {
+        LPDIRECT3DTEXTURE9 texture;
+        int                slot;        // atlas slot, -1 = own texture
+        D3DXVECTOR4        region;
+        uint64_t           hash;        // 0 = never shared
+        int                width;
+        int                height;
+        int                levels;
+        ChunkFormat        format;
+        int                gutter;
+        bool               solid;
+        uint32_t           solidColor;
+        size_t             bytes;       // payload of one reference
+        size_t             gpuBytes;    // actually uploaded
+        int                refs;        // 0 = free entry
+        int                userRefs[TILE_USER_COUNT];
+    };
+
+    void AddRef(int tileId, TileUser user);
+    // Shape and level 0 bytes of a hash hit; reads the managed texture back, only done when the hashes agree
+    bool Matches(int tileId, const ChunkCache::Tile& tile) const;
+
+    LPDIRECT3DDEVICE9       m_pDevice;
+    MapChunkAtlas           m_atlas;
+    bool                    m_useAtlas;
+    std::vector<PlacedTile> m_tiles;
+    std::vector<int>        m_freeTiles;
+    std::unordered_map<uint64_t, int> m_tilesByHash;        // content hash -> tile id
+    std::unordered_map<uint32_t, int> m_tilesBySolidColor;  // colour of a solid tile -> tile id
+    size_t                  m_userBytes[TILE_USER_COUNT];
+};
@@ -0,0 +1,33 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/mapmanager/chunks/ChunkBackgroundFeed.cpp
+ *****************************************************************************/
+
+#include "ChunkBackgroundFeed.h"
+
+ChunkBackgroundFeed::ChunkBackgroundFeed()
+    : m_chunkCount(0)
+    , m_cursor(0)
+    , m_inFlight(false)
+{
+}
+
+void ChunkBackgroundFeed::Reset(int chunkCount)
+{
+    m_chunkCount = (chunkCount > 0) ? chunkCount : 0;
+    m_cursor = 0;
+    m_inFlight = false;
+}
+
+bool ChunkBackgroundFeed::IsDone(const ChunkCache& cache, const ChunkPyramid& pyramid, const ChunkCacheWriter& writer) const
+{
+    // A cache hit already holds the coarse tiles: decoding would read the whole source for nothing
+    if (m_chunkCount == 0 || cache.IsOpen())
+        return true;
+    return (pyramid.GetLevelCount() == 0 || pyramid.GetContributedCount() >= m_chunkCount) && !writer.IsActive();
+}
+
+bool ChunkBackgroundFeed::IsNeeded(int index, const ChunkPyramid& pyramid, const ChunkCacheWriter& writer)
+{
+    return (pyramid.GetLevelCount() > 0 && !pyramid.HasContributed(index)) || (writer.IsActive() && !writer.HasRecorded(0, index));
+}
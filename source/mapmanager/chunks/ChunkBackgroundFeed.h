@@ -0,0 +1,66 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/mapmanager/chunks/ChunkBackgroundFeed.h
+ *****************************************************************************/
+
+#pragma once
+
+#include <vector>
+#include "ChunkCache.h"
+#include "ChunkPyramid.h"
+
+// Streaming mode only requests visible chunks; coarse tiles and the tile cache need all of them.
+// Picks the next chunk the pyramid or the cache writer still lacks, one job at a time; main thread only.
+class ChunkBackgroundFeed
+{
+public:
+    ChunkBackgroundFeed();
+
+    void Reset(int chunkCount);
+    // New source: the next scan starts over at chunk 0, a job in flight still finishes
+    void Rewind() { m_cursor = 0; }
+
+    // Nothing to feed: tiles come from an open cache, or the pyramid and the writer have every chunk
+    bool IsDone(const ChunkCache& cache, const ChunkPyramid& pyramid, const ChunkCacheWriter& writer) const;
+
+    // Hands at most one chunk to submit(index), which returns false if the job could not be started.
+    // Unavailable chunks are recorded as missing on the way. Returns the submitted chunk or -1.
+    template<typename F>
+    int Feed(const ChunkCache& cache, ChunkPyramid& pyramid, ChunkCacheWriter& writer,
+             const std::vector<bool>& queued, const std::vector<bool>& unavailable, F&& submit)
+    {
+        if (m_inFlight || IsDone(cache, pyramid, writer))
+            return -1;
+
+        for (int scanned = 0; scanned < m_chunkCount; ++scanned)
+        {
+            const int index = m_cursor;
+            m_cursor = (m_cursor + 1) % m_chunkCount;
+            if (queued[index] || !IsNeeded(index, pyramid, writer))
+                continue;
+            if (unavailable[index])
+            {
+                pyramid.MarkMissing(index);
+                writer.Skip(0, index);
+                continue;
+            }
+
+            // Set first: without worker threads the job finishes inside submit
+            m_inFlight = true;
+            if (submit(index))
+                return index;
+            m_inFlight = false;
+        }
+        return -1;
+    }
+
+    void OnJobDone() { m_inFlight = false; }
+    bool IsInFlight() const { return m_inFlight; }
+
+private:
+    static bool IsNeeded(int index, const ChunkPyramid& pyramid, const ChunkCacheWriter& writer);
+
+    int  m_chunkCount;
+    int  m_cursor;
+    bool m_inFlight;
+};
@@ -0,0 +1,297 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/mapmanager/chunks/ChunkCache.cpp
+ *****************************************************************************/
+
+#include "ChunkCache.h"
+#include "ChunkMipChain.h"
+#include <Windows.h>
+#include <cstring>
+
+static const uint64_t PAYLOAD_ALIGN = 16;
+
+static bool KeysEqual(const ChunkCache::Key& a, const ChunkCache::Key& b)
+{
+    return a.txdSize == b.txdSize && a.txdMtime == b.txdMtime && a.txdHash == b.txdHash &&
+           a.lodLevels == b.lodLevels && a.compressed == b.compressed && a.gutter == b.gutter;
+}
+
+bool ChunkCache::ComputeKey(const char* txdPath, int lodLevels, bool compressed, int gutter, Key& outKey)
+{
+    outKey = {};
+    if (!MappedFile::GetFileStamp(txdPath, outKey.txdSize, outKey.txdMtime))
+        return false;
+
+    MappedFile txd;
+    if (!txd.Open(txdPath))
+        return false;
+
+    uint64_t hash = 0xCBF29CE484222325ull;
+    const uint8_t* data = txd.GetData();
+    for (size_t i = 0, n = txd.GetSize(); i < n; ++i)
+    {
+        hash ^= data[i];
+        hash *= 0x100000001B3ull;
+    }
+    MakeKey(outKey.txdSize, outKey.txdMtime, hash, lodLevels, compressed, gutter, outKey);
+    return true;
+}
+
+void ChunkCache::MakeKey(uint64_t size, uint64_t mtime, uint64_t hash, int lodLevels, bool compressed, int gutter, Key& outKey)
+{
+    outKey = {};
+    outKey.txdSize = size;
+    outKey.txdMtime = mtime;
+    outKey.txdHash = hash;
+    outKey.lodLevels = (uint32_t)lodLevels;
+    outKey.compressed = compressed ? 1 : 0;
+    outKey.gutter = (uint32_t)gutter;
+}
+
+bool ChunkCache::Open(const char* path, const Key& key)
+{
+    Close();
+    if (!m_file.OpenViews(path))
+        return false;
+
+    const uint64_t fileSize = m_file.GetSize();
+    MappedView headerView;
+    if (fileSize < sizeof(Header) || !headerView.Map(m_file, 0, sizeof(Header)))
+    {
+        Close();
+        return false;
+    }
+
+    Header header;
+    memcpy(&header, headerView.GetData(), sizeof(header));
+    headerView.Reset();
+    if (header.magic != MAGIC || header.version != VERSION || !KeysEqual(header.key, key) ||
+        header.tableOffset > fileSize || (fileSize - header.tableOffset) / sizeof(Entry) < header.entryCount)
+    {
+        Close();
+        return false;
+    }
+
+    MappedView tableView;
+    if (header.entryCount > 0 && !tableView.Map(m_file, header.tableOffset, (size_t)header.entryCount * sizeof(Entry)))
+    {
+        Close();
+        return false;
+    }
+
+    for (uint32_t i = 0; i < header.entryCount; ++i)
+    {
+        Entry entry;
+        memcpy(&entry, tableView.GetData() + (size_t)i * sizeof(Entry), sizeof(entry));
+        if (entry.level >= MAX_LEVELS || entry.width == 0 || entry.height == 0 || entry.levels == 0 || entry.format > CHUNK_FORMAT_DXT5 ||
+            2 * entry.gutter >= entry.width || 2 * entry.gutter >= entry.height ||
+            entry.size != ChunkMipChain::ChainSize(entry.width, entry.height, (int)entry.levels, (ChunkFormat)entry.format) ||
+            entry.offset > fileSize || fileSize - entry.offset < entry.size)
+        {
+            Close();
+            return false;
+        }
+
+        std::vector<Slot>& slots = m_slots[entry.level];
+        if (slots.size() <= entry.index)
+            slots.resize((size_t)entry.index + 1, Slot{});
+        Slot& slot = slots[entry.index];
+        slot.present = true;
+        slot.offset = entry.offset;
+        slot.tile.width = entry.width;
+        slot.tile.height = entry.height;
+        slot.tile.levels = (int)entry.levels;
+        slot.tile.format = (ChunkFormat)entry.format;
+        slot.tile.gutter = entry.gutter;
+        slot.tile.hash = entry.hash;
+        slot.tile.solid = entry.solid != 0;
+        slot.tile.solidColor = entry.solidColor;
+        slot.tile.data = nullptr;
+    }
+    return true;
+}
+
+void ChunkCache::Close()
+{
+    for (auto& slots : m_slots)
+        slots.clear();
+    m_file.Close();
+}
+
+const ChunkCache::Tile* ChunkCache::Find(int level, int index) const
+{
+    if (!IsOpen() || level < 0 || level >= MAX_LEVELS || index < 0 || index >= (int)m_slots[level].size())
+        return nullptr;
+    const Slot& slot = m_slots[level][index];
+    return slot.present ? &slot.tile : nullptr;
+}
+
+bool ChunkCache::Map(int level, int index, MappedView& view, Tile& outTile) const
+{
+    const Tile* tile = Find(level, index);
+    if (!tile)
+        return false;
+
+    const size_t size = ChunkMipChain::ChainSize(tile->width, tile->height, tile->levels, tile->format);
+    if (!view.Map(m_file, m_slots[level][index].offset, size))
+        return false;
+    outTile = *tile;
+    outTile.data = view.GetData();
+    return true;
+}
+
+ChunkCacheWriter::ChunkCacheWriter()
+    : m_file(nullptr)
+    , m_key()
+    , m_expected(0)
+    , m_recordedCount(0)
+    , m_writeOffset(0)
+{
+}
+
+ChunkCacheWriter::~ChunkCacheWriter()
+{
+    Abort();
+}
+
+bool ChunkCacheWriter::Begin(const char* path, const ChunkCache::Key& key, const int* levelTiles, int levelCount)
+{
+    Abort();
+    if (!path || !levelTiles || levelCount <= 0 || levelCount > ChunkCache::MAX_LEVELS)
+        return false;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_path = path;
+    m_tempPath = m_path + ".tmp";
+    if (fopen_s(&m_file, m_tempPath.c_str(), "wb") != 0 || !m_file)
+    {
+        m_file = nullptr;
+        return false;
+    }
+
+    // Placeholder header (magic 0) until Finish
+    ChunkCache::Header header = {};
+    if (fwrite(&header, sizeof(header), 1, m_file) != 1)
+    {
+        CloseFile(false);
+        return false;
+    }
+
+    m_key = key;
+    m_entries.clear();
+    m_recorded.assign((size_t)levelCount, std::vector<bool>());
+    m_expected = 0;
+    for (int level = 0; level < levelCount; ++level)
+    {
+        int tiles = (levelTiles[level] > 0) ? levelTiles[level] : 0;
+        m_recorded[level].assign((size_t)tiles, false);
+        m_expected += tiles;
+    }
+    m_recordedCount = 0;
+    m_writeOffset = sizeof(header);
+    return true;
+}
+
+void ChunkCacheWriter::Abort()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    CloseFile(false);
+}
+
+void ChunkCacheWriter::Write(int level, int index, const ChunkPixels& pixels)
+{
+    Record(level, index, &pixels);
+}
+
+void ChunkCacheWriter::Skip(int level, int index)
+{
+    Record(level, index, nullptr);
+}
+
+bool ChunkCacheWriter::IsActive() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_file != nullptr;
+}
+
+bool ChunkCacheWriter::HasRecorded(int level, int index) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (level < 0 || level >= (int)m_recorded.size() || index < 0 || index >= (int)m_recorded[level].size())
+        return false;
+    return m_recorded[level][index];
+}
+
+void ChunkCacheWriter::Record(int level, int index, const ChunkPixels* pixels)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_file || level < 0 || level >= (int)m_recorded.size() || index < 0 || index >= (int)m_recorded[level].size() || m_recorded[level][index])
+        return;
+
+    // Only tight mip chains can be mapped straight into LockRect copies later
+    if (pixels && pixels->levels > 0 && pixels->levels <= 0xFFFF && pixels->gutter >= 0 && pixels->width <= 0xFFFF && pixels->height <= 0xFFFF &&
+        pixels->pitch == (int)ChunkMipChain::LevelRowBytes(pixels->width, 0, pixels->format) &&
+        pixels->data.size() >= ChunkMipChain::ChainSize(pixels->width, pixels->height, pixels->levels, pixels->format))
+    {
+        static const uint8_t zeros[PAYLOAD_ALIGN] = {};
+        uint64_t pad = (PAYLOAD_ALIGN - (m_writeOffset % PAYLOAD_ALIGN)) % PAYLOAD_ALIGN;
+        uint64_t size = ChunkMipChain::ChainSize(pixels->width, pixels->height, pixels->levels, pixels->format);
+        if ((pad && fwrite(zeros, 1, (size_t)pad, m_file) != pad) || fwrite(pixels->data.data(), 1, (size_t)size, m_file) != size)
+        {
+            CloseFile(false);
+            return;
+        }
+
+        ChunkCache::Entry entry = {};
+        entry.level = (uint16_t)level;
+        entry.index = (uint16_t)index;
+        entry.width = (uint16_t)pixels->width;
+        entry.height = (uint16_t)pixels->height;
+        entry.levels = (uint16_t)pixels->levels;
+        entry.gutter = (uint16_t)pixels->gutter;
+        entry.format = (uint32_t)pixels->format;
+        entry.offset = m_writeOffset + pad;
+        entry.size = size;
+        entry.hash = pixels->hash;
+        entry.solid = pixels->solid ? 1 : 0;
+        entry.solidColor = pixels->solidColor;
+        m_entries.push_back(entry);
+        m_writeOffset = entry.offset + size;
+    }
+
+    m_recorded[level][index] = true;
+    if (++m_recordedCount == m_expected)
+        Finish();
+}
+
+void ChunkCacheWriter::Finish()
+{
+    ChunkCache::Header header = {};
+    header.magic = ChunkCache::MAGIC;
+    header.version = ChunkCache::VERSION;
+    header.key = m_key;
+    header.entryCount = (uint32_t)m_entries.size();
+    header.tableOffset = m_writeOffset;
+
+    bool ok = m_entries.empty() || fwrite(m_entries.data(), sizeof(ChunkCache::Entry), m_entries.size(), m_file) == m_entries.size();
+    ok = ok && fflush(m_file) == 0 && fseek(m_file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, m_file) == 1;
+    CloseFile(ok);
+}
+
+void ChunkCacheWriter::CloseFile(bool keep)
+{
+    if (!m_file)
+        return;
+
+    bool ok = (fclose(m_file) == 0) && keep;
+    m_file = nullptr;
+    if (ok)
+        ok = MoveFileExA(m_tempPath.c_str(), m_path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+    if (!ok)
+        DeleteFileA(m_tempPath.c_str());
+
+    m_entries.clear();
+    m_recorded.clear();
+    m_expected = 0;
+    m_recordedCount = 0;
+}
@@ -0,0 +1,144 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/mapmanager/chunks/ChunkCache.h
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "ChunkTypes.h"
+#include "MappedFile.h"
+
+// Pre-converted map tiles, written once from the TXD (or map pack) and memory-mapped on later starts.
+// Only the header and entry table are read at Open; each tile payload is mapped on its own when it is uploaded.
+//
+// File layout (little endian):
+//   Header                         magic, version, key of the source TXD, entry table position
+//   payloads                       BGRA8 or DXT mip chains (ChunkMipChain layout), 16-byte aligned
+//   Entry[entryCount]              level, index, size, content hash and payload offset per tile
+// The magic is written last, so an interrupted build never validates.
+//
+// Level 0 entries are base chunks, levels 1..lodLevels the merged ChunkPyramid tiles.
+// Missing tiles have no entry. A key mismatch (TXD replaced, LOD, compression or atlas setting changed) means rebuild.
+class ChunkCache
+{
+public:
+    static const uint32_t MAGIC = 0x434D5452;  // "RTMC"
+    static const uint32_t VERSION = 4;
+    static const int      MAX_LEVELS = 8;
+
+    struct Key
+    {
+        uint64_t txdSize;
+        uint64_t txdMtime;
+        uint64_t txdHash;   // FNV-1a 64 over the whole TXD (map packs: over the manifest and tile stamps)
+        uint32_t lodLevels;
+        uint32_t compressed;    // tiles were DXT encoded (MapCompression)
+        uint32_t gutter;        // tiles were padded into atlas cells (MapAtlas), 0 = plain tiles
+        uint32_t reserved;
+    };
+
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        Key      key;
+        uint32_t entryCount;
+        uint32_t reserved;
+        uint64_t tableOffset;
+    };
+
+    struct Entry
+    {
+        uint16_t level;
+        uint16_t index;
+        uint16_t width;
+        uint16_t height;
+        uint16_t levels;    // mip levels in the payload
+        uint16_t gutter;    // ChunkPixels::gutter
+        uint32_t format;    // ChunkFormat
+        uint64_t offset;
+        uint64_t size;
+        uint64_t hash;      // ChunkPixels::hash
+        uint32_t solid;
+        uint32_t solidColor;
+    };
+
+    struct Tile
+    {
+        int            width;
+        int            height;
+        int            levels;
+        ChunkFormat    format;
+        int            gutter;
+        uint64_t       hash;    // content hash, 0 = unknown
+        bool           solid;   // single colour tile
+        uint32_t       solidColor;
+        const uint8_t* data;    // tightly packed mip chain; set by Map, nullptr from Find
+    };
+
+    static bool ComputeKey(const char* txdPath, int lodLevels, bool compressed, int gutter, Key& outKey);
+    // Key for a source stamped by the caller (map packs: MapPackSource::ComputeStamp)
+    static void MakeKey(uint64_t size, uint64_t mtime, uint64_t hash, int lodLevels, bool compressed, int gutter, Key& outKey);
+
+    bool Open(const char* path, const Key& key);
+    void Close();
+    bool IsOpen() const { return m_file.IsOpen(); }
+
+    // Tile description without payload; nullptr if the tile is not in the cache
+    const Tile* Find(int level, int index) const;
+    // Maps the payload of a tile into view; outTile.data stays valid until the view is reset.
+    // False if the tile is not in the cache or the view could not be mapped.
+    bool Map(int level, int index, MappedView& view, Tile& outTile) const;
+
+private:
+    struct Slot
+    {
+        bool     present;
+        uint64_t offset;
+        Tile     tile;
+    };
+
+    MappedFile        m_file;
+    std::vector<Slot> m_slots[MAX_LEVELS];   // per level, indexed by tile index
+};
+
+// Builds a cache file next to the TXD while chunks are decoded the normal way.
+// Write / Skip are thread-safe (decode workers and the render thread); the file is
+// finalized and moved into place when every expected tile has been recorded.
+class ChunkCacheWriter
+{
+public:
+    ChunkCacheWriter();
+    ~ChunkCacheWriter();
+
+    // levelTiles[L] = expected tile count of level L (level 0 = base chunks)
+    bool Begin(const char* path, const ChunkCache::Key& key, const int* levelTiles, int levelCount);
+    void Abort();
+
+    void Write(int level, int index, const ChunkPixels& pixels);
+    void Skip(int level, int index);
+
+    bool IsActive() const;
+    bool HasRecorded(int level, int index) const;
+
+private:
+    void Record(int level, int index, const ChunkPixels* pixels);
+    void Finish();
+    void CloseFile(bool keep);
+
+    mutable std::mutex                m_mutex;
+    FILE*                             m_file;
+    std::string                       m_path;
+    std::string                       m_tempPath;
+    ChunkCache::Key                   m_key;
+    std::vector<ChunkCache::Entry>    m_entries;
+    std::vector<std::vector<bool>>    m_recorded;   // [level][index]
+    int                               m_expected;
+    int                               m_recordedCount;
+    uint64_t                          m_writeOffset;
+};
@@ -0,0 +1,427 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/mapmanager/chunks/ChunkCompress.cpp
+ *****************************************************************************/
+
+#include "ChunkCompress.h"
+#include "ChunkMipChain.h"
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+#include <utility>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define CHUNK_COMPRESS_SSE2 1
+#endif
+
+namespace
+{
+    std::mutex s_statsMutex;
+    int        s_statTiles = 0;
+    uint64_t   s_statTexels = 0;
+    uint64_t   s_statMicros = 0;
+    double     s_statPsnrSum = 0.0;
+    float      s_statPsnrMin = 0.0f;
+    int        s_statPsnrCount = 0;
+}
+
+static inline uint16_t To565(int r, int g, int b)
+{
+    return (uint16_t)(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+}
+
+// Expanded endpoint in B, G, R order
+static inline void From565(uint16_t c, int out[3])
+{
+    int r = (c >> 11) & 31;
+    int g = (c >> 5) & 63;
+    int b = c & 31;
+    out[0] = (b << 3) | (b >> 2);
+    out[1] = (g << 2) | (g >> 4);
+    out[2] = (r << 3) | (r >> 2);
+}
+
+// Per-channel min / max over the 16 texels of a block
+static void GetBlockBounds(const uint8_t* block, uint8_t minC[4], uint8_t maxC[4])
+{
+#ifdef CHUNK_COMPRESS_SSE2
+    __m128i r0 = _mm_loadu_si128((const __m128i*)(block + 0));
+    __m128i r1 = _mm_loadu_si128((const __m128i*)(block + 16));
+    __m128i r2 = _mm_loadu_si128((const __m128i*)(block + 32));
+    __m128i r3 = _mm_loadu_si128((const __m128i*)(block + 48));
+    __m128i mn = _mm_min_epu8(_mm_min_epu8(r0, r1), _mm_min_epu8(r2, r3));
+    __m128i mx = _mm_max_epu8(_mm_max_epu8(r0, r1), _mm_max_epu8(r2, r3));
+    mn = _mm_min_epu8(mn, _mm_shuffle_epi32(mn, _MM_SHUFFLE(1, 0, 3, 2)));
+    mx = _mm_max_epu8(mx, _mm_shuffle_epi32(mx, _MM_SHUFFLE(1, 0, 3, 2)));
+    mn = _mm_min_epu8(mn, _mm_shuffle_epi32(mn, _MM_SHUFFLE(2, 3, 0, 1)));
+    mx = _mm_max_epu8(mx, _mm_shuffle_epi32(mx, _MM_SHUFFLE(2, 3, 0, 1)));
+    uint32_t packedMin = (uint32_t)_mm_cvtsi128_si32(mn);
+    uint32_t packedMax = (uint32_t)_mm_cvtsi128_si32(mx);
+    memcpy(minC, &packedMin, 4);
+    memcpy(maxC, &packedMax, 4);
+#else
+    for (int c = 0; c < 4; ++c)
+    {
+        minC[c] = 255;
+        maxC[c] = 0;
+    }
+    for (int i = 0; i < 16; ++i)
+    {
+        for (int c = 0; c < 4; ++c)
+        {
+            uint8_t v = block[i * 4 + c];
+            if (v < minC[c]) minC[c] = v;
+            if (v > maxC[c]) maxC[c] = v;
+        }
+    }
+#endif
+}
+
+void ChunkCompress::EncodeColor(const uint8_t* block, uint8_t* out)
+{
+    uint8_t minC[4], maxC[4];
+    GetBlockBounds(block, minC, maxC);
+
+    // Inset by 1/16 of the range so the endpoints sit inside the cluster
+    int lo[3], hi[3], mid[3];
+    for (int c = 0; c < 3; ++c)
+    {
+        int inset = (maxC[c] - minC[c]) >> 4;
+        lo[c] = minC[c] + inset;
+        hi[c] = maxC[c] - inset;
+        mid[c] = (minC[c] + maxC[c] + 1) >> 1;
+    }
+
+    // Bounding box diagonal: flip R / B when they fall while G rises
+    int covRG = 0, covBG = 0;
+    for (int i = 0; i < 16; ++i)
+    {
+        int dg = block[i * 4 + 1] - mid[1];
+        covRG += (block[i * 4 + 2] - mid[2]) * dg;
+        covBG += (block[i * 4 + 0] - mid[0]) * dg;
+    }
+    if (covRG < 0)
+        std::swap(lo[2], hi[2]);
+    if (covBG < 0)
+        std::swap(lo[0], hi[0]);
+
+    uint16_t c0 = To565(hi[2], hi[1], hi[0]);
+    uint16_t c1 = To565(lo[2], lo[1], lo[0]);
+    if (c0 < c1)
+        std::swap(c0, c1);  // c0 > c1: four-colour mode in DXT1
+
+    uint32_t indices = 0;
+    if (c0 != c1)
+    {
+        int e0[3], e1[3], d[3];
+        From565(c0, e0);
+        From565(c1, e1);
+        for (int c = 0; c < 3; ++c)
+            d[c] = e1[c] - e0[c];
+        const int dd = d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+
+        // Position along e0 -> e1; palette order on the line is 0, 2, 3, 1
+        for (int i = 0; i < 16; ++i)
+        {
+            const uint8_t* p = block + i * 4;
+            int t = (p[0] - e0[0]) * d[0] + (p[1] - e0[1]) * d[1] + (p[2] - e0[2]) * d[2];
+            uint32_t index;
+            if (6 * t < dd)
+                index = 0;
+            else if (2 * t < dd)
+                index = 2;
+            else if (6 * t < 5 * dd)
+                index = 3;
+            else
+                index = 1;
+            indices |= index << (2 * i);
+        }
+    }
+
+    out[0] = (uint8_t)(c0 & 0xFF);
+    out[1] = (uint8_t)(c0 >> 8);
+    out[2] = (uint8_t)(c1 & 0xFF);
+    out[3] = (uint8_t)(c1 >> 8);
+    out[4] = (uint8_t)(indices & 0xFF);
+    out[5] = (uint8_t)((indices >> 8) & 0xFF);
+    out[6] = (uint8_t)((indices >> 16) & 0xFF);
+    out[7] = (uint8_t)(indices >> 24);
+}
+
+void ChunkCompress::EncodeAlpha(const uint8_t* block, uint8_t* out)
+{
+    int minA = 255, maxA = 0;
+    for (int i = 0; i < 16; ++i)
+    {
+        int a = block[i * 4 + 3];
+        if (a < minA) minA = a;
+        if (a > maxA) maxA = a;
+    }
+
+    // Eight-value mode (a0 > a1): index 0 = a0, 1 = a1, 2..7 = interpolated from a0 towards a1
+    uint64_t indices = 0;
+    const int range = maxA - minA;
+    if (range > 0)
+    {
+        for (int i = 0; i < 16; ++i)
+        {
+            int step = ((maxA - block[i * 4 + 3]) * 14 + range) / (2 * range);
+            uint64_t index = (step == 0) ? 0 : (step == 7) ? 1 : (uint64_t)(step + 1);
+            indices |= index << (3 * i);
+        }
+    }
+
+    out[0] = (uint8_t)maxA;
+    out[1] = (uint8_t)minA;
+    for (int i = 0; i < 6; ++i)
+        out[2 + i] = (uint8_t)((indices >> (8 * i)) & 0xFF);
+}
+
+void ChunkCompress::EncodeBlockDXT1(const uint8_t* block, uint8_t* out)
+{
+    EncodeColor(block, out);
+}
+
+void ChunkCompress::EncodeBlockDXT5(const uint8_t* block, uint8_t* out)
+{
+    EncodeAlpha(block, out);
+    EncodeColor(block, out + 8);
+}
+
+void ChunkCompress::DecodeBlock(const uint8_t* in, ChunkFormat format, uint8_t* block)
+{
+    const uint8_t* color = (format == CHUNK_FORMAT_DXT5) ? in + 8 : in;
+    uint16_t c0 = (uint16_t)(color[0] | (color[1] << 8));
+    uint16_t c1 = (uint16_t)(color[2] | (color[3] << 8));
+    uint32_t indices = (uint32_t)color[4] | ((uint32_t)color[5] << 8) | ((uint32_t)color[6] << 16) | ((uint32_t)color[7] << 24);
+
+    int palette[4][4];
+    int e0[3], e1[3];
+    From565(c0, e0);
+    From565(c1, e1);
+    const bool fourColor = (format == CHUNK_FORMAT_DXT5) || c0 > c1;
+    for (int c = 0; c < 3; ++c)
+    {
+        palette[0][c] = e0[c];
+        palette[1][c] = e1[c];
+        palette[2][c] = fourColor ? (2 * e0[c] + e1[c]) / 3 : (e0[c] + e1[c]) / 2;
+        palette[3][c] = fourColor ? (e0[c] + 2 * e1[c]) / 3 : 0;
+    }
+    palette[0][3] = palette[1][3] = palette[2][3] = 255;
+    palette[3][3] = fourColor ? 255 : 0;
+
+    for (int i = 0; i < 16; ++i)
+    {
+        const int* p = palette[(indices >> (2 * i)) & 3];
+        for (int c = 0; c < 4; ++c)
+            block[i * 4 + c] = (uint8_t)p[c];
+    }
+
+    if (format != CHUNK_FORMAT_DXT5)
+        return;
+
+    int alpha[8];
+    alpha[0] = in[0];
+    alpha[1] = in[1];
+    if (alpha[0] > alpha[1])
+    {
+        for (int k = 1; k <= 6; ++k)
+            alpha[k + 1] = ((7 - k) * alpha[0] + k * alpha[1]) / 7;
+    }
+    else
+    {
+        for (int k = 1; k <= 4; ++k)
+            alpha[k + 1] = ((5 - k) * alpha[0] + k * alpha[1]) / 5;
+        alpha[6] = 0;
+        alpha[7] = 255;
+    }
+    uint64_t alphaIndices = 0;
+    for (int i = 0; i < 6; ++i)
+        alphaIndices |= (uint64_t)in[2 + i] << (8 * i);
+    for (int i = 0; i < 16; ++i)
+        block[i * 4 + 3] = (uint8_t)alpha[(alphaIndices >> (3 * i)) & 7];
+}
+
+bool ChunkCompress::Decompress(const uint8_t* blocks, size_t size, ChunkFormat format, int width, int height, ChunkPixels& out)
+{
+    if (!blocks || width <= 0 || height <= 0 || (format != CHUNK_FORMAT_DXT1 && format != CHUNK_FORMAT_DXT5))
+        return false;
+    const size_t blockBytes = (format == CHUNK_FORMAT_DXT1) ? 8 : 16;
+    const int blocksX = (width + 3) / 4;
+    const int blocksY = (height + 3) / 4;
+    if (size < (size_t)blocksX * blocksY * blockBytes)
+        return false;
+
+    out.width = width;
+    out.height = height;
+    out.pitch = width * 4;
+    out.levels = 1;
+    out.format = CHUNK_FORMAT_BGRA8;
+    out.gutter = 0;
+    out.data.resize((size_t)width * height * 4);
+
+    uint8_t block[64];
+    for (int by = 0; by < blocksY; ++by)
+    {
+        for (int bx = 0; bx < blocksX; ++bx)
+        {
+            DecodeBlock(blocks + ((size_t)by * blocksX + bx) * blockBytes, format, block);
+            const int copyTexels = (width - bx * 4 < 4) ? width - bx * 4 : 4;
+            for (int y = 0; y < 4 && by * 4 + y < height; ++y)
+                memcpy(&out.data[((size_t)(by * 4 + y) * width + bx * 4) * 4], block + y * 16, (size_t)copyTexels * 4);
+        }
+    }
+    return true;
+}
+
+void ChunkCompress::EncodeLevel(const uint8_t* src, int width, int height, int pitch, ChunkFormat format, uint8_t* dst)
+{
+    const size_t blockBytes = (format == CHUNK_FORMAT_DXT1) ? 8 : 16;
+    uint8_t block[64];
+    for (int by = 0; by < height; by += 4)
+    {
+        for (int bx = 0; bx < width; bx += 4)
+        {
+            // Levels smaller than 4x4 repeat their edge texels
+            for (int y = 0; y < 4; ++y)
+            {
+                int sy = (by + y < height) ? by + y : height - 1;
+                const uint8_t* row = src + (size_t)sy * pitch;
+                if (bx + 4 <= width)
+                {
+                    memcpy(block + y * 16, row + bx * 4, 16);
+                    continue;
+                }
+                for (int x = 0; x < 4; ++x)
+                {
+                    int sx = (bx + x < width) ? bx + x : width - 1;
+                    memcpy(block + y * 16 + x * 4, row + sx * 4, 4);
+                }
+            }
+
+            if (format == CHUNK_FORMAT_DXT1)
+                EncodeBlockDXT1(block, dst);
+            else
+                EncodeBlockDXT5(block, dst);
+            dst += blockBytes;
+        }
+    }
+}
+
+bool ChunkCompress::IsOpaque(const uint8_t* bgra, int width, int height, int pitch)
+{
+    for (int y = 0; y < height; ++y)
+    {
+        const uint8_t* row = bgra + (size_t)y * pitch;
+        uint8_t alphaAnd = 255;
+        for (int x = 0; x < width; ++x)
+            alphaAnd &= row[x * 4 + 3];
+        if (alphaAnd != 255)
+            return false;
+    }
+    return true;
+}
+
+float ChunkCompress::ComputePsnr(const uint8_t* bgra, int width, int height, int pitch, const uint8_t* blocks, ChunkFormat format)
+{
+    const size_t blockBytes = (format == CHUNK_FORMAT_DXT1) ? 8 : 16;
+    const int channels = (format == CHUNK_FORMAT_DXT5) ? 4 : 3;
+    uint64_t sqError = 0;
+    uint64_t samples = 0;
+    uint8_t block[64];
+    for (int by = 0; by < height; by += 4)
+    {
+        for (int bx = 0; bx < width; bx += 4)
+        {
+            DecodeBlock(blocks, format, block);
+            blocks += blockBytes;
+            for (int y = 0; y < 4 && by + y < height; ++y)
+            {
+                const uint8_t* row = bgra + (size_t)(by + y) * pitch;
+                for (int x = 0; x < 4 && bx + x < width; ++x)
+                {
+                    for (int c = 0; c < channels; ++c)
+                    {
+                        int diff = (int)row[(bx + x) * 4 + c] - block[y * 16 + x * 4 + c];
+                        sqError += (uint64_t)(diff * diff);
+                    }
+                    samples += channels;
+                }
+            }
+        }
+    }
+    if (sqError == 0 || samples == 0)
+        return 99.0f;
+    double mse = (double)sqError / (double)samples;
+    return (float)(10.0 * log10(255.0 * 255.0 / mse));
+}
+
+bool ChunkCompress::Compress(ChunkPixels& pixels)
+{
+    const int w = pixels.width;
+    const int h = pixels.height;
+    if (pixels.format != CHUNK_FORMAT_BGRA8 || w <= 0 || h <= 0 || (w & 3) != 0 || (h & 3) != 0 ||
+        pixels.levels <= 0 || pixels.pitch != w * 4 || pixels.data.size() < ChunkMipChain::ChainSize(w, h, pixels.levels))
+        return false;
+
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point start = Clock::now();
+
+    const ChunkFormat format = IsOpaque(pixels.data.data(), w, h, pixels.pitch) ? CHUNK_FORMAT_DXT1 : CHUNK_FORMAT_DXT5;
+    std::vector<uint8_t> encoded(ChunkMipChain::ChainSize(w, h, pixels.levels, format));
+    uint64_t texels = 0;
+    for (int level = 0; level < pixels.levels; ++level)
+    {
+        int levelW = ChunkMipChain::LevelWidth(w, level);
+        int levelH = ChunkMipChain::LevelHeight(h, level);
+        EncodeLevel(pixels.data.data() + ChunkMipChain::LevelOffset(w, h, level), levelW, levelH, levelW * 4, format,
+            encoded.data() + ChunkMipChain::LevelOffset(w, h, level, format));
+        texels += (uint64_t)levelW * levelH;
+    }
+    const uint64_t micros = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+
+#ifdef _DEBUG
+    const float psnr = ComputePsnr(pixels.data.data(), w, h, pixels.pitch, encoded.data(), format);
+#endif
+    {
+        std::lock_guard<std::mutex> lock(s_statsMutex);
+        ++s_statTiles;
+        s_statTexels += texels;
+        s_statMicros += micros;
+#ifdef _DEBUG
+        s_statPsnrSum += psnr;
+        s_statPsnrMin = (s_statPsnrCount == 0 || psnr < s_statPsnrMin) ? psnr : s_statPsnrMin;
+        ++s_statPsnrCount;
+#endif
+    }
+
+    pixels.data.swap(encoded);
+    pixels.format = format;
+    pixels.pitch = (int)ChunkMipChain::LevelRowBytes(w, 0, format);
+    return true;
+}
+
+ChunkCompress::Stats ChunkCompress::GetStats()
+{
+    std::lock_guard<std::mutex> lock(s_statsMutex);
+    Stats stats = {};
+    stats.tiles = s_statTiles;
+    stats.texels = s_statTexels;
+    stats.micros = s_statMicros;
+    stats.psnrAvg = s_statPsnrCount ? (float)(s_statPsnrSum / s_statPsnrCount) : 0.0f;
+    stats.psnrMin = s_statPsnrMin;
+    return stats;
+}
+
+void ChunkCompress::ResetStats()
+{
+    std::lock_guard<std::mutex> lock(s_statsMutex);
+    s_statTiles = 0;
+    s_statTexels = 0;
+    s_statMicros = 0;
+    s_statPsnrSum = 0.0;
+    s_statPsnrMin = 0.0f;
+    s_statPsnrCount = 0;
+}
@@ -0,0 +1,50 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/mapmanager/chunks/ChunkCompress.h
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "ChunkTypes.h"
+
+// Real-time DXT1 / DXT5 encoder for chunk mip chains: inset bounding box endpoints,
+// diagonal picked from channel covariance, indices by projection. SSE2 for the block bounds.
+// Thread-safe; called from the decode workers.
+class ChunkCompress
+{
+public:
+    struct Stats
+    {
+        int      tiles;
+        uint64_t texels;        // level 0 + mips
+        uint64_t micros;        // encode time, summed over workers
+        float    psnrAvg;       // level 0 RGB(A) PSNR in dB, debug builds only (0 otherwise)
+        float    psnrMin;
+    };
+
+    // BGRA8 chain -> DXT1 if every level 0 texel is opaque, DXT5 otherwise.
+    // False (pixels untouched) for non-BGRA8 input or sizes that are not a multiple of 4.
+    static bool  Compress(ChunkPixels& pixels);
+
+    static bool  IsOpaque(const uint8_t* bgra, int width, int height, int pitch);
+
+    // 4x4 block of BGRA texels (64 bytes, row-major) -> 8 / 16 bytes
+    static void  EncodeBlockDXT1(const uint8_t* block, uint8_t* out);
+    static void  EncodeBlockDXT5(const uint8_t* block, uint8_t* out);
+    static void  DecodeBlock(const uint8_t* in, ChunkFormat format, uint8_t* block);
+    // Level 0 DXT1 / DXT5 blocks -> plain BGRA8 tile (levels = 1); false if size holds fewer blocks than needed
+    static bool  Decompress(const uint8_t* blocks, size_t size, ChunkFormat format, int width, int height, ChunkPixels& out);
+
+    // Level 0 of an encoded chain against the BGRA source; 99 dB for an exact match
+    static float ComputePsnr(const uint8_t* bgra, int width, int height, int pitch, const uint8_t* blocks, ChunkFormat format);
+
+    static Stats GetStats();
+    static void  ResetStats();
+
+private:
+    static void  EncodeLevel(const uint8_t* src, int width, int height, int pitch, ChunkFormat format, uint8_t* dst);
+    static void  EncodeColor(const uint8_t* block, uint8_t* out);
+    static void  EncodeAlpha(const uint8_t* block, uint8_t* out);
+};
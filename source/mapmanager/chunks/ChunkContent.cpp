@@ -0,0 +1,55 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/mapmanager/chunks/ChunkContent.cpp
+ *****************************************************************************/
+
+#include "ChunkContent.h"
+#include "ChunkMipChain.h"
+#include <cstring>
+
+static uint64_t HashBytes(uint64_t hash, const void* data, size_t size)
+{
+    const uint8_t* bytes = (const uint8_t*)data;
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 0x100000001B3ull;
+    }
+    return hash;
+}
+
+bool ChunkContent::IsUniform(const ChunkPixels& pixels, uint32_t& outColor)
+{
+    outColor = 0;
+    if (pixels.format != CHUNK_FORMAT_BGRA8 || pixels.gutter != 0 || pixels.width <= 0 || pixels.height <= 0 ||
+        pixels.data.size() < (size_t)pixels.pitch * (pixels.height - 1) + (size_t)pixels.width * 4)
+        return false;
+
+    uint32_t color;
+    memcpy(&color, pixels.data.data(), 4);
+    for (int y = 0; y < pixels.height; ++y)
+    {
+        const uint8_t* row = pixels.data.data() + (size_t)y * pixels.pitch;
+        for (int x = 0; x < pixels.width; ++x)
+        {
+            uint32_t texel;
+            memcpy(&texel, row + x * 4, 4);
+            if (texel != color)
+                return false;
+        }
+    }
+    // B, G, R, A bytes read little endian
+    outColor = color;
+    return true;
+}
+
+uint64_t ChunkContent::Hash(const ChunkPixels& pixels)
+{
+    const int32_t header[5] = { pixels.width, pixels.height, pixels.levels, (int32_t)pixels.format, pixels.gutter };
+    uint64_t hash = HashBytes(0xCBF29CE484222325ull, header, sizeof(header));
+    size_t size = ChunkMipChain::ChainSize(pixels.width, pixels.height, pixels.levels, pixels.format);
+    if (size > pixels.data.size())
+        size = pixels.data.size();
+    hash = HashBytes(hash, pixels.data.data(), size);
+    return hash ? hash : 1;
+}
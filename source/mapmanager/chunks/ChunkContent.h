@@ -0,0 +1,20 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/mapmanager/chunks/ChunkContent.h
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include "ChunkTypes.h"
+
+// Content analysis of decoded tiles, so identical chunks (open sea, empty areas) share one texture.
+// Thread-safe, runs on the decode workers.
+class ChunkContent
+{
+public:
+    // Level 0 of a plain BGRA8 tile has a single colour; outColor in A8R8G8B8
+    static bool     IsUniform(const ChunkPixels& pixels, uint32_t& outColor);
+    // FNV-1a 64 over size, format and the whole mip chain; never 0
+    static uint64_t Hash(const ChunkPixels& pixels);
+};
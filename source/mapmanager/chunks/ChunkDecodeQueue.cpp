@@ -0,0 +1,193 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/mapmanager/chunks/ChunkDecodeQueue.cpp
+ *****************************************************************************/
+
+#include "ChunkDecodeQueue.h"
+#include <algorithm>
+#include <chrono>
+
+ChunkDecodeQueue::ChunkDecodeQueue()
+    : m_decoding(0)
+    , m_stopping(false)
+    , m_uploadedTotal(0)
+    , m_failedTotal(0)
+    , m_lastDrainMicros(0)
+    , m_lastDrainUploads(0)
+{
+}
+
+ChunkDecodeQueue::~ChunkDecodeQueue()
+{
+    Stop();
+}
+
+bool ChunkDecodeQueue::Start(int workerCount)
+{
+    if (IsRunning())
+        return true;
+
+    if (workerCount <= 0)
+        workerCount = (int)std::thread::hardware_concurrency() - 1;
+    workerCount = (std::max)(1, (std::min)(workerCount, (int)MAX_WORKERS));
+
+    m_stopping = false;
+    try
+    {
+        for (int i = 0; i < workerCount; ++i)
+            m_workers.emplace_back(&ChunkDecodeQueue::WorkerMain, this);
+    }
+    catch (...)
+    {
+        // Thread creation failed: keep whatever workers were started
+    }
+    return IsRunning();
+}
+
+void ChunkDecodeQueue::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_jobAvailable.notify_all();
+    for (auto& worker : m_workers)
+        if (worker.joinable())
+            worker.join();
+    m_workers.clear();
+
+    // Workers are gone: nothing else touches the queues now
+    for (auto& job : m_queued)
+        if (job.release)
+            job.release();
+    for (auto& job : m_ready)
+        if (job.release)
+            job.release();
+    m_queued.clear();
+    m_ready.clear();
+    m_decoding = 0;
+}
+
+bool ChunkDecodeQueue::Submit(int index, DecodeFunc decode, ReleaseFunc release)
+{
+    if (!IsRunning() || !decode)
+        return false;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Job job = {};
+        job.index = index;
+        job.decoded = false;
+        job.decode = std::move(decode);
+        job.release = std::move(release);
+        m_queued.push_back(std::move(job));
+    }
+    m_jobAvailable.notify_one();
+    return true;
+}
+
+void ChunkDecodeQueue::WorkerMain()
+{
+    for (;;)
+    {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_jobAvailable.wait(lock, [this] { return m_stopping || !m_queued.empty(); });
+            if (m_stopping)
+                return;
+            job = std::move(m_queued.front());
+            m_queued.pop_front();
+            ++m_decoding;
+        }
+
+        try
+        {
+            job.decoded = job.decode(job.pixels);
+        }
+        catch (...)
+        {
+            job.decoded = false;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_decoding;
+            m_ready.push_back(std::move(job));
+        }
+        m_jobDone.notify_all();
+    }
+}
+
+int ChunkDecodeQueue::DrainUploads(IChunkUploader& uploader, int maxUploads, unsigned int maxMicros)
+{
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point start = Clock::now();
+
+    int uploads = 0;
+    for (;;)
+    {
+        if (maxUploads > 0 && uploads >= maxUploads)
+            break;
+        if (maxMicros > 0 && uploads > 0)
+        {
+            auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+            if ((unsigned long long)elapsed >= maxMicros)
+                break;
+        }
+
+        Job job;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_ready.empty())
+                break;
+            job = std::move(m_ready.front());
+            m_ready.pop_front();
+        }
+
+        // A dropped completion is neither: the chunk stays requestable
+        const ChunkUploadResult result = job.decoded ? uploader.Upload(job.index, job.pixels) : CHUNK_FAILED;
+        if (result == CHUNK_UPLOADED)
+        {
+            ++m_uploadedTotal;
+        }
+        else if (result == CHUNK_FAILED)
+        {
+            uploader.OnDecodeFailed(job.index);
+            ++m_failedTotal;
+        }
+        if (job.release)
+            job.release();
+        ++uploads;
+    }
+
+    m_lastDrainMicros = (unsigned int)std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+    m_lastDrainUploads = uploads;
+    return uploads;
+}
+
+void ChunkDecodeQueue::WaitIdle()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_jobDone.wait(lock, [this] { return m_workers.empty() || (m_queued.empty() && m_decoding == 0); });
+}
+
+int ChunkDecodeQueue::GetInFlightCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return (int)(m_queued.size() + m_ready.size()) + m_decoding;
+}
+
+ChunkDecodeQueue::Stats ChunkDecodeQueue::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats stats = {};
+    stats.queued = (int)m_queued.size();
+    stats.decoding = m_decoding;
+    stats.ready = (int)m_ready.size();
+    stats.uploadedTotal = m_uploadedTotal;
+    stats.failedTotal = m_failedTotal;
+    stats.lastDrainMicros = m_lastDrainMicros;
+    stats.lastDrainUploads = m_lastDrainUploads;
+    return stats;
+}
@@ -0,0 +1,83 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/mapmanager/chunks/ChunkDecodeQueue.h
+ *****************************************************************************/
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "ChunkTypes.h"
+
+// Worker pool for the CPU half of chunk loading (conversion into ChunkPixels) plus
+// a main-thread upload queue drained under a per-frame budget.
+// No D3D / RenderWare dependency: the decode and release steps are supplied by the caller.
+class ChunkDecodeQueue
+{
+public:
+    using DecodeFunc  = std::function<bool(ChunkPixels&)>;  // worker thread
+    using ReleaseFunc = std::function<void()>;              // DrainUploads / Stop thread, after the job is done
+
+    static const int MAX_WORKERS = 4;
+
+    struct Stats
+    {
+        int          queued;            // waiting for a worker
+        int          decoding;
+        int          ready;             // decoded, waiting for upload
+        int          uploadedTotal;
+        int          failedTotal;
+        unsigned int lastDrainMicros;
+        int          lastDrainUploads;
+    };
+
+    ChunkDecodeQueue();
+    ~ChunkDecodeQueue();
+
+    // workerCount <= 0: hardware_concurrency - 1, clamped to 1..MAX_WORKERS
+    bool Start(int workerCount = 0);
+    // Drops queued and ready jobs (release is still called) and joins the workers
+    void Stop();
+    bool IsRunning() const { return !m_workers.empty(); }
+
+    bool Submit(int index, DecodeFunc decode, ReleaseFunc release);
+
+    // Uploads finished jobs until maxUploads or maxMicros is reached (0 = no limit).
+    // At least one job is uploaded per call when one is ready. Returns the number of uploads.
+    int  DrainUploads(IChunkUploader& uploader, int maxUploads, unsigned int maxMicros);
+
+    // Blocks until no job is queued or decoding
+    void WaitIdle();
+
+    int   GetInFlightCount() const;
+    Stats GetStats() const;
+
+private:
+    struct Job
+    {
+        int         index;
+        bool        decoded;
+        DecodeFunc  decode;
+        ReleaseFunc release;
+        ChunkPixels pixels;
+    };
+
+    void WorkerMain();
+
+    std::vector<std::thread>    m_workers;
+    mutable std::mutex          m_mutex;
+    std::condition_variable     m_jobAvailable;
+    std::condition_variable     m_jobDone;
+    std::deque<Job>             m_queued;
+    std::deque<Job>             m_ready;
+    int                         m_decoding;
+    bool                        m_stopping;
+    int                         m_uploadedTotal;
+    int                         m_failedTotal;
+    unsigned int                m_lastDrainMicros;
+    int                         m_lastDrainUploads;
+};
@@ -0,0 +1,47 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/mapmanager/chunks/ChunkGrid.cpp
+ *****************************************************************************/
+
+#include "ChunkGrid.h"
+#include <algorithm>
+#include <cmath>
+
+static bool ClampRange(int size, int& rowMin, int& rowMax, int& colMin, int& colMax)
+{
+    colMin = (std::max)(colMin, 0);
+    rowMin = (std::max)(rowMin, 0);
+    colMax = (std::min)(colMax, size - 1);
+    rowMax = (std::min)(rowMax, size - 1);
+    return colMin <= colMax && rowMin <= rowMax;
+}
+
+bool ChunkGrid::GetRangeInRadius(float x, float y, float radius, int& rowMin, int& rowMax, int& colMin, int& colMax) const
+{
+    if (size <= 0)
+        return false;
+
+    const float tileW = GetTileWidth();
+    const float tileH = GetTileHeight();
+    // Chunk center (col + 0.5) * w must fall into [x - radius, x + radius]
+    colMin = (int)ceilf((x - radius - left) / tileW - 0.5f);
+    colMax = (int)floorf((x + radius - left) / tileW - 0.5f);
+    rowMin = (int)ceilf((top - (y + radius)) / tileH - 0.5f);
+    rowMax = (int)floorf((top - (y - radius)) / tileH - 0.5f);
+    return ClampRange(size, rowMin, rowMax, colMin, colMax);
+}
+
+bool ChunkGrid::GetRangeInRect(float minX, float minY, float maxX, float maxY, int& rowMin, int& rowMax, int& colMin, int& colMax) const
+{
+    if (size <= 0)
+        return false;
+
+    const float tileW = GetTileWidth();
+    const float tileH = GetTileHeight();
+    // Tile col spans [left + col * w, left + (col + 1) * w]
+    colMin = (int)floorf((minX - left) / tileW);
+    colMax = (int)floorf((maxX - left) / tileW);
+    rowMin = (int)floorf((top - maxY) / tileH);
+    rowMax = (int)floorf((top - minY) / tileH);
+    return ClampRange(size, rowMin, rowMax, colMin, colMax);
+}
@@ -0,0 +1,32 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/mapmanager/chunks/ChunkGrid.h
+ *****************************************************************************/
+
+#pragma once
+
+// size x size map tiles over the radar space rectangle starting at (left, top); rows grow downwards from top,
+// tile index = row * size + col. Turns a circle or rectangle into the inclusive row / column range that can
+// touch it, so callers visit candidate tiles only, still in index order.
+struct ChunkGrid
+{
+    float left;
+    float top;
+    float width;
+    float height;
+    int   size;
+
+    float GetTileWidth() const { return width / size; }
+    float GetTileHeight() const { return height / size; }
+    void  GetTileCenter(int row, int col, float& outX, float& outY) const
+    {
+        outX = left + (col + 0.5f) * GetTileWidth();
+        outY = top - (row + 0.5f) * GetTileHeight();
+    }
+
+    // Tiles whose centers can lie within radius of (x, y): the box around the circle, callers still test the distance.
+    // false if empty (off the map or size <= 0).
+    bool GetRangeInRadius(float x, float y, float radius, int& rowMin, int& rowMax, int& colMin, int& colMax) const;
+    // Tiles overlapping the rectangle
+    bool GetRangeInRect(float minX, float minY, float maxX, float maxY, int& rowMin, int& rowMax, int& colMin, int& colMax) const;
+};
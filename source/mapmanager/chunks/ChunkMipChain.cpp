@@ -0,0 +1,199 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/mapmanager/chunks/ChunkMipChain.cpp
+ *****************************************************************************/
+
+#include "ChunkMipChain.h"
+#include <cstring>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define CHUNK_MIP_SSE2 1
+#endif
+
+int ChunkMipChain::CountLevels(int width, int height)
+{
+    int size = (width > height) ? width : height;
+    int levels = 1;
+    while (size > 1)
+    {
+        size >>= 1;
+        ++levels;
+    }
+    return levels;
+}
+
+int ChunkMipChain::LevelWidth(int width, int level)
+{
+    int w = width >> level;
+    return (w > 0) ? w : 1;
+}
+
+int ChunkMipChain::LevelHeight(int height, int level)
+{
+    int h = height >> level;
+    return (h > 0) ? h : 1;
+}
+
+size_t ChunkMipChain::LevelRowBytes(int width, int level, ChunkFormat format)
+{
+    int w = LevelWidth(width, level);
+    switch (format)
+    {
+    case CHUNK_FORMAT_DXT1: return (size_t)((w + 3) / 4) * 8;
+    case CHUNK_FORMAT_DXT5: return (size_t)((w + 3) / 4) * 16;
+    default:                return (size_t)w * 4;
+    }
+}
+
+int ChunkMipChain::LevelRows(int height, int level, ChunkFormat format)
+{
+    int h = LevelHeight(height, level);
+    return (format == CHUNK_FORMAT_BGRA8) ? h : (h + 3) / 4;
+}
+
+size_t ChunkMipChain::LevelSize(int width, int height, int level, ChunkFormat format)
+{
+    return LevelRowBytes(width, level, format) * LevelRows(height, level, format);
+}
+
+size_t ChunkMipChain::LevelOffset(int width, int height, int level, ChunkFormat format)
+{
+    size_t offset = 0;
+    for (int i = 0; i < level; ++i)
+        offset += LevelSize(width, height, i, format);
+    return offset;
+}
+
+size_t ChunkMipChain::ChainSize(int width, int height, int levels, ChunkFormat format)
+{
+    return LevelOffset(width, height, levels, format);
+}
+
+bool ChunkMipChain::Build(ChunkPixels& pixels, int maxLevels)
+{
+    const int w = pixels.width;
+    const int h = pixels.height;
+    if (w <= 0 || h <= 0 || pixels.format != CHUNK_FORMAT_BGRA8 || pixels.pitch != w * 4 || pixels.data.size() < LevelSize(w, h, 0))
+        return false;
+
+    int levels = CountLevels(w, h);
+    if (maxLevels > 0 && levels > maxLevels)
+        levels = maxLevels;
+
+    pixels.data.resize(ChainSize(w, h, levels));
+    for (int level = 1; level < levels; ++level)
+    {
+        const uint8_t* src = pixels.data.data() + LevelOffset(w, h, level - 1);
+        uint8_t* dst = pixels.data.data() + LevelOffset(w, h, level);
+        Downsample(src, LevelWidth(w, level - 1), LevelHeight(h, level - 1), dst);
+    }
+    pixels.levels = levels;
+    return true;
+}
+
+bool ChunkMipChain::BuildCell(const ChunkPixels& tile, int gutter, int maxLevels, ChunkPixels& outCell)
+{
+    const int w = tile.width;
+    const int h = tile.height;
+    if (w <= 0 || h <= 0 || gutter <= 0 || tile.format != CHUNK_FORMAT_BGRA8 || tile.gutter != 0 ||
+        tile.pitch < w * 4 || tile.data.size() < (size_t)tile.pitch * (h - 1) + (size_t)w * 4)
+        return false;
+
+    const int cellW = w + 2 * gutter;
+    const int cellH = h + 2 * gutter;
+    outCell.width = cellW;
+    outCell.height = cellH;
+    outCell.pitch = cellW * 4;
+    outCell.levels = 1;
+    outCell.format = CHUNK_FORMAT_BGRA8;
+    outCell.gutter = gutter;
+    outCell.data.resize(LevelSize(cellW, cellH, 0));
+
+    for (int y = 0; y < cellH; ++y)
+    {
+        int srcY = y - gutter;
+        srcY = (srcY < 0) ? 0 : (srcY >= h ? h - 1 : srcY);
+        const uint8_t* src = tile.data.data() + (size_t)srcY * tile.pitch;
+        uint8_t* dst = outCell.data.data() + (size_t)y * outCell.pitch;
+        for (int x = 0; x < gutter; ++x)
+        {
+            memcpy(dst + x * 4, src, 4);
+            memcpy(dst + (size_t)(gutter + w + x) * 4, src + (size_t)(w - 1) * 4, 4);
+        }
+        memcpy(dst + (size_t)gutter * 4, src, (size_t)w * 4);
+    }
+    return Build(outCell, maxLevels);
+}
+
+void ChunkMipChain::Downsample(const uint8_t* src, int srcW, int srcH, uint8_t* dst)
+{
+    const int dstW = (srcW > 1) ? srcW / 2 : 1;
+    const int dstH = (srcH > 1) ? srcH / 2 : 1;
+
+#ifdef CHUNK_MIP_SSE2
+    if ((srcW & 1) == 0 && dstW >= 4)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i round = _mm_set1_epi16(2);
+        const int simdW = dstW & ~3;
+        for (int y = 0; y < dstH; ++y)
+        {
+            int sy1 = (2 * y + 1 < srcH) ? 2 * y + 1 : srcH - 1;
+            const uint8_t* row0 = src + (size_t)(2 * y) * srcW * 4;
+            const uint8_t* row1 = src + (size_t)sy1 * srcW * 4;
+            uint8_t* out = dst + (size_t)y * dstW * 4;
+
+            // 8 source pixels -> 4 destination pixels per iteration
+            for (int x = 0; x < simdW; x += 4)
+            {
+                __m128i a0 = _mm_loadu_si128((const __m128i*)(row0 + x * 8));
+                __m128i a1 = _mm_loadu_si128((const __m128i*)(row0 + x * 8 + 16));
+                __m128i b0 = _mm_loadu_si128((const __m128i*)(row1 + x * 8));
+                __m128i b1 = _mm_loadu_si128((const __m128i*)(row1 + x * 8 + 16));
+
+                // Vertical sums, 16 bits per channel: lo = pixels 0,1  hi = pixels 2,3
+                __m128i v0lo = _mm_add_epi16(_mm_unpacklo_epi8(a0, zero), _mm_unpacklo_epi8(b0, zero));
+                __m128i v0hi = _mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(b0, zero));
+                __m128i v1lo = _mm_add_epi16(_mm_unpacklo_epi8(a1, zero), _mm_unpacklo_epi8(b1, zero));
+                __m128i v1hi = _mm_add_epi16(_mm_unpackhi_epi8(a1, zero), _mm_unpackhi_epi8(b1, zero));
+
+                // Horizontal pairs: [p0 p2] + [p1 p3]
+                __m128i s0 = _mm_add_epi16(_mm_unpacklo_epi64(v0lo, v0hi), _mm_unpackhi_epi64(v0lo, v0hi));
+                __m128i s1 = _mm_add_epi16(_mm_unpacklo_epi64(v1lo, v1hi), _mm_unpackhi_epi64(v1lo, v1hi));
+                s0 = _mm_srli_epi16(_mm_add_epi16(s0, round), 2);
+                s1 = _mm_srli_epi16(_mm_add_epi16(s1, round), 2);
+
+                _mm_storeu_si128((__m128i*)(out + x * 4), _mm_packus_epi16(s0, s1));
+            }
+        }
+        if (simdW < dstW)
+            DownsampleScalar(src, srcW, srcH, dst, dstW, dstH, simdW);
+        return;
+    }
+#endif
+    DownsampleScalar(src, srcW, srcH, dst, dstW, dstH, 0);
+}
+
+void ChunkMipChain::DownsampleScalar(const uint8_t* src, int srcW, int srcH, uint8_t* dst, int dstW, int dstH, int firstX)
+{
+    for (int y = 0; y < dstH; ++y)
+    {
+        int sy0 = (2 * y < srcH) ? 2 * y : srcH - 1;
+        int sy1 = (2 * y + 1 < srcH) ? 2 * y + 1 : srcH - 1;
+        const uint8_t* row0 = src + (size_t)sy0 * srcW * 4;
+        const uint8_t* row1 = src + (size_t)sy1 * srcW * 4;
+        uint8_t* out = dst + (size_t)y * dstW * 4;
+
+        for (int x = firstX; x < dstW; ++x)
+        {
+            int sx0 = (2 * x < srcW) ? 2 * x : srcW - 1;
+            int sx1 = (2 * x + 1 < srcW) ? 2 * x + 1 : srcW - 1;
+            for (int c = 0; c < 4; ++c)
+            {
+                int sum = row0[sx0 * 4 + c] + row0[sx1 * 4 + c] + row1[sx0 * 4 + c] + row1[sx1 * 4 + c];
+                out[x * 4 + c] = (uint8_t)((sum + 2) >> 2);
+            }
+        }
+    }
+}
@@ -0,0 +1,41 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/mapmanager/chunks/ChunkMipChain.h
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "ChunkTypes.h"
+
+// Full mip chain for chunk pixels: 2x2 box filter with rounding, SSE2 on even-sized levels.
+// Straight (non-premultiplied) 8-bit BGRA in, same out.
+class ChunkMipChain
+{
+public:
+    static int    CountLevels(int width, int height);
+    static int    LevelWidth(int width, int level);
+    static int    LevelHeight(int height, int level);
+    // Byte offset / size of a level inside ChunkPixels::data (tightly packed rows)
+    static size_t LevelOffset(int width, int height, int level, ChunkFormat format = CHUNK_FORMAT_BGRA8);
+    static size_t LevelSize(int width, int height, int level, ChunkFormat format = CHUNK_FORMAT_BGRA8);
+    static size_t ChainSize(int width, int height, int levels, ChunkFormat format = CHUNK_FORMAT_BGRA8);
+    // Bytes per row and row count of a level; block rows (4 texels high) for DXT formats
+    static size_t LevelRowBytes(int width, int level, ChunkFormat format = CHUNK_FORMAT_BGRA8);
+    static int    LevelRows(int height, int level, ChunkFormat format = CHUNK_FORMAT_BGRA8);
+
+    // Appends levels 1..N-1 after level 0. Level 0 rows must be tightly packed (pitch == width * 4).
+    // maxLevels <= 0: down to 1x1.
+    static bool   Build(ChunkPixels& pixels, int maxLevels = 0);
+
+    // Atlas cell: level 0 of a plain BGRA8 tile surrounded by gutter copies of its edge texels, then Build(maxLevels).
+    // Filtering and mips inside the gutter never reach the neighbouring cells.
+    static bool   BuildCell(const ChunkPixels& tile, int gutter, int maxLevels, ChunkPixels& outCell);
+
+    // One level: dst is max(1, srcW / 2) x max(1, srcH / 2), edge texels clamped for odd sizes
+    static void   Downsample(const uint8_t* src, int srcW, int srcH, uint8_t* dst);
+
+private:
+    static void   DownsampleScalar(const uint8_t* src, int srcW, int srcH, uint8_t* dst, int dstW, int dstH, int firstX);
+};
@@ -0,0 +1,81 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/mapmanager/chunks/ChunkPageWalker.cpp
+ *****************************************************************************/
+
+#include "ChunkPageWalker.h"
+#include <algorithm>
+#include <cmath>
+#include "RadarGeometry.h"
+
+ChunkPageWalker::ChunkPageWalker()
+    : m_gridSize(0)
+    , m_mapLeft(0.0f)
+    , m_mapTop(0.0f)
+    , m_mapWidth(0.0f)
+    , m_mapHeight(0.0f)
+    , m_pagesDrawn(0)
+    , m_pageMisses(0)
+    , m_finestLevel(0)
+    , m_skippedDraws(0)
+{
+}
+
+void ChunkPageWalker::SetLayout(int gridSize, float left, float top, float width, float height)
+{
+    m_gridSize = gridSize;
+    m_mapLeft = left;
+    m_mapTop = top;
+    m_mapWidth = width;
+    m_mapHeight = height;
+    m_pagesDrawn = 0;
+    m_pageMisses = 0;
+    m_finestLevel = 0;
+    m_skippedDraws = 0;
+}
+
+int ChunkPageWalker::GetTopLevel(const IChunkPageSource& source)
+{
+    int level = 0;
+    while (level < ChunkPyramid::MAX_LEVELS && source.IsLevelComplete(level + 1))
+        ++level;
+    return level;
+}
+
+bool ChunkPageWalker::IsPageVisible(const View& view, float minX, float minY, float maxX, float maxY, float& outDistSq) const
+{
+    // Same culling as ForEachChunkInRadius, at this level's tile size
+    const float width = maxX - minX, height = maxY - minY;
+    const float dx = (minX + maxX) * 0.5f - view.cameraX, dy = (minY + maxY) * 0.5f - view.cameraY;
+    const float radius = view.visibleRadius + 0.5f * sqrtf(width * width + height * height);
+    outDistSq = dx * dx + dy * dy;
+    if (outDistSq > radius * radius)
+        return false;
+    return !view.footprint || RadarGeometry::FootprintOverlapsRect(*view.footprint, minX, minY, maxX, maxY);
+}
+
+int ChunkPageWalker::RequiredLevel(const View& view, float minX, float minY, float maxX, float maxY) const
+{
+    // Texels are largest on screen at the point of the tile nearest to the camera
+    float dx = (std::max)((std::max)(minX - view.cameraX, view.cameraX - maxX), 0.0f);
+    float dy = (std::max)((std::max)(minY - view.cameraY, view.cameraY - maxY), 0.0f);
+    float distance = sqrtf(dx * dx + dy * dy + view.cameraZ * view.cameraZ);
+    float texelsPerPixel = distance * view.pixelSizePerDistance / view.texelSize;
+
+    // Same thresholds as MapChunkManager::SelectLodLevel, which uses the distance straight down
+    int level = 0;
+    while (level < view.maxLevel && texelsPerPixel >= (float)(2 << level))
+        ++level;
+    return level;
+}
+
+ChunkRect ChunkPageWalker::ChildRegion(const ChunkRect& region, int childCol, int childRow)
+{
+    // Rows grow southwards like v
+    const float halfU = (region.u1 - region.u0) * 0.5f;
+    const float halfV = (region.v1 - region.v0) * 0.5f;
+    const float u0 = region.u0 + halfU * childCol;
+    const float v0 = region.v0 + halfV * childRow;
+    const ChunkRect child = { u0, v0, u0 + halfU, v0 + halfV };
+    return child;
+}
@@ -0,0 +1,197 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/mapmanager/chunks/ChunkPageWalker.h
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include "ChunkPyramid.h"
+
+struct RadarFootprint;
+
+// Texture of the page source, opaque to the walk; 0 = none
+typedef uintptr_t ChunkTextureId;
+
+// Texture coordinates of a tile inside its texture (atlas cell or the part of an ancestor tile)
+struct ChunkRect
+{
+    float u0, v0, u1, v1;
+};
+
+// One tile of a level as the page source holds it
+struct ChunkPage
+{
+    ChunkTextureId texture;     // 0: level 0 chunk not resident, or coarse tile without data
+    ChunkRect      region;
+    int            tileId;      // placed tile, -1 = none
+};
+
+// One tile drawn by the walk, radar space
+struct ChunkPageDraw
+{
+    int            level;       // level whose grid index is in
+    int            index;
+    float          centerX;
+    float          centerY;
+    float          width;
+    float          height;
+    ChunkTextureId texture;
+    ChunkRect      region;
+};
+
+// What the page walk reads from the owner of the tiles and reports back to it; main thread
+class IChunkPageSource
+{
+public:
+    virtual ~IChunkPageSource() {}
+    // Every tile of the coarse level is uploaded (empty ones included)
+    virtual bool      IsLevelComplete(int level) const = 0;
+    virtual ChunkPage GetPage(int level, int index) const = 0;
+    // Level 0 chunk missing in the source or failed to convert
+    virtual bool      IsChunkUnavailable(int index) const = 0;
+    // Solid tile in the render target clear colour: nothing to draw
+    virtual bool      IsBackgroundTile(int tileId) const = 0;
+    // Level 0 chunk needed this frame: not resident (distSq from the camera) or drawn
+    virtual void      OnChunkMissing(int index, float distSq) = 0;
+    virtual void      OnChunkDrawn(int index) = 0;
+};
+
+// MapVirtual: pyramid levels used as page tables. From the coarsest complete level down to the level 0 tiles the
+// camera footprint needs, each tile is drawn at the level its texels need on screen; a tile whose level is not
+// resident is drawn from the matching part of its nearest resident ancestor.
+// No device types: MapChunkManager turns texture ids and rects back into its D3D ones.
+class ChunkPageWalker
+{
+public:
+    // Camera of the current frame
+    struct View
+    {
+        float       cameraX;
+        float       cameraY;
+        float       cameraZ;                // height above the tile plane
+        float       visibleRadius;
+        float       pixelSizePerDistance;   // world size of a render target pixel per unit of camera distance
+        float       texelSize;              // world size of a level 0 texel
+        int         maxLevel;               // coarsest level with every tile uploaded (GetTopLevel)
+        const RadarFootprint* footprint;    // nullptr: radius only
+    };
+
+    ChunkPageWalker();
+
+    // Level 0 grid in radar space
+    void SetLayout(int gridSize, float left, float top, float width, float height);
+
+    // Levels are used from the bottom up: a missing coarse tile must mean "no data", not "not uploaded yet"
+    static int GetTopLevel(const IChunkPageSource& source);
+
+    // Visits the view.maxLevel tiles in rows [rowMin, rowMax], columns [colMin, colMax] and their descendants;
+    // callback(const ChunkPageDraw&) for every tile to draw
+    template<typename F>
+    void Walk(IChunkPageSource& source, const View& view, int rowMin, int rowMax, int colMin, int colMax, F& callback);
+
+    int  GetPagesDrawn() const { return m_pagesDrawn; }
+    int  GetPageMisses() const { return m_pageMisses; }     // drawn from a coarser level: the needed one was not resident
+    int  GetFinestLevel() const { return m_finestLevel; }   // finest level drawn by the last walk
+    int  GetSkippedDraws() const { return m_skippedDraws; } // background tiles left out by the last walk
+
+    // Part of a tile's region covering one of its four children
+    static ChunkRect ChildRegion(const ChunkRect& region, int childCol, int childRow);
+
+private:
+    template<typename F>
+    void VisitPage(IChunkPageSource& source, const View& view, int level, int row, int col, ChunkTextureId fallbackTex,
+                   const ChunkRect& fallbackRegion, F& callback);
+    // Radius and footprint test; distSq from the camera to the tile center
+    bool IsPageVisible(const View& view, float minX, float minY, float maxX, float maxY, float& outDistSq) const;
+    int  RequiredLevel(const View& view, float minX, float minY, float maxX, float maxY) const;
+
+    int                 m_gridSize;
+    float               m_mapLeft;
+    float               m_mapTop;
+    float               m_mapWidth;
+    float               m_mapHeight;
+    int                 m_pagesDrawn;
+    int                 m_pageMisses;
+    int                 m_finestLevel;
+    int                 m_skippedDraws;
+};
+
+template<typename F>
+void ChunkPageWalker::Walk(IChunkPageSource& source, const View& view, int rowMin, int rowMax, int colMin, int colMax, F& callback)
+{
+    m_pagesDrawn = 0;
+    m_pageMisses = 0;
+    m_finestLevel = view.maxLevel;
+    m_skippedDraws = 0;
+
+    const ChunkRect noRegion = { 0.0f, 0.0f, 1.0f, 1.0f };
+    for (int row = rowMin; row <= rowMax; ++row)
+        for (int col = colMin; col <= colMax; ++col)
+            VisitPage(source, view, view.maxLevel, row, col, 0, noRegion, callback);
+}
+
+template<typename F>
+void ChunkPageWalker::VisitPage(IChunkPageSource& source, const View& view, int level, int row, int col,
+                                ChunkTextureId fallbackTex, const ChunkRect& fallbackRegion, F& callback)
+{
+    const int gridSize = m_gridSize >> level;
+    const float pageWidth = m_mapWidth / gridSize;
+    const float pageHeight = m_mapHeight / gridSize;
+    const float minX = m_mapLeft + col * pageWidth;
+    const float maxY = m_mapTop - row * pageHeight;
+
+    float distSq;
+    if (!IsPageVisible(view, minX, maxY - pageHeight, minX + pageWidth, maxY, distSq))
+        return;
+
+    const int index = row * gridSize + col;
+    ChunkPage page = source.GetPage(level, index);
+    if (level > 0)
+    {
+        if (!page.texture)
+            return;  // levels up to maxLevel are complete: none of the merged chunks exist
+
+        if (RequiredLevel(view, minX, maxY - pageHeight, minX + pageWidth, maxY) < level)
+        {
+            // Finer level needed: this tile stands in for whichever children are not resident
+            for (int child = 0; child < 4; ++child)
+            {
+                const int childCol = child & 1;
+                const int childRow = child >> 1;
+                VisitPage(source, view, level - 1, row * 2 + childRow, col * 2 + childCol, page.texture,
+                          ChildRegion(page.region, childCol, childRow), callback);
+            }
+            return;
+        }
+    }
+    else if (!page.texture)
+    {
+        if (source.IsChunkUnavailable(index))
+            return;
+        source.OnChunkMissing(index, distSq);
+        ++m_pageMisses;
+        if (!fallbackTex)
+            return;
+        page.texture = fallbackTex;
+        page.region = fallbackRegion;
+        page.tileId = -1;
+    }
+    else
+    {
+        source.OnChunkDrawn(index);
+    }
+
+    ++m_pagesDrawn;
+    if (level < m_finestLevel)
+        m_finestLevel = level;
+    if (source.IsBackgroundTile(page.tileId))
+    {
+        ++m_skippedDraws;
+        return;
+    }
+
+    const ChunkPageDraw draw = { level, index, minX + pageWidth * 0.5f, maxY - pageHeight * 0.5f, pageWidth, pageHeight,
+                                 page.texture, page.region };
+    callback(draw);
+}
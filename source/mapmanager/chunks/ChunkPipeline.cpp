@@ -0,0 +1,45 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/mapmanager/chunks/ChunkPipeline.cpp
+ *****************************************************************************/
+
+#include "ChunkPipeline.h"
+#include "ChunkMipChain.h"
+#include "ChunkCompress.h"
+#include "ChunkContent.h"
+
+bool ChunkPipeline::FinishBaseChunk(ChunkPixels& pixels, int index, ChunkPyramid& pyramid, ChunkCacheWriter& cacheWriter, bool compress, int gutter)
+{
+    // Full mip chain: Image3D samples with linear mip filtering, tiles are heavily minified from the air
+    if (!ChunkMipChain::Build(pixels))
+        return false;
+    pyramid.Contribute(index, pixels);  // needs the plain BGRA8 tile, before padding and compression
+    uint32_t solidColor;
+    const bool solid = ChunkContent::IsUniform(pixels, solidColor);
+    if (gutter > 0)
+    {
+        ChunkPixels cell = {};
+        if (!ChunkMipChain::BuildCell(pixels, gutter, ATLAS_LEVELS, cell))
+            return false;
+        pixels = std::move(cell);
+    }
+    if (compress)
+        ChunkCompress::Compress(pixels);
+    pixels.solid = solid;
+    pixels.solidColor = solidColor;
+    pixels.hash = ChunkContent::Hash(pixels);
+    cacheWriter.Write(0, index, pixels);
+    return true;
+}
+
+bool ChunkPipeline::PopCoarseTile(ChunkPyramid& pyramid, ChunkCacheWriter& cacheWriter, int& level, int& index, ChunkPixels& out)
+{
+    if (!pyramid.PopCompleted(level, index, out))
+        return false;
+    // Empty pixels: none of the merged chunks exist, the tile stays transparent
+    if (out.data.empty())
+        cacheWriter.Skip(level, index);
+    else
+        cacheWriter.Write(level, index, out);
+    return true;
+}
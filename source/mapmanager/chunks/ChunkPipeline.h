@@ -0,0 +1,26 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/mapmanager/chunks/ChunkPipeline.h
+ *****************************************************************************/
+
+#pragma once
+
+#include "ChunkTypes.h"
+#include "ChunkCache.h"
+#include "ChunkPyramid.h"
+
+// Decoded base chunk -> the payload that is uploaded and cached. Shared by MapChunkManager and the
+// map cache tool (tests/tools), so a cache built offline is byte-identical to one built in game.
+class ChunkPipeline
+{
+public:
+    static const int ATLAS_GUTTER = 16;     // MapAtlas: replicated edge texels around each tile
+    static const int ATLAS_LEVELS = 4;      // MapAtlas: mips per cell; the gutter is still 2 texels at the last one
+
+    // pixels: plain BGRA8 level 0. Builds the mip chain, contributes to the pyramid, pads into an atlas cell
+    // (gutter > 0), DXT compresses, analyses the content and records the result in the cache writer.
+    static bool FinishBaseChunk(ChunkPixels& pixels, int index, ChunkPyramid& pyramid, ChunkCacheWriter& cacheWriter, bool compress, int gutter);
+
+    // Hands finished coarse tiles to the cache writer (empty ones as skipped); false when none is waiting
+    static bool PopCoarseTile(ChunkPyramid& pyramid, ChunkCacheWriter& cacheWriter, int& level, int& index, ChunkPixels& out);
+};
@@ -0,0 +1,90 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/mapmanager/chunks/ChunkPrefetch.cpp
+ *****************************************************************************/
+
+#include "ChunkPrefetch.h"
+#include <cmath>
+
+const float ChunkPrefetch::MIN_SPEED = 1.0f;
+const float ChunkPrefetch::YAW_FOLLOW_SECONDS = 1.0f;
+
+ChunkPrefetch::ChunkPrefetch()
+    : m_hits(0)
+    , m_late(0)
+    , m_unused(0)
+{
+}
+
+int ChunkPrefetch::PredictPath(const Motion& motion, float lookAheadSeconds, Sample* outSamples)
+{
+    if (!(lookAheadSeconds > 0.0f) || motion.velX * motion.velX + motion.velY * motion.velY < MIN_SPEED * MIN_SPEED)
+        return 0;
+
+    // Yaw convention of CameraController: atan2(forward.x, forward.y); turn the short way round
+    const float pi = 3.14159265f;
+    float turn = atan2f(motion.velX, motion.velY) - motion.yaw;
+    turn -= 2.0f * pi * floorf((turn + pi) / (2.0f * pi));
+
+    for (int step = 1; step <= STEPS; ++step)
+    {
+        const float t = lookAheadSeconds * (float)step / (float)STEPS;
+        const float yaw = motion.yaw + turn * (1.0f - expf(-t / YAW_FOLLOW_SECONDS));
+        // GetCachedCalculations: offset from sin / cos of the inverted yaw
+        Sample& sample = outSamples[step - 1];
+        sample.x = motion.playerX + motion.velX * t + motion.offsetY * sinf(-yaw);
+        sample.y = motion.playerY + motion.velY * t - motion.offsetY * cosf(-yaw);
+        sample.z = motion.height;
+        sample.seconds = t;
+    }
+    return STEPS;
+}
+
+void ChunkPrefetch::Reset(int chunkCount)
+{
+    m_requested.assign(chunkCount, false);
+    m_unseen.assign(chunkCount, false);
+    m_lateCounted.assign(chunkCount, false);
+    m_hits = 0;
+    m_late = 0;
+    m_unused = 0;
+}
+
+void ChunkPrefetch::Clear()
+{
+    m_requested.clear();
+    m_unseen.clear();
+    m_lateCounted.clear();
+}
+
+void ChunkPrefetch::NoteResident(int index)
+{
+    m_unseen[index] = m_requested[index];
+    m_requested[index] = false;
+    m_lateCounted[index] = false;
+}
+
+void ChunkPrefetch::NoteMissing(int index)
+{
+    if (m_lateCounted[index])
+        return;
+    m_lateCounted[index] = true;
+    m_requested[index] = false;
+    ++m_late;
+}
+
+void ChunkPrefetch::NoteDrawn(int index)
+{
+    if (!m_unseen[index])
+        return;
+    m_unseen[index] = false;
+    ++m_hits;
+}
+
+void ChunkPrefetch::NoteUnloaded(int index)
+{
+    if (!m_unseen[index])
+        return;
+    m_unseen[index] = false;
+    ++m_unused;
+}
@@ -0,0 +1,70 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/mapmanager/chunks/ChunkPrefetch.h
+ *****************************************************************************/
+
+#pragma once
+
+#include <vector>
+
+// Predictive prefetch: the radar camera positions ahead on the player's path, and the hit / late / unused
+// bookkeeping of level 0 chunks requested for them. The owner does the requests and uploads; main thread only.
+class ChunkPrefetch
+{
+public:
+    static const int   STEPS = 4;                   // predicted camera positions sampled over the look-ahead time
+    static const float MIN_SPEED;                   // units per second; slower movement is not extrapolated
+    static const float YAW_FOLLOW_SECONDS;          // the game camera swings round to the direction of travel
+
+    // CameraController state, radar space
+    struct Motion
+    {
+        float playerX;
+        float playerY;
+        float velX;         // units per second
+        float velY;
+        float yaw;          // CameraState::yaw
+        float offsetY;      // camera offset along the view direction
+        float height;       // camera height
+    };
+
+    // Radar camera position after `seconds`, as CameraController::GetCachedCalculations would give it
+    struct Sample
+    {
+        float x;
+        float y;
+        float z;
+        float seconds;
+    };
+
+    ChunkPrefetch();
+
+    // The player keeps its velocity and the camera its offset and height; the yaw eases toward the heading of
+    // travel. Fills STEPS samples evenly over (0, lookAheadSeconds]; 0 when too slow or no look-ahead.
+    static int PredictPath(const Motion& motion, float lookAheadSeconds, Sample* outSamples);
+
+    // Per level 0 chunk, counters cleared
+    void Reset(int chunkCount);
+    void Clear();
+
+    // Requested for a predicted position (not in view yet)
+    void NoteRequested(int index) { m_requested[index] = true; }
+    // Uploaded: a hit if the prefetch got it there before it was needed
+    void NoteResident(int index);
+    // Needed in view while not resident: late, once per residency, even if a prefetch is under way
+    void NoteMissing(int index);
+    void NoteDrawn(int index);
+    void NoteUnloaded(int index);
+
+    int  GetHits() const { return m_hits; }       // prefetched tiles that were resident when first drawn
+    int  GetLate() const { return m_late; }       // tiles needed on screen before they were resident
+    int  GetUnused() const { return m_unused; }   // prefetched tiles evicted without being drawn
+
+private:
+    std::vector<bool>   m_requested;    // last request came from the prefetch
+    std::vector<bool>   m_unseen;       // resident through a prefetch, not drawn yet
+    std::vector<bool>   m_lateCounted;  // needed while not resident, counted once per residency
+    int                 m_hits;
+    int                 m_late;
+    int                 m_unused;
+};
@@ -0,0 +1,195 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/mapmanager/chunks/ChunkPyramid.cpp
+ *****************************************************************************/
+
+#include "ChunkPyramid.h"
+#include "ChunkMipChain.h"
+#include "ChunkCompress.h"
+#include "ChunkContent.h"
+#include <cstring>
+
+ChunkPyramid::ChunkPyramid()
+    : m_baseGrid(0)
+    , m_levelCount(0)
+    , m_tileSize(0)
+    , m_contributedCount(0)
+    , m_compress(false)
+    , m_cellGutter(0)
+    , m_cellLevels(0)
+{
+}
+
+void ChunkPyramid::Reset(int baseGrid, int levelCount)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_baseGrid = (baseGrid > 0) ? baseGrid : 0;
+    m_levelCount = 0;
+    m_tileSize = 0;
+    for (int level = 1; level <= MAX_LEVELS; ++level)
+    {
+        m_tiles[level].clear();
+        if (level > levelCount || m_baseGrid == 0 || (m_baseGrid % (1 << level)) != 0)
+            continue;
+        if (m_levelCount == level - 1)
+        {
+            m_tiles[level].resize((size_t)GetTileCount(level));
+            for (auto& tile : m_tiles[level])
+            {
+                tile.pixels = {};
+                tile.contributed = 0;
+            }
+            m_levelCount = level;
+        }
+    }
+    m_contributed.assign((size_t)m_baseGrid * m_baseGrid, false);
+    m_contributedCount = 0;
+    m_completed.clear();
+}
+
+void ChunkPyramid::Contribute(int baseIndex, const ChunkPixels& pixels)
+{
+    AddContribution(baseIndex, &pixels);
+}
+
+void ChunkPyramid::MarkMissing(int baseIndex)
+{
+    AddContribution(baseIndex, nullptr);
+}
+
+bool ChunkPyramid::HasContributed(int baseIndex) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return baseIndex >= 0 && baseIndex < (int)m_contributed.size() && m_contributed[baseIndex];
+}
+
+int ChunkPyramid::GetContributedCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_contributedCount;
+}
+
+void ChunkPyramid::AddContribution(int baseIndex, const ChunkPixels* pixels)
+{
+    std::vector<Completed> finished;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_levelCount == 0 || baseIndex < 0 || baseIndex >= (int)m_contributed.size() || m_contributed[baseIndex])
+            return;
+        m_contributed[baseIndex] = true;
+        ++m_contributedCount;
+
+        if (pixels && (pixels->format != CHUNK_FORMAT_BGRA8 || pixels->gutter != 0))
+            pixels = nullptr;  // nothing to blit from; the area stays transparent
+        if (pixels && m_tileSize == 0 && pixels->width == pixels->height)
+            m_tileSize = pixels->width;
+
+        int baseRow = baseIndex / m_baseGrid;
+        int baseCol = baseIndex % m_baseGrid;
+        for (int level = 1; level <= m_levelCount; ++level)
+        {
+            int grid = GetGridSize(level);
+            int coarseIndex = (baseRow >> level) * grid + (baseCol >> level);
+            CoarseTile& tile = m_tiles[level][coarseIndex];
+
+            if (pixels && m_tileSize > 0)
+            {
+                if (tile.pixels.data.empty())
+                {
+                    tile.pixels.width = m_tileSize;
+                    tile.pixels.height = m_tileSize;
+                    tile.pixels.pitch = m_tileSize * 4;
+                    tile.pixels.levels = 1;
+                    tile.pixels.format = CHUNK_FORMAT_BGRA8;
+                    tile.pixels.data.assign((size_t)m_tileSize * m_tileSize * 4, 0);
+                }
+                BlitIntoTile(tile, level, baseRow, baseCol, *pixels);
+            }
+
+            int span = 1 << level;
+            if (++tile.contributed == span * span)
+            {
+                Completed done = {};
+                done.level = level;
+                done.index = coarseIndex;
+                done.pixels = std::move(tile.pixels);
+                tile.pixels = {};
+                finished.push_back(std::move(done));
+            }
+        }
+    }
+
+    // Mip chains for finished tiles outside the lock; an all-missing tile is reported with empty pixels
+    for (auto& done : finished)
+    {
+        if (!done.pixels.data.empty())
+        {
+            uint32_t solidColor;
+            const bool solid = ChunkContent::IsUniform(done.pixels, solidColor);
+            bool built;
+            if (m_cellGutter > 0)
+            {
+                ChunkPixels cell = {};
+                built = ChunkMipChain::BuildCell(done.pixels, m_cellGutter, m_cellLevels, cell);
+                done.pixels = std::move(cell);
+            }
+            else
+            {
+                built = ChunkMipChain::Build(done.pixels);
+            }
+            if (!built)
+                done.pixels = {};
+            done.pixels.solid = solid;
+            done.pixels.solidColor = solidColor;
+        }
+        if (m_compress && !done.pixels.data.empty())
+            ChunkCompress::Compress(done.pixels);
+        if (!done.pixels.data.empty())
+            done.pixels.hash = ChunkContent::Hash(done.pixels);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_completed.push_back(std::move(done));
+    }
+}
+
+void ChunkPyramid::BlitIntoTile(CoarseTile& tile, int level, int baseRow, int baseCol, const ChunkPixels& src) const
+{
+    int sub = m_tileSize >> level;
+    if (sub <= 0)
+        return;
+
+    // Source mip level with the size of one sub-square of the coarse tile
+    int srcLevel = -1;
+    for (int l = 0; l < src.levels; ++l)
+    {
+        if (ChunkMipChain::LevelWidth(src.width, l) == sub && ChunkMipChain::LevelHeight(src.height, l) == sub)
+        {
+            srcLevel = l;
+            break;
+        }
+    }
+    if (srcLevel < 0)
+        return;
+
+    int mask = (1 << level) - 1;
+    int dstX = (baseCol & mask) * sub;
+    int dstY = (baseRow & mask) * sub;
+    int srcPitch = (srcLevel == 0) ? src.pitch : sub * 4;
+    const uint8_t* srcBits = src.data.data() + ChunkMipChain::LevelOffset(src.width, src.height, srcLevel);
+    uint8_t* dstBits = tile.pixels.data.data();
+    for (int y = 0; y < sub; ++y)
+        memcpy(dstBits + (size_t)(dstY + y) * tile.pixels.pitch + (size_t)dstX * 4, srcBits + (size_t)y * srcPitch, (size_t)sub * 4);
+}
+
+bool ChunkPyramid::PopCompleted(int& level, int& index, ChunkPixels& out)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_completed.empty())
+        return false;
+    Completed& done = m_completed.front();
+    level = done.level;
+    index = done.index;
+    out = std::move(done.pixels);
+    m_completed.pop_front();
+    return true;
+}
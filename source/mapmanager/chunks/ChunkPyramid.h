@@ -0,0 +1,73 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/mapmanager/chunks/ChunkPyramid.h
+ *****************************************************************************/
+
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <vector>
+#include "ChunkTypes.h"
+
+// Coarse LOD tiles assembled from the mip levels of decoded base chunks.
+// Level L merges 2^L x 2^L base chunks into one tile of the base tile size (12x12 -> 6x6 -> 3x3).
+// CPU only; Contribute is called from decode workers, PopCompleted from the render thread.
+class ChunkPyramid
+{
+public:
+    static const int MAX_LEVELS = 2;
+
+    ChunkPyramid();
+
+    // Drops all state. Levels whose grid would not divide the base grid evenly are not built.
+    void Reset(int baseGrid, int levelCount);
+
+    int  GetLevelCount() const { return m_levelCount; }
+    int  GetGridSize(int level) const { return m_baseGrid >> level; }
+    int  GetTileCount(int level) const { return GetGridSize(level) * GetGridSize(level); }
+
+    // Finished tiles are DXT compressed on the worker (see ChunkCompress)
+    void SetCompression(bool enabled) { m_compress = enabled; }
+    // gutter > 0: finished tiles are padded into atlas cells with at most cellLevels mips (see ChunkMipChain::BuildCell)
+    void SetCellOutput(int gutter, int cellLevels) { m_cellGutter = gutter; m_cellLevels = cellLevels; }
+
+    // Copies the matching mip level of a decoded base chunk (plain BGRA8 tile, full mip chain) into the coarse tiles
+    void Contribute(int baseIndex, const ChunkPixels& pixels);
+    // Base chunk missing from the source: counts as contributed, its area stays transparent
+    void MarkMissing(int baseIndex);
+    bool HasContributed(int baseIndex) const;
+    int  GetContributedCount() const;
+
+    // Finished coarse tile with its own mip chain (empty data if none of its chunks exist); false when none is waiting
+    bool PopCompleted(int& level, int& index, ChunkPixels& out);
+
+private:
+    struct CoarseTile
+    {
+        ChunkPixels pixels;
+        int         contributed;
+    };
+
+    void AddContribution(int baseIndex, const ChunkPixels* pixels);
+    void BlitIntoTile(CoarseTile& tile, int level, int baseRow, int baseCol, const ChunkPixels& src) const;
+
+    mutable std::mutex      m_mutex;
+    int                     m_baseGrid;
+    int                     m_levelCount;
+    int                     m_tileSize;         // taken from the first contributed chunk
+    std::vector<CoarseTile> m_tiles[MAX_LEVELS + 1];
+    std::vector<bool>       m_contributed;
+    int                     m_contributedCount;
+    bool                    m_compress;
+    int                     m_cellGutter;
+    int                     m_cellLevels;
+
+    struct Completed
+    {
+        int         level;
+        int         index;
+        ChunkPixels pixels;
+    };
+    std::deque<Completed>   m_completed;
+};
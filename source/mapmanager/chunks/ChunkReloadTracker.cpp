@@ -0,0 +1,68 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/mapmanager/chunks/ChunkReloadTracker.cpp
+ *****************************************************************************/
+
+#include "ChunkReloadTracker.h"
+
+ChunkReloadTracker::ChunkReloadTracker()
+    : m_pending(0)
+    , m_coarseLeft(0)
+    , m_reloading(false)
+    , m_reloadCount(0)
+    , m_touched(0)
+    , m_checked(0)
+    , m_millis(0)
+{
+}
+
+void ChunkReloadTracker::Begin(std::vector<int>&& chunks, int coarseTiles)
+{
+    m_queue = std::move(chunks);
+    m_pending = 0;
+    m_coarseLeft = coarseTiles;
+    m_checked = 0;
+    m_touched = 0;
+    m_reloading = true;
+}
+
+void ChunkReloadTracker::FinishAll(int tileCount)
+{
+    ++m_reloadCount;
+    m_checked = tileCount;
+    m_touched = tileCount;
+    StopClock();
+}
+
+void ChunkReloadTracker::Cancel()
+{
+    m_queue.clear();
+    m_pending = 0;
+    m_coarseLeft = 0;
+    m_reloading = false;
+}
+
+bool ChunkReloadTracker::PopChunk(int& index)
+{
+    if (m_queue.empty())
+        return false;
+    index = m_queue.back();
+    m_queue.pop_back();
+    return true;
+}
+
+bool ChunkReloadTracker::Finish()
+{
+    if (!m_reloading || !m_queue.empty() || m_pending > 0 || m_coarseLeft > 0)
+        return false;
+
+    m_reloading = false;
+    ++m_reloadCount;
+    StopClock();
+    return true;
+}
+
+void ChunkReloadTracker::StopClock()
+{
+    m_millis = (unsigned int)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_start).count();
+}
@@ -0,0 +1,75 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/mapmanager/chunks/ChunkReloadTracker.h
+ *****************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include "FileWatch.h"
+
+// HotReload bookkeeping: notices a changed source, keeps the chunks still to be decoded from it and counts what
+// the reload changed. The owner swaps the source, decodes and uploads; main thread only.
+class ChunkReloadTracker
+{
+public:
+    ChunkReloadTracker();
+
+    // The source stamp becomes the baseline of the watch
+    void Watch(uint64_t stamp) { m_watch.Reset(stamp); }
+    // True once per change while no reload is running; computeStamp() is called at most once per poll interval
+    template<typename F>
+    bool PollChanged(F&& computeStamp)
+    {
+        return !m_reloading && m_watch.IsPollDue() && m_watch.Update(computeStamp());
+    }
+
+    // The change was noticed: the reload time is measured from here
+    void Start() { m_start = std::chrono::steady_clock::now(); }
+    // chunks: decoded again last to first; coarseTiles: coarse tiles to be rebuilt before the reload is done
+    void Begin(std::vector<int>&& chunks, int coarseTiles);
+    // Nothing could be kept (new layout): every tile counts as changed, the reload is done
+    void FinishAll(int tileCount);
+    // Unfinished reload dropped with the chunks (Cleanup); counters of finished reloads stay
+    void Cancel();
+
+    bool PopChunk(int& index);
+    void OnJobSubmitted() { ++m_pending; }
+    void OnJobDone() { --m_pending; }
+    void OnCoarseRebuilt()
+    {
+        if (m_coarseLeft > 0)
+            --m_coarseLeft;
+    }
+    // A tile of the new source was compared with the resident one
+    void NoteChecked(bool changed)
+    {
+        ++m_checked;
+        if (changed)
+            ++m_touched;
+    }
+    // True once, when every chunk job and coarse tile of the running reload is done
+    bool Finish();
+
+    bool         IsReloading() const { return m_reloading; }
+    int          GetReloadCount() const { return m_reloadCount; }
+    int          GetChecked() const { return m_checked; }
+    int          GetTouched() const { return m_touched; }     // changed (or removed) tiles of the last reload
+    unsigned int GetMillis() const { return m_millis; }       // last finished reload, from noticing the change
+
+private:
+    void StopClock();
+
+    FileWatch           m_watch;
+    std::vector<int>    m_queue;        // resident chunks still to decode from the new source
+    int                 m_pending;      // jobs submitted, not uploaded yet
+    int                 m_coarseLeft;   // coarse tiles not rebuilt since the reload
+    bool                m_reloading;
+    int                 m_reloadCount;
+    int                 m_touched;
+    int                 m_checked;
+    unsigned int        m_millis;
+    std::chrono::steady_clock::time_point m_start;
+};
@@ -0,0 +1,50 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/mapmanager/chunks/ChunkTypes.h
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Payload layout of ChunkPixels; numeric values are stored in the tile cache
+enum ChunkFormat
+{
+    CHUNK_FORMAT_BGRA8 = 0,     // D3DFMT_A8R8G8B8
+    CHUNK_FORMAT_DXT1  = 1,     // opaque tiles, 8 bytes per 4x4 block
+    CHUNK_FORMAT_DXT5  = 2,     // tiles with alpha, 16 bytes per 4x4 block
+};
+
+// CPU copy of one map chunk in D3DFMT_A8R8G8B8 byte order (B, G, R, A) or block compressed, ready for upload.
+// With levels > 1 the mip levels follow level 0 in data, rows tightly packed (see ChunkMipChain).
+struct ChunkPixels
+{
+    int                  width;
+    int                  height;
+    int                  pitch;  // bytes per row of level 0 (per block row when compressed)
+    int                  levels;
+    ChunkFormat          format;
+    int                  gutter; // atlas cell: texels of replicated tile edge on every side (0 = plain tile)
+    uint64_t             hash;   // ChunkContent::Hash of the finished payload, 0 = not analysed
+    bool                 solid;  // every texel of the tile is solidColor (A8R8G8B8)
+    uint32_t             solidColor;
+    std::vector<uint8_t> data;
+};
+
+// Outcome of IChunkUploader::Upload
+enum ChunkUploadResult
+{
+    CHUNK_UPLOADED,     // resident (or consumed) now
+    CHUNK_DROPPED,      // stale or duplicate completion: nothing to do, the chunk can be requested again
+    CHUNK_FAILED,       // unusable: OnDecodeFailed follows
+};
+
+// Receives decoded chunks on the thread that calls ChunkDecodeQueue::DrainUploads
+class IChunkUploader
+{
+public:
+    virtual ~IChunkUploader() {}
+    virtual ChunkUploadResult Upload(int index, const ChunkPixels& pixels) = 0;
+    virtual void OnDecodeFailed(int index) = 0;
+};
@@ -0,0 +1,311 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/mapmanager/chunks/MapPackSource.cpp
+ *****************************************************************************/
+
+#include "MapPackSource.h"
+#include "ChunkCompress.h"
+#include "MappedFile.h"
+#include "PixelConvert.h"
+#include "stb_image.h"      // implementation lives in Base64Image.cpp
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static const char*    MANIFEST_NAME = "manifest.txt";
+static const int      MAX_TILE_SIZE = 4096;
+static const uint32_t DDS_MAGIC = 0x20534444;  // "DDS "
+static const uint32_t DDS_HEADER_SIZE = 128;   // magic + DDS_HEADER
+static const uint32_t DDPF_FOURCC = 0x4;
+static const uint32_t DDPF_RGB = 0x40;
+static const uint32_t DDPF_ALPHAPIXELS = 0x1;
+static const uint32_t FOURCC_DXT1 = 0x31545844;
+static const uint32_t FOURCC_DXT5 = 0x35545844;
+
+static uint32_t ReadU32(const uint8_t* p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint64_t HashBytes(uint64_t hash, const void* data, size_t size)
+{
+    const uint8_t* bytes = (const uint8_t*)data;
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 0x100000001B3ull;
+    }
+    return hash;
+}
+
+static std::string Trim(const std::string& s)
+{
+    size_t begin = s.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos)
+        return std::string();
+    size_t end = s.find_last_not_of(" \t\r\n");
+    return s.substr(begin, end - begin + 1);
+}
+
+static bool ReadTextFile(const std::string& path, std::string& out)
+{
+    FILE* file = nullptr;
+    if (fopen_s(&file, path.c_str(), "rb") != 0 || !file)
+        return false;
+    char buffer[4096];
+    size_t read;
+    out.clear();
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        out.append(buffer, read);
+    fclose(file);
+    return true;
+}
+
+static std::string ToLower(std::string s)
+{
+    for (char& c : s)
+        if (c >= 'A' && c <= 'Z')
+            c = (char)(c - 'A' + 'a');
+    return s;
+}
+
+MapPackSource::MapPackSource()
+    : m_open(false)
+    , m_manifest()
+{
+}
+
+bool MapPackSource::ParseManifest(const std::string& text, Manifest& out)
+{
+    out = {};
+    out.left = -3000.0f;
+    out.top = 3000.0f;
+    out.width = 6000.0f;
+    out.height = 6000.0f;
+
+    size_t lineStart = 0;
+    while (lineStart < text.size())
+    {
+        size_t lineEnd = text.find('\n', lineStart);
+        if (lineEnd == std::string::npos)
+            lineEnd = text.size();
+        std::string line = Trim(text.substr(lineStart, lineEnd - lineStart));
+        lineStart = lineEnd + 1;
+
+        if (line.empty() || line[0] == '#' || line[0] == ';')
+            continue;
+        size_t eq = line.find('=');
+        if (eq == std::string::npos)
+            continue;
+        std::string key = ToLower(Trim(line.substr(0, eq)));
+        std::string value = Trim(line.substr(eq + 1));
+
+        if (key == "grid")
+            out.grid = atoi(value.c_str());
+        else if (key == "left")
+            out.left = (float)atof(value.c_str());
+        else if (key == "top")
+            out.top = (float)atof(value.c_str());
+        else if (key == "width")
+            out.width = (float)atof(value.c_str());
+        else if (key == "height")
+            out.height = (float)atof(value.c_str());
+        else if (key == "pattern")
+            out.pattern = value;
+    }
+
+    return out.grid >= 1 && out.grid <= MAX_GRID && out.width > 0.0f && out.height > 0.0f && !out.pattern.empty();
+}
+
+bool MapPackSource::Open(const char* directory)
+{
+    Close();
+    if (!directory || !directory[0])
+        return false;
+
+    std::string dir = directory;
+    if (dir.back() != '\\' && dir.back() != '/')
+        dir += '\\';
+
+    std::string text;
+    if (!ReadTextFile(dir + MANIFEST_NAME, text) || !ParseManifest(text, m_manifest))
+        return false;
+
+    m_directory = dir;
+    m_open = true;
+    return true;
+}
+
+void MapPackSource::Close()
+{
+    m_open = false;
+    m_directory.clear();
+    m_manifest = {};
+}
+
+std::string MapPackSource::GetTilePath(int index) const
+{
+    if (!m_open || index < 0 || index >= m_manifest.grid * m_manifest.grid)
+        return std::string();
+
+    const int row = index / m_manifest.grid;
+    const int col = index % m_manifest.grid;
+    const std::string& pattern = m_manifest.pattern;
+
+    std::string path = m_directory;
+    size_t pos = 0;
+    while (pos < pattern.size())
+    {
+        size_t open = pattern.find('{', pos);
+        size_t close = (open == std::string::npos) ? std::string::npos : pattern.find('}', open);
+        if (close == std::string::npos)
+        {
+            path.append(pattern, pos, std::string::npos);
+            break;
+        }
+        path.append(pattern, pos, open - pos);
+        pos = close + 1;
+
+        // {name} or {name:width}
+        std::string field = pattern.substr(open + 1, close - open - 1);
+        int width = 0;
+        size_t colon = field.find(':');
+        if (colon != std::string::npos)
+        {
+            width = (std::min)((std::max)(atoi(field.c_str() + colon + 1), 0), 9);
+            field.resize(colon);
+        }
+
+        int value;
+        if (field == "row")
+            value = row;
+        else if (field == "col")
+            value = col;
+        else if (field == "index")
+            value = index;
+        else
+        {
+            path.append(pattern, open, close - open + 1);
+            continue;
+        }
+
+        char number[16];
+        snprintf(number, sizeof(number), "%0*d", width, value);
+        path += number;
+    }
+    return path;
+}
+
+bool MapPackSource::DecodeTile(int index, ChunkPixels& out) const
+{
+    std::string path = GetTilePath(index);
+    if (path.empty())
+        return false;
+
+    size_t dot = path.find_last_of('.');
+    if (dot != std::string::npos && ToLower(path.substr(dot)) == ".dds")
+        return DecodeDds(path.c_str(), out);
+    return DecodeImage(path.c_str(), out);
+}
+
+bool MapPackSource::DecodeImage(const char* path, ChunkPixels& out)
+{
+    int width = 0, height = 0, channels = 0;
+    unsigned char* rgba = stbi_load(path, &width, &height, &channels, 4);
+    if (!rgba)
+        return false;
+    if (width <= 0 || height <= 0 || width > MAX_TILE_SIZE || height > MAX_TILE_SIZE)
+    {
+        stbi_image_free(rgba);
+        return false;
+    }
+
+    out.width = width;
+    out.height = height;
+    out.pitch = width * 4;
+    out.levels = 1;
+    out.format = CHUNK_FORMAT_BGRA8;
+    out.gutter = 0;
+    out.data.resize((size_t)width * height * 4);
+    PixelConvert::SwapRedBlue(rgba, width * 4, out.data.data(), out.pitch, width, height);
+    stbi_image_free(rgba);
+    return true;
+}
+
+bool MapPackSource::DecodeDds(const char* path, ChunkPixels& out)
+{
+    MappedFile file;
+    if (!file.Open(path) || file.GetSize() < DDS_HEADER_SIZE)
+        return false;
+
+    const uint8_t* base = file.GetData();
+    if (ReadU32(base) != DDS_MAGIC || ReadU32(base + 4) != 124)
+        return false;
+
+    const int height = (int)ReadU32(base + 12);
+    const int width = (int)ReadU32(base + 16);
+    const uint32_t pfFlags = ReadU32(base + 80);
+    const uint32_t fourCC = ReadU32(base + 84);
+    const uint32_t bitCount = ReadU32(base + 88);
+    const uint32_t redMask = ReadU32(base + 92);
+    const uint32_t blueMask = ReadU32(base + 100);
+    if (width <= 0 || height <= 0 || width > MAX_TILE_SIZE || height > MAX_TILE_SIZE)
+        return false;
+
+    const uint8_t* src = base + DDS_HEADER_SIZE;
+    const size_t available = file.GetSize() - DDS_HEADER_SIZE;
+
+    out.width = width;
+    out.height = height;
+    out.pitch = width * 4;
+    out.levels = 1;
+    out.format = CHUNK_FORMAT_BGRA8;
+    out.gutter = 0;
+
+    if ((pfFlags & DDPF_RGB) && bitCount == 32 && redMask == 0x00FF0000 && blueMask == 0x000000FF)
+    {
+        // A8R8G8B8 / X8R8G8B8: already in BGRA byte order
+        const size_t bytes = (size_t)width * height * 4;
+        if (available < bytes)
+            return false;
+        out.data.assign(src, src + bytes);
+        if (!(pfFlags & DDPF_ALPHAPIXELS))
+            for (size_t i = 3; i < bytes; i += 4)
+                out.data[i] = 255;
+        return true;
+    }
+
+    if (!(pfFlags & DDPF_FOURCC) || (fourCC != FOURCC_DXT1 && fourCC != FOURCC_DXT5))
+        return false;
+
+    // Decoded to BGRA so the tile goes through the same mip / cell / compression path as the TXD chunks
+    const ChunkFormat format = (fourCC == FOURCC_DXT1) ? CHUNK_FORMAT_DXT1 : CHUNK_FORMAT_DXT5;
+    return ChunkCompress::Decompress(src, available, format, width, height, out);
+}
+
+bool MapPackSource::ComputeStamp(uint64_t& outSize, uint64_t& outMtime, uint64_t& outHash) const
+{
+    outSize = 0;
+    outMtime = 0;
+    outHash = 0xCBF29CE484222325ull;
+    if (!m_open)
+        return false;
+
+    std::string text;
+    if (!ReadTextFile(m_directory + MANIFEST_NAME, text))
+        return false;
+    outHash = HashBytes(outHash, text.data(), text.size());
+
+    // Stamps only: hashing every image would read the whole pack on each start
+    const int count = m_manifest.grid * m_manifest.grid;
+    for (int i = 0; i < count; ++i)
+    {
+        uint64_t stamp[2] = { 0, 0 };
+        MappedFile::GetFileStamp(GetTilePath(i).c_str(), stamp[0], stamp[1]);
+        outHash = HashBytes(outHash, stamp, sizeof(stamp));
+        outSize += stamp[0];
+        outMtime = (std::max)(outMtime, stamp[1]);
+    }
+    return true;
+}
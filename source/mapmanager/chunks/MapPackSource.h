@@ -0,0 +1,64 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/mapmanager/chunks/MapPackSource.h
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "ChunkTypes.h"
+
+// Map pack: a directory of tile images described by manifest.txt, used instead of radar/map.txd.
+//
+//   grid    = 24                        tiles per row and column (1..255)
+//   left    = -3000                     world X of the west edge      (default -3000)
+//   top     = 3000                      world Y of the north edge     (default 3000)
+//   width   = 6000                      world size                    (default 6000 x 6000)
+//   height  = 6000
+//   pattern = tiles/{row:2}_{col:2}.png path relative to the directory; {row} {col} {index}, ":N" zero-pads
+//
+// Row 0 is the north row, index = row * grid + col (the radarNN order). Tiles are read and decoded one file at a
+// time on the decode workers; missing files are missing tiles. PNG / JPG / TGA / BMP through stb_image,
+// DDS (A8R8G8B8, X8R8G8B8, DXT1, DXT5; level 0 only) directly.
+class MapPackSource
+{
+public:
+    static const int MAX_GRID = 255;    // tile index must fit the cache's 16-bit field
+
+    struct Manifest
+    {
+        int         grid;
+        float       left;
+        float       top;
+        float       width;
+        float       height;
+        std::string pattern;
+    };
+
+    MapPackSource();
+
+    bool Open(const char* directory);
+    void Close();
+    bool IsOpen() const { return m_open; }
+
+    const Manifest&    GetManifest() const { return m_manifest; }
+    const std::string& GetDirectory() const { return m_directory; }
+    std::string        GetTilePath(int index) const;
+
+    // Thread-safe: reads one tile file into a plain BGRA8 tile (levels = 1). False if missing or undecodable.
+    bool DecodeTile(int index, ChunkPixels& out) const;
+
+    // Cache key input without reading the images: total size, newest write time and a hash over the manifest
+    // and every tile's size / write time. False if the manifest cannot be read.
+    bool ComputeStamp(uint64_t& outSize, uint64_t& outMtime, uint64_t& outHash) const;
+
+private:
+    static bool ParseManifest(const std::string& text, Manifest& out);
+    static bool DecodeImage(const char* path, ChunkPixels& out);
+    static bool DecodeDds(const char* path, ChunkPixels& out);
+
+    bool        m_open;
+    std::string m_directory;    // with trailing separator
+    Manifest    m_manifest;
+};
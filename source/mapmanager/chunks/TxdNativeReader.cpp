@@ -0,0 +1,223 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/mapmanager/chunks/TxdNativeReader.cpp
+ *****************************************************************************/
+
+#include "TxdNativeReader.h"
+#include "ChunkCompress.h"
+#include <algorithm>
+#include <cstring>
+
+// RenderWare stream chunks: type, size, library version, then size bytes of body
+static const uint32_t RW_CHUNK_HEADER = 12;
+static const uint32_t RW_ID_STRUCT = 0x01;
+static const uint32_t RW_ID_TEXTURE_NATIVE = 0x15;
+static const uint32_t RW_ID_TEX_DICTIONARY = 0x16;
+
+static const uint32_t PLATFORM_D3D8 = 8;
+static const uint32_t PLATFORM_D3D9 = 9;
+
+// Texture native struct: platform, filter / addressing, name[32], mask[32], raster format, D3D format
+// (D3D9) or alpha flag (D3D8), width, height, depth, levels, raster type, flags (D3D9) or DXT number (D3D8),
+// then (palette,) per level: size, payload
+static const uint32_t NATIVE_NAME = 8;
+static const uint32_t NATIVE_RASTER_FORMAT = 72;
+static const uint32_t NATIVE_D3D_FORMAT = 76;
+static const uint32_t NATIVE_WIDTH = 80;
+static const uint32_t NATIVE_HEIGHT = 82;
+static const uint32_t NATIVE_DEPTH = 84;
+static const uint32_t NATIVE_LEVELS = 85;
+static const uint32_t NATIVE_FLAGS = 87;
+static const uint32_t NATIVE_LEVEL0 = 88;
+static const uint32_t D3D9_FLAG_COMPRESSED = 0x8;
+
+static const uint32_t RASTER_PIXEL_FORMAT_MASK = 0x0F00;
+static const uint32_t RASTER_FORMAT_8888 = 0x0500;
+static const uint32_t RASTER_FORMAT_888 = 0x0600;
+static const uint32_t RASTER_FORMAT_PALETTE = 0x6000;   // PAL8 | PAL4
+
+static const uint32_t D3DFMT_A8R8G8B8_VALUE = 21;
+static const uint32_t D3DFMT_X8R8G8B8_VALUE = 22;
+static const uint32_t FOURCC_DXT1 = 0x31545844;
+static const uint32_t FOURCC_DXT3 = 0x33545844;
+static const uint32_t FOURCC_DXT5 = 0x35545844;
+
+static uint32_t ReadU32(const uint8_t* p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t ReadU16(const uint8_t* p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+TxdNativeReader::TxdNativeReader()
+{
+}
+
+bool TxdNativeReader::Open(const char* path)
+{
+    Close();
+    if (!m_file.Open(path))
+        return false;
+
+    const uint8_t* base = m_file.GetData();
+    const size_t size = m_file.GetSize();
+    if (size < RW_CHUNK_HEADER || ReadU32(base) != RW_ID_TEX_DICTIONARY)
+    {
+        Close();
+        return false;
+    }
+
+    // Children of the dictionary: count struct, one texture native per texture, extension
+    const size_t end = (std::min)(size, (size_t)RW_CHUNK_HEADER + ReadU32(base + 4));
+    size_t pos = RW_CHUNK_HEADER;
+    while (pos + RW_CHUNK_HEADER <= end)
+    {
+        const uint32_t type = ReadU32(base + pos);
+        const size_t body = pos + RW_CHUNK_HEADER;
+        const size_t next = body + ReadU32(base + pos + 4);
+        if (next > end)
+            break;
+        if (type == RW_ID_TEXTURE_NATIVE)
+            ParseNative(base + body, next - body);
+        pos = next;
+    }
+    return true;
+}
+
+void TxdNativeReader::Close()
+{
+    m_textures.clear();
+    m_file.Close();
+}
+
+void TxdNativeReader::ParseNative(const uint8_t* chunk, size_t size)
+{
+    if (size < RW_CHUNK_HEADER || ReadU32(chunk) != RW_ID_STRUCT)
+        return;
+    const size_t structSize = ReadU32(chunk + 4);
+    const uint8_t* s = chunk + RW_CHUNK_HEADER;
+    if (structSize < NATIVE_LEVEL0 || structSize > size - RW_CHUNK_HEADER)
+        return;
+
+    const uint32_t platform = ReadU32(s);
+    if (platform != PLATFORM_D3D8 && platform != PLATFORM_D3D9)
+        return;
+
+    Texture texture = {};
+    texture.name.assign((const char*)s + NATIVE_NAME, strnlen((const char*)s + NATIVE_NAME, 32));
+    texture.format = TXD_FORMAT_UNSUPPORTED;
+    texture.width = ReadU16(s + NATIVE_WIDTH);
+    texture.height = ReadU16(s + NATIVE_HEIGHT);
+
+    const uint32_t rasterFormat = ReadU32(s + NATIVE_RASTER_FORMAT);
+    const uint32_t d3dFormat = ReadU32(s + NATIVE_D3D_FORMAT);
+    const uint32_t pixelFormat = rasterFormat & RASTER_PIXEL_FORMAT_MASK;
+    const uint8_t flags = s[NATIVE_FLAGS];
+    Format format = TXD_FORMAT_UNSUPPORTED;
+    if (platform == PLATFORM_D3D9 && (flags & D3D9_FLAG_COMPRESSED))
+    {
+        if (d3dFormat == FOURCC_DXT1)
+            format = TXD_FORMAT_DXT1;
+        else if (d3dFormat == FOURCC_DXT3)
+            format = TXD_FORMAT_DXT3;
+        else if (d3dFormat == FOURCC_DXT5)
+            format = TXD_FORMAT_DXT5;
+    }
+    else if (platform == PLATFORM_D3D9)
+    {
+        if (d3dFormat == D3DFMT_A8R8G8B8_VALUE)
+            format = TXD_FORMAT_A8R8G8B8;
+        else if (d3dFormat == D3DFMT_X8R8G8B8_VALUE)
+            format = TXD_FORMAT_X8R8G8B8;
+    }
+    else if (flags != 0)
+    {
+        // D3D8: DXT number
+        if (flags == 1)
+            format = TXD_FORMAT_DXT1;
+        else if (flags == 3)
+            format = TXD_FORMAT_DXT3;
+        else if (flags == 5)
+            format = TXD_FORMAT_DXT5;
+    }
+    else if (s[NATIVE_DEPTH] == 32)
+    {
+        if (pixelFormat == RASTER_FORMAT_8888)
+            format = TXD_FORMAT_A8R8G8B8;
+        else if (pixelFormat == RASTER_FORMAT_888)
+            format = TXD_FORMAT_X8R8G8B8;
+    }
+
+    // A palette would sit before the levels; such textures stay with RenderWare anyway
+    if (format != TXD_FORMAT_UNSUPPORTED && !(rasterFormat & RASTER_FORMAT_PALETTE) && s[NATIVE_LEVELS] >= 1 &&
+        texture.width > 0 && texture.height > 0 && structSize >= NATIVE_LEVEL0 + 4)
+    {
+        const size_t levelSize = ReadU32(s + NATIVE_LEVEL0);
+        const bool compressed = format == TXD_FORMAT_DXT1 || format == TXD_FORMAT_DXT3 || format == TXD_FORMAT_DXT5;
+        if (compressed)
+        {
+            texture.rows = (texture.height + 3) / 4;
+            texture.rowBytes = ((texture.width + 3) / 4) * ((format == TXD_FORMAT_DXT1) ? 8 : 16);
+            texture.pitch = texture.rowBytes;
+        }
+        else
+        {
+            // Rows may be padded: the payload is pitch * height
+            texture.rows = texture.height;
+            texture.rowBytes = texture.width * 4;
+            texture.pitch = (int)(levelSize / (size_t)texture.height);
+        }
+        if (texture.pitch >= texture.rowBytes && levelSize >= (size_t)texture.pitch * texture.rows &&
+            levelSize <= structSize - NATIVE_LEVEL0 - 4)
+        {
+            texture.format = format;
+            texture.data = s + NATIVE_LEVEL0 + 4;
+        }
+    }
+    m_textures.push_back(std::move(texture));
+}
+
+const TxdNativeReader::Texture* TxdNativeReader::Find(const char* name) const
+{
+    if (!name)
+        return nullptr;
+    for (const Texture& texture : m_textures)
+        if (_stricmp(texture.name.c_str(), name) == 0)
+            return &texture;
+    return nullptr;
+}
+
+bool TxdNativeReader::CanDecode(const Texture& texture)
+{
+    return texture.format == TXD_FORMAT_A8R8G8B8 || texture.format == TXD_FORMAT_X8R8G8B8 ||
+           texture.format == TXD_FORMAT_DXT1 || texture.format == TXD_FORMAT_DXT5;
+}
+
+bool TxdNativeReader::Decode(const Texture& texture, ChunkPixels& out)
+{
+    if (texture.format == TXD_FORMAT_DXT1 || texture.format == TXD_FORMAT_DXT5)
+    {
+        const ChunkFormat format = (texture.format == TXD_FORMAT_DXT1) ? CHUNK_FORMAT_DXT1 : CHUNK_FORMAT_DXT5;
+        return ChunkCompress::Decompress(texture.data, (size_t)texture.pitch * texture.rows, format, texture.width, texture.height, out);
+    }
+    if (texture.format != TXD_FORMAT_A8R8G8B8 && texture.format != TXD_FORMAT_X8R8G8B8)
+        return false;
+
+    // D3DFMT_A8R8G8B8 memory order is the chunk's B, G, R, A: one copy, no conversion
+    out.width = texture.width;
+    out.height = texture.height;
+    out.pitch = texture.rowBytes;
+    out.levels = 1;
+    out.format = CHUNK_FORMAT_BGRA8;
+    out.gutter = 0;
+    out.data.resize((size_t)texture.rowBytes * texture.rows);
+    for (int y = 0; y < texture.rows; ++y)
+        memcpy(out.data.data() + (size_t)y * texture.rowBytes, texture.data + (size_t)y * texture.pitch, (size_t)texture.rowBytes);
+    if (texture.format == TXD_FORMAT_X8R8G8B8)
+        for (size_t i = 3; i < out.data.size(); i += 4)
+            out.data[i] = 255;
+    return true;
+}
@@ -0,0 +1,66 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/mapmanager/chunks/TxdNativeReader.h
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "ChunkTypes.h"
+#include "MappedFile.h"
+
+// Texture natives of a D3D8 / D3D9 TXD read straight out of the memory-mapped file, without RenderWare:
+// no RwImage, no raster lock, the level 0 payload is used in place. 32-bit (A8R8G8B8, X8R8G8B8) and DXT1 / DXT3 /
+// DXT5 textures are understood; palettized and 16-bit ones are listed as TXD_FORMAT_UNSUPPORTED and are left
+// to the RenderWare path.
+class TxdNativeReader
+{
+public:
+    enum Format
+    {
+        TXD_FORMAT_UNSUPPORTED,
+        TXD_FORMAT_A8R8G8B8,
+        TXD_FORMAT_X8R8G8B8,    // alpha byte undefined
+        TXD_FORMAT_DXT1,
+        TXD_FORMAT_DXT3,
+        TXD_FORMAT_DXT5,
+    };
+
+    struct Texture
+    {
+        std::string    name;
+        Format         format;
+        int            width;
+        int            height;
+        int            pitch;       // bytes per row of level 0, per block row for DXT
+        int            rows;        // rows of level 0, block rows for DXT
+        int            rowBytes;    // payload bytes of one row / block row
+        const uint8_t* data;        // level 0 inside the mapping, valid until Close
+    };
+
+    TxdNativeReader();
+
+    // False if the file is missing or not a texture dictionary
+    bool Open(const char* path);
+    void Close();
+    bool IsOpen() const { return m_file.IsOpen(); }
+
+    // Case-insensitive like RwTexDictionaryFindNamedTexture; nullptr if the TXD has no such texture
+    const Texture* Find(const char* name) const;
+    int            GetTextureCount() const { return (int)m_textures.size(); }
+    const Texture& GetTexture(int i) const { return m_textures[i]; }
+
+    // Formats Decode handles: everything but DXT3 (no decoder for it) and unsupported ones
+    static bool CanDecode(const Texture& texture);
+    // Thread-safe: level 0 as a plain BGRA8 tile (levels = 1)
+    static bool Decode(const Texture& texture, ChunkPixels& out);
+
+private:
+    void ParseNative(const uint8_t* chunk, size_t size);
+
+    MappedFile           m_file;
+    std::vector<Texture> m_textures;
+};
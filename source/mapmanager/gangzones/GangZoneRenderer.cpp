@@ -17,6 +17,7 @@
 const float GangZoneRenderer::MAX_RENDER_DISTANCE = 4000.0f;
 const float GangZoneRenderer::MAX_ZONE_SIZE = 600.0f;
 const float GangZoneRenderer::ZONE_OVERLAP = 0.001f;  // overlap at edges to avoid seams
+const float GangZoneRenderer::ZONE_Z = 1.0f;
 
 GangZoneRenderer::GangZoneRenderer(LPDIRECT3DDEVICE9 pDevice)
     : m_pDevice(pDevice)
@@ -104,7 +105,7 @@ void GangZoneRenderer::UpdateCache()
 
 void GangZoneRenderer::Render(const D3DXVECTOR3& cameraPos, const D3DXVECTOR3& cameraRot,
                               float fov, float nearPlane, float farPlane,
-                              float cameraPosX, float cameraPosY,
+                              float cameraPosX, float cameraPosY, const RadarFootprint* footprint,
                               LPDIRECT3DTEXTURE9 lineTexture,
                               dxDrawImage3DCallback drawCallback)
 {
@@ -141,6 +142,8 @@ void GangZoneRenderer::Render(const D3DXVECTOR3& cameraPos, const D3DXVECTOR3& c
             float distance = sqrtf(dx * dx + dy * dy);
             if (distance > MAX_RENDER_DISTANCE)
                 continue;
+            if (footprint && !RadarGeometry::FootprintOverlapsRect(*footprint, minX + 3000.0f, minY - 3000.0f, maxX + 3000.0f, maxY - 3000.0f))
+                continue;
 
             float width  = maxX - minX;
             float height = maxY - minY;
@@ -152,7 +155,7 @@ void GangZoneRenderer::Render(const D3DXVECTOR3& cameraPos, const D3DXVECTOR3& c
             height += ZONE_OVERLAP;
 
             // Use constant Z for all zones to avoid z-fighting at junctions
-            D3DXVECTOR3 zonePos(centerWorldX + 3000.0f, centerWorldY - 3000.0f, 1.0f);
+            D3DXVECTOR3 zonePos(centerWorldX + 3000.0f, centerWorldY - 3000.0f, ZONE_Z);
             D3DXVECTOR3 zoneRot(0.0f, 0.0f, 0.0f);
             D3DXVECTOR2 zoneSize(width, height);
 
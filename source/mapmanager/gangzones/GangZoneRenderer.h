@@ -10,6 +10,7 @@
 #include <vector>
 #include <functional>
 #include "GangZoneTypes.h"
+#include "RadarGeometry.h"
 
 class GangZoneRenderer
 {
@@ -18,6 +19,7 @@ public:
     static const float        MAX_RENDER_DISTANCE;
     static const float        MAX_ZONE_SIZE;
     static const float        ZONE_OVERLAP;
+    static const float        ZONE_Z;               // height all zones are drawn at
 
     using dxDrawImage3DCallback = std::function<void(const D3DXVECTOR3&, const D3DXVECTOR3&, const D3DXVECTOR2&,
                                                      const D3DXVECTOR3&, const D3DXVECTOR3&, float, float, float,
@@ -26,8 +28,9 @@ public:
     GangZoneRenderer(LPDIRECT3DDEVICE9 pDevice);
 
     void UpdateCache();
+    // footprint: camera footprint at ZONE_Z, zones outside it are skipped; nullptr culls by distance only
     void Render(const D3DXVECTOR3& cameraPos, const D3DXVECTOR3& cameraRot, float fov, float nearPlane, float farPlane,
-               float cameraPosX, float cameraPosY,
+               float cameraPosX, float cameraPosY, const RadarFootprint* footprint,
                LPDIRECT3DTEXTURE9 lineTexture, dxDrawImage3DCallback drawCallback);
 
     void SetEnabled(bool enabled) { m_enabled = enabled; }
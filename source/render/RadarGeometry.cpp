@@ -4,8 +4,9 @@
  *****************************************************************************/
 
 #include "RadarGeometry.h"
-#include "MathUtils.h"
 #include "common.h"
+#include <algorithm>
+#include <cfloat>
 #include <cmath>
 
 const float RadarGeometry::RADAR_OFFSET_X = 3000.0f;
@@ -25,86 +26,189 @@ void RadarGeometry::WorldToRadarPos(float worldX, float worldY, D3DXVECTOR3& out
     outRadarPos.z = 0.1f;
 }
 
-bool RadarGeometry::IsWithinRadarRange(const D3DXVECTOR3& posRadarSpace, const D3DXVECTOR3& playerPosRadarSpace, float range)
+bool RadarGeometry::WorldToCircleScreen(const D3DXVECTOR3& worldPos, const RadarProjection& projection,
+    float sizeX, float sizeY, float centerX, float centerY,
+    float& outCircleX, float& outCircleY)
 {
-    return MathUtils::DistanceSq2D(posRadarSpace, playerPosRadarSpace) <= range * range;
+    float screenX, screenY;
+    if (!projection.Project(worldPos, screenX, screenY))
+        return false;
+    ScreenToCircle(screenX, screenY, projection, sizeX, sizeY, centerX, centerY, outCircleX, outCircleY);
+    return true;
 }
 
-bool RadarGeometry::WorldToCircleScreen(const D3DXVECTOR3& worldPos,
-    const D3DXVECTOR3& cameraPos, const D3DXVECTOR3& cameraRot,
-    float fov, float nearPlane, float farPlane,
-    float rtWidth, float rtHeight, float sizeX, float sizeY,
-    float centerX, float centerY,
-    float& outCircleX, float& outCircleY,
-    float projectionAspect)
+void RadarGeometry::ScreenToCircle(float screenX, float screenY, const RadarProjection& projection,
+    float sizeX, float sizeY, float centerX, float centerY,
+    float& outCircleX, float& outCircleY)
 {
-    float screenX, screenY;
-    if (!MathUtils::WorldToScreen(worldPos, cameraPos, cameraRot, fov, nearPlane, farPlane, rtWidth, rtHeight, screenX, screenY, projectionAspect))
-        return false;
-    float nx = screenX / rtWidth, ny = screenY / rtHeight;
+    float nx = screenX / projection.GetScreenWidth(), ny = screenY / projection.GetScreenHeight();
     outCircleX = centerX + (nx - 0.5f) * sizeX;
     outCircleY = centerY + (ny - 0.5f) * sizeY;
-    return true;
 }
 
 void RadarGeometry::ClampToOrbit(float circleScreenX, float circleScreenY,
     float centerX, float centerY, float halfX, float halfY,
     float& outX, float& outY, bool useSquare)
 {
-    float dx = circleScreenX - centerX, dy = circleScreenY - centerY;
+    const RadarOrbit orbit = { centerX, centerY, halfX, halfY };
     if (useSquare)
-    {
-        float normX = (halfX > 0.01f) ? (fabsf(dx) / halfX) : 0.0f;
-        float normY = (halfY > 0.01f) ? (fabsf(dy) / halfY) : 0.0f;
-        float maxNorm = (normX > normY) ? normX : normY;
-        if (maxNorm > 1.0f && maxNorm > 0.01f)
-        {
-            float scale = 1.0f / maxNorm;
-            dx *= scale;
-            dy *= scale;
-        }
-        outX = centerX + dx;
-        outY = centerY + dy;
-    }
+        RadarOrbitOps<ORBIT_SQUARE>::Clamp(orbit, circleScreenX, circleScreenY, outX, outY);
     else
-    {
-        float r = (halfX < halfY) ? halfX : halfY;
-        float len = sqrtf(dx * dx + dy * dy);
-        if (len > 0.01f) { dx /= len; dy /= len; }
-        outX = centerX + dx * r;
-        outY = centerY + dy * r;
-    }
+        RadarOrbitOps<ORBIT_CIRCLE>::Clamp(orbit, circleScreenX, circleScreenY, outX, outY);
 }
 
 void RadarGeometry::PointOnOrbitEdge(float centerX, float centerY, float halfX, float halfY,
     float cosA, float sinA, bool useSquare,
     float& outX, float& outY)
 {
+    const RadarOrbit orbit = { centerX, centerY, halfX, halfY };
     if (useSquare)
-    {
-        float tx = (fabsf(cosA) > 1e-6f) ? (halfX / fabsf(cosA)) : 1e6f;
-        float ty = (fabsf(sinA) > 1e-6f) ? (halfY / fabsf(sinA)) : 1e6f;
-        float t = (tx < ty) ? tx : ty;
-        outX = centerX + cosA * t;
-        outY = centerY + sinA * t;
-    }
+        RadarOrbitOps<ORBIT_SQUARE>::EdgePoint(orbit, cosA, sinA, outX, outY);
     else
-    {
-        float r = (halfX < halfY) ? halfX : halfY;
-        outX = centerX + cosA * r;
-        outY = centerY + sinA * r;
-    }
+        RadarOrbitOps<ORBIT_CIRCLE>::EdgePoint(orbit, cosA, sinA, outX, outY);
 }
 
 bool RadarGeometry::IsInsideOrbit(float x, float y,
     float centerX, float centerY, float halfX, float halfY,
     bool useSquare)
 {
-    float dx = x - centerX, dy = y - centerY;
-    if (useSquare)
-        return (fabsf(dx) <= halfX && fabsf(dy) <= halfY);
-    float r = (halfX < halfY) ? halfX : halfY;
-    return (dx * dx + dy * dy) <= (r * r);
+    const RadarOrbit orbit = { centerX, centerY, halfX, halfY };
+    return useSquare ? RadarOrbitOps<ORBIT_SQUARE>::IsInside(orbit, x, y) : RadarOrbitOps<ORBIT_CIRCLE>::IsInside(orbit, x, y);
+}
+
+// a * x + b * y + c >= 0 keeps the inside; Sutherland-Hodgman step for one half-plane
+static int ClipPolygon(const D3DXVECTOR2* in, int count, float a, float b, float c, D3DXVECTOR2* out)
+{
+    int outCount = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        const D3DXVECTOR2& cur = in[i];
+        const D3DXVECTOR2& next = in[(i + 1) % count];
+        const float dCur = a * cur.x + b * cur.y + c;
+        const float dNext = a * next.x + b * next.y + c;
+        if (dCur >= 0.0f)
+            out[outCount++] = cur;
+        if ((dCur >= 0.0f) != (dNext >= 0.0f))
+        {
+            const float t = dCur / (dCur - dNext);
+            out[outCount++] = D3DXVECTOR2(cur.x + (next.x - cur.x) * t, cur.y + (next.y - cur.y) * t);
+        }
+    }
+    return outCount;
+}
+
+bool RadarGeometry::BuildFootprint(const RadarProjection& projection, float planeZ, float marginPx, RadarFootprint& outFootprint)
+{
+    outFootprint.count = 0;
+    outFootprint.valid = false;
+    outFootprint.minX = outFootprint.minY = outFootprint.maxX = outFootprint.maxY = 0.0f;
+
+    const D3DXMATRIX& m = projection.GetViewProj();
+    const float halfWidth = projection.GetScreenWidth() * 0.5f;
+    const float halfHeight = projection.GetScreenHeight() * 0.5f;
+    D3DXMATRIX inverse;
+    if (halfWidth <= 0.0f || halfHeight <= 0.0f || !D3DXMatrixInverse(&inverse, nullptr, &m))
+        return false;
+
+    // Margin as a widening of the NDC range: |x / w| <= 1 + kx
+    const float kx = 1.0f + marginPx / halfWidth;
+    const float ky = 1.0f + marginPx / halfHeight;
+
+    // Start from the XY bounds of the (widened) frustum corners: the plane section lies inside them
+    float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+    for (int corner = 0; corner < 8; ++corner)
+    {
+        const float cx = (corner & 1) ? kx : -kx;
+        const float cy = (corner & 2) ? ky : -ky;
+        const float cz = (corner & 4) ? 1.0f : 0.0f;
+        const float w = cx * inverse._14 + cy * inverse._24 + cz * inverse._34 + inverse._44;
+        if (w <= 0.0f)
+            return false;
+        const float x = (cx * inverse._11 + cy * inverse._21 + cz * inverse._31 + inverse._41) / w;
+        const float y = (cx * inverse._12 + cy * inverse._22 + cz * inverse._32 + inverse._42) / w;
+        minX = (std::min)(minX, x); maxX = (std::max)(maxX, x);
+        minY = (std::min)(minY, y); maxY = (std::max)(maxY, y);
+    }
+    outFootprint.valid = true;
+
+    D3DXVECTOR2 polygon[2][RadarFootprint::MAX_POINTS];
+    polygon[0][0] = D3DXVECTOR2(minX, minY);
+    polygon[0][1] = D3DXVECTOR2(maxX, minY);
+    polygon[0][2] = D3DXVECTOR2(maxX, maxY);
+    polygon[0][3] = D3DXVECTOR2(minX, maxY);
+    int count = 4;
+    int cur = 0;
+
+    // Clip coordinates on the plane are affine in (x, y): column j is x * m._1j + y * m._2j + (planeZ * m._3j + m._4j).
+    // Project keeps 0 <= z <= w, the render target keeps |X| <= kx * w and |Y| <= ky * w. Near the far plane
+    // z / w rounds to 1 either way, so the depth range gets a few ulps of slack to stay conservative.
+    const float depthSlack = 2e-6f;
+    const float cX = planeZ * m._31 + m._41, cY = planeZ * m._32 + m._42, cZ = planeZ * m._33 + m._43, cW = planeZ * m._34 + m._44;
+    const float planes[6][3] = {
+        { m._13 + depthSlack * m._14, m._23 + depthSlack * m._24, cZ + depthSlack * cW },
+        { (1.0f + depthSlack) * m._14 - m._13, (1.0f + depthSlack) * m._24 - m._23, (1.0f + depthSlack) * cW - cZ },
+        { kx * m._14 + m._11, kx * m._24 + m._21, kx * cW + cX },
+        { kx * m._14 - m._11, kx * m._24 - m._21, kx * cW - cX },
+        { ky * m._14 + m._12, ky * m._24 + m._22, ky * cW + cY },
+        { ky * m._14 - m._12, ky * m._24 - m._22, ky * cW - cY },
+    };
+    for (int i = 0; i < 6 && count > 0; ++i)
+    {
+        count = ClipPolygon(polygon[cur], count, planes[i][0], planes[i][1], planes[i][2], polygon[cur ^ 1]);
+        cur ^= 1;
+    }
+    if (count < 3)
+        return true;
+
+    // The box starts counter-clockwise (y up) and clipping keeps the winding
+    outFootprint.count = count;
+    outFootprint.minX = outFootprint.minY = FLT_MAX;
+    outFootprint.maxX = outFootprint.maxY = -FLT_MAX;
+    for (int i = 0; i < count; ++i)
+    {
+        const D3DXVECTOR2& p = polygon[cur][i];
+        const D3DXVECTOR2& next = polygon[cur][(i + 1) % count];
+        outFootprint.points[i] = p;
+        // Inward normal (-ey, ex) of the edge p -> next
+        outFootprint.edges[i] = D3DXVECTOR3(p.y - next.y, next.x - p.x, 0.0f);
+        outFootprint.edges[i].z = -(outFootprint.edges[i].x * p.x + outFootprint.edges[i].y * p.y);
+        outFootprint.minX = (std::min)(outFootprint.minX, p.x); outFootprint.maxX = (std::max)(outFootprint.maxX, p.x);
+        outFootprint.minY = (std::min)(outFootprint.minY, p.y); outFootprint.maxY = (std::max)(outFootprint.maxY, p.y);
+    }
+    return true;
+}
+
+bool RadarGeometry::FootprintContains(const RadarFootprint& footprint, float x, float y)
+{
+    if (!footprint.valid)
+        return true;
+    if (footprint.count == 0 || x < footprint.minX || x > footprint.maxX || y < footprint.minY || y > footprint.maxY)
+        return false;
+    for (int i = 0; i < footprint.count; ++i)
+    {
+        const D3DXVECTOR3& e = footprint.edges[i];
+        if (e.x * x + e.y * y + e.z < 0.0f)
+            return false;
+    }
+    return true;
+}
+
+bool RadarGeometry::FootprintOverlapsRect(const RadarFootprint& footprint, float minX, float minY, float maxX, float maxY)
+{
+    if (!footprint.valid)
+        return true;
+    if (footprint.count == 0 || maxX < footprint.minX || minX > footprint.maxX || maxY < footprint.minY || minY > footprint.maxY)
+        return false;
+    for (int i = 0; i < footprint.count; ++i)
+    {
+        // Box corner furthest along the inward normal: if even that one is outside, the edge separates
+        const D3DXVECTOR3& e = footprint.edges[i];
+        const float px = (e.x >= 0.0f) ? maxX : minX;
+        const float py = (e.y >= 0.0f) ? maxY : minY;
+        if (e.x * px + e.y * py + e.z < 0.0f)
+            return false;
+    }
+    return true;
 }
 
 float RadarGeometry::GetRadarScale()
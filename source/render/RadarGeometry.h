@@ -5,19 +5,184 @@
 
 #pragma once
 
+#include <cmath>
+#include <cstdint>
 #include <d3d9.h>
 #include <d3dx9.h>
+#include "RadarProjection.h"
+
+enum RadarOrbitShape
+{
+    ORBIT_CIRCLE,
+    ORBIT_SQUARE,
+};
+
+// Orbit icons are kept on: radar centre and half extents (GetRadarHalfExtents); the circle's radius is min(halfX, halfY)
+struct RadarOrbit
+{
+    float centerX;
+    float centerY;
+    float halfX;
+    float halfY;
+};
+
+// Orbit operations with the shape fixed at compile time, so loops over icons carry no shape branch.
+// The renderer picks RadarOrbitOps<ORBIT_CIRCLE> or <ORBIT_SQUARE> once per frame; the bool-taking
+// RadarGeometry functions forward here.
+template<RadarOrbitShape Shape>
+struct RadarOrbitOps
+{
+    static bool IsInside(const RadarOrbit& orbit, float x, float y)
+    {
+        const float dx = x - orbit.centerX, dy = y - orbit.centerY;
+        if constexpr (Shape == ORBIT_SQUARE)
+            return fabsf(dx) <= orbit.halfX && fabsf(dy) <= orbit.halfY;
+        else
+        {
+            const float r = (orbit.halfX < orbit.halfY) ? orbit.halfX : orbit.halfY;
+            return dx * dx + dy * dy <= r * r;
+        }
+    }
+
+    // Onto the edge along the ray from the centre (the square keeps points already inside)
+    static void Clamp(const RadarOrbit& orbit, float x, float y, float& outX, float& outY)
+    {
+        float dx = x - orbit.centerX, dy = y - orbit.centerY;
+        if constexpr (Shape == ORBIT_SQUARE)
+        {
+            const float normX = (orbit.halfX > 0.01f) ? (fabsf(dx) / orbit.halfX) : 0.0f;
+            const float normY = (orbit.halfY > 0.01f) ? (fabsf(dy) / orbit.halfY) : 0.0f;
+            const float maxNorm = (normX > normY) ? normX : normY;
+            if (maxNorm > 1.0f)
+            {
+                const float scale = 1.0f / maxNorm;
+                dx *= scale;
+                dy *= scale;
+            }
+            outX = orbit.centerX + dx;
+            outY = orbit.centerY + dy;
+        }
+        else
+        {
+            const float r = (orbit.halfX < orbit.halfY) ? orbit.halfX : orbit.halfY;
+            const float len = sqrtf(dx * dx + dy * dy);
+            if (len > 0.01f) { dx /= len; dy /= len; }
+            outX = orbit.centerX + dx * r;
+            outY = orbit.centerY + dy * r;
+        }
+    }
+
+    // Edge point in the unit direction (cosA, sinA) from the centre
+    static void EdgePoint(const RadarOrbit& orbit, float cosA, float sinA, float& outX, float& outY)
+    {
+        if constexpr (Shape == ORBIT_SQUARE)
+        {
+            const float tx = (fabsf(cosA) > 1e-6f) ? (orbit.halfX / fabsf(cosA)) : 1e6f;
+            const float ty = (fabsf(sinA) > 1e-6f) ? (orbit.halfY / fabsf(sinA)) : 1e6f;
+            const float t = (tx < ty) ? tx : ty;
+            outX = orbit.centerX + cosA * t;
+            outY = orbit.centerY + sinA * t;
+        }
+        else
+        {
+            const float r = (orbit.halfX < orbit.halfY) ? orbit.halfX : orbit.halfY;
+            outX = orbit.centerX + cosA * r;
+            outY = orbit.centerY + sinA * r;
+        }
+    }
+
+    // One pass over an overlay in SoA form, x / y updated in place. Point i is a position in radar pixels or,
+    // where isDirection[i] is non-zero, a unit direction (cos, sin) from the centre. Positions outside the orbit
+    // are clamped onto it, directions are put on the edge; outInside[i] is 1 only for positions inside.
+    static void PlaceBatch(const RadarOrbit& orbit, float* x, float* y, const uint8_t* isDirection, int count, uint8_t* outInside)
+    {
+        // Orbit constants hoisted into locals: the output arrays could alias orbit as far as the compiler knows
+        const float cx = orbit.centerX, cy = orbit.centerY;
+        if constexpr (Shape == ORBIT_SQUARE)
+        {
+            const float hx = orbit.halfX, hy = orbit.halfY;
+            const float invHx = (hx > 0.01f) ? 1.0f / hx : 0.0f;
+            const float invHy = (hy > 0.01f) ? 1.0f / hy : 0.0f;
+            for (int i = 0; i < count; ++i)
+            {
+                float dx = x[i], dy = y[i];
+                if (isDirection[i])
+                {
+                    // min(hx / |cos|, hy / |sin|) with one divide
+                    const float nx = fabsf(dx) * invHx, ny = fabsf(dy) * invHy;
+                    const float n = (nx > ny) ? nx : ny;
+                    const float t = (n > 1e-6f) ? 1.0f / n : 0.0f;
+                    x[i] = cx + dx * t;
+                    y[i] = cy + dy * t;
+                    outInside[i] = 0;
+                    continue;
+                }
+                dx -= cx;
+                dy -= cy;
+                const float nx = fabsf(dx) * invHx, ny = fabsf(dy) * invHy;
+                const float n = (nx > ny) ? nx : ny;
+                const bool inside = fabsf(dx) <= hx && fabsf(dy) <= hy;
+                outInside[i] = inside ? 1 : 0;
+                if (!inside && n > 1.0f)
+                {
+                    const float scale = 1.0f / n;
+                    x[i] = cx + dx * scale;
+                    y[i] = cy + dy * scale;
+                }
+            }
+        }
+        else
+        {
+            const float r = (orbit.halfX < orbit.halfY) ? orbit.halfX : orbit.halfY;
+            const float rSq = r * r;
+            for (int i = 0; i < count; ++i)
+            {
+                const float px = x[i], py = y[i];
+                if (isDirection[i])
+                {
+                    x[i] = cx + px * r;
+                    y[i] = cy + py * r;
+                    outInside[i] = 0;
+                    continue;
+                }
+                const float dx = px - cx, dy = py - cy;
+                const float lenSq = dx * dx + dy * dy;
+                const bool inside = lenSq <= rSq;
+                outInside[i] = inside ? 1 : 0;
+                if (!inside && lenSq > 0.0001f)
+                {
+                    const float scale = r / sqrtf(lenSq);
+                    x[i] = cx + dx * scale;
+                    y[i] = cy + dy * scale;
+                }
+            }
+        }
+    }
+};
+
+// What the radar camera sees of the horizontal plane z = planeZ: the frustum cut by that plane, a convex
+// polygon in radar space. Built once per frame so culling an item is a 2D test instead of a projection.
+struct RadarFootprint
+{
+    static const int MAX_POINTS = 12;   // start box + one vertex per clipping half-plane at most
+
+    D3DXVECTOR2 points[MAX_POINTS];     // counter-clockwise
+    D3DXVECTOR3 edges[MAX_POINTS];      // edge i = points[i] -> points[i + 1]: x * a + y * b + c >= 0 inside
+    int         count;                  // 0: none of the plane is in view
+    float       minX, minY, maxX, maxY;
+    bool        valid;                  // false: no usable projection, every test passes
+};
 
 class RadarGeometry
 {
 public:
-    static bool WorldToCircleScreen(const D3DXVECTOR3& worldPos,
-        const D3DXVECTOR3& cameraPos, const D3DXVECTOR3& cameraRot,
-        float fov, float nearPlane, float farPlane,
-        float rtWidth, float rtHeight, float sizeX, float sizeY,
-        float centerX, float centerY,
-        float& outCircleX, float& outCircleY,
-        float projectionAspect = 0.0f);
+    static bool WorldToCircleScreen(const D3DXVECTOR3& worldPos, const RadarProjection& projection,
+        float sizeX, float sizeY, float centerX, float centerY,
+        float& outCircleX, float& outCircleY);
+    // Second half of WorldToCircleScreen for a point already projected (RadarProjection::ProjectBatch)
+    static void ScreenToCircle(float screenX, float screenY, const RadarProjection& projection,
+        float sizeX, float sizeY, float centerX, float centerY,
+        float& outCircleX, float& outCircleY);
 
     static void ClampToOrbit(float circleScreenX, float circleScreenY,
         float centerX, float centerY, float halfX, float halfY,
@@ -31,6 +196,13 @@ public:
         float centerX, float centerY, float halfX, float halfY,
         bool useSquare);
 
+    // Footprint of the render target widened by marginPx render target pixels on each side (icon size);
+    // false (and footprint.valid false) if the projection is not built yet
+    static bool BuildFootprint(const RadarProjection& projection, float planeZ, float marginPx, RadarFootprint& outFootprint);
+    static bool FootprintContains(const RadarFootprint& footprint, float x, float y);
+    // Exact for the convex polygon against the box: separating axes are the box axes and the polygon edges
+    static bool FootprintOverlapsRect(const RadarFootprint& footprint, float minX, float minY, float maxX, float maxY);
+
     static float GetRadarScale();
     static void GetRadarHalfExtents(float sizeX, float sizeY, float& halfX, float& halfY);
     // Orbit at middle of border: pass borderThicknessPx and shapeCircle
@@ -42,5 +214,4 @@ public:
 
     static void WorldToRadarPos(float worldX, float worldY, float worldZ, float& outRadarX, float& outRadarY, float& outRadarZ);
     static void WorldToRadarPos(float worldX, float worldY, D3DXVECTOR3& outRadarPos);
-    static bool IsWithinRadarRange(const D3DXVECTOR3& posRadarSpace, const D3DXVECTOR3& playerPosRadarSpace, float range);
 };
@@ -14,11 +14,14 @@
 #include "ShaderManager.h"
 #include "CameraController.h"
 #include "MapChunkManager.h"
+#include "ChunkCompress.h"
 #include "BlipManager.h"
 #include "GangZoneRenderer.h"
 #include "GpsRender.h"
 #include "RenderRadio.h"
 #include "MathUtils.h"
+#include "FastMath.h"
+#include <algorithm>
 #include <cstring>
 #include <cmath>
 #include <cfloat>
@@ -81,6 +84,8 @@ RadarRenderer::RadarRenderer()
     , m_cachedPitchAngle(0.0f)
     , m_nearPlane(0.3f)
     , m_farPlane(10000.0f)
+    , m_blipFootprint()
+    , m_spriteStats()
     , m_initialAircraftAltitude(0.0f)
     , m_bWasInAircraft(false)
     , m_bWasInInterior(false)
@@ -92,6 +97,7 @@ RadarRenderer::RadarRenderer()
     , m_bInitialized(false)
 #ifdef _DEBUG
     , m_debugChunksRenderedLastFrame(0)
+    , m_debugMapDrawCallsLastFrame(0)
 #endif
 {
 }
@@ -354,34 +360,7 @@ bool RadarRenderer::InitializeResources()
     }
 
     
-    if (m_pBlipManager)
-        m_pNorthTexture = m_pBlipManager->GetBlipTexture(4);
-
-    // Line from blip.txd
-    if (m_pBlipManager)
-    {
-        m_pLineTexture = m_pBlipManager->LoadTextureFromTxd("line");
-        if (!m_pLineTexture)
-            m_pLineTexture = m_pBlipManager->LoadTextureFromTxd("radarLine");
-    }
-    if (!m_pLineTexture)
-    {
-        const char* fallback = PLUGIN_PATH("radar/blip/line.png");
-        D3DXCreateTextureFromFileA(m_pd3dDevice, fallback, &m_pLineTexture);
-    }
-
-    // RingPlane from blip.txd
-    if (m_pBlipManager)
-    {
-        m_pRadarRingPlaneTexture = m_pBlipManager->LoadTextureFromTxd("radarRingPlane");
-        if (!m_pRadarRingPlaneTexture)
-            m_pRadarRingPlaneTexture = m_pBlipManager->LoadTextureFromTxd("RingPlane");
-    }
-    if (!m_pRadarRingPlaneTexture)
-    {
-        const char* fallback = PLUGIN_PATH("radar/blip/RingPlane.png");
-        D3DXCreateTextureFromFileA(m_pd3dDevice, fallback, &m_pRadarRingPlaneTexture);
-    }
+    LoadBlipTxdTextures();
     
     // Create DirectX font for text rendering
     D3DXFONT_DESC fontDesc;
@@ -441,6 +420,48 @@ bool RadarRenderer::InitializeResources()
     return true;
 }
 
+void RadarRenderer::LoadBlipTxdTextures()
+{
+    if (m_pLineTexture)
+    {
+        m_pLineTexture->Release();
+        m_pLineTexture = nullptr;
+    }
+    if (m_pRadarRingPlaneTexture)
+    {
+        m_pRadarRingPlaneTexture->Release();
+        m_pRadarRingPlaneTexture = nullptr;
+    }
+
+    m_pNorthTexture = m_pBlipManager ? m_pBlipManager->GetBlipTexture(4) : nullptr;
+
+    // Line from blip.txd
+    if (m_pBlipManager)
+    {
+        m_pLineTexture = m_pBlipManager->LoadTextureFromTxd("line");
+        if (!m_pLineTexture)
+            m_pLineTexture = m_pBlipManager->LoadTextureFromTxd("radarLine");
+    }
+    if (!m_pLineTexture)
+    {
+        const char* fallback = PLUGIN_PATH("radar/blip/line.png");
+        D3DXCreateTextureFromFileA(m_pd3dDevice, fallback, &m_pLineTexture);
+    }
+
+    // RingPlane from blip.txd
+    if (m_pBlipManager)
+    {
+        m_pRadarRingPlaneTexture = m_pBlipManager->LoadTextureFromTxd("radarRingPlane");
+        if (!m_pRadarRingPlaneTexture)
+            m_pRadarRingPlaneTexture = m_pBlipManager->LoadTextureFromTxd("RingPlane");
+    }
+    if (!m_pRadarRingPlaneTexture)
+    {
+        const char* fallback = PLUGIN_PATH("radar/blip/RingPlane.png");
+        D3DXCreateTextureFromFileA(m_pd3dDevice, fallback, &m_pRadarRingPlaneTexture);
+    }
+}
+
 void RadarRenderer::UpdateDrawResources()
 {
     m_drawResources.pDevice             = m_pd3dDevice;
@@ -529,6 +550,65 @@ void RadarRenderer::CalculateRadarPosition(float& circleX, float& circleY, float
     MathUtils::CalculateRadarPosition(circleX, circleY, sizeX, sizeY, baseCircle, baseSqX, baseSqY, m_bRadarShapeCircle, baseOffsetX, baseOffsetY);
 }
 
+void RadarRenderer::UpdateProjection()
+{
+    if (!m_pCameraController)
+        return;
+    float offsetWorldX, offsetWorldY;
+    D3DXVECTOR3 cameraPos, cameraRot;
+    m_pCameraController->GetCachedCalculations(offsetWorldX, offsetWorldY, cameraPos, cameraRot);
+    const CameraController::CameraState& camState = m_pCameraController->GetState();
+    float rtWidth = m_pRenderTarget ? (float)m_pRenderTarget->GetWidth() : 0.0f;
+    float rtHeight = m_pRenderTarget ? (float)m_pRenderTarget->GetHeight() : 0.0f;
+    float screenAspect = (m_width > 0) ? ((float)m_height / (float)m_width) : 1.0f;
+    m_projection.Build(cameraPos, cameraRot, camState.fov, m_nearPlane, m_farPlane, rtWidth, rtHeight, screenAspect);
+
+    // Blips sit at 0.1 + 0.1 (see RenderBlips2D); margin of half an icon, radar pixels scaled to render target pixels
+    float circleX, circleY, sizeX, sizeY;
+    CalculateRadarPosition(circleX, circleY, sizeX, sizeY);
+    float marginPx = (sizeX > 0.0f) ? CalculateBlipSize(24.0f) * 0.5f * rtWidth / sizeX : 0.0f;
+    RadarGeometry::BuildFootprint(m_projection, 0.2f, marginPx, m_blipFootprint);
+}
+
+template<RadarOrbitShape Shape>
+void RadarRenderer::PlaceOverlayPoints(const RadarOrbit& orbit, float sizeX, float sizeY, float playerX, float playerY, float yaw)
+{
+    const int count = m_overlayBatch.GetCount();
+    m_overlayX.resize(count);
+    m_overlayY.resize(count);
+    m_overlayKind.resize(count);
+    m_overlayInside.resize(count);
+
+    // Projected points to radar pixels; the others get their direction from the player, for the edge
+    float cosYaw, sinYaw;
+    FastMath::SinCos(yaw, sinYaw, cosYaw);
+    for (int k = 0; k < count; ++k)
+    {
+        if (m_overlayBatch.visible[k])
+        {
+            RadarGeometry::ScreenToCircle(m_overlayBatch.screenX[k], m_overlayBatch.screenY[k], m_projection, sizeX, sizeY,
+                orbit.centerX, orbit.centerY, m_overlayX[k], m_overlayY[k]);
+            m_overlayKind[k] = OVERLAY_PROJECTED;
+        }
+        else if (MathUtils::DirectionToOrbit(playerX, playerY, m_overlayBatch.x[k], m_overlayBatch.y[k], cosYaw, sinYaw, m_overlayX[k], m_overlayY[k]))
+            m_overlayKind[k] = OVERLAY_EDGE;
+        else
+        {
+            m_overlayX[k] = m_overlayY[k] = 0.0f;
+            m_overlayKind[k] = OVERLAY_NONE;
+        }
+    }
+    RadarOrbitOps<Shape>::PlaceBatch(orbit, m_overlayX.data(), m_overlayY.data(), m_overlayKind.data(), count, m_overlayInside.data());
+}
+
+void RadarRenderer::PlaceOverlayPoints(const RadarOrbit& orbit, float sizeX, float sizeY, float playerX, float playerY, float yaw)
+{
+    if (m_bRadarShapeCircle)
+        PlaceOverlayPoints<ORBIT_CIRCLE>(orbit, sizeX, sizeY, playerX, playerY, yaw);
+    else
+        PlaceOverlayPoints<ORBIT_SQUARE>(orbit, sizeX, sizeY, playerX, playerY, yaw);
+}
+
 float RadarRenderer::CalculateBlipSize(float baseBlipSize, float baseWidth) const
 {
     float screenWidth = (float)RsGlobal.maximumWidth;
@@ -549,23 +629,72 @@ void RadarRenderer::RenderRadarTargetContents(float circleX, float circleY, floa
         if (!m_bRadarShapeCircle)
             visibleRadius *= 1.65f;  // square corners extend beyond circle; extra margin for square radar
 
-        MapChunkManager::FrustumParams frustum = {};
-        frustum.cameraPos = &cameraPos;
-        frustum.cameraRot = &cameraRot;
-        frustum.fov = camState.fov;
-        frustum.nearPlane = m_nearPlane;
-        frustum.farPlane = m_farPlane;
-        frustum.screenWidth = m_pRenderTarget ? (float)m_pRenderTarget->GetWidth() : 0.0f;
-        frustum.screenHeight = m_pRenderTarget ? (float)m_pRenderTarget->GetHeight() : 0.0f;
-        frustum.projectionAspect = (frustum.screenWidth > 0) ? (frustum.screenHeight / frustum.screenWidth) : 1.0f;
-
-        m_pMapChunkManager->ForEachChunkInRadius(cameraPos, visibleRadius, &frustum, [this, &cameraPos, &cameraRot, &camState](int, const D3DXVECTOR3& elementPos, const D3DXVECTOR3& elementRot, const D3DXVECTOR2& elementSize, LPDIRECT3DTEXTURE9 chunkTex)
+        MapChunkManager::FrustumParams footprint = {};
+        footprint.cameraPos = &cameraPos;
+        footprint.cameraRot = &cameraRot;
+        footprint.fov = camState.fov;
+        footprint.nearPlane = m_nearPlane;
+        footprint.farPlane = m_farPlane;
+        footprint.screenWidth = m_pRenderTarget ? (float)m_pRenderTarget->GetWidth() : 0.0f;
+        footprint.screenHeight = m_pRenderTarget ? (float)m_pRenderTarget->GetHeight() : 0.0f;
+        footprint.projectionAspect = (footprint.screenWidth > 0) ? (footprint.screenHeight / footprint.screenWidth) : 1.0f;
+
+        // Tiles are collected per texture and drawn afterwards: with MapAtlas the whole layer is 1-2 draw calls
+        m_pMapChunkManager->ForEachChunkInRadius(cameraPos, visibleRadius, &footprint, [this](int, const D3DXVECTOR3& elementPos, const D3DXVECTOR3&, const D3DXVECTOR2& elementSize, LPDIRECT3DTEXTURE9 chunkTex, const D3DXVECTOR4& region)
         {
-            m_pDraw->dxDrawImage3D(elementPos, elementRot, elementSize, cameraPos, cameraRot, camState.fov, m_nearPlane, m_farPlane, chunkTex, tocolor(255, 255, 255, 255));
+            MapTileBatch* batch = nullptr;
+            for (auto& b : m_mapBatches)
+            {
+                if (b.texture == chunkTex)
+                {
+                    batch = &b;
+                    break;
+                }
+            }
+            if (!batch)
+            {
+                m_mapBatches.push_back(MapTileBatch{ chunkTex, {} });
+                batch = &m_mapBatches.back();
+            }
+
+            // Map tiles are never rotated; north edge at v0 like the flipped Image3D texcoords
+            const float x0 = elementPos.x - elementSize.x * 0.5f;
+            const float x1 = elementPos.x + elementSize.x * 0.5f;
+            const float yN = elementPos.y + elementSize.y * 0.5f;
+            const float yS = elementPos.y - elementSize.y * 0.5f;
+            const float z = elementPos.z;
+            const DWORD color = tocolor(255, 255, 255, 255);
+            const Image3DBatchVertex quad[6] = {
+                { x0, yN, z, color, region.x, region.y },
+                { x0, yS, z, color, region.x, region.w },
+                { x1, yN, z, color, region.z, region.y },
+                { x0, yS, z, color, region.x, region.w },
+                { x1, yS, z, color, region.z, region.w },
+                { x1, yN, z, color, region.z, region.y }
+            };
+            batch->vertices.insert(batch->vertices.end(), quad, quad + 6);
 #ifdef _DEBUG
             ++m_debugChunksRenderedLastFrame;
 #endif
         });
+
+        for (auto& batch : m_mapBatches)
+        {
+            if (batch.vertices.empty())
+                continue;
+            m_pDraw->dxDrawImage3DBatch(batch.vertices.data(), (int)batch.vertices.size(), cameraPos, cameraRot, camState.fov, m_nearPlane, m_farPlane, batch.texture);
+#ifdef _DEBUG
+            ++m_debugMapDrawCallsLastFrame;
+#endif
+        }
+        // Textures unused this frame may be released by UpdateStreaming; the others keep their vertex capacity
+        m_mapBatches.erase(std::remove_if(m_mapBatches.begin(), m_mapBatches.end(), [](const MapTileBatch& b) { return b.vertices.empty(); }), m_mapBatches.end());
+        for (auto& batch : m_mapBatches)
+            batch.vertices.clear();
+        const ChunkPrefetch::Motion motion = { camState.posX, camState.posY, camState.velX, camState.velY, camState.yaw,
+                                               camState.offsetY, cameraPos.z };
+        m_pMapChunkManager->PrefetchAlongPath(motion, visibleRadius);
+        m_pMapChunkManager->UpdateStreaming();
     }
     if (m_pGangZoneRenderer && m_pCameraController)
     {
@@ -573,8 +702,10 @@ void RadarRenderer::RenderRadarTargetContents(float circleX, float circleY, floa
         D3DXVECTOR3 cameraPos, cameraRot;
         m_pCameraController->GetCachedCalculations(offsetWorldX, offsetWorldY, cameraPos, cameraRot);
         const CameraController::CameraState& camState = m_pCameraController->GetState();
+        RadarFootprint zoneFootprint;
+        RadarGeometry::BuildFootprint(m_projection, GangZoneRenderer::ZONE_Z, 1.0f, zoneFootprint);
         m_pGangZoneRenderer->Render(cameraPos, cameraRot, camState.fov, m_nearPlane, m_farPlane,
-            camState.posX, camState.posY, m_pCircleTexture ? m_pCircleTexture : m_pLineTexture,
+            camState.posX, camState.posY, &zoneFootprint, m_pCircleTexture ? m_pCircleTexture : m_pLineTexture,
             [this](const D3DXVECTOR3& pos, const D3DXVECTOR3& rot, const D3DXVECTOR2& size,
                 const D3DXVECTOR3& camPos, const D3DXVECTOR3& camRot,
                 float fov, float nearPlane, float farPlane,
@@ -745,6 +876,9 @@ void RadarRenderer::RenderRadarOverlays(float circleX, float circleY, float size
         m_pDraw->dxDrawRectangle(stripX + stripWidth * 0.85f, progressBarY, stripWidth * 1.3f, stripWidth * 0.2f, tocolor(255, 255, 255, 225));
     }
 
+    // North marker, blips, airstrips, indicators and legends share one sprite queue
+    m_spriteBatch.clear();
+    m_spriteStats = SpriteStats();
     if (m_pNorthTexture && m_pCameraController)
     {
         float northMarkerSize = CalculateBlipSize(28.0f);
@@ -753,15 +887,17 @@ void RadarRenderer::RenderRadarOverlays(float circleX, float circleY, float size
         RadarGeometry::GetRadarHalfExtents(sizeX, sizeY, (float)RadarConfig::GetBorderThickness(), m_bRadarShapeCircle, halfX, halfY);
         const CameraController::CameraState& camState = m_pCameraController->GetState();
         float northAngle = -camState.yaw - D3DX_PI * 0.5f;
-        float northCenterX, northCenterY;
-        RadarGeometry::PointOnOrbitEdge(centerX, centerY, halfX, halfY, cosf(northAngle), sinf(northAngle), !m_bRadarShapeCircle, northCenterX, northCenterY);
-        m_pDraw->dxDrawImage2D(northCenterX - northMarkerSize * 0.5f, northCenterY - northMarkerSize * 0.5f, northMarkerSize, northMarkerSize, m_pNorthTexture, tocolor(255, 255, 255, 255));
+        float northCenterX, northCenterY, northSin, northCos;
+        FastMath::SinCos(northAngle, northSin, northCos);
+        RadarGeometry::PointOnOrbitEdge(centerX, centerY, halfX, halfY, northCos, northSin, !m_bRadarShapeCircle, northCenterX, northCenterY);
+        QueueSprite(4, m_pNorthTexture, northCenterX - northMarkerSize * 0.5f, northCenterY - northMarkerSize * 0.5f, northMarkerSize, 0.0f, tocolor(255, 255, 255, 255));
     }
 
     RenderBlips2D();
     RenderAirstrips();
     RenderIndicatorBlips();
     RenderLegends();
+    FlushSprites();
 
     // Отрисовка текста радио
     RenderRadioText();
@@ -795,6 +931,7 @@ void RadarRenderer::Render()
         return;
 #ifdef _DEBUG
     m_debugChunksRenderedLastFrame = 0;
+    m_debugMapDrawCallsLastFrame = 0;
 #endif
     // Save all device states so as not to affect the game
     IDirect3DStateBlock9* pStateBlock = nullptr;
@@ -852,7 +989,11 @@ void RadarRenderer::Render()
     if (m_pRenderTarget && (m_pRenderTarget->GetWidth() != rtSize || m_pRenderTarget->GetHeight() != rtSize))
         m_pRenderTarget->dxCreateRenderTarget(rtSize, rtSize);
 
+    // HotReload: the north marker is borrowed from BlipManager, line / ring plane were copied out of blip.txd
+    if (m_pBlipManager && m_pBlipManager->ReloadIfChanged())
+        LoadBlipTxdTextures();
     UpdateDrawResources();
+    UpdateProjection();
 
     if (m_pRenderTarget && m_pRenderTarget->GetSurface())
     {
@@ -927,6 +1068,62 @@ void RadarRenderer::dxDrawGTAIndicatorBlip(float screenX, float screenY, float s
     if (m_pDraw) m_pDraw->dxDrawGTAIndicatorBlip(screenX, screenY, size, color, type);
 }
 
+void RadarRenderer::QueueSprite(int spriteId, LPDIRECT3DTEXTURE9 texture, float x, float y, float size, float rotation, DWORD color)
+{
+    if (!m_pDraw)
+        return;
+    ++m_spriteStats.sprites;
+    ++m_spriteStats.unbatchedDraws;
+
+    D3DXVECTOR4 region;
+    // The texture check keeps an icon replaced after the atlas was built out of it
+    if (m_pBlipManager && m_pBlipManager->GetBlipAtlas().GetRegion(spriteId, region) && m_pBlipManager->GetBlipTexture(spriteId) == texture)
+    {
+        DxDrawPrimitives::AppendImage2D(m_spriteBatch, x, y, size, size, region, rotation, color);
+        return;
+    }
+
+    // Not in the atlas (too large, or another texture): keep the order, draw it on its own
+    FlushSprites();
+    if (rotation != 0.0f)
+        m_pDraw->dxDrawImage2DRotated(x, y, size, size, texture, rotation, color);
+    else
+        m_pDraw->dxDrawImage2D(x, y, size, size, texture, color);
+    ++m_spriteStats.draws;
+}
+
+void RadarRenderer::QueueIndicator(float screenX, float screenY, float size, DWORD color, eHeightIndicatorType type)
+{
+    if (!m_pDraw)
+        return;
+    ++m_spriteStats.sprites;
+    m_spriteStats.unbatchedDraws += 2;
+
+    const BlipAtlas* atlas = m_pBlipManager ? &m_pBlipManager->GetBlipAtlas() : nullptr;
+    if (atlas && atlas->GetTexture())
+    {
+        DxDrawPrimitives::AppendGTAIndicatorBlip(m_spriteBatch, screenX, screenY, size, color, type, atlas->GetWhite());
+        return;
+    }
+
+    FlushSprites();
+    m_pDraw->dxDrawGTAIndicatorBlip(screenX, screenY, size, color, type);
+    m_spriteStats.draws += 2;
+}
+
+void RadarRenderer::FlushSprites()
+{
+    if (m_spriteBatch.empty())
+        return;
+    LPDIRECT3DTEXTURE9 atlasTexture = m_pBlipManager ? m_pBlipManager->GetBlipAtlas().GetTexture() : nullptr;
+    if (m_pDraw && atlasTexture)
+    {
+        m_pDraw->dxDrawImage2DBatch(m_spriteBatch.data(), (int)m_spriteBatch.size(), atlasTexture);
+        ++m_spriteStats.draws;
+    }
+    m_spriteBatch.clear();
+}
+
 void RadarRenderer::dxDrawImage3D(const D3DXVECTOR3& elementPos, const D3DXVECTOR3& elementRot, const D3DXVECTOR2& elementSize,
                                  const D3DXVECTOR3& cameraPos, const D3DXVECTOR3& cameraRot,
                                  float fov, float nearPlane, float farPlane,
@@ -1001,28 +1198,122 @@ void RadarRenderer::dxDrawRenderDebugMemory()
     lineY += 24.0f;
 
     int chunksRendered = 0;
-    int chunksLoaded = 0;
-    int chunksUnloaded = MapChunkManager::MAP_CHUNKS_COUNT;
+    MapChunkManager::StreamingStats chunkStats = {};
     size_t blipsTotal = 0;
     size_t blipsEnabled = 0;
     if (m_pMapChunkManager)
     {
-        chunksLoaded = m_pMapChunkManager->GetLoadedChunksCount();
-        chunksUnloaded = MapChunkManager::MAP_CHUNKS_COUNT - chunksLoaded;
+        chunkStats = m_pMapChunkManager->GetStreamingStats();
         chunksRendered = m_debugChunksRenderedLastFrame;
     }
     if (m_pBlipManager)
     {
-        const auto& blips = m_pBlipManager->GetBlips();
-        blipsTotal = blips.size();
-        for (const auto& b : blips)
-            if (b.enabled) ++blipsEnabled;
+        const BlipStore& store = m_pBlipManager->GetBlipStore();
+        const uint8_t* flags = store.GetFlags();
+        blipsTotal = (size_t)store.GetCount();
+        for (int i = 0; i < store.GetCount(); ++i)
+            if (flags[i] & BlipStore::FLAG_ENABLED) ++blipsEnabled;
+    }
+    sprintf_s(buf, "Chunks: %d rend., %d resid., %d pend., %d evict. (of %d)",
+        chunksRendered, chunkStats.resident, chunkStats.pending, chunkStats.evicted,
+        m_pMapChunkManager ? m_pMapChunkManager->GetChunkCount() : 0);
+    drawWithOutline(buf, 10.0f, lineY, 560.0f, 22.0f, color);
+    lineY += 24.0f;
+    if (m_pMapChunkManager && m_pMapChunkManager->IsStreaming())
+    {
+        int needed = chunkStats.prefetchHits + chunkStats.prefetchLate;
+        sprintf_s(buf, "Prefetch: %d hit, %d late (%d%%), %d unused",
+            chunkStats.prefetchHits, chunkStats.prefetchLate, needed ? chunkStats.prefetchHits * 100 / needed : 0, chunkStats.prefetchUnused);
+        drawWithOutline(buf, 10.0f, lineY, 560.0f, 22.0f, color);
+        lineY += 24.0f;
     }
-    sprintf_s(buf, "Chunks: %d rend., %d load., %d unload. (of %d)", chunksRendered, chunksLoaded, chunksUnloaded, MapChunkManager::MAP_CHUNKS_COUNT);
+    sprintf_s(buf, "Map draws: %d, atlas %d pages, %d cells, %u KB",
+        m_debugMapDrawCallsLastFrame, chunkStats.atlasPages, chunkStats.atlasCells, (unsigned)(chunkStats.atlasBytes / 1024));
+    drawWithOutline(buf, 10.0f, lineY, 560.0f, 22.0f, color);
+    lineY += 24.0f;
+    sprintf_s(buf, "Tile dedup: %d shared, %d solid, %u KB saved, %d draws skipped",
+        chunkStats.sharedTiles, chunkStats.solidTiles, (unsigned)(chunkStats.dedupSavedBytes / 1024), chunkStats.skippedDraws);
+    drawWithOutline(buf, 10.0f, lineY, 560.0f, 22.0f, color);
+    lineY += 24.0f;
+    if (chunkStats.reloading || chunkStats.reloads > 0)
+    {
+        if (chunkStats.reloading)
+            sprintf_s(buf, "Hot reload: in progress, %d tiles changed so far", chunkStats.reloadTouched);
+        else
+            sprintf_s(buf, "Hot reload: %d done, last %u ms, %d of %d tiles changed", chunkStats.reloads, chunkStats.reloadMillis,
+                chunkStats.reloadTouched, chunkStats.reloadChecked);
+        drawWithOutline(buf, 10.0f, lineY, 560.0f, 22.0f, color);
+        lineY += 24.0f;
+    }
+    if (chunkStats.nativeTiles > 0 || chunkStats.imageTiles > 0)
+    {
+        // Main thread cost per tile of the two map.txd paths, and the RwImage memory the native one avoids
+        sprintf_s(buf, "TXD ingest: native %d (%u us/tile), RwImage %d (%u us/tile, %u KB)",
+            chunkStats.nativeTiles, chunkStats.nativeTiles ? chunkStats.nativeMicros / chunkStats.nativeTiles : 0,
+            chunkStats.imageTiles, chunkStats.imageTiles ? chunkStats.imageMicros / chunkStats.imageTiles : 0,
+            (unsigned)(chunkStats.imageBytes / 1024));
+        drawWithOutline(buf, 10.0f, lineY, 560.0f, 22.0f, color);
+        lineY += 24.0f;
+    }
+    if (chunkStats.budgetBytes)
+        sprintf_s(buf, "Chunk mem: %u / %u KB, budget %d tiles",
+            (unsigned)(chunkStats.residentBytes / 1024), (unsigned)(chunkStats.budgetBytes / 1024), chunkStats.budgetChunks);
+    else
+        sprintf_s(buf, "Chunk mem: %u KB, budget %d tiles", (unsigned)(chunkStats.residentBytes / 1024), chunkStats.budgetChunks);
     drawWithOutline(buf, 10.0f, lineY, 560.0f, 22.0f, color);
     lineY += 24.0f;
+    sprintf_s(buf, "LOD: level %d, coarse %d/%d, %u KB",
+        chunkStats.lodLevel, chunkStats.coarseReady, chunkStats.coarseTotal, (unsigned)(chunkStats.coarseBytes / 1024));
+    drawWithOutline(buf, 10.0f, lineY, 560.0f, 22.0f, color);
+    lineY += 24.0f;
+    if (m_pMapChunkManager && m_pMapChunkManager->IsVirtualPaging())
+    {
+        sprintf_s(buf, "Pages: %d drawn, %d from coarser level", chunkStats.pagesDrawn, chunkStats.pageMisses);
+        drawWithOutline(buf, 10.0f, lineY, 560.0f, 22.0f, color);
+        lineY += 24.0f;
+    }
+    sprintf_s(buf, "Map init: %u ms, cache %s", chunkStats.initMicros / 1000,
+        chunkStats.cacheHit ? "hit" : (chunkStats.cacheBuilding ? "building" : "none"));
+    drawWithOutline(buf, 10.0f, lineY, 560.0f, 22.0f, color);
+    lineY += 24.0f;
+    if (chunkStats.cacheMapFailures > 0)
+    {
+        sprintf_s(buf, "Map cache: %d tiles could not be mapped", chunkStats.cacheMapFailures);
+        drawWithOutline(buf, 10.0f, lineY, 560.0f, 22.0f, color);
+        lineY += 24.0f;
+    }
+    if (m_pMapChunkManager)
+    {
+        ChunkDecodeQueue::Stats decodeStats = m_pMapChunkManager->GetDecodeStats();
+        sprintf_s(buf, "Chunk decode: %d queued, %d ready, upload %d in %u us",
+            decodeStats.queued + decodeStats.decoding, decodeStats.ready, decodeStats.lastDrainUploads, decodeStats.lastDrainMicros);
+        drawWithOutline(buf, 10.0f, lineY, 560.0f, 22.0f, color);
+        lineY += 24.0f;
+
+        ChunkCompress::Stats dxtStats = ChunkCompress::GetStats();
+        if (dxtStats.tiles > 0)
+        {
+            double mtexPerSec = dxtStats.micros ? (double)dxtStats.texels / (double)dxtStats.micros : 0.0;
+            sprintf_s(buf, "DXT: %d tiles, %.1f Mtex/s, PSNR avg %.1f / min %.1f dB",
+                dxtStats.tiles, mtexPerSec, dxtStats.psnrAvg, dxtStats.psnrMin);
+            drawWithOutline(buf, 10.0f, lineY, 560.0f, 22.0f, color);
+            lineY += 24.0f;
+        }
+    }
     sprintf_s(buf, "\xC1\xEB\xE8\xEF\xFB: %zu \xE2\xF1\xE5\xE3\xEE, %zu \xE2\xEA\xEB.", blipsTotal, blipsEnabled);
     drawWithOutline(buf, 10.0f, lineY, 420.0f, 22.0f, color);
+    if (m_pBlipManager)
+    {
+        const BlipManager::SyncStats& sync = m_pBlipManager->GetSyncStats();
+        lineY += 24.0f;
+        sprintf_s(buf, "Blip sync: %d added, %d removed, %d updated, %d untouched",
+            sync.added, sync.removed, sync.updated, sync.untouched);
+        drawWithOutline(buf, 10.0f, lineY, 560.0f, 22.0f, color);
+    }
+    lineY += 24.0f;
+    sprintf_s(buf, "2D icons: %d sprites, %d draws (was %d)",
+        m_spriteStats.sprites, m_spriteStats.draws, m_spriteStats.unbatchedDraws);
+    drawWithOutline(buf, 10.0f, lineY, 560.0f, 22.0f, color);
 }
 
 #endif // _DEBUG
@@ -1042,14 +1333,14 @@ void RadarRenderer::RenderBlips()
         m_pCameraController->GetCachedCalculations(offsetWorldX, offsetWorldY, cameraPos, cameraRot);
         const CameraController::CameraState& camState = m_pCameraController->GetState();
         
-        const auto& blips = m_pBlipManager->GetBlips();
+        const int blipCount = m_pBlipManager->GetBlipStore().GetCount();
         D3DXVECTOR2 elementSize(6000.0f, 6000.0f);
         
         // Render player icon in 3D (hidden in plane for round radar; square radar always shows it)
         LPDIRECT3DTEXTURE9 playerTexture = m_pBlipManager->GetBlipTexture(2);
         if (playerTexture && (!m_cachedIsInPlane || !m_bRadarShapeCircle))
         {
-            D3DXVECTOR3 playerPos(camState.posX, camState.posY, 0.1f + (float)(blips.size() + 1) * 0.01f);
+            D3DXVECTOR3 playerPos(camState.posX, camState.posY, 0.1f + (float)(blipCount + 1) * 0.01f);
             
             float playerRotation = 0.0f;
             if (m_cachedPlayer)
@@ -1098,13 +1389,10 @@ void RadarRenderer::RenderBlips2D()
     RadarGeometry::GetRadarHalfExtents(sizeX, sizeY, (float)RadarConfig::GetBorderThickness(), m_bRadarShapeCircle, halfX, halfY);
     if (!m_pBlipManager || !m_pCameraController)
         return;
-    float offsetWorldX, offsetWorldY;
-    D3DXVECTOR3 cameraPos, cameraRot;
-    m_pCameraController->GetCachedCalculations(offsetWorldX, offsetWorldY, cameraPos, cameraRot);
+    // Camera and render target size of this frame, see UpdateProjection
     const CameraController::CameraState& camState = m_pCameraController->GetState();
-    float rtWidth = m_pRenderTarget ? (float)m_pRenderTarget->GetWidth() : 0.0f;
-    float rtHeight = m_pRenderTarget ? (float)m_pRenderTarget->GetHeight() : 0.0f;
-    float screenAspect = (m_width > 0) ? ((float)m_height / (float)m_width) : 1.0f;
+    float rtWidth = m_projection.GetScreenWidth();
+    float rtHeight = m_projection.GetScreenHeight();
 
     // When mission marker is active (checkpoint indicator), don't show waypoint (41) вЂ” same as 2D-RADAR hideLegendsFromOrbit logic
     bool hasMissionCheckpoint = false;
@@ -1122,16 +1410,51 @@ void RadarRenderer::RenderBlips2D()
     float radarRange = CRadar::m_radarRange;
     D3DXVECTOR3 playerPos(camState.posX, camState.posY, 0.0f);
 
-    const std::vector<Blip>& blips = m_pBlipManager->GetBlips();
-    for (size_t i = 0; i < blips.size(); ++i)
+    // Only the columns the filters read
+    const BlipStore& store = m_pBlipManager->GetBlipStore();
+    const int blipCount = store.GetCount();
+    const float* blipX = store.GetX();
+    const float* blipY = store.GetY();
+    const float* blipZ = store.GetZ();
+    const int* blipIcon = store.GetIcon();
+    const uint8_t* blipFlags = store.GetFlags();
+    const float radarRangeSq = radarRange * radarRange;
+
+    // Candidates: the grid cells under the footprint, plus the blips kept on the orbit edge wherever they are
+    m_blipCandidates.clear();
+    if (!m_blipFootprint.valid)
+    {
+        for (int i = 0; i < blipCount; ++i)
+            m_blipCandidates.push_back(i);
+    }
+    else if (m_blipFootprint.count > 0)
+        store.QueryRect(m_blipFootprint.minX, m_blipFootprint.minY, m_blipFootprint.maxX, m_blipFootprint.maxY, m_blipCandidates);
+    const size_t queried = m_blipCandidates.size();
+    for (BlipHandle handle : m_pBlipManager->GetEdgeBlips())
+    {
+        const int index = store.GetIndex(handle);
+        if (index >= 0)
+            m_blipCandidates.push_back(index);
+    }
+    if (m_blipCandidates.size() > queried)
     {
-        if (!blips[i].enabled)
+        std::sort(m_blipCandidates.begin(), m_blipCandidates.end());
+        m_blipCandidates.erase(std::unique(m_blipCandidates.begin(), m_blipCandidates.end()), m_blipCandidates.end());
+    }
+
+    // Gather the blips that pass the filters, project them in one batch, then draw
+    m_overlayBatch.Clear();
+    m_overlayPoints.clear();
+    for (int i : m_blipCandidates)
+    {
+        if (!(blipFlags[i] & BlipStore::FLAG_ENABLED))
             continue;
 
-        if (blips[i].shortRange && !RadarGeometry::IsWithinRadarRange(blips[i].position, playerPos, radarRange))
+        if ((blipFlags[i] & BlipStore::FLAG_SHORT_RANGE)
+            && MathUtils::DistanceSq2D(blipX[i], blipY[i], playerPos.x, playerPos.y) > radarRangeSq)
             continue;
         
-        int iconId = blips[i].iconId;
+        int iconId = blipIcon[i];
         LPDIRECT3DTEXTURE9 blipTexture = m_pBlipManager->GetBlipTexture(iconId);
         bool validIconRange = (iconId >= 0 && iconId <= BlipManager::MAX_BLIP_ID)
             || (iconId >= BlipManager::MORE_ICON_STORE && iconId <= BlipManager::MORE_ICON_TRAIN);
@@ -1146,35 +1469,47 @@ void RadarRenderer::RenderBlips2D()
         if (iconId == RADAR_SPRITE_WAYPOINT && hasMissionCheckpoint)
             continue;
         
-        D3DXVECTOR3 blipWorldPos = blips[i].position;
-        blipWorldPos.z += 0.1f;
+        D3DXVECTOR3 blipWorldPos(blipX[i], blipY[i], blipZ[i] + 0.1f);
+        // Outside the render target it would be outside the orbit too; only the waypoint is kept for its edge icon
+        if (iconId != 41 && !RadarGeometry::FootprintContains(m_blipFootprint, blipWorldPos.x, blipWorldPos.y))
+            continue;
+        m_overlayBatch.Add(blipWorldPos);
+        OverlayPoint point = { i, blipWorldPos.z, blipTexture };
+        m_overlayPoints.push_back(point);
+    }
+    m_projection.ProjectBatch(m_overlayBatch);
+    const RadarOrbit orbit = { centerX, centerY, halfX, halfY };
+    PlaceOverlayPoints(orbit, sizeX, sizeY, playerPos.x, playerPos.y, camState.yaw);
+
+    for (int k = 0; k < m_overlayBatch.GetCount(); ++k)
+    {
+        const OverlayPoint& point = m_overlayPoints[k];
+        int iconId = blipIcon[point.index];
+        LPDIRECT3DTEXTURE9 blipTexture = point.texture;
+        bool projected = m_overlayKind[k] == OVERLAY_PROJECTED;
+        float screenX = m_overlayBatch.screenX[k];
+        float screenY = m_overlayBatch.screenY[k];
         
         bool isVisible = false;
-        
-        float circleScreenX, circleScreenY;
         bool useSquareOrbit = !m_bRadarShapeCircle;
-        if (RadarGeometry::WorldToCircleScreen(blipWorldPos, cameraPos, cameraRot, camState.fov, m_nearPlane, m_farPlane, rtWidth, rtHeight, sizeX, sizeY, centerX, centerY, circleScreenX, circleScreenY, screenAspect))
+        if (projected && m_overlayInside[k])
         {
-            if (RadarGeometry::IsInsideOrbit(circleScreenX, circleScreenY, centerX, centerY, halfX, halfY, useSquareOrbit))
-            {
-                isVisible = true;
-                float iconSize = CalculateBlipSize(24.0f);
-                
-                float iconX = circleScreenX - iconSize * 0.5f;
-                float iconY = circleScreenY - iconSize * 0.5f;
-                m_pDraw->dxDrawImage2D(iconX, iconY, iconSize, iconSize, blipTexture, tocolor(255, 255, 255, 255));
-            }
+            isVisible = true;
+            float iconSize = CalculateBlipSize(24.0f);
+            
+            float iconX = m_overlayX[k] - iconSize * 0.5f;
+            float iconY = m_overlayY[k] - iconSize * 0.5f;
+            QueueSprite(iconId, blipTexture, iconX, iconY, iconSize, 0.0f, tocolor(255, 255, 255, 255));
         }
         
         // Waypoint should ALWAYS be visible on edge, even if behind camera or very far
         if (iconId == 41 && !isVisible)
         {
-            float angle = 0.0f;
+            // Unit direction from the radar centre; cos / sin of the orbit angle without going through the angle
+            float edgeCos = 0.0f, edgeSin = 0.0f;
             bool angleCalculated = false;
             
-            float screenX, screenY;
-            if (MathUtils::WorldToScreen(blipWorldPos, cameraPos, cameraRot, camState.fov, m_nearPlane, m_farPlane,
-                rtWidth, rtHeight, screenX, screenY, screenAspect))
+            if (projected)
             {
                 // Convert from render target coordinates to normalized coordinates
                 float normalizedX = screenX / rtWidth; // 0 to 1
@@ -1188,29 +1523,27 @@ void RadarRenderer::RenderBlips2D()
                 float dirLength = sqrtf(dirX * dirX + dirY * dirY);
                 if (dirLength > 0.01f)
                 {
-                    dirX /= dirLength;
-                    dirY /= dirLength;
-                    
-                    // Calculate angle from center to waypoint in screen space
-                    angle = atan2f(dirY, dirX);
+                    edgeCos = dirX / dirLength;
+                    edgeSin = dirY / dirLength;
                     angleCalculated = true;
                 }
             }
             
             if (!angleCalculated)
             {
-                D3DXVECTOR3 waypointPos2D(blipWorldPos.x, blipWorldPos.y, 0.0f);
-                angleCalculated = MathUtils::DirectionToOrbitAngle(playerPos, waypointPos2D, camState.yaw, angle);
+                float cosYaw, sinYaw;
+                FastMath::SinCos(camState.yaw, sinYaw, cosYaw);
+                angleCalculated = MathUtils::DirectionToOrbit(playerPos.x, playerPos.y, m_overlayBatch.x[k], m_overlayBatch.y[k], cosYaw, sinYaw, edgeCos, edgeSin);
             }
             
             if (angleCalculated)
             {
                 float iconSize = CalculateBlipSize(24.0f);
                 float edgeCenterX, edgeCenterY;
-                RadarGeometry::PointOnOrbitEdge(centerX, centerY, halfX, halfY, cosf(angle), sinf(angle), useSquareOrbit, edgeCenterX, edgeCenterY);
+                RadarGeometry::PointOnOrbitEdge(centerX, centerY, halfX, halfY, edgeCos, edgeSin, useSquareOrbit, edgeCenterX, edgeCenterY);
                 float edgeX = edgeCenterX - iconSize * 0.5f;
                 float edgeY = edgeCenterY - iconSize * 0.5f;
-                m_pDraw->dxDrawImage2D(edgeX, edgeY, iconSize, iconSize, blipTexture, tocolor(255, 255, 255, 255));
+                QueueSprite(iconId, blipTexture, edgeX, edgeY, iconSize, 0.0f, tocolor(255, 255, 255, 255));
             }
         }
     }
@@ -1264,34 +1597,31 @@ static bool IsPlayerOnRunwaySegment(float point1X, float point1Y, float point2X,
     return MathUtils::DistanceSq2D(playerX, playerY, projX, projY) <= runwayWidth * runwayWidth;
 }
 
-// World (x,y) -> circle-space offset from center. Returns true if WorldToScreen succeeded.
-static bool WorldToCircleOffset(float worldX, float worldY, float worldZ,
-    const D3DXVECTOR3& cameraPos, const D3DXVECTOR3& cameraRot, float fov, float nearPlane, float farPlane,
-    float rtWidth, float rtHeight, float sizeX, float sizeY, float centerX, float centerY,
-    float& outCircleX, float& outCircleY, float projectionAspect = 0.0f)
+// World (x,y) -> circle-space offset from center. Returns true if the point projects.
+static bool WorldToCircleOffset(float worldX, float worldY, float worldZ, const RadarProjection& projection,
+    float sizeX, float sizeY, float centerX, float centerY, float& outCircleX, float& outCircleY)
 {
     D3DXVECTOR3 worldPos(worldX + RadarGeometry::RADAR_OFFSET_X, worldY + RadarGeometry::RADAR_OFFSET_Y, 0.1f);
     float screenX, screenY;
-    if (!MathUtils::WorldToScreen(worldPos, cameraPos, cameraRot, fov, nearPlane, farPlane, rtWidth, rtHeight, screenX, screenY, projectionAspect))
+    if (!projection.Project(worldPos, screenX, screenY))
         return false;
-    float normalizedX = screenX / rtWidth, normalizedY = screenY / rtHeight;
+    float normalizedX = screenX / projection.GetScreenWidth(), normalizedY = screenY / projection.GetScreenHeight();
     outCircleX = (normalizedX - 0.5f) * sizeX;
     outCircleY = (normalizedY - 0.5f) * sizeY;
     return true;
 }
 
 static bool GetAirstripOffsetRangeInsideCircle(float stripCenterX, float stripCenterY, float stripDirRad, float halfLen, float playerZ,
-    float centerX, float centerY, float innerRadius,
-    const D3DXVECTOR3& cameraPos, const D3DXVECTOR3& cameraRot, float fov, float nearPlane, float farPlane,
-    float rtWidth, float rtHeight, float sizeX, float sizeY,
-    float& outMinOffset, float& outMaxOffset, float projectionAspect = 0.0f)
+    float centerX, float centerY, float innerRadius, const RadarProjection& projection, float sizeX, float sizeY,
+    float& outMinOffset, float& outMaxOffset)
 {
     const float stepWorld = 100.0f;
-    float cosDir = cosf(stripDirRad), sinDir = sinf(stripDirRad);
+    float cosDir, sinDir;
+    FastMath::SinCos(stripDirRad, sinDir, cosDir);
     float cx, cy, sx, sy;
-    if (!WorldToCircleOffset(stripCenterX, stripCenterY, playerZ, cameraPos, cameraRot, fov, nearPlane, farPlane, rtWidth, rtHeight, sizeX, sizeY, centerX, centerY, cx, cy, projectionAspect))
+    if (!WorldToCircleOffset(stripCenterX, stripCenterY, playerZ, projection, sizeX, sizeY, centerX, centerY, cx, cy))
         return false;
-    if (!WorldToCircleOffset(stripCenterX + stepWorld * cosDir, stripCenterY + stepWorld * sinDir, playerZ, cameraPos, cameraRot, fov, nearPlane, farPlane, rtWidth, rtHeight, sizeX, sizeY, centerX, centerY, sx, sy, projectionAspect))
+    if (!WorldToCircleOffset(stripCenterX + stepWorld * cosDir, stripCenterY + stepWorld * sinDir, playerZ, projection, sizeX, sizeY, centerX, centerY, sx, sy))
         return false;
     float Dx = (sx - cx) / stepWorld, Dy = (sy - cy) / stepWorld;
     float a = Dx * Dx + Dy * Dy;
@@ -1358,13 +1688,10 @@ void RadarRenderer::RenderAirstrips()
     RadarGeometry::GetRadarHalfExtents(sizeX, sizeY, (float)RadarConfig::GetBorderThickness(), m_bRadarShapeCircle, halfX, halfY);
     float iconSize = CalculateBlipSize(24.0f);
 
-    float offsetWorldX, offsetWorldY;
-    D3DXVECTOR3 cameraPos, cameraRot;
-    m_pCameraController->GetCachedCalculations(offsetWorldX, offsetWorldY, cameraPos, cameraRot);
+    // Camera and render target size of this frame, see UpdateProjection
     const CameraController::CameraState& camState = m_pCameraController->GetState();
-    float rtWidth = m_pRenderTarget ? (float)m_pRenderTarget->GetWidth() : 0.0f;
-    float rtHeight = m_pRenderTarget ? (float)m_pRenderTarget->GetHeight() : 0.0f;
-    float screenAspect = (m_width > 0) ? ((float)m_height / (float)m_width) : 1.0f;
+    float rtWidth = m_projection.GetScreenWidth();
+    float rtHeight = m_projection.GetScreenHeight();
 
     float playerX = 0.0f, playerY = 0.0f, playerZ = 0.0f;
     if (m_cachedPlayer)
@@ -1399,7 +1726,8 @@ void RadarRenderer::RenderAirstrips()
         {
             float halfLen = strip.radius * 0.5f;
             float dirRad = strip.direction * (3.14159265f / 180.0f);
-            float cosD = cosf(dirRad), sinD = sinf(dirRad);
+            float cosD, sinD;
+            FastMath::SinCos(dirRad, sinD, cosD);
             float point1X = strip.posX + halfLen * cosD, point1Y = strip.posY + halfLen * sinD;
             float point2X = strip.posX - halfLen * cosD, point2Y = strip.posY - halfLen * sinD;
             float runwayWidth = strip.radius * 0.25f;
@@ -1407,13 +1735,13 @@ void RadarRenderer::RenderAirstrips()
         }
 
         float airstripCenterCircleX, airstripCenterCircleY;
-        bool airstripCenterVisible = WorldToCircleOffset(strip.posX, strip.posY, playerZ, cameraPos, cameraRot, camState.fov, m_nearPlane, m_farPlane, rtWidth, rtHeight, sizeX, sizeY, centerX, centerY, airstripCenterCircleX, airstripCenterCircleY, screenAspect);
+        bool airstripCenterVisible = WorldToCircleOffset(strip.posX, strip.posY, playerZ, m_projection, sizeX, sizeY, centerX, centerY, airstripCenterCircleX, airstripCenterCircleY);
         bool show56Light = airstripCenterVisible || playerOnRunwaySegment;
         bool isOnOrbit = !show56Light;
 
         D3DXVECTOR3 blipWorldPos(wx + RadarGeometry::RADAR_OFFSET_X, wy + RadarGeometry::RADAR_OFFSET_Y, 0.1f);
         float screenX, screenY;
-        bool visible = MathUtils::WorldToScreen(blipWorldPos, cameraPos, cameraRot, camState.fov, m_nearPlane, m_farPlane, rtWidth, rtHeight, screenX, screenY, screenAspect);
+        bool visible = m_projection.Project(blipWorldPos, screenX, screenY);
         float circleScreenX, circleScreenY;
         float dx, dy;
         if (visible)
@@ -1426,17 +1754,20 @@ void RadarRenderer::RenderAirstrips()
         }
         else
         {
-            D3DXVECTOR3 playerPos(camState.posX, camState.posY, 0.0f);
-            D3DXVECTOR3 airstripPos2D(wx + RadarGeometry::RADAR_OFFSET_X, wy + RadarGeometry::RADAR_OFFSET_Y, 0.0f);
-            float angle;
-            if (!MathUtils::DirectionToOrbitAngle(playerPos, airstripPos2D, camState.yaw, angle))
+            float cosYaw, sinYaw;
+            FastMath::SinCos(camState.yaw, sinYaw, cosYaw);
+            if (!MathUtils::DirectionToOrbit(camState.posX, camState.posY, wx + RadarGeometry::RADAR_OFFSET_X, wy + RadarGeometry::RADAR_OFFSET_Y,
+                                             cosYaw, sinYaw, dx, dy))
                 return;
-            dx = cosf(angle);
-            dy = sinf(angle);
             bool useSquareOrbit = !m_bRadarShapeCircle;
             RadarGeometry::PointOnOrbitEdge(centerX, centerY, halfX, halfY, dx, dy, useSquareOrbit, circleScreenX, circleScreenY);
         }
 
+        // Direction of the icon from the centre, what atan2f + cosf / sinf used to give (angle 0 for the centre itself)
+        float orbitLen = sqrtf(dx * dx + dy * dy);
+        float orbitCos = (orbitLen > 0.0f) ? dx / orbitLen : 1.0f;
+        float orbitSin = (orbitLen > 0.0f) ? dy / orbitLen : 0.0f;
+
         unsigned char airstripSprite = isOnOrbit ? RADAR_SPRITE_RUNWAY : RADAR_SPRITE_LIGHT;
         LPDIRECT3DTEXTURE9 iconTex = m_pBlipManager->GetBlipTexture(airstripSprite);
         if (!iconTex)
@@ -1454,13 +1785,12 @@ void RadarRenderer::RenderAirstrips()
                 float orbitInset = iconSize * 0.5f;
                 float insetHalfX = (halfX > orbitInset) ? (halfX - orbitInset) : halfX;
                 float insetHalfY = (halfY > orbitInset) ? (halfY - orbitInset) : halfY;
-                float orbitAngle = atan2f(dy, dx);
                 bool useSquareOrbit = !m_bRadarShapeCircle;
-                RadarGeometry::PointOnOrbitEdge(centerX, centerY, insetHalfX, insetHalfY, cosf(orbitAngle), sinf(orbitAngle), useSquareOrbit, circleScreenX, circleScreenY);
+                RadarGeometry::PointOnOrbitEdge(centerX, centerY, insetHalfX, insetHalfY, orbitCos, orbitSin, useSquareOrbit, circleScreenX, circleScreenY);
             }
             float iconX = circleScreenX - iconSize * 0.5f;
             float iconY = circleScreenY - iconSize * 0.5f;
-            m_pDraw->dxDrawImage2DRotated(iconX, iconY, iconSize, iconSize, iconTex, rotation, tocolor(255, 255, 255, 255));
+            QueueSprite(airstripSprite, iconTex, iconX, iconY, iconSize, rotation, tocolor(255, 255, 255, 255));
         }
         else if (airstripIdx >= 0)
         {
@@ -1469,7 +1799,7 @@ void RadarRenderer::RenderAirstrips()
             float rangeRadius = (halfX < halfY) ? halfX : halfY;
             float minOffset, maxOffset;
             bool hasRange = GetAirstripOffsetRangeInsideCircle(stripInner.posX, stripInner.posY, runwayDirectionRad, halfLen, playerZ,
-                centerX, centerY, rangeRadius, cameraPos, cameraRot, camState.fov, m_nearPlane, m_farPlane, rtWidth, rtHeight, sizeX, sizeY, minOffset, maxOffset, screenAspect);
+                centerX, centerY, rangeRadius, m_projection, sizeX, sizeY, minOffset, maxOffset);
             float offset;
             if (!hasRange || maxOffset <= minOffset)
                 offset = 0.0f;
@@ -1481,17 +1811,19 @@ void RadarRenderer::RenderAirstrips()
                 float newMin = centerOffset - animLen * 0.5f;
                 float newMax = centerOffset + animLen * 0.5f;
                 unsigned int timeMs = CTimer::m_snTimeInMilliseconds;
-                const float cycleMs = 350.0f;
-                float t = static_cast<float>(timeMs) / cycleMs;
-                float tSmooth = 0.5f + 0.5f * sinf(t * 6.283185307f);
+                const unsigned int cycleMs = 350;
+                // Phase of the current cycle: keeps the angle in FastMath's range however long the game runs
+                float t = static_cast<float>(timeMs % cycleMs) / static_cast<float>(cycleMs);
+                float tSmooth = 0.5f + 0.5f * FastMath::Sin(t * FastMath::TWO_PI);
                 offset = newMin + (newMax - newMin) * tSmooth;
             }
             bool useSquareOrbit = !m_bRadarShapeCircle;
 
-            float cosDir = cosf(runwayDirectionRad), sinDir = sinf(runwayDirectionRad);
+            float cosDir, sinDir;
+            FastMath::SinCos(runwayDirectionRad, sinDir, cosDir);
             float animX = stripInner.posX + offset * cosDir, animY = stripInner.posY + offset * sinDir;
             float animCircleX, animCircleY;
-            bool lightPosOk = WorldToCircleOffset(animX, animY, playerZ, cameraPos, cameraRot, camState.fov, m_nearPlane, m_farPlane, rtWidth, rtHeight, sizeX, sizeY, centerX, centerY, animCircleX, animCircleY, screenAspect);
+            bool lightPosOk = WorldToCircleOffset(animX, animY, playerZ, m_projection, sizeX, sizeY, centerX, centerY, animCircleX, animCircleY);
 
             // 56 LIGHT: always show when on runway, never on orbit. Keep icon inside radar with margin.
             LPDIRECT3DTEXTURE9 lightTex = m_pBlipManager->GetBlipTexture(RADAR_SPRITE_LIGHT);
@@ -1509,11 +1841,10 @@ void RadarRenderer::RenderAirstrips()
                 }
                 else
                 {
-                    float orbitAngle = atan2f(dy, dx);
                     float innerRadius = ((halfX < halfY) ? halfX : halfY) - iconSize;
                     if (innerRadius < 10.0f) innerRadius = 10.0f;
-                    circleScreenX = centerX + cosf(orbitAngle) * innerRadius;
-                    circleScreenY = centerY + sinf(orbitAngle) * innerRadius;
+                    circleScreenX = centerX + orbitCos * innerRadius;
+                    circleScreenY = centerY + orbitSin * innerRadius;
                 }
                 float iconMargin = iconSize * 0.6f;
                 float innerHalfX = (halfX > iconMargin) ? (halfX - iconMargin) : halfX;
@@ -1532,10 +1863,11 @@ void RadarRenderer::RenderAirstrips()
                     else
                         RadarGeometry::ClampToOrbit(circleScreenX, circleScreenY, centerX, centerY, innerHalfX, innerHalfY, circleScreenX, circleScreenY, useSquareOrbit);
                 }
+                int spriteToDraw = switchTo57 ? RADAR_SPRITE_RUNWAY : RADAR_SPRITE_LIGHT;
                 LPDIRECT3DTEXTURE9 iconToDraw = switchTo57 ? m_pBlipManager->GetBlipTexture(RADAR_SPRITE_RUNWAY) : lightTex;
                 float iconX = circleScreenX - iconSize * 0.5f;
                 float iconY = circleScreenY - iconSize * 0.5f;
-                m_pDraw->dxDrawImage2DRotated(iconX, iconY, iconSize, iconSize, iconToDraw, neededClamp ? rotation : 0.0f, tocolor(255, 255, 255, 255));
+                QueueSprite(spriteToDraw, iconToDraw, iconX, iconY, iconSize, neededClamp ? rotation : 0.0f, tocolor(255, 255, 255, 255));
             }
         }
     }
@@ -1558,15 +1890,9 @@ void RadarRenderer::RenderIndicatorBlips()
     float halfX, halfY;
     RadarGeometry::GetRadarHalfExtents(sizeX, sizeY, (float)RadarConfig::GetBorderThickness(), m_bRadarShapeCircle, halfX, halfY);
     float indicatorSize = CalculateBlipSize(13.0f);
-    bool useSquareOrbit = !m_bRadarShapeCircle;
 
-    float offsetWorldX, offsetWorldY;
-    D3DXVECTOR3 cameraPos, cameraRot;
-    m_pCameraController->GetCachedCalculations(offsetWorldX, offsetWorldY, cameraPos, cameraRot);
+    // Camera of this frame; the projection is built in UpdateProjection
     const CameraController::CameraState& camState = m_pCameraController->GetState();
-    float rtWidth = m_pRenderTarget ? (float)m_pRenderTarget->GetWidth() : 0.0f;
-    float rtHeight = m_pRenderTarget ? (float)m_pRenderTarget->GetHeight() : 0.0f;
-    float screenAspect = (m_width > 0) ? ((float)m_height / (float)m_width) : 1.0f;
 
     float playerZ = 0.0f;
     if (m_cachedPlayer)
@@ -1575,6 +1901,11 @@ void RadarRenderer::RenderIndicatorBlips()
         playerZ = ppos.z;
     }
 
+    D3DXVECTOR3 playerPos(camState.posX, camState.posY, 0.0f);
+
+    // Gather the traces that need an indicator, project them in one batch, then draw
+    m_overlayBatch.Clear();
+    m_overlayPoints.clear();
     for (unsigned int i = 0; i < MAX_RADAR_TRACES; i++)
     {
         tRadarTrace& trace = CRadar::ms_RadarTrace[i];
@@ -1592,32 +1923,24 @@ void RadarRenderer::RenderIndicatorBlips()
 
         float wx, wy, wz;
         GetLegendTraceWorldPosition(trace, wx, wy, wz);
-        D3DXVECTOR3 blipWorldPos(wx + RadarGeometry::RADAR_OFFSET_X, wy + RadarGeometry::RADAR_OFFSET_Y, 0.1f);
+        m_overlayBatch.Add(D3DXVECTOR3(wx + RadarGeometry::RADAR_OFFSET_X, wy + RadarGeometry::RADAR_OFFSET_Y, 0.1f));
+        OverlayPoint point = { (int)i, wz, nullptr };
+        m_overlayPoints.push_back(point);
+    }
+    m_projection.ProjectBatch(m_overlayBatch);
+    const RadarOrbit orbit = { centerX, centerY, halfX, halfY };
+    PlaceOverlayPoints(orbit, sizeX, sizeY, playerPos.x, playerPos.y, camState.yaw);
 
-        float screenX, screenY;
-        if (!MathUtils::WorldToScreen(blipWorldPos, cameraPos, cameraRot, camState.fov, m_nearPlane, m_farPlane, rtWidth, rtHeight, screenX, screenY, screenAspect))
-        {
-            D3DXVECTOR3 playerPos(camState.posX, camState.posY, 0.0f);
-            D3DXVECTOR3 blipPos2D(wx + RadarGeometry::RADAR_OFFSET_X, wy + RadarGeometry::RADAR_OFFSET_Y, 0.0f);
-            float angle;
-            if (!MathUtils::DirectionToOrbitAngle(playerPos, blipPos2D, camState.yaw, angle))
-                continue;
-            float iconX, iconY;
-            RadarGeometry::PointOnOrbitEdge(centerX, centerY, halfX, halfY, cosf(angle), sinf(angle), useSquareOrbit, iconX, iconY);
-            DWORD color = BlipManager::TraceColorToD3D(trace.m_nColour, trace.m_bBright != 0, trace.m_bFriendly != 0);
-            m_pDraw->dxDrawGTAIndicatorBlip(iconX, iconY, indicatorSize, color, BlipManager::GetHeightIndicatorType(wz, playerZ, 2.5f));
+    // Indicators stay on the orbit: inside where projected, clamped or on the edge otherwise
+    for (int k = 0; k < m_overlayBatch.GetCount(); ++k)
+    {
+        if (m_overlayKind[k] == OVERLAY_NONE)
             continue;
-        }
-
-        float normalizedX = screenX / rtWidth;
-        float normalizedY = screenY / rtHeight;
-        float circleScreenX = centerX + (normalizedX - 0.5f) * sizeX;
-        float circleScreenY = centerY + (normalizedY - 0.5f) * sizeY;
-        if (!RadarGeometry::IsInsideOrbit(circleScreenX, circleScreenY, centerX, centerY, halfX, halfY, useSquareOrbit))
-            RadarGeometry::ClampToOrbit(circleScreenX, circleScreenY, centerX, centerY, halfX, halfY, circleScreenX, circleScreenY, useSquareOrbit);
-
+        const OverlayPoint& point = m_overlayPoints[k];
+        const tRadarTrace& trace = CRadar::ms_RadarTrace[point.index];
         DWORD color = BlipManager::TraceColorToD3D(trace.m_nColour, trace.m_bBright != 0, trace.m_bFriendly != 0);
-        m_pDraw->dxDrawGTAIndicatorBlip(circleScreenX, circleScreenY, indicatorSize, color, BlipManager::GetHeightIndicatorType(wz, playerZ, 2.5f));
+        eHeightIndicatorType heightType = BlipManager::GetHeightIndicatorType(point.worldZ, playerZ, 2.5f);
+        QueueIndicator(m_overlayX[k], m_overlayY[k], indicatorSize, color, heightType);
     }
 
     // Enemy missiles/rockets (from 2D-RADAR): only show rockets not created by player or player vehicle
@@ -1630,6 +1953,8 @@ void RadarRenderer::RenderIndicatorBlips()
         DWORD missileColor = tocolor(255, 0, 0, 255);
         float missileIndicatorSize = CalculateBlipSize(12.0f);
 
+        m_overlayBatch.Clear();
+        m_overlayPoints.clear();
         for (unsigned int i = 0; i < MAX_PROJECTILE_INFOS; i++)
         {
             CProjectileInfo& info = gaProjectileInfo[i];
@@ -1643,29 +1968,19 @@ void RadarRenderer::RenderIndicatorBlips()
                 continue;
 
             CVector worldPos = CProjectileInfo::ms_apProjectile[i]->GetPosition();
-            D3DXVECTOR3 missileWorldPos(worldPos.x + RadarGeometry::RADAR_OFFSET_X, worldPos.y + RadarGeometry::RADAR_OFFSET_Y, 0.1f);
+            m_overlayBatch.Add(D3DXVECTOR3(worldPos.x + RadarGeometry::RADAR_OFFSET_X, worldPos.y + RadarGeometry::RADAR_OFFSET_Y, 0.1f));
+            OverlayPoint point = { (int)i, worldPos.z, nullptr };
+            m_overlayPoints.push_back(point);
+        }
+        m_projection.ProjectBatch(m_overlayBatch);
+        PlaceOverlayPoints(orbit, sizeX, sizeY, playerPos.x, playerPos.y, camState.yaw);
 
-            float screenX, screenY;
-            if (!MathUtils::WorldToScreen(missileWorldPos, cameraPos, cameraRot, camState.fov, m_nearPlane, m_farPlane, rtWidth, rtHeight, screenX, screenY, screenAspect))
-            {
-                D3DXVECTOR3 playerPos(camState.posX, camState.posY, 0.0f);
-                D3DXVECTOR3 missilePos2D(worldPos.x + RadarGeometry::RADAR_OFFSET_X, worldPos.y + RadarGeometry::RADAR_OFFSET_Y, 0.0f);
-                float angle;
-                if (!MathUtils::DirectionToOrbitAngle(playerPos, missilePos2D, camState.yaw, angle))
-                    continue;
-                float iconX, iconY;
-                RadarGeometry::PointOnOrbitEdge(centerX, centerY, halfX, halfY, cosf(angle), sinf(angle), useSquareOrbit, iconX, iconY);
-                m_pDraw->dxDrawGTAIndicatorBlip(iconX, iconY, missileIndicatorSize, missileColor, BlipManager::GetHeightIndicatorType(worldPos.z, playerPosR.z, 2.5f));
+        for (int k = 0; k < m_overlayBatch.GetCount(); ++k)
+        {
+            if (m_overlayKind[k] == OVERLAY_NONE)
                 continue;
-            }
-
-            float normalizedX = screenX / rtWidth;
-            float normalizedY = screenY / rtHeight;
-            float circleScreenX = centerX + (normalizedX - 0.5f) * sizeX;
-            float circleScreenY = centerY + (normalizedY - 0.5f) * sizeY;
-            if (!RadarGeometry::IsInsideOrbit(circleScreenX, circleScreenY, centerX, centerY, halfX, halfY, useSquareOrbit))
-                RadarGeometry::ClampToOrbit(circleScreenX, circleScreenY, centerX, centerY, halfX, halfY, circleScreenX, circleScreenY, useSquareOrbit);
-            m_pDraw->dxDrawGTAIndicatorBlip(circleScreenX, circleScreenY, missileIndicatorSize, missileColor, BlipManager::GetHeightIndicatorType(worldPos.z, playerPosR.z, 2.5f));
+            eHeightIndicatorType heightType = BlipManager::GetHeightIndicatorType(m_overlayPoints[k].worldZ, playerPosR.z, 2.5f);
+            QueueIndicator(m_overlayX[k], m_overlayY[k], missileIndicatorSize, missileColor, heightType);
         }
     }
 }
@@ -1688,14 +2003,8 @@ void RadarRenderer::RenderLegends()
     float centerY = circleY + sizeY * 0.5f;
     float halfX, halfY;
     RadarGeometry::GetRadarHalfExtents(sizeX, sizeY, (float)RadarConfig::GetBorderThickness(), m_bRadarShapeCircle, halfX, halfY);
-    bool useSquareOrbit = !m_bRadarShapeCircle;
-    float offsetWorldX, offsetWorldY;
-    D3DXVECTOR3 cameraPos, cameraRot;
-    m_pCameraController->GetCachedCalculations(offsetWorldX, offsetWorldY, cameraPos, cameraRot);
+    // Camera of this frame; the projection is built in UpdateProjection
     const CameraController::CameraState& camState = m_pCameraController->GetState();
-    float rtWidth = m_pRenderTarget ? (float)m_pRenderTarget->GetWidth() : 0.0f;
-    float rtHeight = m_pRenderTarget ? (float)m_pRenderTarget->GetHeight() : 0.0f;
-    float screenAspect = (m_width > 0) ? ((float)m_height / (float)m_width) : 1.0f;
 
     bool hideLegendsFromOrbit = false;
     for (unsigned int i = 0; i < MAX_RADAR_TRACES; i++)
@@ -1711,6 +2020,11 @@ void RadarRenderer::RenderLegends()
     float iconSize = CalculateBlipSize(24.0f);
     DWORD iconColor = tocolor(255, 255, 255, 255);
 
+    D3DXVECTOR3 playerPos(camState.posX, camState.posY, 0.0f);
+
+    // Gather the legend traces, project them in one batch, then draw
+    m_overlayBatch.Clear();
+    m_overlayPoints.clear();
     for (unsigned int i = 0; i < MAX_RADAR_TRACES; i++)
     {
         tRadarTrace& trace = CRadar::ms_RadarTrace[i];
@@ -1724,43 +2038,24 @@ void RadarRenderer::RenderLegends()
         float wx, wy, wz;
         GetLegendTraceWorldPosition(trace, wx, wy, wz);
         // Same height as regular blips: fixed 0.1f (radar plane), not world Z
-        D3DXVECTOR3 blipWorldPos(wx + RadarGeometry::RADAR_OFFSET_X, wy + RadarGeometry::RADAR_OFFSET_Y, 0.1f);
+        m_overlayBatch.Add(D3DXVECTOR3(wx + RadarGeometry::RADAR_OFFSET_X, wy + RadarGeometry::RADAR_OFFSET_Y, 0.1f));
+        OverlayPoint point = { (int)i, wz, blipTexture };
+        m_overlayPoints.push_back(point);
+    }
+    m_projection.ProjectBatch(m_overlayBatch);
+    const RadarOrbit orbit = { centerX, centerY, halfX, halfY };
+    PlaceOverlayPoints(orbit, sizeX, sizeY, playerPos.x, playerPos.y, camState.yaw);
 
-        float screenX, screenY;
-        if (!MathUtils::WorldToScreen(blipWorldPos, cameraPos, cameraRot, camState.fov, m_nearPlane, m_farPlane, rtWidth, rtHeight, screenX, screenY, screenAspect))
-        {
-            if (hideLegendsFromOrbit)
-                continue;
-            D3DXVECTOR3 playerPos(camState.posX, camState.posY, 0.0f);
-            D3DXVECTOR3 legendPos2D(wx + RadarGeometry::RADAR_OFFSET_X, wy + RadarGeometry::RADAR_OFFSET_Y, 0.0f);
-            float angle;
-            if (!MathUtils::DirectionToOrbitAngle(playerPos, legendPos2D, camState.yaw, angle))
-                continue;
-            float edgeCenterX, edgeCenterY;
-            RadarGeometry::PointOnOrbitEdge(centerX, centerY, halfX, halfY, cosf(angle), sinf(angle), useSquareOrbit, edgeCenterX, edgeCenterY);
-            float edgeX = edgeCenterX - iconSize * 0.5f;
-            float edgeY = edgeCenterY - iconSize * 0.5f;
-            m_pDraw->dxDrawImage2D(edgeX, edgeY, iconSize, iconSize, blipTexture, iconColor);
+    for (int k = 0; k < m_overlayBatch.GetCount(); ++k)
+    {
+        if (m_overlayKind[k] == OVERLAY_NONE)
             continue;
-        }
-
-        float normalizedX = screenX / rtWidth;
-        float normalizedY = screenY / rtHeight;
-        float circleScreenX = centerX + (normalizedX - 0.5f) * sizeX;
-        float circleScreenY = centerY + (normalizedY - 0.5f) * sizeY;
-
-        if (RadarGeometry::IsInsideOrbit(circleScreenX, circleScreenY, centerX, centerY, halfX, halfY, useSquareOrbit))
-        {
-            float iconX = circleScreenX - iconSize * 0.5f;
-            float iconY = circleScreenY - iconSize * 0.5f;
-            m_pDraw->dxDrawImage2D(iconX, iconY, iconSize, iconSize, blipTexture, iconColor);
-        }
-        else if (!hideLegendsFromOrbit)
-        {
-            float orbitX, orbitY;
-            RadarGeometry::ClampToOrbit(circleScreenX, circleScreenY, centerX, centerY, halfX, halfY, orbitX, orbitY, useSquareOrbit);
-            m_pDraw->dxDrawImage2D(orbitX - iconSize * 0.5f, orbitY - iconSize * 0.5f, iconSize, iconSize, blipTexture, iconColor);
-        }
+        // Clamped or behind the camera: on the orbit edge, hidden while an indicator is shown
+        if (!m_overlayInside[k] && hideLegendsFromOrbit)
+            continue;
+        float iconX = m_overlayX[k] - iconSize * 0.5f;
+        float iconY = m_overlayY[k] - iconSize * 0.5f;
+        QueueSprite(CRadar::ms_RadarTrace[m_overlayPoints[k].index].m_nRadarSprite, m_overlayPoints[k].texture, iconX, iconY, iconSize, 0.0f, iconColor);
     }
 }
 
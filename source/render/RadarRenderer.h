@@ -12,6 +12,8 @@
 #include "../utils/ColorUtils.h"
 #include "BlipTypes.h"
 #include "DrawResources.h"
+#include "RadarProjection.h"
+#include "RadarGeometry.h"
 
 class ShaderManager;
 class CameraController;
@@ -23,6 +25,7 @@ class DxDrawPrimitives;
 class RenderTarget;
 class RenderRadio;
 class CPed;
+struct Image3DBatchVertex;
 
 class RadarRenderer
 {
@@ -80,11 +83,23 @@ private:
     void RenderAirstrips();
     void RenderIndicatorBlips();
     void RenderLegends();
+    // Overlay icon queue over BlipManager's atlas, see m_spriteBatch
+    void QueueSprite(int spriteId, LPDIRECT3DTEXTURE9 texture, float x, float y, float size, float rotation, DWORD color);
+    void QueueIndicator(float screenX, float screenY, float size, DWORD color, eHeightIndicatorType type);
+    void FlushSprites();
 
     void RenderRadarTargetContents(float circleX, float circleY, float sizeX, float sizeY);
     void RenderRadarOverlays(float circleX, float circleY, float sizeX, float sizeY);
 
     void UpdateDrawResources();
+    // Camera of this frame for the 2D overlays (blips, legends, airstrips, indicators); after the camera update
+    void UpdateProjection();
+    // m_overlayBatch after ProjectBatch -> m_overlayX / Y / Kind / Inside; the orbit shape is picked once per batch
+    void PlaceOverlayPoints(const RadarOrbit& orbit, float sizeX, float sizeY, float playerX, float playerY, float yaw);
+    template<RadarOrbitShape Shape>
+    void PlaceOverlayPoints(const RadarOrbit& orbit, float sizeX, float sizeY, float playerX, float playerY, float yaw);
+    // North marker, line and ring plane from blip.txd (PNG fallbacks); again after a blip.txd reload
+    void LoadBlipTxdTextures();
 
 #ifdef _DEBUG
     void dxDrawRenderDebugMemory();
@@ -137,6 +152,42 @@ private:
 
     float                 m_nearPlane;
     float                 m_farPlane;
+    RadarProjection       m_projection;        // render target pixels, screen aspect; rebuilt each Render
+    RadarFootprint        m_blipFootprint;     // blip plane seen by m_projection, half an icon wider
+    std::vector<int>      m_blipCandidates;    // store indices RenderBlips2D tests, ascending
+
+    // Overlay points of one pass (blips, indicators, legends), projected together with ProjectBatch
+    struct OverlayPoint
+    {
+        int                index;      // blip / trace / projectile index
+        float              worldZ;     // for the height indicator
+        LPDIRECT3DTEXTURE9 texture;
+    };
+    RadarProjectionBatch      m_overlayBatch;
+    std::vector<OverlayPoint> m_overlayPoints;
+
+    // Where each m_overlayBatch point goes on the radar, filled by PlaceOverlayPoints after ProjectBatch
+    enum OverlayKind : uint8_t
+    {
+        OVERLAY_PROJECTED,      // projected: inside, or clamped onto the orbit
+        OVERLAY_EDGE,           // not projected: on the orbit edge towards it
+        OVERLAY_NONE,           // not projected and on top of the player: not drawn
+    };
+    std::vector<float>        m_overlayX;
+    std::vector<float>        m_overlayY;
+    std::vector<uint8_t>      m_overlayKind;
+    std::vector<uint8_t>      m_overlayInside;  // projected and inside the orbit
+
+    // 2D icons of the overlay pass (north marker, blips, airstrips, indicators, legends) in blip atlas
+    // coordinates, drawn in one call by FlushSprites; an icon outside the atlas flushes and draws on its own
+    struct SpriteStats
+    {
+        int sprites;            // icons and indicator shapes queued
+        int draws;              // draw calls they took
+        int unbatchedDraws;     // one per icon, two per indicator (before the atlas)
+    };
+    std::vector<ScreenVertex> m_spriteBatch;
+    SpriteStats               m_spriteStats;
     float                 m_initialAircraftAltitude;
     bool                  m_bWasInAircraft;
 
@@ -146,7 +197,16 @@ private:
 
     bool                  m_bInitialized;
 
+    // Map tiles of the current frame grouped by texture (atlas page or own tile texture), one draw each
+    struct MapTileBatch
+    {
+        LPDIRECT3DTEXTURE9              texture;
+        std::vector<Image3DBatchVertex> vertices;
+    };
+    std::vector<MapTileBatch> m_mapBatches;
+
 #ifdef _DEBUG
     int                   m_debugChunksRenderedLastFrame;
+    int                   m_debugMapDrawCallsLastFrame;
 #endif
 };
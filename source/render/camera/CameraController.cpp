@@ -43,6 +43,8 @@ CameraController::CameraController()
     m_state.posY    = 0.0f;
     m_state.offsetY = DEFAULT_CAMERA_OFFSET_Y;
     m_state.fov     = DEFAULT_FOV_DEGREES * D3DX_PI / 180.0f;
+    m_state.velX    = 0.0f;
+    m_state.velY    = 0.0f;
 
     m_target.height   = DEFAULT_CAMERA_HEIGHT;
     m_target.offsetY   = DEFAULT_CAMERA_OFFSET_Y;
@@ -75,6 +77,11 @@ void CameraController::UpdateFromGame(CPed* player)
             CVector pos = player->GetPosition();
             m_state.posX = pos.x + 3000.0f;
             m_state.posY = pos.y - 3000.0f;
+
+            // m_vecMoveSpeed is per 1/50 s
+            CPhysical* body = (player->bInVehicle && player->m_pVehicle) ? static_cast<CPhysical*>(player->m_pVehicle) : static_cast<CPhysical*>(player);
+            m_state.velX = body->m_vecMoveSpeed.x * 50.0f;
+            m_state.velY = body->m_vecMoveSpeed.y * 50.0f;
         }
 
         CVector forward = TheCamera.GetForward();
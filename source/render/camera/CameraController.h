@@ -23,6 +23,8 @@ public:
         float posY;
         float offsetY;
         float fov;
+        float velX;     // player (or vehicle) velocity, units per second
+        float velY;
     };
 
     struct CameraTarget
@@ -5,6 +5,8 @@
 
 #include "DxDrawPrimitives.h"
 #include "ColorUtils.h"
+#include "MathUtils.h"
+#include "FastMath.h"
 #include <cmath>
 
 DxDrawPrimitives::DxDrawPrimitives(LPDIRECT3DDEVICE9 pDevice)
@@ -376,17 +378,20 @@ void DxDrawPrimitives::dxDrawRectangle(float x, float y, float width, float heig
     RestoreRenderStates(saved);
 }
 
+// Height indicator shapes by eHeightIndicatorType, in units of half the size
+static const struct { float dx[4], dy[4]; int n; D3DPRIMITIVETYPE prim; UINT count; } g_indicatorShapes[] = {
+    {{ -1, 1, 0 }, { -1, -1, 1 }, 3, D3DPT_TRIANGLELIST, 1 },
+    {{ 0, -1, 1 }, { -1, 1, 1 }, 3, D3DPT_TRIANGLELIST, 1 },
+    {{ -1, 1, -1, 1 }, { -1, -1, 1, 1 }, 4, D3DPT_TRIANGLESTRIP, 2 }
+};
+static const float INDICATOR_BORDER = 3.0f;
+
 void DxDrawPrimitives::dxDrawGTAIndicatorBlip(float screenX, float screenY, float size, DWORD color, eHeightIndicatorType type)
 {
     if (!m_pDevice)
         return;
 
     struct SimpleVertex { float x, y, z; DWORD color; };
-    static const struct { float dx[4], dy[4]; int n; D3DPRIMITIVETYPE prim; UINT count; } shapes[] = {
-        {{ -1, 1, 0 }, { -1, -1, 1 }, 3, D3DPT_TRIANGLELIST, 1 },
-        {{ 0, -1, 1 }, { -1, 1, 1 }, 3, D3DPT_TRIANGLELIST, 1 },
-        {{ -1, 1, -1, 1 }, { -1, -1, 1, 1 }, 4, D3DPT_TRIANGLESTRIP, 2 }
-    };
 
     RenderStates saved = SaveRenderStates();
     Setup2DSpriteStates();
@@ -401,15 +406,14 @@ void DxDrawPrimitives::dxDrawGTAIndicatorBlip(float screenX, float screenY, floa
     m_pDevice->SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
     m_pDevice->SetRenderState(D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA);
 
-    const float borderThickness = 3.0f;
     const BYTE alpha = (color >> 24) & 0xFF;
     const DWORD borderColor = tocolor(0, 0, 0, alpha);
-    const auto& s = shapes[type];
+    const auto& s = g_indicatorShapes[type];
     SimpleVertex v[4];
 
     for (int pass = 0; pass < 2; pass++)
     {
-        float halfSize = (pass == 0 ? size + borderThickness * 2.0f : size) * 0.5f;
+        float halfSize = (pass == 0 ? size + INDICATOR_BORDER * 2.0f : size) * 0.5f;
         DWORD curColor = pass == 0 ? borderColor : color;
         for (int i = 0; i < s.n; i++)
         {
@@ -588,6 +592,53 @@ void DxDrawPrimitives::dxDrawImage3D(const D3DXVECTOR3& elementPos, const D3DXVE
     }
 }
 
+void DxDrawPrimitives::dxDrawImage3DBatch(const Image3DBatchVertex* vertices, int vertexCount,
+                                          const D3DXVECTOR3& cameraPos, const D3DXVECTOR3& cameraRot,
+                                          float fov, float nearPlane, float farPlane, LPDIRECT3DTEXTURE9 texture)
+{
+    if (!m_pDevice || !m_pResources || !m_pResources->pImage3DEffect || !texture || !vertices || vertexCount < 3)
+        return;
+
+    HRESULT hr = m_pDevice->TestCooperativeLevel();
+    if (FAILED(hr) && hr != D3DERR_DEVICENOTRESET)
+        return;
+
+    // Same camera as the Image3D vertex shader builds per element, computed once on the CPU
+    float renderWidth  = (m_pResources->renderTargetWidth > 0)  ? (float)m_pResources->renderTargetWidth  : (float)m_pResources->screenWidth;
+    float renderHeight = (m_pResources->renderTargetHeight > 0) ? (float)m_pResources->renderTargetHeight : (float)m_pResources->screenHeight;
+    float projectionAspect = (m_pResources->screenWidth > 0)
+        ? ((float)m_pResources->screenHeight / (float)m_pResources->screenWidth)
+        : (renderHeight / renderWidth);
+
+    D3DXMATRIX view, proj, viewProj;
+    MathUtils::BuildRadarViewProj(cameraPos, cameraRot, fov, nearPlane, farPlane, projectionAspect, view, proj);
+    D3DXMatrixMultiply(&viewProj, &view, &proj);
+
+    LPD3DXEFFECT eff = m_pResources->pImage3DEffect;
+    D3DXHANDLE h;
+    h = eff->GetParameterByName(nullptr, "WorldViewProj");
+    if (h) eff->SetMatrix(h, &viewProj);
+    h = eff->GetParameterByName(nullptr, "sTexColor");
+    if (h) eff->SetTexture(h, texture);
+
+    D3DXHANDLE hTechnique = eff->GetTechniqueByName("Image3DBatch");
+    if (hTechnique)
+    {
+        eff->SetTechnique(hTechnique);
+        UINT numPasses = 0;
+        eff->Begin(&numPasses, 0);
+        for (UINT pass = 0; pass < numPasses; ++pass)
+        {
+            eff->BeginPass(pass);
+            m_pDevice->SetFVF(D3DFVF_XYZ | D3DFVF_TEX1 | D3DFVF_DIFFUSE);
+            m_pDevice->SetStreamSource(0, nullptr, 0, 0);
+            m_pDevice->DrawPrimitiveUP(D3DPT_TRIANGLELIST, (UINT)(vertexCount / 3), vertices, sizeof(Image3DBatchVertex));
+            eff->EndPass();
+        }
+        eff->End();
+    }
+}
+
 void DxDrawPrimitives::dxDrawText(const char* text, float x, float y, float sx, float sy, float rotation, DWORD color)
 {
     if (!m_pDevice || !m_pResources || !m_pResources->pFont || !text)
@@ -616,63 +667,79 @@ void DxDrawPrimitives::dxDrawText(const char* text, float x, float y, float sx,
     }
 }
 
-static void BuildRadarViewProjMatrix(const D3DXVECTOR3& cameraPos, const D3DXVECTOR3& cameraRot,
-    float fov, float nearPlane, float farPlane, float aspect,
-    D3DXMATRIX& outView, D3DXMATRIX& outProj)
+void DxDrawPrimitives::dxDrawImage2DBatch(const ScreenVertex* vertices, int vertexCount, LPDIRECT3DTEXTURE9 texture)
 {
-    float cp = cosf(cameraRot.x);
-    float sp = sinf(cameraRot.x);
-    float cy = cosf(cameraRot.z);
-    float sy = sinf(cameraRot.z);
+    if (!m_pDevice || !texture || !vertices || vertexCount < 3)
+        return;
 
-    D3DXMATRIX camWorld;
-    camWorld._11 = cy; camWorld._12 = sy; camWorld._13 = 0.0f; camWorld._14 = 0.0f;
-    camWorld._21 = -cp * sy; camWorld._22 = cy * cp; camWorld._23 = sp; camWorld._24 = 0.0f;
-    camWorld._31 = sy * sp; camWorld._32 = -cy * sp; camWorld._33 = cp; camWorld._34 = 0.0f;
-    camWorld._41 = cameraPos.x; camWorld._42 = cameraPos.y; camWorld._43 = cameraPos.z; camWorld._44 = 1.0f;
+    HRESULT hr = m_pDevice->TestCooperativeLevel();
+    if (FAILED(hr) && hr != D3DERR_DEVICENOTRESET)
+        return;
 
-    D3DXVECTOR3 forwardVec(camWorld._21, camWorld._22, camWorld._23);
-    D3DXVECTOR3 downVec(0.0f, 0.0f, -1.0f);
-    float dotProduct = D3DXVec3Dot(&downVec, &forwardVec);
-    if (dotProduct > 1.0f) dotProduct = 1.0f;
-    if (dotProduct < -1.0f) dotProduct = -1.0f;
-    float rotOff = 600.0f * acosf(dotProduct) / (0.5f * D3DX_PI);
+    RenderStates saved = SaveRenderStates();
+    Setup2DSpriteStates();
 
-    D3DXVECTOR3 offX(
-        camWorld._11 + camWorld._21 - rotOff * camWorld._31,
-        camWorld._12 + camWorld._22 - rotOff * camWorld._32,
-        camWorld._13 + camWorld._23 - rotOff * camWorld._33
-    );
+    // Indicator shapes share the batch through a white texel, so no shader may tint it
+    m_pDevice->SetVertexShader(nullptr);
+    m_pDevice->SetPixelShader(nullptr);
+    m_pDevice->SetTexture(0, texture);
+    m_pDevice->SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_MODULATE);
+    m_pDevice->SetTextureStageState(0, D3DTSS_COLORARG1, D3DTA_TEXTURE);
+    m_pDevice->SetTextureStageState(0, D3DTSS_COLORARG2, D3DTA_DIFFUSE);
+    m_pDevice->SetTextureStageState(0, D3DTSS_ALPHAOP, D3DTOP_MODULATE);
+    m_pDevice->SetTextureStageState(0, D3DTSS_ALPHAARG1, D3DTA_TEXTURE);
+    m_pDevice->SetTextureStageState(0, D3DTSS_ALPHAARG2, D3DTA_DIFFUSE);
+    m_pDevice->SetSamplerState(0, D3DSAMP_MINFILTER, D3DTEXF_LINEAR);
+    m_pDevice->SetSamplerState(0, D3DSAMP_MAGFILTER, D3DTEXF_LINEAR);
 
-    D3DXVECTOR3 viewPos(camWorld._41 + offX.x, camWorld._42 + offX.y, camWorld._43 + offX.z);
-    D3DXVECTOR3 zaxis = forwardVec;
-    D3DXVec3Normalize(&zaxis, &zaxis);
+    m_pDevice->SetFVF(D3DFVF_XYZ | D3DFVF_DIFFUSE | D3DFVF_TEX1);
+    m_pDevice->DrawPrimitiveUP(D3DPT_TRIANGLELIST, (UINT)(vertexCount / 3), vertices, sizeof(ScreenVertex));
 
-    D3DXVECTOR3 upVec(camWorld._31, camWorld._32, camWorld._33);
-    D3DXVECTOR3 xaxis, yaxis;
-    D3DXVECTOR3 negUpVec(-upVec.x, -upVec.y, -upVec.z);
-    D3DXVec3Cross(&xaxis, &negUpVec, &zaxis);
-    D3DXVec3Normalize(&xaxis, &xaxis);
-    D3DXVec3Cross(&yaxis, &xaxis, &zaxis);
-
-    outView._11 = xaxis.x; outView._12 = yaxis.x; outView._13 = zaxis.x; outView._14 = 0.0f;
-    outView._21 = xaxis.y; outView._22 = yaxis.y; outView._23 = zaxis.y; outView._24 = 0.0f;
-    outView._31 = xaxis.z; outView._32 = yaxis.z; outView._33 = zaxis.z; outView._34 = 0.0f;
-    outView._41 = -D3DXVec3Dot(&xaxis, &viewPos);
-    outView._42 = -D3DXVec3Dot(&yaxis, &viewPos);
-    outView._43 = -D3DXVec3Dot(&zaxis, &viewPos);
-    outView._44 = 1.0f;
-
-    float w = 1.0f / tanf(fov * 0.5f);
-    float h = w / aspect;
-    float Q = farPlane / (farPlane - nearPlane);
-    D3DXMatrixIdentity(&outProj);
-    outProj._11 = w;
-    outProj._22 = h;
-    outProj._33 = Q;
-    outProj._34 = 1.0f;
-    outProj._43 = -Q * nearPlane;
-    outProj._44 = 0.0f;
+    RestoreRenderStates(saved);
+}
+
+void DxDrawPrimitives::AppendImage2D(std::vector<ScreenVertex>& batch, float x, float y, float width, float height,
+                                     const D3DXVECTOR4& region, float rotationAngle, DWORD color)
+{
+    // Corners as in CreateScreenQuad, turned about the centre like the world matrix of dxDrawImage2DRotated
+    const float halfW = width * 0.5f, halfH = height * 0.5f;
+    const float centerX = x + halfW, centerY = y + halfH;
+    float s = 0.0f, c = 1.0f;
+    if (rotationAngle != 0.0f)
+        FastMath::SinCos(rotationAngle, s, c);
+    auto corner = [&](float dx, float dy, float u, float v) {
+        ScreenVertex vertex = { centerX + dx * c - dy * s, centerY + dx * s + dy * c, 0.0f, color, u, v };
+        batch.push_back(vertex);
+    };
+    corner(-halfW, -halfH, region.x, region.y);
+    corner(-halfW, halfH, region.x, region.w);
+    corner(halfW, -halfH, region.z, region.y);
+    corner(-halfW, halfH, region.x, region.w);
+    corner(halfW, halfH, region.z, region.w);
+    corner(halfW, -halfH, region.z, region.y);
+}
+
+void DxDrawPrimitives::AppendGTAIndicatorBlip(std::vector<ScreenVertex>& batch, float screenX, float screenY, float size, DWORD color,
+                                              eHeightIndicatorType type, const D3DXVECTOR2& white)
+{
+    const BYTE alpha = (color >> 24) & 0xFF;
+    const DWORD borderColor = tocolor(0, 0, 0, alpha);
+    const auto& s = g_indicatorShapes[type];
+    // Strip order of the square: triangles 0 1 2 and 2 1 3
+    static const int stripAsList[6] = { 0, 1, 2, 2, 1, 3 };
+
+    for (int pass = 0; pass < 2; pass++)
+    {
+        float halfSize = (pass == 0 ? size + INDICATOR_BORDER * 2.0f : size) * 0.5f;
+        DWORD curColor = pass == 0 ? borderColor : color;
+        const int vertexCount = (s.prim == D3DPT_TRIANGLESTRIP) ? 6 : s.n;
+        for (int i = 0; i < vertexCount; i++)
+        {
+            const int k = (s.prim == D3DPT_TRIANGLESTRIP) ? stripAsList[i] : i;
+            ScreenVertex vertex = { screenX + s.dx[k] * halfSize, screenY + s.dy[k] * halfSize, 0.0f, curColor, white.x, white.y };
+            batch.push_back(vertex);
+        }
+    }
 }
 
 void DxDrawPrimitives::dxDrawRoute3D(const std::vector<RoutePoint3D>& route, const D3DXVECTOR3& cameraPos, const D3DXVECTOR3& cameraRot,
@@ -686,7 +753,7 @@ void DxDrawPrimitives::dxDrawRoute3D(const std::vector<RoutePoint3D>& route, con
         return;
 
     D3DXMATRIX view, proj;
-    BuildRadarViewProjMatrix(cameraPos, cameraRot, fov, nearPlane, farPlane, aspect, view, proj);
+    MathUtils::BuildRadarViewProj(cameraPos, cameraRot, fov, nearPlane, farPlane, aspect, view, proj);
 
     D3DXMATRIX world;
     D3DXMatrixIdentity(&world);
@@ -746,23 +813,22 @@ void DxDrawPrimitives::dxDrawRoute3D(const std::vector<RoutePoint3D>& route, con
             {
                 if (SUCCEEDED(eff->BeginPass(pass)))
                 {
+                    // Joint discs: unit circle from the table, all triangles of a joint in one draw
+                    const FastMath::CircleTable<circleSegments>& circle = FastMath::CircleTable<circleSegments>::Get();
                     for (size_t i = 0; i < numSegments; ++i)
                     {
                         float cx = route[i].x, cy = route[i].y, cz = route[i].z;
                         DWORD color = (route[i].color & 0x00FFFFFF) | 0xFF000000;
 
+                        LineSmoothVertex tris[circleSegments * 3];
                         for (int j = 0; j < circleSegments; ++j)
                         {
-                            float a1 = (float)j / (float)circleSegments * 2.0f * D3DX_PI;
-                            float a2 = (float)(j + 1) / (float)circleSegments * 2.0f * D3DX_PI;
-
-                            LineSmoothVertex tri[3] = {
-                                { cx, cy, cz, color, 0.5f, 0.0f },
-                                { cx + cosf(a1) * circleRadius, cy + sinf(a1) * circleRadius, cz, color, 0.5f, 1.0f },
-                                { cx + cosf(a2) * circleRadius, cy + sinf(a2) * circleRadius, cz, color, 0.5f, 1.0f }
-                            };
-                            m_pDevice->DrawPrimitiveUP(D3DPT_TRIANGLELIST, 1, tri, sizeof(LineSmoothVertex));
+                            LineSmoothVertex* tri = tris + j * 3;
+                            tri[0] = { cx, cy, cz, color, 0.5f, 0.0f };
+                            tri[1] = { cx + circle.cosA[j] * circleRadius, cy + circle.sinA[j] * circleRadius, cz, color, 0.5f, 1.0f };
+                            tri[2] = { cx + circle.cosA[j + 1] * circleRadius, cy + circle.sinA[j + 1] * circleRadius, cz, color, 0.5f, 1.0f };
                         }
+                        m_pDevice->DrawPrimitiveUP(D3DPT_TRIANGLELIST, circleSegments, tris, sizeof(LineSmoothVertex));
                     }
 
                     for (size_t i = 0; i < numSegments; ++i)
@@ -830,7 +896,7 @@ void DxDrawPrimitives::dxDrawLine3D(const D3DXVECTOR3& start, const D3DXVECTOR3&
         return;
 
     D3DXMATRIX view, proj;
-    BuildRadarViewProjMatrix(cameraPos, cameraRot, fov, nearPlane, farPlane, aspect, view, proj);
+    MathUtils::BuildRadarViewProj(cameraPos, cameraRot, fov, nearPlane, farPlane, aspect, view, proj);
 
     float cp = cosf(cameraRot.x);
     float sp = sinf(cameraRot.x);
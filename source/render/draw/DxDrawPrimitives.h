@@ -19,6 +19,14 @@ struct RoutePoint3D
     DWORD color;
 };
 
+// Vertex of dxDrawImage3DBatch: radar 3D space position, texcoord inside the batch texture
+struct Image3DBatchVertex
+{
+    float x, y, z;
+    DWORD color;
+    float u, v;
+};
+
 class DxDrawPrimitives
 {
 public:
@@ -40,7 +48,19 @@ public:
                        const D3DXVECTOR3& cameraPos, const D3DXVECTOR3& cameraRot,
                        float fov, float nearPlane, float farPlane,
                        LPDIRECT3DTEXTURE9 texture, DWORD color = 0xFFFFFFFF);
+    // Triangle list sharing one texture in a single draw call; same shading and states as dxDrawImage3D
+    void dxDrawImage3DBatch(const Image3DBatchVertex* vertices, int vertexCount,
+                            const D3DXVECTOR3& cameraPos, const D3DXVECTOR3& cameraRot,
+                            float fov, float nearPlane, float farPlane, LPDIRECT3DTEXTURE9 texture);
     void dxDrawText(const char* text, float x, float y, float sx, float sy, float rotation, DWORD color);
+    // Screen-space triangle list sharing one (atlas) texture in a single draw call; same states as dxDrawImage2D
+    void dxDrawImage2DBatch(const ScreenVertex* vertices, int vertexCount, LPDIRECT3DTEXTURE9 texture);
+    // dxDrawImage2D(Rotated) as two triangles for dxDrawImage2DBatch; region: (u0, v0, u1, v1) of the image in the texture
+    static void AppendImage2D(std::vector<ScreenVertex>& batch, float x, float y, float width, float height,
+                              const D3DXVECTOR4& region, float rotationAngle, DWORD color);
+    // dxDrawGTAIndicatorBlip (outline, then the shape) as triangles; white: texcoord of a white texel
+    static void AppendGTAIndicatorBlip(std::vector<ScreenVertex>& batch, float screenX, float screenY, float size, DWORD color,
+                                       eHeightIndicatorType type, const D3DXVECTOR2& white);
     void dxDrawRoute3D(const std::vector<RoutePoint3D>& route, const D3DXVECTOR3& cameraPos, const D3DXVECTOR3& cameraRot,
                        float fov, float nearPlane, float farPlane, float aspect, float lineWidth);
     void dxDrawLine3D(const D3DXVECTOR3& start, const D3DXVECTOR3& end, float width, DWORD color,
@@ -107,12 +107,19 @@ PSInput VertexShaderFunction(VSInput VS) {
     float4 wPos = mul(float4(VS.Position, 1.0), sWorld); float4 vPos = mul(wPos, sView); PS.Position = mul(vPos, sProjection);
     PS.TexCoord = VS.TexCoord; PS.Diffuse = VS.Diffuse; return PS;
 }
+// Batched tiles: positions already in radar space, texcoords already in the (atlas) texture
+PSInput VertexShaderBatch(VSInput VS) {
+    PSInput PS = (PSInput)0;
+    PS.Position = mul(float4(VS.Position, 1.0), WorldViewProj);
+    PS.TexCoord = VS.TexCoord; PS.Diffuse = VS.Diffuse; return PS;
+}
 float4 PixelShaderFunction(PSInput PS) : COLOR0 {
     float4 finalColor = tex2D(SamplerColor, PS.TexCoord.xy); finalColor *= PS.Diffuse;
     finalColor.rgb *= finalColor.a;
     return saturate(finalColor);
 }
 technique Image3D { pass P0 { VertexShader = compile vs_2_0 VertexShaderFunction(); PixelShader = compile ps_2_0 PixelShaderFunction(); ZEnable = true; ZWriteEnable = true; ZFunc = LessEqual; AlphaBlendEnable = true; SrcBlend = One; DestBlend = InvSrcAlpha; CullMode = None; Lighting = false; FogEnable = false; } }
+technique Image3DBatch { pass P0 { VertexShader = compile vs_2_0 VertexShaderBatch(); PixelShader = compile ps_2_0 PixelShaderFunction(); ZEnable = true; ZWriteEnable = true; ZFunc = LessEqual; AlphaBlendEnable = true; SrcBlend = One; DestBlend = InvSrcAlpha; CullMode = None; Lighting = false; FogEnable = false; } }
 )";
 }
 
@@ -4,6 +4,7 @@
  *****************************************************************************/
 
 #include "Base64Image.h"
+#include "PixelConvert.h"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
@@ -225,22 +226,8 @@ namespace Base64Image {
             return nullptr;
         }
 
-        uint8_t* dst = static_cast<uint8_t*>(lockedRect.pBits);
-        const uint8_t* src = pixelData.data();
-
-        for (int y = 0; y < outHeight; y++)
-        {
-            uint8_t* dstRow = dst + y * lockedRect.Pitch;
-            const uint8_t* srcRow = src + y * outWidth * 4;
-
-            for (int x = 0; x < outWidth; x++)
-            {
-                dstRow[x * 4 + 0] = srcRow[x * 4 + 2];
-                dstRow[x * 4 + 1] = srcRow[x * 4 + 1];
-                dstRow[x * 4 + 2] = srcRow[x * 4 + 0];
-                dstRow[x * 4 + 3] = srcRow[x * 4 + 3];
-            }
-        }
+        PixelConvert::SwapRedBlue(pixelData.data(), outWidth * 4, static_cast<uint8_t*>(lockedRect.pBits), lockedRect.Pitch,
+                                  outWidth, outHeight);
 
         texture->UnlockRect(0);
 
@@ -0,0 +1,58 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/utils/CpuFeatures.cpp
+ *****************************************************************************/
+
+#include "CpuFeatures.h"
+#include <intrin.h>
+#include <immintrin.h>
+
+struct CpuFeatureBits
+{
+    bool ssse3;
+    bool avx;
+    bool avx2;
+};
+
+static CpuFeatureBits Detect()
+{
+    CpuFeatureBits bits = {};
+    int info[4];
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+    if (maxLeaf < 1)
+        return bits;
+
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    bits.ssse3 = (info[2] & (1 << 9)) != 0;
+    bits.avx = (info[2] & (1 << 28)) != 0 && osxsave && (_xgetbv(0) & 6) == 6;
+
+    if (maxLeaf >= 7 && bits.avx)
+    {
+        __cpuidex(info, 7, 0);
+        bits.avx2 = (info[1] & (1 << 5)) != 0;
+    }
+    return bits;
+}
+
+static const CpuFeatureBits& GetBits()
+{
+    static const CpuFeatureBits s_bits = Detect();
+    return s_bits;
+}
+
+bool CpuFeatures::HasSsse3()
+{
+    return GetBits().ssse3;
+}
+
+bool CpuFeatures::HasAvx()
+{
+    return GetBits().avx;
+}
+
+bool CpuFeatures::HasAvx2()
+{
+    return GetBits().avx2;
+}
@@ -0,0 +1,17 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/utils/CpuFeatures.h
+ *****************************************************************************/
+
+#pragma once
+
+// Instruction set extensions this process may use, read once from CPUID / XGETBV.
+// The SIMD kernels pick their path from here. Thread-safe.
+class CpuFeatures
+{
+public:
+    static bool HasSsse3();
+    // AVX with YMM state saved by the OS (XCR0 bits 1 and 2)
+    static bool HasAvx();
+    static bool HasAvx2();
+};
@@ -0,0 +1,86 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/utils/FastMath.cpp
+ *****************************************************************************/
+
+#include "FastMath.h"
+#include <emmintrin.h>
+
+// mask ? a : b
+static inline __m128 Select(__m128 mask, __m128 a, __m128 b)
+{
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+void FastMath::SinCosBatch(const float* angles, int count, float* outSin, float* outCos)
+{
+    const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32((int)0x80000000));
+    const __m128 zero = _mm_setzero_ps();
+    const __m128i one = _mm_set1_epi32(1), two = _mm_set1_epi32(2), four = _mm_set1_epi32(4);
+    const __m128i notOne = _mm_set1_epi32(~1);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128 angle = _mm_loadu_ps(angles + i);
+        const __m128 absAngle = _mm_andnot_ps(signMask, angle);
+        const __m128i j = _mm_and_si128(_mm_add_epi32(_mm_cvttps_epi32(_mm_mul_ps(absAngle, _mm_set1_ps(FOUR_OVER_PI))), one), notOne);
+        const __m128 y = _mm_cvtepi32_ps(j);
+        __m128 x = _mm_sub_ps(absAngle, _mm_mul_ps(y, _mm_set1_ps(DP1)));
+        x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(DP2)));
+        x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(DP3)));
+        const __m128 z = _mm_mul_ps(x, x);
+
+        __m128 ps = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(SIN_C0), z), _mm_set1_ps(SIN_C1));
+        ps = _mm_add_ps(_mm_mul_ps(ps, z), _mm_set1_ps(SIN_C2));
+        ps = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(ps, z), x), x);
+        __m128 pc = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(COS_C0), z), _mm_set1_ps(COS_C1));
+        pc = _mm_add_ps(_mm_mul_ps(pc, z), _mm_set1_ps(COS_C2));
+        pc = _mm_sub_ps(_mm_mul_ps(_mm_mul_ps(pc, z), z), _mm_mul_ps(_mm_set1_ps(0.5f), z));
+        pc = _mm_add_ps(pc, _mm_set1_ps(1.0f));
+
+        // Octant bits straight into the sign bit, as in SinCos
+        const __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(j, two), two));
+        const __m128 sinSign = _mm_xor_ps(_mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(j, four), 29)),
+                                          _mm_and_ps(_mm_cmplt_ps(angle, zero), signMask));
+        const __m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(j, two), four), 29));
+        _mm_storeu_ps(outSin + i, _mm_xor_ps(Select(swap, pc, ps), sinSign));
+        _mm_storeu_ps(outCos + i, _mm_xor_ps(Select(swap, ps, pc), cosSign));
+    }
+    for (; i < count; ++i)
+        SinCos(angles[i], outSin[i], outCos[i]);
+}
+
+void FastMath::Atan2Batch(const float* y, const float* x, int count, float* outAngle)
+{
+    const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32((int)0x80000000));
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128 py = _mm_loadu_ps(y + i);
+        const __m128 px = _mm_loadu_ps(x + i);
+        const __m128 absY = _mm_andnot_ps(signMask, py);
+        const __m128 absX = _mm_andnot_ps(signMask, px);
+        const __m128 minV = _mm_min_ps(absY, absX);
+        const __m128 maxV = _mm_max_ps(absX, absY);
+        // 0 / 0 lanes are masked to 0 like the scalar branch
+        const __m128 r = _mm_and_ps(_mm_cmpgt_ps(maxV, zero), _mm_div_ps(minV, maxV));
+        const __m128 upper = _mm_cmpgt_ps(r, _mm_set1_ps(TAN_PI_8));
+        const __m128 t = Select(upper, _mm_div_ps(_mm_sub_ps(r, one), _mm_add_ps(r, one)), r);
+        const __m128 z = _mm_mul_ps(t, t);
+
+        __m128 a = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(ATAN_C0), z), _mm_set1_ps(ATAN_C1));
+        a = _mm_add_ps(_mm_mul_ps(a, z), _mm_set1_ps(ATAN_C2));
+        a = _mm_add_ps(_mm_mul_ps(a, z), _mm_set1_ps(ATAN_C3));
+        a = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(a, z), t), t);
+        a = Select(upper, _mm_add_ps(a, _mm_set1_ps(QUARTER_PI)), a);
+        a = Select(_mm_cmpgt_ps(absY, absX), _mm_sub_ps(_mm_set1_ps(HALF_PI), a), a);
+        a = Select(_mm_cmplt_ps(px, zero), _mm_sub_ps(_mm_set1_ps(PI), a), a);
+        _mm_storeu_ps(outAngle + i, _mm_or_ps(_mm_andnot_ps(signMask, a), _mm_and_ps(signMask, py)));
+    }
+    for (; i < count; ++i)
+        outAngle[i] = Atan2(y[i], x[i]);
+}
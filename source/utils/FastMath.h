@@ -0,0 +1,124 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/utils/FastMath.h
+ *****************************************************************************/
+
+#pragma once
+
+#include <cmath>
+
+// sin / cos / atan2 for the per-frame radar code: Cephes single-precision polynomials without libm's
+// full-range reduction and errno handling. Scalar versions inline, batch versions 4 per step (SSE2) with the
+// same operations in the same order, so both give the same bits.
+// Max error against the double-precision result:
+//   SinCos: |angle| <= 8192: 1.6 ulp, 8e-8 absolute; larger angles are not supported (wrap periodic phases first)
+//   Atan2:  finite y, x: 3 ulp; (0, 0) gives 0, the sign of y is kept like atan2f
+class FastMath
+{
+public:
+    static constexpr float PI = 3.14159265358979f;
+    static constexpr float TWO_PI = 6.28318530717959f;
+    static constexpr float HALF_PI = 1.57079632679490f;
+
+    static void SinCos(float angle, float& outSin, float& outCos)
+    {
+        // Cody-Waite reduction to [-pi/4, pi/4] around the nearest even multiple of pi/4
+        const float absAngle = fabsf(angle);
+        const int j = ((int)(absAngle * FOUR_OVER_PI) + 1) & ~1;
+        const float y = (float)j;
+        const float x = ((absAngle - y * DP1) - y * DP2) - y * DP3;
+        const float z = x * x;
+        const float ps = ((SIN_C0 * z + SIN_C1) * z + SIN_C2) * z * x + x;
+        const float pc = ((COS_C0 * z + COS_C1) * z + COS_C2) * z * z - 0.5f * z + 1.0f;
+
+        // Octant 0, 2, 4, 6: (ps, pc), (pc, -ps), (-ps, -pc), (-pc, ps); sin is odd
+        const int octant = j & 7;
+        const bool swap = (octant & 2) != 0;
+        float s = swap ? pc : ps;
+        float c = swap ? ps : pc;
+        if (octant & 4)
+            s = -s;
+        if ((octant + 2) & 4)
+            c = -c;
+        outSin = (angle < 0.0f) ? -s : s;
+        outCos = c;
+    }
+
+    static float Sin(float angle)
+    {
+        float s, c;
+        SinCos(angle, s, c);
+        return s;
+    }
+
+    static float Atan2(float y, float x)
+    {
+        // atan of min / max in [0, 1], reduced once more around pi/4, then unfolded to the octant
+        const float absY = fabsf(y), absX = fabsf(x);
+        const float minV = (absY < absX) ? absY : absX;
+        const float maxV = (absY < absX) ? absX : absY;
+        const float r = (maxV > 0.0f) ? minV / maxV : 0.0f;
+        const bool upper = r > TAN_PI_8;
+        const float t = upper ? (r - 1.0f) / (r + 1.0f) : r;
+        const float z = t * t;
+        float a = (((ATAN_C0 * z + ATAN_C1) * z + ATAN_C2) * z + ATAN_C3) * z * t + t;
+        if (upper)
+            a = a + QUARTER_PI;
+        if (absY > absX)
+            a = HALF_PI - a;
+        if (x < 0.0f)
+            a = PI - a;
+        return std::copysign(a, y);
+    }
+
+    // count angles at once; outSin / outCos may not alias angles
+    static void SinCosBatch(const float* angles, int count, float* outSin, float* outCos);
+    static void Atan2Batch(const float* y, const float* x, int count, float* outAngle);
+
+    // cos / sin of 2 * pi * i / N for i = 0..N, entry N equal to entry 0: segment i of an N-gon runs
+    // from entry i to i + 1. Built with libm on first use.
+    template<int N>
+    struct CircleTable
+    {
+        float cosA[N + 1];
+        float sinA[N + 1];
+
+        static const CircleTable& Get()
+        {
+            static const CircleTable table;
+            return table;
+        }
+
+    private:
+        CircleTable()
+        {
+            for (int i = 0; i < N; ++i)
+            {
+                const float a = (float)i / (float)N * TWO_PI;
+                cosA[i] = cosf(a);
+                sinA[i] = sinf(a);
+            }
+            cosA[N] = cosA[0];
+            sinA[N] = sinA[0];
+        }
+    };
+
+private:
+    // Cephes sinf / cosf / atanf: pi/4 split in three for the reduction, minimax polynomials
+    static constexpr float FOUR_OVER_PI = 1.27323954473516f;
+    static constexpr float QUARTER_PI = 0.785398163397448f;
+    static constexpr float DP1 = 0.78515625f;
+    static constexpr float DP2 = 2.4187564849853515625e-4f;
+    static constexpr float DP3 = 3.77489497744594108e-8f;
+    static constexpr float SIN_C0 = -1.9515295891e-4f;
+    static constexpr float SIN_C1 = 8.3321608736e-3f;
+    static constexpr float SIN_C2 = -1.6666654611e-1f;
+    static constexpr float COS_C0 = 2.443315711809948e-5f;
+    static constexpr float COS_C1 = -1.388731625493765e-3f;
+    static constexpr float COS_C2 = 4.166664568298827e-2f;
+    static constexpr float TAN_PI_8 = 0.414213562373095f;
+    static constexpr float ATAN_C0 = 8.05374449538e-2f;
+    static constexpr float ATAN_C1 = -1.38776856032e-1f;
+    static constexpr float ATAN_C2 = 1.99777106478e-1f;
+    static constexpr float ATAN_C3 = -3.33329491539e-1f;
+};
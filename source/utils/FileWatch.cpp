@@ -0,0 +1,59 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/utils/FileWatch.cpp
+ *****************************************************************************/
+
+#include "FileWatch.h"
+#include "MappedFile.h"
+
+FileWatch::FileWatch()
+    : m_baseline(0)
+    , m_pending(0)
+    , m_hasPending(false)
+    , m_lastPoll(Clock::now())
+{
+}
+
+void FileWatch::Reset(uint64_t stamp)
+{
+    m_baseline = stamp;
+    m_pending = 0;
+    m_hasPending = false;
+    m_lastPoll = Clock::now();
+}
+
+bool FileWatch::IsPollDue()
+{
+    const Clock::time_point now = Clock::now();
+    if (now - m_lastPoll < std::chrono::milliseconds(POLL_INTERVAL_MS))
+        return false;
+    m_lastPoll = now;
+    return true;
+}
+
+bool FileWatch::Update(uint64_t stamp)
+{
+    if (stamp == m_baseline)
+    {
+        m_hasPending = false;
+        return false;
+    }
+    // Still changing: wait until two polls agree
+    if (!m_hasPending || stamp != m_pending)
+    {
+        m_pending = stamp;
+        m_hasPending = true;
+        return false;
+    }
+    Reset(stamp);
+    return true;
+}
+
+uint64_t FileWatch::GetFileStamp(const char* path)
+{
+    uint64_t size, mtime;
+    if (!MappedFile::GetFileStamp(path, size, mtime))
+        return 0;
+    // Write time in 100 ns ticks; the size catches rewrites within the same tick
+    return (mtime ^ (size * 0x9E3779B97F4A7C15ull)) | 1;
+}
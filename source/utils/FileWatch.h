@@ -0,0 +1,38 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/utils/FileWatch.h
+ *****************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+// Polled change detection for hot reload. The caller computes a stamp of whatever it watches (one file or a
+// whole tile pack) at most once per POLL_INTERVAL_MS; a change is reported once the new stamp has stayed the
+// same for a full interval, so a file that is still being written is not read half way.
+class FileWatch
+{
+public:
+    static const unsigned int POLL_INTERVAL_MS = 1000;
+
+    FileWatch();
+
+    // Current state becomes the baseline
+    void Reset(uint64_t stamp);
+    // True at most once per POLL_INTERVAL_MS
+    bool IsPollDue();
+    // True once per change; the stamp then becomes the new baseline
+    bool Update(uint64_t stamp);
+
+    // Size and last write time of one file folded into a stamp; 0 if the file does not exist
+    static uint64_t GetFileStamp(const char* path);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    uint64_t          m_baseline;
+    uint64_t          m_pending;        // differs from the baseline, seen on the last poll
+    bool              m_hasPending;
+    Clock::time_point m_lastPoll;
+};
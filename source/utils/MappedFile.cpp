@@ -0,0 +1,146 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/utils/MappedFile.cpp
+ *****************************************************************************/
+
+#include "MappedFile.h"
+#include <Windows.h>
+
+MappedFile::MappedFile()
+    : m_hFile(INVALID_HANDLE_VALUE)
+    , m_hMapping(nullptr)
+    , m_pData(nullptr)
+    , m_size(0)
+{
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+bool MappedFile::Open(const char* path)
+{
+    if (!OpenMapping(path))
+        return false;
+
+    m_pData = (const uint8_t*)MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, 0);
+    if (!m_pData)
+    {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+bool MappedFile::OpenViews(const char* path)
+{
+    return OpenMapping(path);
+}
+
+bool MappedFile::OpenMapping(const char* path)
+{
+    Close();
+    if (!path)
+        return false;
+
+    HANDLE hFile = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (hFile == INVALID_HANDLE_VALUE)
+        return false;
+    m_hFile = hFile;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(hFile, &size) || size.QuadPart <= 0 || (unsigned long long)size.QuadPart > (size_t)-1)
+    {
+        Close();
+        return false;
+    }
+
+    m_hMapping = CreateFileMappingA(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!m_hMapping)
+    {
+        Close();
+        return false;
+    }
+    m_size = (size_t)size.QuadPart;
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (m_pData)
+    {
+        UnmapViewOfFile(m_pData);
+        m_pData = nullptr;
+    }
+    if (m_hMapping)
+    {
+        CloseHandle(m_hMapping);
+        m_hMapping = nullptr;
+    }
+    if (m_hFile != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(m_hFile);
+        m_hFile = INVALID_HANDLE_VALUE;
+    }
+    m_size = 0;
+}
+
+bool MappedFile::GetFileStamp(const char* path, uint64_t& outSize, uint64_t& outMtime)
+{
+    WIN32_FILE_ATTRIBUTE_DATA attr;
+    if (!path || !GetFileAttributesExA(path, GetFileExInfoStandard, &attr))
+        return false;
+
+    outSize = ((uint64_t)attr.nFileSizeHigh << 32) | attr.nFileSizeLow;
+    outMtime = ((uint64_t)attr.ftLastWriteTime.dwHighDateTime << 32) | attr.ftLastWriteTime.dwLowDateTime;
+    return true;
+}
+
+MappedView::MappedView()
+    : m_pBase(nullptr)
+    , m_pData(nullptr)
+    , m_size(0)
+{
+}
+
+MappedView::~MappedView()
+{
+    Reset();
+}
+
+bool MappedView::Map(const MappedFile& file, uint64_t offset, size_t size)
+{
+    Reset();
+    if (!file.IsOpen() || size == 0 || offset > file.m_size || file.m_size - offset < size)
+        return false;
+
+    // View offsets must be multiples of the allocation granularity (64 KB)
+    static DWORD granularity = 0;
+    if (granularity == 0)
+    {
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        granularity = info.dwAllocationGranularity;
+    }
+    const uint64_t start = offset - offset % granularity;
+    const size_t lead = (size_t)(offset - start);
+    m_pBase = MapViewOfFile(file.m_hMapping, FILE_MAP_READ, (DWORD)(start >> 32), (DWORD)start, lead + size);
+    if (!m_pBase)
+        return false;
+
+    m_pData = (const uint8_t*)m_pBase + lead;
+    m_size = size;
+    return true;
+}
+
+void MappedView::Reset()
+{
+    if (m_pBase)
+    {
+        UnmapViewOfFile(m_pBase);
+        m_pBase = nullptr;
+    }
+    m_pData = nullptr;
+    m_size = 0;
+}
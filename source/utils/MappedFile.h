@@ -0,0 +1,67 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/utils/MappedFile.h
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Read-only file mapping. Pages are loaded by the OS on first access.
+// Open maps the whole file; OpenViews only creates the mapping and MappedView maps windows of it,
+// so a large file never needs one contiguous range of a 32-bit address space.
+class MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(const char* path);
+    bool OpenViews(const char* path);
+    void Close();
+
+    bool           IsOpen() const { return m_hMapping != nullptr; }
+    // nullptr after OpenViews
+    const uint8_t* GetData() const { return m_pData; }
+    size_t         GetSize() const { return m_size; }
+
+    // Size and last write time (FILETIME ticks) without mapping; false if the file does not exist
+    static bool GetFileStamp(const char* path, uint64_t& outSize, uint64_t& outMtime);
+
+private:
+    friend class MappedView;
+
+    bool OpenMapping(const char* path);
+
+    void*          m_hFile;
+    void*          m_hMapping;
+    const uint8_t* m_pData;
+    size_t         m_size;
+};
+
+// Window [offset, offset + size) of a file opened with MappedFile::OpenViews; unmapped on Reset or destruction.
+// The file must stay open while the view is mapped.
+class MappedView
+{
+public:
+    MappedView();
+    ~MappedView();
+
+    MappedView(const MappedView&) = delete;
+    MappedView& operator=(const MappedView&) = delete;
+
+    bool Map(const MappedFile& file, uint64_t offset, size_t size);
+    void Reset();
+
+    const uint8_t* GetData() const { return m_pData; }
+    size_t         GetSize() const { return m_size; }
+
+private:
+    void*          m_pBase;     // start of the allocation-granularity aligned view
+    const uint8_t* m_pData;
+    size_t         m_size;
+};
@@ -4,52 +4,25 @@
  *****************************************************************************/
 
 #include "MathUtils.h"
+#include "RadarProjection.h"
 #include "RenderWare.h"
 #include <d3dx9.h>
 #include <cmath>
 
-bool MathUtils::WorldToScreen(const D3DXVECTOR3& worldPos,
-                              const D3DXVECTOR3& cameraPos,
-                              const D3DXVECTOR3& cameraRot,
-                              float fov,
-                              float nearPlane,
-                              float farPlane,
-                              float screenWidth,
-                              float screenHeight,
-                              float& screenX,
-                              float& screenY,
-                              float projectionAspect)
+void MathUtils::BuildRadarViewProj(const D3DXVECTOR3& cameraPos, const D3DXVECTOR3& cameraRot,
+                                   float fov, float nearPlane, float farPlane, float aspect,
+                                   D3DXMATRIX& outView, D3DXMATRIX& outProj)
 {
+    float cp = cosf(cameraRot.x);
+    float sp = sinf(cameraRot.x);
+    float cy = cosf(cameraRot.z);
+    float sy = sinf(cameraRot.z);
+
     D3DXMATRIX camWorld;
-    {
-        float pitch = cameraRot.x;
-        float yaw = cameraRot.z;
-
-        float cp = cosf(pitch);
-        float sp = sinf(pitch);
-        float cy = cosf(yaw);
-        float sy = sinf(yaw);
-
-        camWorld._11 = cy * 1.0f - sy * sp * 0.0f;
-        camWorld._12 = 1.0f * sy + cy * sp * 0.0f;
-        camWorld._13 = -cp * 0.0f;
-        camWorld._14 = 0.0f;
-
-        camWorld._21 = -cp * sy;
-        camWorld._22 = cy * cp;
-        camWorld._23 = sp;
-        camWorld._24 = 0.0f;
-
-        camWorld._31 = cy * 0.0f + 1.0f * sy * sp;
-        camWorld._32 = sy * 0.0f - cy * 1.0f * sp;
-        camWorld._33 = cp * 1.0f;
-        camWorld._34 = 0.0f;
-
-        camWorld._41 = cameraPos.x;
-        camWorld._42 = cameraPos.y;
-        camWorld._43 = cameraPos.z;
-        camWorld._44 = 1.0f;
-    }
+    camWorld._11 = cy; camWorld._12 = sy; camWorld._13 = 0.0f; camWorld._14 = 0.0f;
+    camWorld._21 = -cp * sy; camWorld._22 = cy * cp; camWorld._23 = sp; camWorld._24 = 0.0f;
+    camWorld._31 = sy * sp; camWorld._32 = -cy * sp; camWorld._33 = cp; camWorld._34 = 0.0f;
+    camWorld._41 = cameraPos.x; camWorld._42 = cameraPos.y; camWorld._43 = cameraPos.z; camWorld._44 = 1.0f;
 
     D3DXVECTOR3 forwardVec(camWorld._21, camWorld._22, camWorld._23);
     D3DXVECTOR3 downVec(0.0f, 0.0f, -1.0f);
@@ -75,48 +48,41 @@ bool MathUtils::WorldToScreen(const D3DXVECTOR3& worldPos,
     D3DXVec3Normalize(&xaxis, &xaxis);
     D3DXVec3Cross(&yaxis, &xaxis, &zaxis);
 
-    D3DXMATRIX view;
-    view._11 = xaxis.x; view._12 = yaxis.x; view._13 = zaxis.x; view._14 = 0.0f;
-    view._21 = xaxis.y; view._22 = yaxis.y; view._23 = zaxis.y; view._24 = 0.0f;
-    view._31 = xaxis.z; view._32 = yaxis.z; view._33 = zaxis.z; view._34 = 0.0f;
-    view._41 = -D3DXVec3Dot(&xaxis, &viewPos);
-    view._42 = -D3DXVec3Dot(&yaxis, &viewPos);
-    view._43 = -D3DXVec3Dot(&zaxis, &viewPos);
-    view._44 = 1.0f;
+    outView._11 = xaxis.x; outView._12 = yaxis.x; outView._13 = zaxis.x; outView._14 = 0.0f;
+    outView._21 = xaxis.y; outView._22 = yaxis.y; outView._23 = zaxis.y; outView._24 = 0.0f;
+    outView._31 = xaxis.z; outView._32 = yaxis.z; outView._33 = zaxis.z; outView._34 = 0.0f;
+    outView._41 = -D3DXVec3Dot(&xaxis, &viewPos);
+    outView._42 = -D3DXVec3Dot(&yaxis, &viewPos);
+    outView._43 = -D3DXVec3Dot(&zaxis, &viewPos);
+    outView._44 = 1.0f;
 
-    float aspect = (projectionAspect > 0.0f) ? projectionAspect : (screenHeight / screenWidth);
     float w = 1.0f / tanf(fov * 0.5f);
     float h = w / aspect;
     float Q = farPlane / (farPlane - nearPlane);
+    D3DXMatrixIdentity(&outProj);
+    outProj._11 = w;
+    outProj._22 = h;
+    outProj._33 = Q;
+    outProj._34 = 1.0f;
+    outProj._43 = -Q * nearPlane;
+    outProj._44 = 0.0f;
+}
 
-    D3DXMATRIX proj;
-    D3DXMatrixIdentity(&proj);
-    proj._11 = w;
-    proj._22 = h;
-    proj._33 = Q;
-    proj._34 = 1.0f;
-    proj._43 = -Q * nearPlane;
-    proj._44 = 0.0f;
-
-    D3DXVECTOR4 worldPos4(worldPos.x, worldPos.y, worldPos.z, 1.0f);
-    D3DXVECTOR4 viewPos4, clipPos4;
-
-    D3DXVec4Transform(&viewPos4, &worldPos4, &view);
-    D3DXVec4Transform(&clipPos4, &viewPos4, &proj);
-
-    if (clipPos4.w <= 0.0f || clipPos4.z < 0.0f || clipPos4.z > clipPos4.w)
-    {
-        return false;
-    }
-
-    float invW = 1.0f / clipPos4.w;
-    float ndcX = clipPos4.x * invW;
-    float ndcY = clipPos4.y * invW;
-
-    screenX = (ndcX + 1.0f) * 0.5f * screenWidth;
-    screenY = (1.0f - ndcY) * 0.5f * screenHeight;
-
-    return true;
+bool MathUtils::WorldToScreen(const D3DXVECTOR3& worldPos,
+                              const D3DXVECTOR3& cameraPos,
+                              const D3DXVECTOR3& cameraRot,
+                              float fov,
+                              float nearPlane,
+                              float farPlane,
+                              float screenWidth,
+                              float screenHeight,
+                              float& screenX,
+                              float& screenY,
+                              float projectionAspect)
+{
+    RadarProjection projection;
+    projection.Build(cameraPos, cameraRot, fov, nearPlane, farPlane, screenWidth, screenHeight, projectionAspect);
+    return projection.Project(worldPos, screenX, screenY);
 }
 
 void MathUtils::CalculateRadarPosition(float& circleX, float& circleY, float& circleSize)
@@ -175,15 +141,17 @@ float MathUtils::DistanceSq2D(float ax, float ay, float bx, float by)
     return dx * dx + dy * dy;
 }
 
-bool MathUtils::DirectionToOrbitAngle(const D3DXVECTOR3& fromPos, const D3DXVECTOR3& toPos, float yaw, float& outAngle)
+bool MathUtils::DirectionToOrbit(float fromX, float fromY, float toX, float toY, float cosYaw, float sinYaw, float& outCos, float& outSin)
 {
-    float dx = toPos.x - fromPos.x;
-    float dy = toPos.y - fromPos.y;
+    float dx = toX - fromX;
+    float dy = toY - fromY;
     float lenSq = dx * dx + dy * dy;
     if (lenSq < 0.0001f)
         return false;
-    float len = sqrtf(lenSq);
-    float worldAngle = atan2f(dy, dx);
-    outAngle = -worldAngle - yaw;
+    // angle = -(worldAngle + yaw): cos = cos(w)cos(yaw) - sin(w)sin(yaw), sin = -(sin(w)cos(yaw) + cos(w)sin(yaw))
+    float invLen = 1.0f / sqrtf(lenSq);
+    float cw = dx * invLen, sw = dy * invLen;
+    outCos = cw * cosYaw - sw * sinYaw;
+    outSin = -(sw * cosYaw + cw * sinYaw);
     return true;
 }
@@ -11,7 +11,11 @@
 class MathUtils
 {
 public:
-    // projectionAspect: if > 0 use for projection (e.g. screen height/width); if <= 0 use screenHeight/screenWidth
+    // Radar camera view and projection (same construction as the Image3D shader). aspect = height / width
+    static void  BuildRadarViewProj(const D3DXVECTOR3& cameraPos, const D3DXVECTOR3& cameraRot, float fov, float nearPlane,
+                                    float farPlane, float aspect, D3DXMATRIX& outView, D3DXMATRIX& outProj);
+    // projectionAspect: if > 0 use for projection (e.g. screen height/width); if <= 0 use screenHeight/screenWidth.
+    // Builds the matrices on every call: per-frame code projects through a RadarProjection instead
     static bool  WorldToScreen(const D3DXVECTOR3& worldPos, const D3DXVECTOR3& cameraPos, const D3DXVECTOR3& cameraRot, float fov, float nearPlane,
                                float farPlane, float screenWidth, float screenHeight, float& screenX, float& screenY, float projectionAspect = 0.0f);
     static void  CalculateRadarPosition(float& circleX, float& circleY, float& circleSize);
@@ -23,6 +27,7 @@ public:
     static float CalculateDistance2D(const D3DXVECTOR3& a, const D3DXVECTOR3& b);
     static float DistanceSq2D(const D3DXVECTOR3& a, const D3DXVECTOR3& b);
     static float DistanceSq2D(float ax, float ay, float bx, float by);
-    // Direction from A to B, normalised; returns orbit angle for PointOnOrbitEdge (or false if too close)
-    static bool  DirectionToOrbitAngle(const D3DXVECTOR3& fromPos, const D3DXVECTOR3& toPos, float yaw, float& outAngle);
+    // Direction from A to B as (cos, sin) of the orbit angle for PointOnOrbitEdge (false if too close);
+    // no atan2f / cosf / sinf per call: cosYaw, sinYaw once per frame
+    static bool  DirectionToOrbit(float fromX, float fromY, float toX, float toY, float cosYaw, float sinYaw, float& outCos, float& outSin);
 };
@@ -0,0 +1,154 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/utils/PixelConvert.cpp
+ *****************************************************************************/
+
+#include "PixelConvert.h"
+#include "CpuFeatures.h"
+#include <immintrin.h>
+
+// Bytes 0 and 2 of every pixel swapped
+#define SWAP_RB_SHUFFLE 2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15
+// Alpha of pixel 0 / 1 (low half) and 2 / 3 (high half) into the colour lanes of 16-bit pixels, 0 elsewhere
+#define ALPHA_LO_SHUFFLE 3, -1, 3, -1, 3, -1, -1, -1, 7, -1, 7, -1, 7, -1, -1, -1
+#define ALPHA_HI_SHUFFLE 11, -1, 11, -1, 11, -1, -1, -1, 15, -1, 15, -1, 15, -1, -1, -1
+
+// c * a / 255 rounded, exact for every 8-bit c and a: t = c * a + 128, (t + (t >> 8)) >> 8.
+// The vector paths use the same formula on 16-bit lanes, alpha multiplied by 255 so it comes out unchanged.
+static inline uint8_t MulDiv255(unsigned int c, unsigned int a)
+{
+    unsigned int t = c * a + 128;
+    return (uint8_t)((t + (t >> 8)) >> 8);
+}
+
+static void SwapRowScalar(const uint8_t* src, uint8_t* dst, int width, bool premultiply)
+{
+    for (int x = 0; x < width; ++x)
+    {
+        const int off = x * 4;
+        // Through locals: src and dst may be the same row
+        uint8_t c0 = src[off + 0];
+        uint8_t c1 = src[off + 1];
+        uint8_t c2 = src[off + 2];
+        uint8_t a = src[off + 3];
+        if (premultiply)
+        {
+            c0 = MulDiv255(c0, a);
+            c1 = MulDiv255(c1, a);
+            c2 = MulDiv255(c2, a);
+        }
+        dst[off + 0] = c2;
+        dst[off + 1] = c1;
+        dst[off + 2] = c0;
+        dst[off + 3] = a;
+    }
+}
+
+static inline __m128i PremultiplySsse3(__m128i px)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i alphaLo = _mm_setr_epi8(ALPHA_LO_SHUFFLE);
+    const __m128i alphaHi = _mm_setr_epi8(ALPHA_HI_SHUFFLE);
+    const __m128i keepAlpha = _mm_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255);
+    const __m128i round = _mm_set1_epi16(128);
+
+    __m128i lo = _mm_mullo_epi16(_mm_unpacklo_epi8(px, zero), _mm_or_si128(_mm_shuffle_epi8(px, alphaLo), keepAlpha));
+    __m128i hi = _mm_mullo_epi16(_mm_unpackhi_epi8(px, zero), _mm_or_si128(_mm_shuffle_epi8(px, alphaHi), keepAlpha));
+    lo = _mm_add_epi16(lo, round);
+    hi = _mm_add_epi16(hi, round);
+    lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+    hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+    return _mm_packus_epi16(lo, hi);
+}
+
+static void SwapRowSsse3(const uint8_t* src, uint8_t* dst, int width, bool premultiply)
+{
+    const __m128i shuffle = _mm_setr_epi8(SWAP_RB_SHUFFLE);
+    int x = 0;
+    for (; x + 4 <= width; x += 4)
+    {
+        __m128i px = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(src + x * 4)), shuffle);
+        if (premultiply)
+            px = PremultiplySsse3(px);
+        _mm_storeu_si128((__m128i*)(dst + x * 4), px);
+    }
+    SwapRowScalar(src + x * 4, dst + x * 4, width - x, premultiply);
+}
+
+// Byte shuffles, unpacks and packs work per 128-bit lane, so the SSSE3 constants repeat in both halves
+static inline __m256i PremultiplyAvx2(__m256i px)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i alphaLo = _mm256_setr_epi8(ALPHA_LO_SHUFFLE, ALPHA_LO_SHUFFLE);
+    const __m256i alphaHi = _mm256_setr_epi8(ALPHA_HI_SHUFFLE, ALPHA_HI_SHUFFLE);
+    const __m256i keepAlpha = _mm256_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255);
+    const __m256i round = _mm256_set1_epi16(128);
+
+    __m256i lo = _mm256_mullo_epi16(_mm256_unpacklo_epi8(px, zero), _mm256_or_si256(_mm256_shuffle_epi8(px, alphaLo), keepAlpha));
+    __m256i hi = _mm256_mullo_epi16(_mm256_unpackhi_epi8(px, zero), _mm256_or_si256(_mm256_shuffle_epi8(px, alphaHi), keepAlpha));
+    lo = _mm256_add_epi16(lo, round);
+    hi = _mm256_add_epi16(hi, round);
+    lo = _mm256_srli_epi16(_mm256_add_epi16(lo, _mm256_srli_epi16(lo, 8)), 8);
+    hi = _mm256_srli_epi16(_mm256_add_epi16(hi, _mm256_srli_epi16(hi, 8)), 8);
+    return _mm256_packus_epi16(lo, hi);
+}
+
+static void SwapRowAvx2(const uint8_t* src, uint8_t* dst, int width, bool premultiply)
+{
+    const __m256i shuffle = _mm256_setr_epi8(SWAP_RB_SHUFFLE, SWAP_RB_SHUFFLE);
+    int x = 0;
+    for (; x + 8 <= width; x += 8)
+    {
+        __m256i px = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)(src + x * 4)), shuffle);
+        if (premultiply)
+            px = PremultiplyAvx2(px);
+        _mm256_storeu_si256((__m256i*)(dst + x * 4), px);
+    }
+    // Leaves the upper YMM halves dirty otherwise: SSE code after this would pay the transition penalty
+    _mm256_zeroupper();
+    SwapRowSsse3(src + x * 4, dst + x * 4, width - x, premultiply);
+}
+
+static PixelConvert::Path DetectPath()
+{
+    if (CpuFeatures::HasAvx2())
+        return PixelConvert::PATH_AVX2;
+    return CpuFeatures::HasSsse3() ? PixelConvert::PATH_SSSE3 : PixelConvert::PATH_SCALAR;
+}
+
+PixelConvert::Path PixelConvert::GetBestPath()
+{
+    static const Path s_best = DetectPath();
+    return s_best;
+}
+
+const char* PixelConvert::GetPathName(Path path)
+{
+    switch (path == PATH_AUTO ? GetBestPath() : path)
+    {
+    case PATH_AVX2:  return "AVX2";
+    case PATH_SSSE3: return "SSSE3";
+    default:         return "scalar";
+    }
+}
+
+void PixelConvert::SwapRedBlue(const uint8_t* src, int srcPitch, uint8_t* dst, int dstPitch, int width, int height,
+                               bool premultiply, Path path)
+{
+    if (!src || !dst || width <= 0 || height <= 0)
+        return;
+
+    // Forced paths never go beyond what the CPU supports; the enum is ordered by capability
+    const Path best = GetBestPath();
+    if (path == PATH_AUTO || path > best)
+        path = best;
+
+    void (*swapRow)(const uint8_t*, uint8_t*, int, bool) = SwapRowScalar;
+    if (path == PATH_AVX2)
+        swapRow = SwapRowAvx2;
+    else if (path == PATH_SSSE3)
+        swapRow = SwapRowSsse3;
+
+    for (int y = 0; y < height; ++y)
+        swapRow(src + (size_t)y * srcPitch, dst + (size_t)y * dstPitch, width, premultiply);
+}
@@ -0,0 +1,32 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/utils/PixelConvert.h
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+
+// 32-bit pixel rows between RGBA (RwImage, stb_image) and BGRA (D3DFMT_A8R8G8B8) byte order; the swap is the
+// same in both directions. AVX2 / SSSE3 / scalar kernel picked once from CpuFeatures, every path gives the same bytes.
+// Thread-safe, used on the decode workers.
+class PixelConvert
+{
+public:
+    enum Path
+    {
+        PATH_AUTO,      // best path the CPU supports
+        PATH_SCALAR,
+        PATH_SSSE3,     // pshufb, 4 pixels per step
+        PATH_AVX2,      // vpshufb, 8 pixels per step
+    };
+
+    // width x height pixels; pitches in bytes, may differ (LockRect). src == dst with equal pitches converts in place.
+    // premultiply: colour *= alpha / 255, rounded; alpha itself is kept.
+    static void SwapRedBlue(const uint8_t* src, int srcPitch, uint8_t* dst, int dstPitch, int width, int height,
+                            bool premultiply = false, Path path = PATH_AUTO);
+
+    // Path PATH_AUTO resolves to; a forced path the CPU lacks falls back to this one too
+    static Path        GetBestPath();
+    static const char* GetPathName(Path path);
+};
@@ -0,0 +1,171 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/utils/RadarProjection.cpp
+ *****************************************************************************/
+
+#include "RadarProjection.h"
+#include "MathUtils.h"
+#include "CpuFeatures.h"
+#include <immintrin.h>
+
+RadarProjection::RadarProjection()
+    : m_halfWidth(0.0f)
+    , m_halfHeight(0.0f)
+{
+    ZeroMemory(&m_viewProj, sizeof(m_viewProj));
+}
+
+void RadarProjection::Build(const D3DXVECTOR3& cameraPos, const D3DXVECTOR3& cameraRot, float fov, float nearPlane, float farPlane,
+                            float screenWidth, float screenHeight, float projectionAspect)
+{
+    float aspect = (projectionAspect > 0.0f) ? projectionAspect : (screenHeight / screenWidth);
+    D3DXMATRIX view, proj;
+    MathUtils::BuildRadarViewProj(cameraPos, cameraRot, fov, nearPlane, farPlane, aspect, view, proj);
+    D3DXMatrixMultiply(&m_viewProj, &view, &proj);
+    m_halfWidth = screenWidth * 0.5f;
+    m_halfHeight = screenHeight * 0.5f;
+}
+
+void RadarProjectionBatch::Clear()
+{
+    x.clear();
+    y.clear();
+    z.clear();
+}
+
+int RadarProjectionBatch::Add(const D3DXVECTOR3& worldPos)
+{
+    x.push_back(worldPos.x);
+    y.push_back(worldPos.y);
+    z.push_back(worldPos.z);
+    return (int)x.size() - 1;
+}
+
+// Same operation order as Project, exact division and ordered compares (false on NaN like the scalar ones),
+// so every path gives the same bits
+static int ProjectSse(const D3DXMATRIX& m, float halfWidth, float halfHeight, const float* x, const float* y, const float* z,
+                      int count, float* outScreenX, float* outScreenY, uint8_t* outVisible)
+{
+    const __m128 m11 = _mm_set1_ps(m._11), m21 = _mm_set1_ps(m._21), m31 = _mm_set1_ps(m._31), m41 = _mm_set1_ps(m._41);
+    const __m128 m12 = _mm_set1_ps(m._12), m22 = _mm_set1_ps(m._22), m32 = _mm_set1_ps(m._32), m42 = _mm_set1_ps(m._42);
+    const __m128 m13 = _mm_set1_ps(m._13), m23 = _mm_set1_ps(m._23), m33 = _mm_set1_ps(m._33), m43 = _mm_set1_ps(m._43);
+    const __m128 m14 = _mm_set1_ps(m._14), m24 = _mm_set1_ps(m._24), m34 = _mm_set1_ps(m._34), m44 = _mm_set1_ps(m._44);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 halfW = _mm_set1_ps(halfWidth);
+    const __m128 halfH = _mm_set1_ps(halfHeight);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128 px = _mm_loadu_ps(x + i);
+        const __m128 py = _mm_loadu_ps(y + i);
+        const __m128 pz = _mm_loadu_ps(z + i);
+        const __m128 w = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(px, m14), _mm_mul_ps(py, m24)), _mm_mul_ps(pz, m34)), m44);
+        const __m128 cz = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(px, m13), _mm_mul_ps(py, m23)), _mm_mul_ps(pz, m33)), m43);
+        const __m128 hidden = _mm_or_ps(_mm_or_ps(_mm_cmple_ps(w, zero), _mm_cmplt_ps(cz, zero)), _mm_cmpgt_ps(cz, w));
+
+        const __m128 invW = _mm_div_ps(one, w);
+        const __m128 cx = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(px, m11), _mm_mul_ps(py, m21)), _mm_mul_ps(pz, m31)), m41);
+        const __m128 cy = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(px, m12), _mm_mul_ps(py, m22)), _mm_mul_ps(pz, m32)), m42);
+        _mm_storeu_ps(outScreenX + i, _mm_mul_ps(_mm_add_ps(_mm_mul_ps(cx, invW), one), halfW));
+        _mm_storeu_ps(outScreenY + i, _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(cy, invW)), halfH));
+
+        const int hiddenBits = _mm_movemask_ps(hidden);
+        for (int k = 0; k < 4; ++k)
+            outVisible[i + k] = (uint8_t)(((hiddenBits >> k) & 1) ^ 1);
+    }
+    return i;
+}
+
+static int ProjectAvx(const D3DXMATRIX& m, float halfWidth, float halfHeight, const float* x, const float* y, const float* z,
+                      int count, float* outScreenX, float* outScreenY, uint8_t* outVisible)
+{
+    const __m256 m11 = _mm256_set1_ps(m._11), m21 = _mm256_set1_ps(m._21), m31 = _mm256_set1_ps(m._31), m41 = _mm256_set1_ps(m._41);
+    const __m256 m12 = _mm256_set1_ps(m._12), m22 = _mm256_set1_ps(m._22), m32 = _mm256_set1_ps(m._32), m42 = _mm256_set1_ps(m._42);
+    const __m256 m13 = _mm256_set1_ps(m._13), m23 = _mm256_set1_ps(m._23), m33 = _mm256_set1_ps(m._33), m43 = _mm256_set1_ps(m._43);
+    const __m256 m14 = _mm256_set1_ps(m._14), m24 = _mm256_set1_ps(m._24), m34 = _mm256_set1_ps(m._34), m44 = _mm256_set1_ps(m._44);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 halfW = _mm256_set1_ps(halfWidth);
+    const __m256 halfH = _mm256_set1_ps(halfHeight);
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m256 px = _mm256_loadu_ps(x + i);
+        const __m256 py = _mm256_loadu_ps(y + i);
+        const __m256 pz = _mm256_loadu_ps(z + i);
+        const __m256 w = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(px, m14), _mm256_mul_ps(py, m24)), _mm256_mul_ps(pz, m34)), m44);
+        const __m256 cz = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(px, m13), _mm256_mul_ps(py, m23)), _mm256_mul_ps(pz, m33)), m43);
+        const __m256 hidden = _mm256_or_ps(_mm256_or_ps(_mm256_cmp_ps(w, zero, _CMP_LE_OQ), _mm256_cmp_ps(cz, zero, _CMP_LT_OQ)),
+                                           _mm256_cmp_ps(cz, w, _CMP_GT_OQ));
+
+        const __m256 invW = _mm256_div_ps(one, w);
+        const __m256 cx = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(px, m11), _mm256_mul_ps(py, m21)), _mm256_mul_ps(pz, m31)), m41);
+        const __m256 cy = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(px, m12), _mm256_mul_ps(py, m22)), _mm256_mul_ps(pz, m32)), m42);
+        _mm256_storeu_ps(outScreenX + i, _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(cx, invW), one), halfW));
+        _mm256_storeu_ps(outScreenY + i, _mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(cy, invW)), halfH));
+
+        const int hiddenBits = _mm256_movemask_ps(hidden);
+        for (int k = 0; k < 8; ++k)
+            outVisible[i + k] = (uint8_t)(((hiddenBits >> k) & 1) ^ 1);
+    }
+    // Leaves the upper YMM halves dirty otherwise: SSE code after this would pay the transition penalty
+    _mm256_zeroupper();
+    return i;
+}
+
+// The float kernel needs AVX only, no AVX2
+static RadarProjection::Path DetectPath()
+{
+    return CpuFeatures::HasAvx() ? RadarProjection::PATH_AVX : RadarProjection::PATH_SSE;
+}
+
+RadarProjection::Path RadarProjection::GetBestPath()
+{
+    static const Path s_best = DetectPath();
+    return s_best;
+}
+
+const char* RadarProjection::GetPathName(Path path)
+{
+    switch (path == PATH_AUTO ? GetBestPath() : path)
+    {
+    case PATH_AVX: return "AVX";
+    case PATH_SSE: return "SSE";
+    default:       return "scalar";
+    }
+}
+
+void RadarProjection::ProjectBatch(const float* x, const float* y, const float* z, int count,
+                                   float* outScreenX, float* outScreenY, uint8_t* outVisible, Path path) const
+{
+    if (count <= 0)
+        return;
+
+    // Forced paths never go beyond what the CPU supports; the enum is ordered by capability
+    const Path best = GetBestPath();
+    if (path == PATH_AUTO || path > best)
+        path = best;
+
+    int done = 0;
+    if (path == PATH_AVX)
+        done = ProjectAvx(m_viewProj, m_halfWidth, m_halfHeight, x, y, z, count, outScreenX, outScreenY, outVisible);
+    if (path >= PATH_SSE)
+        done += ProjectSse(m_viewProj, m_halfWidth, m_halfHeight, x + done, y + done, z + done, count - done,
+                           outScreenX + done, outScreenY + done, outVisible + done);
+
+    for (int i = done; i < count; ++i)
+        outVisible[i] = Project(D3DXVECTOR3(x[i], y[i], z[i]), outScreenX[i], outScreenY[i]) ? 1 : 0;
+}
+
+void RadarProjection::ProjectBatch(RadarProjectionBatch& batch, Path path) const
+{
+    const size_t count = batch.x.size();
+    batch.screenX.resize(count);
+    batch.screenY.resize(count);
+    batch.visible.resize(count);
+    ProjectBatch(batch.x.data(), batch.y.data(), batch.z.data(), (int)count, batch.screenX.data(), batch.screenY.data(),
+                 batch.visible.data(), path);
+}
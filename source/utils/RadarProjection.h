@@ -0,0 +1,84 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        source/utils/RadarProjection.h
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <d3d9.h>
+#include <d3dx9.h>
+
+// Points to project together, structure-of-arrays; the vectors keep their capacity between frames
+struct RadarProjectionBatch
+{
+    std::vector<float>   x;
+    std::vector<float>   y;
+    std::vector<float>   z;
+    std::vector<float>   screenX;   // ProjectBatch output, undefined where visible is 0
+    std::vector<float>   screenY;
+    std::vector<uint8_t> visible;   // 1 where Project would return true
+
+    void Clear();
+    int  Add(const D3DXVECTOR3& worldPos);  // index of the point
+    int  GetCount() const { return (int)x.size(); }
+};
+
+// Radar camera of one frame: the view and projection of MathUtils::BuildRadarViewProj combined once, so projecting
+// a point is one row-vector transform and a divide. Rebuild whenever the camera moves (once per frame);
+// Project then gives the same result as MathUtils::WorldToScreen with the Build arguments.
+class RadarProjection
+{
+public:
+    enum Path
+    {
+        PATH_AUTO,      // best path the CPU supports
+        PATH_SCALAR,
+        PATH_SSE,       // 4 points per step
+        PATH_AVX,       // 8 points per step
+    };
+
+    RadarProjection();
+
+    // projectionAspect: if > 0 used for the projection, otherwise screenHeight / screenWidth
+    void Build(const D3DXVECTOR3& cameraPos, const D3DXVECTOR3& cameraRot, float fov, float nearPlane, float farPlane,
+               float screenWidth, float screenHeight, float projectionAspect = 0.0f);
+
+    const D3DXMATRIX& GetViewProj() const { return m_viewProj; }
+    float             GetScreenWidth() const { return m_halfWidth * 2.0f; }
+    float             GetScreenHeight() const { return m_halfHeight * 2.0f; }
+
+    // World -> render target pixels; false if the point is behind the camera or outside near / far.
+    // Always false before the first Build (zero matrix).
+    bool Project(const D3DXVECTOR3& worldPos, float& screenX, float& screenY) const
+    {
+        const D3DXMATRIX& m = m_viewProj;
+        const float w = worldPos.x * m._14 + worldPos.y * m._24 + worldPos.z * m._34 + m._44;
+        const float z = worldPos.x * m._13 + worldPos.y * m._23 + worldPos.z * m._33 + m._43;
+        if (w <= 0.0f || z < 0.0f || z > w)
+            return false;
+
+        const float invW = 1.0f / w;
+        const float x = worldPos.x * m._11 + worldPos.y * m._21 + worldPos.z * m._31 + m._41;
+        const float y = worldPos.x * m._12 + worldPos.y * m._22 + worldPos.z * m._32 + m._42;
+        screenX = (x * invW + 1.0f) * m_halfWidth;
+        screenY = (1.0f - y * invW) * m_halfHeight;
+        return true;
+    }
+
+    // Project for count points at once: 8 per step with AVX, 4 with SSE, bit-identical to Project.
+    // outScreenX / outScreenY are left undefined where outVisible is 0. A forced path the CPU lacks falls back to
+    // GetBestPath().
+    void ProjectBatch(const float* x, const float* y, const float* z, int count,
+                      float* outScreenX, float* outScreenY, uint8_t* outVisible, Path path = PATH_AUTO) const;
+    void ProjectBatch(RadarProjectionBatch& batch, Path path = PATH_AUTO) const;
+
+    static Path        GetBestPath();
+    static const char* GetPathName(Path path);
+
+private:
+    D3DXMATRIX m_viewProj;
+    float      m_halfWidth;
+    float      m_halfHeight;
+};
@@ -0,0 +1,191 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        tests/BlipGridTest.cpp
+ *****************************************************************************/
+
+#include "TestCheck.h"
+#include "BlipGrid.h"
+#include <cmath>
+#include <limits>
+#include <vector>
+
+static int CellOf(int cx, int cy)
+{
+    return cy * BlipGrid::CELLS + cx;
+}
+
+// Every filed slot is in the cell it says, once
+static bool Consistent(const BlipGrid& grid, int slotCount)
+{
+    std::vector<int> seen(slotCount, 0);
+    for (int cell = 0; cell < BlipGrid::CELLS * BlipGrid::CELLS; ++cell)
+    {
+        for (uint16_t slot : grid.GetCellSlots(cell))
+        {
+            if (slot >= slotCount || grid.GetCell(slot) != cell || seen[slot]++)
+                return false;
+        }
+    }
+    for (int slot = 0; slot < slotCount; ++slot)
+        if ((grid.GetCell(slot) >= 0) != (seen[slot] == 1))
+            return false;
+    return true;
+}
+
+// A move stays in the cell until it leaves the cell widened by LOOSENESS
+static void TestLooseMoveKeepsCell()
+{
+    const float size = BlipGrid::CELL_SIZE, loose = BlipGrid::LOOSENESS;
+    BlipGrid grid;
+    // Cell (10, 20): x 10..11 cells, y -6000 + 20..21 cells
+    const float minX = 10.0f * size, minY = -6000.0f + 20.0f * size;
+    grid.Insert(0, minX + 0.5f * size, minY + 0.5f * size);
+    CHECK_EQ(grid.GetCell(0), CellOf(10, 20));
+
+    const float inside[][2] = {
+        { minX - loose + 1.0f, minY + 1.0f }, { minX + size + loose - 1.0f, minY + size - 1.0f },
+        { minX + 1.0f, minY - loose + 1.0f }, { minX + size + loose - 1.0f, minY + size + loose - 1.0f },
+    };
+    for (const auto& p : inside)
+    {
+        grid.Move(0, p[0], p[1]);
+        CHECK_EQ(grid.GetCell(0), CellOf(10, 20));
+    }
+
+    // Just past the loose edge: filed under the cell it is in now
+    grid.Move(0, minX + size + loose + 1.0f, minY + 1.0f);
+    CHECK_EQ(grid.GetCell(0), CellOf(11 + (int)((loose + 1.0f) / size), 20));
+    grid.Move(0, minX - loose - 1.0f, minY + 1.0f);
+    CHECK_EQ(grid.GetCell(0), CellOf(9 - (int)((loose + 1.0f) / size), 20));
+
+    // A query around the point finds it wherever the loose cell put it
+    bool found = false;
+    grid.Query(minX - loose - 2.0f, minY, minX - loose, minY + 2.0f, [&](uint16_t slot) { found |= slot == 0; });
+    CHECK(found);
+    CHECK(Consistent(grid, 1));
+}
+
+// Outside the map, and NaN, land in the border cells and stay there however far they go
+static void TestBorderCellsClamp()
+{
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    BlipGrid grid;
+    grid.Insert(0, -500.0f, -3000.0f);
+    grid.Insert(1, 90000.0f, -3000.0f);
+    grid.Insert(2, 3000.0f, -90000.0f);
+    grid.Insert(3, 3000.0f, 500.0f);
+    grid.Insert(4, -1e30f, 1e30f);
+    grid.Insert(5, nan, nan);
+    const int mid = (int)(3000.0f / BlipGrid::CELL_SIZE);
+    CHECK_EQ(grid.GetCell(0), CellOf(0, mid));
+    CHECK_EQ(grid.GetCell(1), CellOf(BlipGrid::CELLS - 1, mid));
+    CHECK_EQ(grid.GetCell(2), CellOf(mid, 0));
+    CHECK_EQ(grid.GetCell(3), CellOf(mid, BlipGrid::CELLS - 1));
+    CHECK_EQ(grid.GetCell(4), CellOf(0, BlipGrid::CELLS - 1));
+    CHECK_EQ(grid.GetCell(5), CellOf(0, 0));
+
+    grid.Move(0, -1e9f, -3000.0f);
+    CHECK_EQ(grid.GetCell(0), CellOf(0, mid));
+    grid.Move(1, 6000.0f + BlipGrid::LOOSENESS * 100.0f, -3000.0f);
+    CHECK_EQ(grid.GetCell(1), CellOf(BlipGrid::CELLS - 1, mid));
+
+    // Queries clamp the same way
+    int visited = 0;
+    grid.Query(-2e9f, -3001.0f, -1e9f, -2999.0f, [&](uint16_t slot) { visited += (slot == 0) ? 1 : 0; });
+    CHECK_EQ(visited, 1);
+    visited = 0;
+    grid.Query(1e5f, 1e5f, 2e5f, 2e5f, [&](uint16_t slot) { visited += (slot == 4) ? 0 : 1; });
+    CHECK_EQ(visited, 0);
+    CHECK(Consistent(grid, 6));
+}
+
+// Remove swaps the last entry of the cell into the gap; its position must follow or the next remove breaks
+static void TestRemoveSwapBack()
+{
+    BlipGrid grid;
+    for (uint32_t slot = 0; slot < 5; ++slot)
+        grid.Insert(slot, 100.0f + slot, -100.0f);
+    const int cell = grid.GetCell(0);
+
+    grid.Remove(0);     // 4 moves to 0's place
+    CHECK(Consistent(grid, 5));
+    grid.Remove(4);     // removed from its new place, 3 moves there
+    CHECK(Consistent(grid, 5));
+    grid.Remove(1);
+    CHECK(Consistent(grid, 5));
+    CHECK_EQ(grid.GetCellSlots(cell).size(), 2u);
+    CHECK_EQ(grid.GetCell(4), -1);
+    grid.Remove(4);     // not in the grid: no-op
+    CHECK_EQ(grid.GetCellSlots(cell).size(), 2u);
+
+    // Moving the swapped entry to another cell and back
+    grid.Move(3, 5000.0f, -5000.0f);
+    CHECK(grid.GetCell(3) != cell);
+    grid.Move(2, 5000.0f, -5000.0f);
+    grid.Remove(3);
+    CHECK(Consistent(grid, 5));
+    CHECK_EQ(grid.GetCellSlots(cell).size(), 0u);
+}
+
+// Random inserts, moves and removes: the grid stays consistent and a query returns every slot in the rect
+static void TestRandomQueries()
+{
+    const int SLOTS = 3000;
+    BlipGrid grid;
+    std::vector<float> x(SLOTS), y(SLOTS);
+    std::vector<bool> live(SLOTS, false);
+    uint32_t seed = 11;
+    auto random = [&seed](float range) {
+        seed = seed * 1664525u + 1013904223u;
+        return (float)(seed >> 8) / 16777216.0f * range;
+    };
+    for (int step = 0; step < 40000; ++step)
+    {
+        const int slot = (int)random((float)SLOTS);
+        if (!live[slot])
+        {
+            x[slot] = random(7000.0f) - 500.0f;
+            y[slot] = random(7000.0f) - 6500.0f;
+            grid.Insert(slot, x[slot], y[slot]);
+            live[slot] = true;
+        }
+        else if (random(1.0f) < 0.3f)
+        {
+            grid.Remove(slot);
+            live[slot] = false;
+        }
+        else
+        {
+            x[slot] += random(400.0f) - 200.0f;
+            y[slot] += random(400.0f) - 200.0f;
+            grid.Move(slot, x[slot], y[slot]);
+        }
+        if (step % 500 != 0)
+            continue;
+
+        if (!CHECK(Consistent(grid, SLOTS)))
+            return;
+        const float minX = random(6000.0f) - 500.0f, minY = random(6000.0f) - 6500.0f;
+        const float maxX = minX + random(1500.0f), maxY = minY + random(1500.0f);
+        std::vector<int> hits(SLOTS, 0);
+        grid.Query(minX, minY, maxX, maxY, [&](uint16_t s) { ++hits[s]; });
+        for (int s = 0; s < SLOTS; ++s)
+        {
+            const bool inRect = live[s] && x[s] >= minX && x[s] <= maxX && y[s] >= minY && y[s] <= maxY;
+            if (!CHECK(hits[s] <= 1) || (inRect && !CHECK(hits[s] == 1)))
+            {
+                fprintf(stderr, "    step %d, slot %d\n", step, s);
+                return;
+            }
+        }
+    }
+}
+
+int main()
+{
+    RUN_TEST(TestLooseMoveKeepsCell);
+    RUN_TEST(TestBorderCellsClamp);
+    RUN_TEST(TestRemoveSwapBack);
+    RUN_TEST(TestRandomQueries);
+    return TEST_RESULT();
+}
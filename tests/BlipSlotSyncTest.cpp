@@ -0,0 +1,276 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        tests/BlipSlotSyncTest.cpp
+ *****************************************************************************/
+
+#include "TestCheck.h"
+#include "BlipSlotSync.h"
+#include <cstring>
+#include <vector>
+
+// Stand-in for tRadarTrace: compared whole, so no padding bytes
+struct TestTrace
+{
+    uint32_t counter;
+    uint8_t  inUse;
+    uint8_t  icon;
+    uint8_t  vehicleBlip;   // BLIP_CAR: follows entities[entity]
+    uint8_t  reserved;
+    int32_t  entity;
+    float    x;
+    float    y;
+    uint32_t colour;
+};
+
+// Entities the vehicle blips follow; position x < 0 = not in the pool
+struct TestSource
+{
+    std::vector<D3DXVECTOR3> entities;
+    int builds = 0;
+    int followCalls = 0;
+
+    bool Build(int, const uint8_t* record, Blip& outBlip, bool& outFollows)
+    {
+        ++builds;
+        const TestTrace& trace = *(const TestTrace*)record;
+        outFollows = trace.vehicleBlip && entities[trace.entity].x >= 0.0f;
+        if (!trace.inUse)
+            return false;
+        outBlip.position = outFollows ? entities[trace.entity] : D3DXVECTOR3(trace.x, trace.y, 0.1f);
+        outBlip.iconId = outFollows ? 0 : trace.icon;
+        outBlip.size = 8.0f;
+        outBlip.color = trace.colour;
+        outBlip.enabled = true;
+        outBlip.shortRange = false;
+        return true;
+    }
+
+    BlipSlotSync::FollowResult Follow(int, const uint8_t* record, bool follows, D3DXVECTOR3& outPosition)
+    {
+        ++followCalls;
+        const TestTrace& trace = *(const TestTrace*)record;
+        if (!trace.inUse || !trace.vehicleBlip)
+            return BlipSlotSync::FOLLOW_STATIC;
+        const bool inPool = entities[trace.entity].x >= 0.0f;
+        if (inPool != follows)
+            return BlipSlotSync::FOLLOW_REBUILD;
+        if (!inPool)
+            return BlipSlotSync::FOLLOW_STATIC;
+        outPosition = entities[trace.entity];
+        return BlipSlotSync::FOLLOW_AT;
+    }
+};
+
+static const int SLOTS = 250;
+
+static std::vector<TestTrace> MakeTraces(int inUse)
+{
+    std::vector<TestTrace> traces(SLOTS);
+    memset(traces.data(), 0, traces.size() * sizeof(TestTrace));
+    for (int i = 0; i < inUse; ++i)
+    {
+        traces[i].counter = 1;
+        traces[i].inUse = 1;
+        traces[i].icon = (uint8_t)(2 + i % 60);
+        traces[i].x = 10.0f * i;
+        traces[i].y = 5000.0f - 10.0f * i;
+        traces[i].colour = 0xFF000000u | (uint32_t)i;
+    }
+    return traces;
+}
+
+static bool SameBlip(const Blip& a, const Blip& b)
+{
+    return a.position.x == b.position.x && a.position.y == b.position.y && a.position.z == b.position.z && a.iconId == b.iconId && a.size == b.size && a.color == b.color &&
+           a.enabled == b.enabled && a.shortRange == b.shortRange;
+}
+
+// Store holds exactly what building every slot from scratch gives
+static bool MatchesFullBuild(const BlipSlotSync& sync, const BlipStore& store, const std::vector<TestTrace>& traces, TestSource source)
+{
+    int expected = 0;
+    for (int i = 0; i < SLOTS; ++i)
+    {
+        Blip blip;
+        bool follows;
+        const bool hasBlip = source.Build(i, (const uint8_t*)&traces[i], blip, follows);
+        const int index = store.GetIndex(sync.GetHandle(i));
+        if (hasBlip != (index >= 0) || (hasBlip && !SameBlip(store.Get(index), blip)))
+            return false;
+        expected += hasBlip ? 1 : 0;
+    }
+    return store.GetCount() - store.GetRemovedCount() == expected;
+}
+
+static void TestAddThenUntouched()
+{
+    BlipSlotSync sync;
+    BlipStore store;
+    TestSource source;
+    source.entities.assign(8, D3DXVECTOR3(-1.0f, 0.0f, 0.0f));
+    std::vector<TestTrace> traces = MakeTraces(175);
+    sync.Reset(SLOTS, sizeof(TestTrace));
+
+    CHECK(sync.Sync((const uint8_t*)traces.data(), store, source));
+    CHECK_EQ(sync.GetStats().added, 175);
+    CHECK_EQ(sync.GetStats().untouched, SLOTS - 175);
+    CHECK_EQ(source.builds, SLOTS);
+    CHECK(MatchesFullBuild(sync, store, traces, source));
+
+    // Nothing changed: no builds, no store writes
+    const uint32_t version = store.GetVersion();
+    source.builds = 0;
+    CHECK(!sync.Sync((const uint8_t*)traces.data(), store, source));
+    CHECK_EQ(sync.GetStats().untouched, SLOTS);
+    CHECK_EQ(source.builds, 0);
+    CHECK_EQ(store.GetVersion(), version);
+}
+
+static void TestChangedSlotsOnly()
+{
+    BlipSlotSync sync;
+    BlipStore store;
+    TestSource source;
+    source.entities.assign(8, D3DXVECTOR3(-1.0f, 0.0f, 0.0f));
+    std::vector<TestTrace> traces = MakeTraces(100);
+    sync.Reset(SLOTS, sizeof(TestTrace));
+    sync.Sync((const uint8_t*)traces.data(), store, source);
+    const BlipHandle handle7 = sync.GetHandle(7);
+
+    // Colour change, slot freed, slot taken, counter bump (same trace reused): one build each
+    traces[7].colour = 0xFFFF0000u;
+    traces[20].inUse = 0;
+    traces[200].inUse = 1;
+    traces[200].icon = 9;
+    traces[40].counter = 2;
+    source.builds = 0;
+    CHECK(sync.Sync((const uint8_t*)traces.data(), store, source));
+    CHECK_EQ(source.builds, 4);
+    CHECK_EQ(sync.GetStats().updated, 2);
+    CHECK_EQ(sync.GetStats().removed, 1);
+    CHECK_EQ(sync.GetStats().added, 1);
+    CHECK_EQ(sync.GetStats().untouched, SLOTS - 4);
+    CHECK_EQ(sync.GetHandle(7), handle7);
+    CHECK_EQ(sync.GetHandle(20), 0u);
+    CHECK(MatchesFullBuild(sync, store, traces, source));
+}
+
+static void TestVehicleBlipFollows()
+{
+    BlipSlotSync sync;
+    BlipStore store;
+    TestSource source;
+    source.entities.assign(8, D3DXVECTOR3(-1.0f, 0.0f, 0.0f));
+    source.entities[3] = D3DXVECTOR3(100.0f, 200.0f, 0.1f);
+    std::vector<TestTrace> traces = MakeTraces(10);
+    traces[4].vehicleBlip = 1;
+    traces[4].entity = 3;
+    traces[5].vehicleBlip = 1;
+    traces[5].entity = 6;       // not in the pool yet
+    sync.Reset(SLOTS, sizeof(TestTrace));
+    sync.Sync((const uint8_t*)traces.data(), store, source);
+
+    // Moving vehicle: position only, no build
+    source.entities[3] = D3DXVECTOR3(150.0f, 210.0f, 0.1f);
+    source.builds = 0;
+    CHECK(!sync.Sync((const uint8_t*)traces.data(), store, source));
+    CHECK_EQ(source.builds, 0);
+    CHECK_EQ(sync.GetStats().updated, 1);
+    const int index = store.GetIndex(sync.GetHandle(4));
+    CHECK(index >= 0 && store.GetX()[index] == 150.0f && store.GetY()[index] == 210.0f);
+
+    // Vehicle enters the pool: the slot is rebuilt with the vehicle sprite; leaving rebuilds it again
+    source.entities[6] = D3DXVECTOR3(5.0f, 5.0f, 0.1f);
+    CHECK(sync.Sync((const uint8_t*)traces.data(), store, source));
+    CHECK_EQ(source.builds, 1);
+    CHECK_EQ(store.Get(store.GetIndex(sync.GetHandle(5))).iconId, 0);
+    source.entities[3] = D3DXVECTOR3(-1.0f, 0.0f, 0.0f);
+    CHECK(sync.Sync((const uint8_t*)traces.data(), store, source));
+    CHECK_EQ(source.builds, 2);
+    CHECK(MatchesFullBuild(sync, store, traces, source));
+}
+
+static void TestInvalidateRebuildsAll()
+{
+    BlipSlotSync sync;
+    BlipStore store;
+    TestSource source;
+    source.entities.assign(8, D3DXVECTOR3(-1.0f, 0.0f, 0.0f));
+    std::vector<TestTrace> traces = MakeTraces(50);
+    sync.Reset(SLOTS, sizeof(TestTrace));
+    sync.Sync((const uint8_t*)traces.data(), store, source);
+
+    // As BlipManager::ResetStore after a texture reload
+    store.Clear();
+    sync.Invalidate();
+    CHECK(!sync.IsValid());
+    source.builds = 0;
+    CHECK(sync.Sync((const uint8_t*)traces.data(), store, source));
+    CHECK_EQ(source.builds, SLOTS);
+    CHECK_EQ(sync.GetStats().added, 50);
+    CHECK(MatchesFullBuild(sync, store, traces, source));
+}
+
+// Random replay: after every update the store equals a full rebuild and the counters cover every slot once
+static void TestReplayMatchesFullBuild()
+{
+    BlipSlotSync sync;
+    BlipStore store;
+    TestSource source;
+    source.entities.assign(32, D3DXVECTOR3(-1.0f, 0.0f, 0.0f));
+    std::vector<TestTrace> traces = MakeTraces(175);
+    for (int i = 0; i < 32; ++i)
+    {
+        traces[i * 5].vehicleBlip = 1;
+        traces[i * 5].entity = i;
+    }
+    sync.Reset(SLOTS, sizeof(TestTrace));
+
+    uint32_t seed = 1;
+    auto random = [&seed](int range) {
+        seed = seed * 1664525u + 1013904223u;
+        return (int)((seed >> 8) % (uint32_t)range);
+    };
+    for (int update = 0; update < 3000; ++update)
+    {
+        for (int i = 0; i < 32; ++i)
+        {
+            if (random(50) == 0)
+                source.entities[i].x = (source.entities[i].x < 0.0f) ? (float)random(6000) : -1.0f;
+            else if (source.entities[i].x >= 0.0f && random(3) == 0)
+                source.entities[i].x += 1.0f;
+        }
+        for (int change = random(4); change > 0; --change)
+        {
+            TestTrace& trace = traces[random(SLOTS)];
+            switch (random(4))
+            {
+            case 0: trace.inUse ^= 1; break;
+            case 1: trace.colour ^= 0x00FF00u; break;
+            case 2: trace.x += 10.0f; break;
+            default: ++trace.counter; break;
+            }
+        }
+
+        sync.Sync((const uint8_t*)traces.data(), store, source);
+        if (update % 3 == 0)
+            store.Compact();
+        const BlipSlotSync::Stats& stats = sync.GetStats();
+        if (!CHECK(stats.added + stats.removed + stats.updated + stats.untouched == SLOTS) ||
+            !CHECK(MatchesFullBuild(sync, store, traces, source)))
+        {
+            fprintf(stderr, "    update %d\n", update);
+            return;
+        }
+    }
+}
+
+int main()
+{
+    RUN_TEST(TestAddThenUntouched);
+    RUN_TEST(TestChangedSlotsOnly);
+    RUN_TEST(TestVehicleBlipFollows);
+    RUN_TEST(TestInvalidateRebuildsAll);
+    RUN_TEST(TestReplayMatchesFullBuild);
+    return TEST_RESULT();
+}
@@ -0,0 +1,168 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        tests/BlipStoreTest.cpp
+ *****************************************************************************/
+
+#include "TestCheck.h"
+#include "BlipStore.h"
+#include <algorithm>
+#include <vector>
+
+static Blip MakeBlip(float x, float y, int icon)
+{
+    Blip blip;
+    blip.position = D3DXVECTOR3(x, y, 0.1f);
+    blip.iconId = icon;
+    blip.size = 8.0f;
+    blip.color = 0xFF000000u | (DWORD)icon;
+    blip.enabled = true;
+    blip.shortRange = (icon & 1) != 0;
+    return blip;
+}
+
+// Remove leaves the other blips where they are; Compact closes the gaps in order
+static void TestRemoveThenCompact()
+{
+    BlipStore store;
+    std::vector<BlipHandle> handles;
+    for (int i = 0; i < 10; ++i)
+        handles.push_back(store.Add(MakeBlip(10.0f * i, 0.0f, i)));
+
+    const uint32_t version = store.GetVersion();
+    CHECK(store.Remove(handles[2]));
+    CHECK(store.Remove(handles[7]));
+    CHECK(!store.Remove(handles[7]));
+    CHECK(store.GetVersion() != version);
+    CHECK_EQ(store.GetCount(), 10);
+    CHECK_EQ(store.GetRemovedCount(), 2);
+    CHECK(!store.IsValid(handles[2]));
+    CHECK_EQ(store.GetFlags()[2], 0);
+    CHECK_EQ(store.GetIndex(handles[9]), 9);
+
+    // Tombstones never come out of the grid
+    std::vector<int> indices;
+    store.QueryRect(-1.0f, -1.0f, 1000.0f, 1.0f, indices);
+    CHECK_EQ(indices.size(), 8u);
+    CHECK(std::find(indices.begin(), indices.end(), 2) == indices.end());
+
+    store.Compact();
+    CHECK_EQ(store.GetCount(), 8);
+    CHECK_EQ(store.GetRemovedCount(), 0);
+    const int order[] = { 0, 1, 3, 4, 5, 6, 8, 9 };
+    for (int k = 0; k < 8; ++k)
+    {
+        CHECK_EQ(store.GetIndex(handles[order[k]]), k);
+        CHECK_EQ(store.GetIcon()[k], order[k]);
+        CHECK_EQ(store.GetX()[k], 10.0f * order[k]);
+    }
+    indices.clear();
+    store.QueryRect(-1.0f, -1.0f, 1000.0f, 1.0f, indices);
+    CHECK_EQ(indices.size(), 8u);
+    CHECK_EQ(indices.back(), 7);
+}
+
+// A freed slot is reused with a new generation: the old handle stays stale
+static void TestStaleHandles()
+{
+    BlipStore store;
+    const BlipHandle first = store.Add(MakeBlip(0.0f, 0.0f, 3));
+    store.Remove(first);
+    const BlipHandle second = store.Add(MakeBlip(5.0f, 5.0f, 4));
+    CHECK(second != first);
+    CHECK((second & 0xFFFF) == (first & 0xFFFF));
+    CHECK(!store.IsValid(first));
+    CHECK(!store.Set(first, MakeBlip(1.0f, 1.0f, 1)));
+    CHECK(!store.SetPosition(first, D3DXVECTOR3(1.0f, 1.0f, 0.0f)));
+    CHECK_EQ(store.GetIndex(second), 1);
+    store.Compact();
+    CHECK_EQ(store.GetIndex(second), 0);
+    CHECK_EQ(store.Get(0).iconId, 4);
+
+    store.Clear();
+    CHECK_EQ(store.GetCount(), 0);
+    CHECK_EQ(store.GetRemovedCount(), 0);
+    CHECK(!store.IsValid(second));
+    store.Compact();
+    CHECK_EQ(store.GetCount(), 0);
+}
+
+// Random adds, removes and moves against an ordered list of (handle, blip), compacted every few steps
+static void TestRandomAgainstList()
+{
+    struct Entry
+    {
+        BlipHandle handle;
+        Blip       blip;
+    };
+    BlipStore store;
+    std::vector<Entry> list;
+    std::vector<BlipHandle> removed;
+
+    uint32_t seed = 3;
+    auto random = [&seed](int range) {
+        seed = seed * 1664525u + 1013904223u;
+        return (int)((seed >> 8) % (uint32_t)range);
+    };
+    for (int step = 0; step < 20000; ++step)
+    {
+        const int op = random(10);
+        if (op < 4 || list.empty())
+        {
+            Entry entry;
+            entry.blip = MakeBlip((float)random(6000) - 3000.0f, (float)random(6000) - 3000.0f, random(70));
+            entry.handle = store.Add(entry.blip);
+            list.push_back(entry);
+        }
+        else if (op < 8)
+        {
+            const size_t k = (size_t)random((int)list.size());
+            CHECK(store.Remove(list[k].handle));
+            removed.push_back(list[k].handle);
+            list.erase(list.begin() + k);
+        }
+        else
+        {
+            Entry& entry = list[(size_t)random((int)list.size())];
+            entry.blip.position = D3DXVECTOR3((float)random(6000) - 3000.0f, (float)random(6000) - 3000.0f, 0.1f);
+            CHECK(store.SetPosition(entry.handle, entry.blip.position));
+        }
+        if (random(8) != 0)
+            continue;
+
+        store.Compact();
+        if (!CHECK(store.GetCount() == (int)list.size()))
+            return;
+        for (size_t k = 0; k < list.size(); ++k)
+        {
+            const Blip blip = store.Get((int)k);
+            const Blip& expected = list[k].blip;
+            if (!CHECK(store.GetIndex(list[k].handle) == (int)k) || !CHECK(blip.position.x == expected.position.x) ||
+                !CHECK(blip.position.y == expected.position.y) || !CHECK(blip.iconId == expected.iconId) ||
+                !CHECK(blip.shortRange == expected.shortRange))
+            {
+                fprintf(stderr, "    step %d, entry %zu\n", step, k);
+                return;
+            }
+        }
+        for (BlipHandle handle : removed)
+            if (!CHECK(!store.IsValid(handle)))
+                return;
+        removed.clear();
+
+        std::vector<int> indices;
+        store.QueryRadius(0.0f, 0.0f, 1500.0f, indices);
+        size_t inside = 0;
+        for (const Entry& entry : list)
+            inside += (entry.blip.position.x * entry.blip.position.x + entry.blip.position.y * entry.blip.position.y <= 1500.0f * 1500.0f) ? 1 : 0;
+        if (!CHECK(indices.size() == inside))
+            return;
+    }
+}
+
+int main()
+{
+    RUN_TEST(TestRemoveThenCompact);
+    RUN_TEST(TestStaleHandles);
+    RUN_TEST(TestRandomAgainstList);
+    return TEST_RESULT();
+}
@@ -0,0 +1,138 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        tests/ChunkBackgroundFeedTest.cpp
+ *****************************************************************************/
+
+#include "TestCheck.h"
+#include "ChunkBackgroundFeed.h"
+#include "ChunkMipChain.h"
+#include <filesystem>
+#include <string>
+
+static const int GRID = 12;
+static const int CHUNKS = GRID * GRID;
+
+static ChunkPixels MakeChunk()
+{
+    ChunkPixels pixels = {};
+    pixels.width = 8;
+    pixels.height = 8;
+    pixels.pitch = 32;
+    pixels.levels = 4;
+    pixels.format = CHUNK_FORMAT_BGRA8;
+    pixels.data.assign(ChunkMipChain::ChainSize(8, 8, 4), 0x40);
+    return pixels;
+}
+
+static void TestCacheHitSubmitsNothing()
+{
+    const std::string path = (std::filesystem::temp_directory_path() / "radar_feed_hit.cache").string();
+    ChunkCache::Key key;
+    ChunkCache::MakeKey(1, 2, 3, ChunkPyramid::MAX_LEVELS, false, 0, key);
+    {
+        // Every level present, the way a finished session leaves it
+        const int levelTiles[3] = { CHUNKS, 36, 9 };
+        ChunkCacheWriter writer;
+        CHECK(writer.Begin(path.c_str(), key, levelTiles, 3));
+        const ChunkPixels chunk = MakeChunk();
+        for (int level = 0; level < 3; ++level)
+            for (int index = 0; index < levelTiles[level]; ++index)
+                writer.Write(level, index, chunk);
+        CHECK(!writer.IsActive());
+    }
+
+    ChunkCache cache;
+    CHECK(cache.Open(path.c_str(), key));
+    // Same state as MapChunkManager after a cache hit: empty pyramid, no writer
+    ChunkPyramid pyramid;
+    pyramid.Reset(GRID, ChunkPyramid::MAX_LEVELS);
+    ChunkCacheWriter writer;
+    std::vector<bool> queued(CHUNKS, false), unavailable(CHUNKS, false);
+
+    ChunkBackgroundFeed feed;
+    feed.Reset(CHUNKS);
+    CHECK(feed.IsDone(cache, pyramid, writer));
+    int submitted = 0;
+    for (int frame = 0; frame < 2 * CHUNKS; ++frame)
+        feed.Feed(cache, pyramid, writer, queued, unavailable, [&](int) { ++submitted; return true; });
+    CHECK_EQ(submitted, 0);
+    CHECK_EQ(pyramid.GetContributedCount(), 0);
+    CHECK(!feed.IsInFlight());
+
+    cache.Close();
+    std::filesystem::remove(path);
+}
+
+static void TestFeedsEveryChunkOnce()
+{
+    ChunkCache cache;
+    ChunkPyramid pyramid;
+    pyramid.Reset(GRID, ChunkPyramid::MAX_LEVELS);
+    ChunkCacheWriter writer;
+    std::vector<bool> queued(CHUNKS, false), unavailable(CHUNKS, false);
+    unavailable[7] = true;
+    unavailable[100] = true;
+    queued[20] = true;  // requested by the view: the feed leaves it alone
+
+    ChunkBackgroundFeed feed;
+    feed.Reset(CHUNKS);
+    std::vector<int> submits(CHUNKS, 0);
+    const ChunkPixels chunk = MakeChunk();
+    int pending = -1;
+    for (int frame = 0; frame < 4 * CHUNKS && !feed.IsDone(cache, pyramid, writer); ++frame)
+    {
+        // Last frame's job finishes on a worker
+        if (pending >= 0)
+        {
+            pyramid.Contribute(pending, chunk);
+            feed.OnJobDone();
+            pending = -1;
+        }
+        if (frame == CHUNKS)
+        {
+            queued[20] = false;
+            pyramid.Contribute(20, chunk);
+        }
+
+        const int index = feed.Feed(cache, pyramid, writer, queued, unavailable, [&](int i) { ++submits[i]; return true; });
+        if (index >= 0)
+        {
+            CHECK(feed.IsInFlight());
+            // One job at a time
+            CHECK_EQ(feed.Feed(cache, pyramid, writer, queued, unavailable, [&](int i) { ++submits[i]; return true; }), -1);
+            pending = index;
+        }
+    }
+
+    CHECK(feed.IsDone(cache, pyramid, writer));
+    CHECK_EQ(pyramid.GetContributedCount(), CHUNKS);
+    bool once = true;
+    for (int i = 0; i < CHUNKS; ++i)
+        once = once && submits[i] == ((i == 7 || i == 100 || i == 20) ? 0 : 1);
+    CHECK(once);
+}
+
+static void TestFailedSubmitMovesOn()
+{
+    ChunkCache cache;
+    ChunkPyramid pyramid;
+    pyramid.Reset(GRID, 1);
+    ChunkCacheWriter writer;
+    std::vector<bool> queued(CHUNKS, false), unavailable(CHUNKS, false);
+
+    ChunkBackgroundFeed feed;
+    feed.Reset(CHUNKS);
+    int attempts = 0;
+    const int index = feed.Feed(cache, pyramid, writer, queued, unavailable, [&](int i) { ++attempts; return i >= 3; });
+    CHECK_EQ(index, 3);
+    CHECK_EQ(attempts, 4);
+    CHECK(feed.IsInFlight());
+}
+
+int main()
+{
+    RUN_TEST(TestCacheHitSubmitsNothing);
+    RUN_TEST(TestFeedsEveryChunkOnce);
+    RUN_TEST(TestFailedSubmitMovesOn);
+    return TEST_RESULT();
+}
@@ -0,0 +1,271 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        tests/ChunkCacheTest.cpp
+ *****************************************************************************/
+
+#include "TestCheck.h"
+#include "ChunkCache.h"
+#include "ChunkMipChain.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+static std::string TempPath(const char* name)
+{
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+static ChunkPixels MakeTile(int size, int seed)
+{
+    ChunkPixels pixels = {};
+    pixels.width = size;
+    pixels.height = size;
+    pixels.pitch = size * 4;
+    pixels.levels = 1;
+    pixels.format = CHUNK_FORMAT_BGRA8;
+    pixels.data.resize((size_t)size * size * 4);
+    for (size_t i = 0; i < pixels.data.size(); ++i)
+        pixels.data[i] = (uint8_t)(i * 7 + seed * 31 + (i >> 8));
+    ChunkMipChain::Build(pixels);
+    pixels.hash = 1000 + seed;
+    return pixels;
+}
+
+// 4 base tiles of 256x256 (~350 KB each, so most payloads start off a 64 KB boundary), tile 2 missing, one coarse tile
+static bool WriteCache(const std::string& path, const ChunkCache::Key& key)
+{
+    const int levelTiles[2] = { 4, 1 };
+    ChunkCacheWriter writer;
+    if (!writer.Begin(path.c_str(), key, levelTiles, 2))
+        return false;
+    writer.Write(0, 0, MakeTile(256, 0));
+    writer.Write(0, 1, MakeTile(256, 1));
+    writer.Skip(0, 2);
+    writer.Write(0, 3, MakeTile(256, 3));
+    writer.Write(1, 0, MakeTile(64, 4));
+    return !writer.IsActive();
+}
+
+static void TestPerTileViews()
+{
+    const std::string path = TempPath("radar_cache_views.cache");
+    ChunkCache::Key key;
+    ChunkCache::MakeKey(123, 456, 789, 1, false, 0, key);
+    CHECK(WriteCache(path, key));
+
+    ChunkCache cache;
+    CHECK(cache.Open(path.c_str(), key));
+    CHECK(cache.Find(0, 2) == nullptr);
+    CHECK(cache.Find(0, 4) == nullptr);
+    CHECK(cache.Find(2, 0) == nullptr);
+
+    const int present[4][2] = { { 0, 0 }, { 0, 1 }, { 0, 3 }, { 1, 0 } };
+    for (const auto& p : present)
+    {
+        const ChunkCache::Tile* found = cache.Find(p[0], p[1]);
+        if (!CHECK(found != nullptr))
+            continue;
+        CHECK(found->data == nullptr);
+
+        const int seed = (p[0] == 1) ? 4 : p[1];
+        const ChunkPixels expected = MakeTile(p[0] == 1 ? 64 : 256, seed);
+        MappedView view;
+        ChunkCache::Tile tile;
+        CHECK(cache.Map(p[0], p[1], view, tile));
+        CHECK_EQ(tile.width, expected.width);
+        CHECK_EQ(tile.levels, expected.levels);
+        CHECK_EQ(tile.hash, expected.hash);
+        CHECK_EQ(view.GetSize(), expected.data.size());
+        CHECK(tile.data == view.GetData());
+        CHECK(memcmp(tile.data, expected.data.data(), expected.data.size()) == 0);
+    }
+
+    MappedView view;
+    ChunkCache::Tile tile;
+    CHECK(!cache.Map(0, 2, view, tile));
+    CHECK(view.GetData() == nullptr);
+    cache.Close();
+    std::filesystem::remove(path);
+}
+
+static void TestViewBounds()
+{
+    const std::string path = TempPath("radar_cache_bounds.bin");
+    {
+        FILE* f = fopen(path.c_str(), "wb");
+        for (int i = 0; i < 200000; ++i)
+            fputc(i & 0xFF, f);
+        fclose(f);
+    }
+
+    MappedFile file;
+    CHECK(file.OpenViews(path.c_str()));
+    CHECK(file.IsOpen());
+    CHECK(file.GetData() == nullptr);
+    CHECK_EQ(file.GetSize(), (size_t)200000);
+
+    // Offsets on and off the 64 KB granularity, up to the last byte
+    const uint64_t offsets[] = { 0, 1, 65535, 65536, 65537, 199999 };
+    for (uint64_t offset : offsets)
+    {
+        MappedView view;
+        const size_t size = (size_t)(200000 - offset < 1000 ? 200000 - offset : 1000);
+        CHECK(view.Map(file, offset, size));
+        bool same = true;
+        for (size_t i = 0; i < size; ++i)
+            same = same && view.GetData()[i] == (uint8_t)((offset + i) & 0xFF);
+        CHECK(same);
+    }
+
+    MappedView view;
+    CHECK(!view.Map(file, 199999, 2));
+    CHECK(!view.Map(file, 200001, 1));
+    CHECK(!view.Map(file, 0, 0));
+    file.Close();
+    CHECK(!view.Map(file, 0, 1));
+    std::filesystem::remove(path);
+}
+
+static void TestKeyInvalidation()
+{
+    const std::string path = TempPath("radar_cache_key.cache");
+    ChunkCache::Key key;
+    ChunkCache::MakeKey(123, 456, 789, 1, false, 0, key);
+    CHECK(WriteCache(path, key));
+
+    ChunkCache cache;
+    CHECK(cache.Open(path.c_str(), key));
+
+    // Any change of the source or of the settings the tiles were built with
+    ChunkCache::Key other;
+    ChunkCache::MakeKey(124, 456, 789, 1, false, 0, other);
+    CHECK(!cache.Open(path.c_str(), other));
+    CHECK(!cache.IsOpen());
+    ChunkCache::MakeKey(123, 457, 789, 1, false, 0, other);
+    CHECK(!cache.Open(path.c_str(), other));
+    ChunkCache::MakeKey(123, 456, 790, 1, false, 0, other);
+    CHECK(!cache.Open(path.c_str(), other));
+    ChunkCache::MakeKey(123, 456, 789, 2, false, 0, other);
+    CHECK(!cache.Open(path.c_str(), other));
+    ChunkCache::MakeKey(123, 456, 789, 1, true, 0, other);
+    CHECK(!cache.Open(path.c_str(), other));
+    ChunkCache::MakeKey(123, 456, 789, 1, false, 16, other);
+    CHECK(!cache.Open(path.c_str(), other));
+    CHECK(cache.Open(path.c_str(), key));
+    cache.Close();
+    std::filesystem::remove(path);
+}
+
+static void TestComputeKeyFollowsContent()
+{
+    const std::string txd = TempPath("radar_cache_key.txd");
+    auto writeTxd = [&](char fill) { std::ofstream(txd, std::ios::binary) << std::string(4096, fill); };
+
+    writeTxd('a');
+    const auto firstWrite = std::filesystem::last_write_time(txd);
+    ChunkCache::Key first, second;
+    CHECK(ChunkCache::ComputeKey(txd.c_str(), 2, false, 0, first));
+    CHECK(ChunkCache::ComputeKey(txd.c_str(), 2, false, 0, second));
+    CHECK(memcmp(&first, &second, sizeof(first)) == 0);
+
+    // Same size, same write time, other bytes: only the hash tells
+    writeTxd('b');
+    std::filesystem::last_write_time(txd, firstWrite);
+    CHECK(ChunkCache::ComputeKey(txd.c_str(), 2, false, 0, second));
+    CHECK_EQ(second.txdSize, first.txdSize);
+    CHECK_EQ(second.txdMtime, first.txdMtime);
+    CHECK(second.txdHash != first.txdHash);
+
+    std::filesystem::last_write_time(txd, std::filesystem::last_write_time(txd) + std::chrono::hours(1));
+    ChunkCache::Key later;
+    CHECK(ChunkCache::ComputeKey(txd.c_str(), 2, false, 0, later));
+    CHECK(later.txdMtime != second.txdMtime);
+    CHECK_EQ(later.txdHash, second.txdHash);
+
+    CHECK(!ChunkCache::ComputeKey(TempPath("radar_cache_missing.txd").c_str(), 2, false, 0, later));
+    std::filesystem::remove(txd);
+}
+
+static void TestTornFileRejected()
+{
+    const std::string path = TempPath("radar_cache_torn.cache");
+    ChunkCache::Key key;
+    ChunkCache::MakeKey(1, 2, 3, 1, false, 0, key);
+    CHECK(WriteCache(path, key));
+    const uintmax_t fullSize = std::filesystem::file_size(path);
+    ChunkCache cache;
+
+    // Entry table cut short
+    std::filesystem::resize_file(path, fullSize - 1);
+    CHECK(!cache.Open(path.c_str(), key));
+    // Table intact but a payload points past the end
+    CHECK(WriteCache(path, key));
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        ChunkCache::Header header;
+        file.read((char*)&header, sizeof(header));
+        ChunkCache::Entry entry;
+        file.seekg((std::streamoff)header.tableOffset);
+        file.read((char*)&entry, sizeof(entry));
+        entry.offset = fullSize;
+        file.seekp((std::streamoff)header.tableOffset);
+        file.write((const char*)&entry, sizeof(entry));
+    }
+    CHECK(!cache.Open(path.c_str(), key));
+    // Header only
+    CHECK(WriteCache(path, key));
+    std::filesystem::resize_file(path, sizeof(ChunkCache::Header));
+    CHECK(!cache.Open(path.c_str(), key));
+    std::filesystem::resize_file(path, 3);
+    CHECK(!cache.Open(path.c_str(), key));
+    std::filesystem::remove(path);
+}
+
+static void TestUnfinishedBuildKeepsOldCache()
+{
+    const std::string path = TempPath("radar_cache_unfinished.cache");
+    ChunkCache::Key oldKey, newKey;
+    ChunkCache::MakeKey(1, 2, 3, 1, false, 0, oldKey);
+    ChunkCache::MakeKey(1, 2, 4, 1, false, 0, newKey);
+    CHECK(WriteCache(path, oldKey));
+
+    // Interrupted (game closed mid-build): the magic is never written, the old file is left alone
+    {
+        const int levelTiles[2] = { 4, 1 };
+        ChunkCacheWriter writer;
+        CHECK(writer.Begin(path.c_str(), newKey, levelTiles, 2));
+        writer.Write(0, 0, MakeTile(256, 0));
+        writer.Write(0, 1, MakeTile(256, 1));
+        CHECK(writer.IsActive());
+        CHECK(std::filesystem::exists(path + ".tmp"));
+    }
+    CHECK(!std::filesystem::exists(path + ".tmp"));
+
+    ChunkCache cache;
+    CHECK(!cache.Open(path.c_str(), newKey));
+    CHECK(cache.Open(path.c_str(), oldKey));
+    cache.Close();
+
+    // A temp file left by a crash never validates: its header is still the zero placeholder
+    std::filesystem::copy_file(path, path + ".tmp");
+    {
+        std::fstream file(path + ".tmp", std::ios::in | std::ios::out | std::ios::binary);
+        const ChunkCache::Header placeholder = {};
+        file.write((const char*)&placeholder, sizeof(placeholder));
+    }
+    CHECK(!cache.Open((path + ".tmp").c_str(), oldKey));
+    std::filesystem::remove(path + ".tmp");
+    std::filesystem::remove(path);
+}
+
+int main()
+{
+    RUN_TEST(TestPerTileViews);
+    RUN_TEST(TestViewBounds);
+    RUN_TEST(TestKeyInvalidation);
+    RUN_TEST(TestComputeKeyFollowsContent);
+    RUN_TEST(TestTornFileRejected);
+    RUN_TEST(TestUnfinishedBuildKeepsOldCache);
+    return TEST_RESULT();
+}
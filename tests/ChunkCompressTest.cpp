@@ -0,0 +1,250 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        tests/ChunkCompressTest.cpp
+ *****************************************************************************/
+
+#include "TestCheck.h"
+#include "ChunkCompress.h"
+#include "ChunkMipChain.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+static uint32_t s_seed = 12345;
+
+static int Random(int range)
+{
+    s_seed = s_seed * 1664525u + 1013904223u;
+    return (int)((s_seed >> 8) % (uint32_t)range);
+}
+
+// 565 endpoint as the decoder expands it
+static int Quantize(int value, int bits)
+{
+    const int q = value >> (8 - bits);
+    return (q << (8 - bits)) | (q >> (2 * bits - 8));
+}
+
+static ChunkPixels MakeTile(int size, int kind)
+{
+    ChunkPixels pixels = {};
+    pixels.width = size;
+    pixels.height = size;
+    pixels.pitch = size * 4;
+    pixels.levels = 1;
+    pixels.format = CHUNK_FORMAT_BGRA8;
+    pixels.data.resize((size_t)size * size * 4);
+    for (int y = 0; y < size; ++y)
+    {
+        for (int x = 0; x < size; ++x)
+        {
+            uint8_t* t = &pixels.data[((size_t)y * size + x) * 4];
+            if (kind == 0)
+            {
+                // Linear gradient
+                t[0] = (uint8_t)(x * 255 / size);
+                t[1] = (uint8_t)(y * 255 / size);
+                t[2] = (uint8_t)((x + y) * 255 / (2 * size));
+                t[3] = 255;
+            }
+            else
+            {
+                // Smooth terrain-like shading, alpha fading out towards the bottom for kind 2
+                const float v = 0.5f + 0.25f * sinf(x * 0.05f) * cosf(y * 0.07f) + 0.25f * sinf((x + y) * 0.011f);
+                t[0] = (uint8_t)(60 + v * 120);
+                t[1] = (uint8_t)(80 + v * 140);
+                t[2] = (uint8_t)(40 + v * 100);
+                t[3] = (kind == 2) ? (uint8_t)(255 - y * 255 / size) : 255;
+            }
+        }
+    }
+    return pixels;
+}
+
+static void TestSolidBlocksExact()
+{
+    uint8_t block[64], encoded[16], decoded[64];
+    for (int i = 0; i < 2000; ++i)
+    {
+        const int b = Random(256), g = Random(256), r = Random(256), a = Random(256);
+        for (int t = 0; t < 16; ++t)
+        {
+            block[t * 4 + 0] = (uint8_t)b;
+            block[t * 4 + 1] = (uint8_t)g;
+            block[t * 4 + 2] = (uint8_t)r;
+            block[t * 4 + 3] = (uint8_t)a;
+        }
+
+        // Both endpoints are the colour itself: only 565 quantization is left, alpha is exact
+        bool exact = true;
+        ChunkCompress::EncodeBlockDXT5(block, encoded);
+        ChunkCompress::DecodeBlock(encoded, CHUNK_FORMAT_DXT5, decoded);
+        for (int t = 0; t < 16; ++t)
+            exact = exact && decoded[t * 4 + 0] == Quantize(b, 5) && decoded[t * 4 + 1] == Quantize(g, 6) &&
+                    decoded[t * 4 + 2] == Quantize(r, 5) && decoded[t * 4 + 3] == a;
+
+        ChunkCompress::EncodeBlockDXT1(block, encoded);
+        ChunkCompress::DecodeBlock(encoded, CHUNK_FORMAT_DXT1, decoded);
+        for (int t = 0; t < 16; ++t)
+            exact = exact && decoded[t * 4 + 0] == Quantize(b, 5) && decoded[t * 4 + 1] == Quantize(g, 6) &&
+                    decoded[t * 4 + 2] == Quantize(r, 5) && decoded[t * 4 + 3] == 255;
+        if (!CHECK(exact))
+            break;
+    }
+}
+
+// Texels on a line whose green changes: per channel within a sixth of the block range (palette spacing / 2)
+// plus 565 quantization and the endpoint inset
+static void TestLineBlockErrorBound()
+{
+    uint8_t block[64], encoded[8], decoded[64];
+    int worstExcess = -255;
+    for (int i = 0; i < 20000; ++i)
+    {
+        int from[3], to[3];
+        for (int c = 0; c < 3; ++c)
+        {
+            from[c] = Random(256);
+            to[c] = Random(256);
+        }
+        if (abs(to[1] - from[1]) < 32)
+            continue;
+        for (int t = 0; t < 16; ++t)
+        {
+            const float f = Random(1000) / 999.0f;
+            for (int c = 0; c < 3; ++c)
+                block[t * 4 + c] = (uint8_t)lrintf(from[c] + (to[c] - from[c]) * f);
+            block[t * 4 + 3] = 255;
+        }
+        ChunkCompress::EncodeBlockDXT1(block, encoded);
+        ChunkCompress::DecodeBlock(encoded, CHUNK_FORMAT_DXT1, decoded);
+
+        for (int c = 0; c < 3; ++c)
+        {
+            int lo = 255, hi = 0;
+            for (int t = 0; t < 16; ++t)
+            {
+                lo = std::min(lo, (int)block[t * 4 + c]);
+                hi = std::max(hi, (int)block[t * 4 + c]);
+            }
+            for (int t = 0; t < 16; ++t)
+                worstExcess = std::max(worstExcess, abs(block[t * 4 + c] - decoded[t * 4 + c]) * 6 - (hi - lo));
+        }
+    }
+    // |error| <= range / 6 + 8
+    CHECK(worstExcess <= 48);
+}
+
+// Eight-value alpha between the exact block min / max: within half a step (range / 14) plus decoder rounding
+static void TestAlphaErrorBound()
+{
+    uint8_t block[64], encoded[16], decoded[64];
+    bool bounded = true;
+    for (int i = 0; i < 20000 && bounded; ++i)
+    {
+        const int lo = Random(256);
+        const int hi = lo + Random(256 - lo);
+        for (int t = 0; t < 16; ++t)
+        {
+            block[t * 4 + 0] = block[t * 4 + 1] = block[t * 4 + 2] = 128;
+            block[t * 4 + 3] = (uint8_t)(lo + Random(hi - lo + 1));
+        }
+        ChunkCompress::EncodeBlockDXT5(block, encoded);
+        ChunkCompress::DecodeBlock(encoded, CHUNK_FORMAT_DXT5, decoded);
+        for (int t = 0; t < 16; ++t)
+            bounded = bounded && abs(block[t * 4 + 3] - decoded[t * 4 + 3]) * 14 <= (hi - lo) + 14;
+    }
+    CHECK(bounded);
+}
+
+static double PsnrFromDecompress(const ChunkPixels& source, const ChunkPixels& encoded)
+{
+    ChunkPixels decoded = {};
+    if (!ChunkCompress::Decompress(encoded.data.data(), encoded.data.size(), encoded.format, source.width, source.height, decoded))
+        return -1.0;
+    const int channels = (encoded.format == CHUNK_FORMAT_DXT5) ? 4 : 3;
+    double sum = 0.0;
+    for (size_t i = 0; i < (size_t)source.width * source.height; ++i)
+        for (int c = 0; c < channels; ++c)
+        {
+            const double d = (double)source.data[i * 4 + c] - decoded.data[i * 4 + c];
+            sum += d * d;
+        }
+    const double mse = sum / ((double)source.width * source.height * channels);
+    return mse == 0.0 ? 99.0 : 10.0 * log10(255.0 * 255.0 / mse);
+}
+
+static void TestTilePsnr()
+{
+    // Minimum level 0 PSNR (dB) per kind of tile content
+    const struct { int kind; ChunkFormat format; float minPsnr; } cases[] = {
+        { 0, CHUNK_FORMAT_DXT1, 38.0f },
+        { 1, CHUNK_FORMAT_DXT1, 40.0f },
+        { 2, CHUNK_FORMAT_DXT5, 40.0f },
+    };
+    for (const auto& test : cases)
+    {
+        const ChunkPixels source = MakeTile(256, test.kind);
+        ChunkPixels encoded = source;
+        CHECK(ChunkCompress::Compress(encoded));
+        CHECK_EQ(encoded.format, test.format);
+        const float psnr = ChunkCompress::ComputePsnr(source.data.data(), 256, 256, source.pitch, encoded.data.data(), encoded.format);
+        if (!CHECK(psnr >= test.minPsnr))
+            fprintf(stderr, "    kind %d: %.2f dB\n", test.kind, psnr);
+        CHECK_NEAR(psnr, PsnrFromDecompress(source, encoded), 0.01);
+    }
+}
+
+static void TestCompressLayout()
+{
+    ChunkPixels opaque = MakeTile(64, 1);
+    CHECK(ChunkMipChain::Build(opaque));
+    const std::vector<uint8_t> chain = opaque.data;
+    CHECK(ChunkCompress::Compress(opaque));
+    CHECK_EQ(opaque.format, CHUNK_FORMAT_DXT1);
+    CHECK_EQ(opaque.levels, 7);
+    CHECK_EQ(opaque.pitch, 16 * 8);
+    CHECK_EQ(opaque.data.size(), ChunkMipChain::ChainSize(64, 64, 7, CHUNK_FORMAT_DXT1));
+
+    // 2x2 and 1x1 levels are encoded from repeated edge texels
+    for (int level = 5; level < 7; ++level)
+    {
+        const int size = ChunkMipChain::LevelWidth(64, level);
+        ChunkPixels decoded = {};
+        const uint8_t* blocks = opaque.data.data() + ChunkMipChain::LevelOffset(64, 64, level, CHUNK_FORMAT_DXT1);
+        CHECK(ChunkCompress::Decompress(blocks, 8, CHUNK_FORMAT_DXT1, size, size, decoded));
+        const uint8_t* src = chain.data() + ChunkMipChain::LevelOffset(64, 64, level);
+        bool close = true;
+        for (int i = 0; i < size * size * 4; ++i)
+            close = close && abs(src[i] - decoded.data[i]) <= 8;
+        CHECK(close);
+    }
+
+    ChunkPixels translucent = MakeTile(64, 1);
+    translucent.data[4 * 100 + 3] = 254;
+    CHECK(ChunkCompress::Compress(translucent));
+    CHECK_EQ(translucent.format, CHUNK_FORMAT_DXT5);
+    CHECK_EQ(translucent.data.size(), ChunkMipChain::ChainSize(64, 64, 1, CHUNK_FORMAT_DXT5));
+
+    // Not a multiple of 4, or compressed already: left untouched
+    ChunkPixels odd = MakeTile(6, 1);
+    const std::vector<uint8_t> oddData = odd.data;
+    CHECK(!ChunkCompress::Compress(odd));
+    CHECK(odd.format == CHUNK_FORMAT_BGRA8 && odd.data == oddData);
+    CHECK(!ChunkCompress::Compress(opaque));
+
+    ChunkPixels out = {};
+    CHECK(!ChunkCompress::Decompress(opaque.data.data(), 16 * 16 * 8 - 1, CHUNK_FORMAT_DXT1, 64, 64, out));
+}
+
+int main()
+{
+    RUN_TEST(TestSolidBlocksExact);
+    RUN_TEST(TestLineBlockErrorBound);
+    RUN_TEST(TestAlphaErrorBound);
+    RUN_TEST(TestTilePsnr);
+    RUN_TEST(TestCompressLayout);
+    return TEST_RESULT();
+}
@@ -0,0 +1,118 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        tests/ChunkDecodeQueueTest.cpp
+ *****************************************************************************/
+
+#include "TestCheck.h"
+#include "ChunkDecodeQueue.h"
+#include <atomic>
+#include <vector>
+
+// Chunk i: i % 10 == 0 fails to decode, i % 10 == 3 is a stale completion, i % 10 == 7 fails to upload
+class FakeUploader : public IChunkUploader
+{
+public:
+    std::vector<int> uploaded;
+    std::vector<int> failed;
+    int              dropped = 0;
+
+    ChunkUploadResult Upload(int index, const ChunkPixels& pixels) override
+    {
+        CHECK_EQ(pixels.width, index);
+        if (index % 10 == 3)
+        {
+            ++dropped;
+            return CHUNK_DROPPED;
+        }
+        if (index % 10 == 7)
+            return CHUNK_FAILED;
+        uploaded.push_back(index);
+        return CHUNK_UPLOADED;
+    }
+
+    void OnDecodeFailed(int index) override { failed.push_back(index); }
+};
+
+static void SubmitJobs(ChunkDecodeQueue& queue, int count, std::atomic<int>& released)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        const bool submitted = queue.Submit(i, [i](ChunkPixels& out) {
+            out.width = i;
+            out.data.resize(4096);
+            return i % 10 != 0;
+        }, [&released] { ++released; });
+        CHECK(submitted);
+    }
+}
+
+static void TestEveryJobEndsOnce()
+{
+    ChunkDecodeQueue queue;
+    CHECK(queue.Start(3));
+    std::atomic<int> released(0);
+    SubmitJobs(queue, 100, released);
+    queue.WaitIdle();
+
+    FakeUploader uploader;
+    while (queue.DrainUploads(uploader, 0, 0) > 0)
+    {
+    }
+
+    // 10 decode failures + 10 upload failures; stale completions are neither uploaded nor failed
+    CHECK_EQ((int)uploader.uploaded.size(), 70);
+    CHECK_EQ((int)uploader.failed.size(), 20);
+    CHECK_EQ(uploader.dropped, 10);
+    CHECK_EQ(released.load(), 100);
+    const ChunkDecodeQueue::Stats stats = queue.GetStats();
+    CHECK_EQ(stats.uploadedTotal, 70);
+    CHECK_EQ(stats.failedTotal, 20);
+    CHECK_EQ(queue.GetInFlightCount(), 0);
+    for (int index : uploader.failed)
+        CHECK(index % 10 == 0 || index % 10 == 7);
+}
+
+static void TestDrainBudget()
+{
+    ChunkDecodeQueue queue;
+    CHECK(queue.Start(2));
+    std::atomic<int> released(0);
+    SubmitJobs(queue, 25, released);
+    queue.WaitIdle();
+
+    // At most maxUploads per call; a time budget of 1 us still lets one job through
+    FakeUploader uploader;
+    CHECK_EQ(queue.DrainUploads(uploader, 4, 0), 4);
+    CHECK_EQ(queue.GetStats().lastDrainUploads, 4);
+    CHECK(queue.DrainUploads(uploader, 0, 1) >= 1);
+
+    int calls = 0;
+    while (queue.DrainUploads(uploader, 4, 0) > 0)
+        ++calls;
+    CHECK(calls >= 4);
+    CHECK_EQ(released.load(), 25);
+}
+
+static void TestStopReleasesPendingJobs()
+{
+    std::atomic<int> released(0);
+    {
+        ChunkDecodeQueue queue;
+        CHECK(queue.Start(1));
+        SubmitJobs(queue, 50, released);
+        queue.Stop();
+        CHECK(!queue.IsRunning());
+        CHECK_EQ(queue.GetInFlightCount(), 0);
+        // Not running: the caller decodes inline instead
+        CHECK(!queue.Submit(0, [](ChunkPixels&) { return true; }, [] {}));
+    }
+    CHECK_EQ(released.load(), 50);
+}
+
+int main()
+{
+    RUN_TEST(TestEveryJobEndsOnce);
+    RUN_TEST(TestDrainBudget);
+    RUN_TEST(TestStopReleasesPendingJobs);
+    return TEST_RESULT();
+}
@@ -0,0 +1,117 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        tests/ChunkGridTest.cpp
+ *****************************************************************************/
+
+#include "TestCheck.h"
+#include "ChunkGrid.h"
+#include <cstdint>
+#include <vector>
+
+static uint32_t s_seed = 77;
+
+static float RandomFloat(float lo, float hi)
+{
+    s_seed = s_seed * 1664525u + 1013904223u;
+    return lo + (hi - lo) * (float)(s_seed >> 8) / 16777216.0f;
+}
+
+// Tiles ForEachChunkInRadius visits, in visiting order: every tile with its center within radius
+static std::vector<int> ScanAll(const ChunkGrid& grid, float x, float y, float radius)
+{
+    std::vector<int> tiles;
+    for (int row = 0; row < grid.size; ++row)
+        for (int col = 0; col < grid.size; ++col)
+        {
+            float cx, cy;
+            grid.GetTileCenter(row, col, cx, cy);
+            if ((cx - x) * (cx - x) + (cy - y) * (cy - y) <= radius * radius)
+                tiles.push_back(row * grid.size + col);
+        }
+    return tiles;
+}
+
+static std::vector<int> ScanRange(const ChunkGrid& grid, float x, float y, float radius)
+{
+    std::vector<int> tiles;
+    int rowMin, rowMax, colMin, colMax;
+    if (!grid.GetRangeInRadius(x, y, radius, rowMin, rowMax, colMin, colMax))
+        return tiles;
+    for (int row = rowMin; row <= rowMax; ++row)
+        for (int col = colMin; col <= colMax; ++col)
+        {
+            float cx, cy;
+            grid.GetTileCenter(row, col, cx, cy);
+            if ((cx - x) * (cx - x) + (cy - y) * (cy - y) <= radius * radius)
+                tiles.push_back(row * grid.size + col);
+        }
+    return tiles;
+}
+
+// Range walk gives the full scan's tiles in the same order, for the LOD grids and larger custom maps,
+// cameras on and off the map
+static void TestRadiusRangeMatchesScan()
+{
+    const int sizes[] = { 3, 6, 12, 48, 96 };
+    for (int size : sizes)
+    {
+        const ChunkGrid grid = { -3000.0f, 3000.0f, 6000.0f, 6000.0f, size };
+        for (int i = 0; i < 3000; ++i)
+        {
+            const float x = RandomFloat(-4000.0f, 4000.0f), y = RandomFloat(-4000.0f, 4000.0f);
+            const float radius = RandomFloat(0.0f, 3500.0f);
+            if (!CHECK(ScanRange(grid, x, y, radius) == ScanAll(grid, x, y, radius)))
+            {
+                fprintf(stderr, "    grid %d at %.3f, %.3f radius %.3f\n", size, x, y, radius);
+                return;
+            }
+        }
+    }
+
+    // Radius exactly reaching the two neighbouring tile centers: the tile and both neighbours, not the diagonal
+    const ChunkGrid grid = { -3000.0f, 3000.0f, 6000.0f, 6000.0f, 12 };
+    CHECK(ScanRange(grid, -2750.0f, 2750.0f, 500.0f) == ScanAll(grid, -2750.0f, 2750.0f, 500.0f));
+    CHECK_EQ(ScanRange(grid, -2750.0f, 2750.0f, 500.0f).size(), 3u);
+}
+
+static void TestRectRange()
+{
+    const ChunkGrid grid = { -3000.0f, 3000.0f, 6000.0f, 6000.0f, 12 };
+    for (int i = 0; i < 5000; ++i)
+    {
+        float minX = RandomFloat(-3500.0f, 3500.0f), minY = RandomFloat(-3500.0f, 3500.0f);
+        const float maxX = minX + RandomFloat(0.0f, 3000.0f), maxY = minY + RandomFloat(0.0f, 3000.0f);
+
+        int rowMin = 0, rowMax = -1, colMin = 0, colMax = -1;
+        grid.GetRangeInRect(minX, minY, maxX, maxY, rowMin, rowMax, colMin, colMax);
+        bool same = true;
+        for (int row = 0; row < 12; ++row)
+            for (int col = 0; col < 12; ++col)
+            {
+                const float tileMinX = -3000.0f + col * 500.0f, tileMaxY = 3000.0f - row * 500.0f;
+                const bool overlaps = tileMinX <= maxX && tileMinX + 500.0f >= minX && tileMaxY - 500.0f <= maxY && tileMaxY >= minY;
+                const bool inRange = row >= rowMin && row <= rowMax && col >= colMin && col <= colMax;
+                same = same && overlaps == inRange;
+            }
+        if (!CHECK(same))
+            return;
+    }
+}
+
+static void TestEmpty()
+{
+    int rowMin, rowMax, colMin, colMax;
+    const ChunkGrid grid = { -3000.0f, 3000.0f, 6000.0f, 6000.0f, 12 };
+    CHECK(!grid.GetRangeInRadius(5000.0f, 0.0f, 1000.0f, rowMin, rowMax, colMin, colMax));
+    CHECK(!grid.GetRangeInRect(-5000.0f, -5000.0f, -4000.0f, -4000.0f, rowMin, rowMax, colMin, colMax));
+    const ChunkGrid none = { -3000.0f, 3000.0f, 6000.0f, 6000.0f, 0 };
+    CHECK(!none.GetRangeInRadius(0.0f, 0.0f, 1000.0f, rowMin, rowMax, colMin, colMax));
+}
+
+int main()
+{
+    RUN_TEST(TestRadiusRangeMatchesScan);
+    RUN_TEST(TestRectRange);
+    RUN_TEST(TestEmpty);
+    return TEST_RESULT();
+}
@@ -0,0 +1,160 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        tests/ChunkMipChainTest.cpp
+ *****************************************************************************/
+
+#include "TestCheck.h"
+#include "ChunkMipChain.h"
+#include <cstring>
+#include <vector>
+
+static ChunkPixels MakeTile(int w, int h, uint32_t seed)
+{
+    ChunkPixels pixels = {};
+    pixels.width = w;
+    pixels.height = h;
+    pixels.pitch = w * 4;
+    pixels.levels = 1;
+    pixels.format = CHUNK_FORMAT_BGRA8;
+    pixels.data.resize((size_t)w * h * 4);
+    for (size_t i = 0; i < pixels.data.size(); ++i)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        pixels.data[i] = (uint8_t)(seed >> 24);
+    }
+    return pixels;
+}
+
+// Reference 2x2 box filter: rounded mean, edge texels clamped on odd sizes
+static std::vector<uint8_t> ReferenceLevel(const std::vector<uint8_t>& src, int srcW, int srcH)
+{
+    const int dstW = (srcW > 1) ? srcW / 2 : 1;
+    const int dstH = (srcH > 1) ? srcH / 2 : 1;
+    std::vector<uint8_t> dst((size_t)dstW * dstH * 4);
+    auto at = [&](int x, int y, int c) {
+        x = (x < srcW) ? x : srcW - 1;
+        y = (y < srcH) ? y : srcH - 1;
+        return (int)src[((size_t)y * srcW + x) * 4 + c];
+    };
+    for (int y = 0; y < dstH; ++y)
+        for (int x = 0; x < dstW; ++x)
+            for (int c = 0; c < 4; ++c)
+            {
+                const int sum = at(2 * x, 2 * y, c) + at(2 * x + 1, 2 * y, c) + at(2 * x, 2 * y + 1, c) + at(2 * x + 1, 2 * y + 1, c);
+                dst[((size_t)y * dstW + x) * 4 + c] = (uint8_t)((sum + 2) >> 2);
+            }
+    return dst;
+}
+
+static void CheckChainMatchesReference(int w, int h)
+{
+    ChunkPixels pixels = MakeTile(w, h, (uint32_t)(w * 31 + h));
+    CHECK(ChunkMipChain::Build(pixels));
+    CHECK_EQ(pixels.levels, ChunkMipChain::CountLevels(w, h));
+    CHECK_EQ(pixels.data.size(), ChunkMipChain::ChainSize(w, h, pixels.levels));
+
+    std::vector<uint8_t> expected(pixels.data.begin(), pixels.data.begin() + ChunkMipChain::LevelSize(w, h, 0));
+    for (int level = 1; level < pixels.levels; ++level)
+    {
+        expected = ReferenceLevel(expected, ChunkMipChain::LevelWidth(w, level - 1), ChunkMipChain::LevelHeight(h, level - 1));
+        CHECK_EQ(expected.size(), ChunkMipChain::LevelSize(w, h, level));
+        const uint8_t* actual = pixels.data.data() + ChunkMipChain::LevelOffset(w, h, level);
+        if (!CHECK(memcmp(actual, expected.data(), expected.size()) == 0))
+            fprintf(stderr, "    %dx%d level %d differs\n", w, h, level);
+    }
+}
+
+static void TestLayout()
+{
+    CHECK_EQ(ChunkMipChain::CountLevels(256, 256), 9);
+    CHECK_EQ(ChunkMipChain::CountLevels(256, 64), 9);
+    CHECK_EQ(ChunkMipChain::CountLevels(1, 1), 1);
+    CHECK_EQ(ChunkMipChain::LevelWidth(256, 3), 32);
+    CHECK_EQ(ChunkMipChain::LevelHeight(64, 8), 1);
+    CHECK_EQ(ChunkMipChain::ChainSize(4, 4, 3), (size_t)(16 + 4 + 1) * 4);
+    CHECK_EQ(ChunkMipChain::LevelOffset(256, 256, 1), (size_t)256 * 256 * 4);
+
+    // DXT sizes count 4x4 blocks, at least one per level
+    CHECK_EQ(ChunkMipChain::LevelSize(256, 256, 0, CHUNK_FORMAT_DXT1), (size_t)64 * 64 * 8);
+    CHECK_EQ(ChunkMipChain::LevelSize(256, 256, 8, CHUNK_FORMAT_DXT5), (size_t)16);
+    CHECK_EQ(ChunkMipChain::LevelRows(256, 7, CHUNK_FORMAT_DXT1), 1);
+}
+
+static void TestBoxFilterOutput()
+{
+    // Even sizes take the SSE2 path, with a scalar tail when the level is not a multiple of 4 wide
+    CheckChainMatchesReference(256, 256);
+    CheckChainMatchesReference(24, 8);
+    CheckChainMatchesReference(20, 12);
+    // Odd and thin sizes clamp the last row / column
+    CheckChainMatchesReference(7, 5);
+    CheckChainMatchesReference(33, 1);
+    CheckChainMatchesReference(1, 9);
+}
+
+static void TestSolidTileStaysSolid()
+{
+    ChunkPixels pixels = MakeTile(64, 64, 1);
+    for (size_t i = 0; i < pixels.data.size(); i += 4)
+    {
+        pixels.data[i + 0] = 0x12;
+        pixels.data[i + 1] = 0x80;
+        pixels.data[i + 2] = 0xFE;
+        pixels.data[i + 3] = 0xFF;
+    }
+    CHECK(ChunkMipChain::Build(pixels));
+    bool solid = true;
+    for (size_t i = 0; i < pixels.data.size(); i += 4)
+        solid = solid && pixels.data[i] == 0x12 && pixels.data[i + 1] == 0x80 && pixels.data[i + 2] == 0xFE && pixels.data[i + 3] == 0xFF;
+    CHECK(solid);
+}
+
+static void TestMaxLevelsAndRejects()
+{
+    ChunkPixels pixels = MakeTile(128, 128, 2);
+    CHECK(ChunkMipChain::Build(pixels, 4));
+    CHECK_EQ(pixels.levels, 4);
+    CHECK_EQ(pixels.data.size(), ChunkMipChain::ChainSize(128, 128, 4));
+
+    // Padded rows and compressed payloads are not accepted
+    ChunkPixels padded = MakeTile(16, 16, 3);
+    padded.pitch = 80;
+    CHECK(!ChunkMipChain::Build(padded));
+    ChunkPixels dxt = MakeTile(16, 16, 4);
+    dxt.format = CHUNK_FORMAT_DXT1;
+    CHECK(!ChunkMipChain::Build(dxt));
+}
+
+static void TestCellGutter()
+{
+    const int w = 16, h = 8, gutter = 3;
+    const ChunkPixels tile = MakeTile(w, h, 5);
+    ChunkPixels cell = {};
+    CHECK(ChunkMipChain::BuildCell(tile, gutter, 2, cell));
+    CHECK_EQ(cell.width, w + 2 * gutter);
+    CHECK_EQ(cell.height, h + 2 * gutter);
+    CHECK_EQ(cell.gutter, gutter);
+    CHECK_EQ(cell.levels, 2);
+
+    // Every cell texel is the nearest tile texel: the tile inside, its edge replicated outwards
+    bool same = true;
+    for (int y = 0; y < cell.height; ++y)
+        for (int x = 0; x < cell.width; ++x)
+        {
+            int tx = x - gutter, ty = y - gutter;
+            tx = (tx < 0) ? 0 : (tx >= w ? w - 1 : tx);
+            ty = (ty < 0) ? 0 : (ty >= h ? h - 1 : ty);
+            same = same && memcmp(&cell.data[((size_t)y * cell.width + x) * 4], &tile.data[((size_t)ty * w + tx) * 4], 4) == 0;
+        }
+    CHECK(same);
+}
+
+int main()
+{
+    RUN_TEST(TestLayout);
+    RUN_TEST(TestBoxFilterOutput);
+    RUN_TEST(TestSolidTileStaysSolid);
+    RUN_TEST(TestMaxLevelsAndRejects);
+    RUN_TEST(TestCellGutter);
+    return TEST_RESULT();
+}
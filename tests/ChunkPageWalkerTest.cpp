@@ -0,0 +1,341 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        tests/ChunkPageWalkerTest.cpp
+ *****************************************************************************/
+
+#include "TestCheck.h"
+#include "ChunkPageWalker.h"
+#include "RadarGeometry.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+static const float MAP_LEFT = -3000.0f;
+static const float MAP_TOP = 3000.0f;
+static const float MAP_SIZE = 6000.0f;
+static const float SCREEN = 1024.0f;
+static const int   TILE_TEXELS = 256;
+
+static ChunkTextureId TextureOf(int level, int index)
+{
+    return ((ChunkTextureId)level << 24 | (ChunkTextureId)index) + 1;
+}
+
+// Pyramid levels 1..MAX_LEVELS complete, level 0 chunks resident as the replay streams them
+class TestPageSource : public IChunkPageSource
+{
+public:
+    explicit TestPageSource(int gridSize)
+        : m_gridSize(gridSize)
+        , m_resident(gridSize * gridSize, false)
+        , m_unavailable(gridSize * gridSize, false)
+        , m_backgroundTile(-2)
+    {
+    }
+
+    bool IsLevelComplete(int level) const override { return level >= 1 && level <= ChunkPyramid::MAX_LEVELS; }
+    ChunkPage GetPage(int level, int index) const override
+    {
+        const ChunkPage page = { (level > 0 || m_resident[index]) ? TextureOf(level, index) : 0, { 0.0f, 0.0f, 1.0f, 1.0f },
+                                 (level > 0 || m_resident[index]) ? index : -1 };
+        return page;
+    }
+    bool IsChunkUnavailable(int index) const override { return m_unavailable[index]; }
+    bool IsBackgroundTile(int tileId) const override { return tileId == m_backgroundTile; }
+    void OnChunkMissing(int index, float distSq) override
+    {
+        m_missing.push_back(index);
+        m_missingDistSq.push_back(distSq);
+    }
+    void OnChunkDrawn(int index) override { m_drawn.push_back(index); }
+
+    int                m_gridSize;
+    std::vector<bool>  m_resident;
+    std::vector<bool>  m_unavailable;
+    int                m_backgroundTile;
+    std::vector<int>   m_missing;
+    std::vector<float> m_missingDistSq;
+    std::vector<int>   m_drawn;
+};
+
+struct TestCamera
+{
+    D3DXVECTOR3 pos;
+    D3DXVECTOR3 rot;
+    float       fov;
+};
+
+// Drive, climb for a flight and hold still at the end (as in RadarFootprintTest)
+static TestCamera PathCamera(int frame)
+{
+    const float t = (float)(std::min)(frame, 900) * 0.01f;
+    TestCamera camera;
+    const float yaw = t * 1.3f;
+    camera.pos = D3DXVECTOR3(2400.0f * sinf(t * 0.7f), 2400.0f * sinf(t * 0.45f + 1.0f),
+                             445.0f + 1500.0f * (std::max)(0.0f, sinf(t * 0.6f)));
+    camera.rot = D3DXVECTOR3(-(26.0f + 50.0f * (std::max)(0.0f, sinf(t * 0.17f + 2.0f))) * D3DX_PI / 180.0f, 0.0f, -yaw);
+    camera.fov = 70.0f * D3DX_PI / 180.0f;
+    return camera;
+}
+
+static ChunkPageWalker::View MakeView(const TestCamera& camera, int gridSize, RadarFootprint& footprint)
+{
+    RadarProjection projection;
+    projection.Build(camera.pos, camera.rot, camera.fov, 0.3f, 10000.0f, SCREEN, SCREEN, 1080.0f / 1920.0f);
+    ChunkPageWalker::View view;
+    view.cameraX = camera.pos.x;
+    view.cameraY = camera.pos.y;
+    view.cameraZ = camera.pos.z;
+    view.visibleRadius = camera.pos.z * 3.0f;
+    view.pixelSizePerDistance = 2.0f * tanf(camera.fov * 0.5f) / SCREEN;
+    view.texelSize = MAP_SIZE / gridSize / TILE_TEXELS;
+    view.maxLevel = ChunkPyramid::MAX_LEVELS;
+    view.footprint = RadarGeometry::BuildFootprint(projection, 0.0f, 1.0f, footprint) ? &footprint : nullptr;
+    return view;
+}
+
+// The walk's level choice, restated: texels per pixel at the nearest point of the rect
+static int RequiredLevel(const ChunkPageWalker::View& view, float minX, float minY, float maxX, float maxY)
+{
+    const float dx = (std::max)((std::max)(minX - view.cameraX, view.cameraX - maxX), 0.0f);
+    const float dy = (std::max)((std::max)(minY - view.cameraY, view.cameraY - maxY), 0.0f);
+    const float texelsPerPixel = sqrtf(dx * dx + dy * dy + view.cameraZ * view.cameraZ) * view.pixelSizePerDistance / view.texelSize;
+    int level = 0;
+    while (level < view.maxLevel && texelsPerPixel >= (float)(2 << level))
+        ++level;
+    return level;
+}
+
+static bool Visible(const ChunkPageWalker::View& view, float minX, float minY, float maxX, float maxY)
+{
+    const float w = maxX - minX, h = maxY - minY;
+    const float dx = (minX + maxX) * 0.5f - view.cameraX, dy = (minY + maxY) * 0.5f - view.cameraY;
+    const float radius = view.visibleRadius + 0.5f * sqrtf(w * w + h * h);
+    return dx * dx + dy * dy <= radius * radius &&
+           (!view.footprint || RadarGeometry::FootprintOverlapsRect(*view.footprint, minX, minY, maxX, maxY));
+}
+
+struct TileRect
+{
+    float minX, minY, maxX, maxY;
+};
+
+static TileRect RectOf(int gridSize, int level, int index)
+{
+    const int grid = gridSize >> level;
+    const float size = MAP_SIZE / grid;
+    const int row = index / grid, col = index % grid;
+    const TileRect rect = { MAP_LEFT + col * size, MAP_TOP - (row + 1) * size, MAP_LEFT + (col + 1) * size, MAP_TOP - row * size };
+    return rect;
+}
+
+static void WalkAll(ChunkPageWalker& walker, TestPageSource& source, const ChunkPageWalker::View& view,
+                    std::vector<ChunkPageDraw>& outDraws)
+{
+    const int top = source.m_gridSize >> view.maxLevel;
+    source.m_missing.clear();
+    source.m_missingDistSq.clear();
+    source.m_drawn.clear();
+    outDraws.clear();
+    auto collect = [&outDraws](const ChunkPageDraw& draw) { outDraws.push_back(draw); };
+    walker.Walk(source, view, 0, top - 1, 0, top - 1, collect);
+}
+
+// Per frame of a camera path with part of level 0 resident:
+//  - every level 0 tile in view is drawn exactly once, by itself or an ancestor, unless it is unavailable
+//  - each draw is at the level its texels need, or level 0 from the parent's quarter when the chunk is missing
+//  - misses are the level 0 tiles in view that are not resident, reported once each
+static bool CheckFrame(int gridSize, const ChunkPageWalker& walker, const TestPageSource& source,
+                       const ChunkPageWalker::View& view, const std::vector<ChunkPageDraw>& draws)
+{
+    std::vector<int> covered(gridSize * gridSize, 0);
+    for (const ChunkPageDraw& draw : draws)
+    {
+        const TileRect rect = RectOf(gridSize, draw.level, draw.index);
+        if (!CHECK(fabsf(draw.centerX - (rect.minX + rect.maxX) * 0.5f) < 1e-3f) || !CHECK(draw.width == rect.maxX - rect.minX))
+            return false;
+        if (draw.level > 0 && !CHECK(RequiredLevel(view, rect.minX, rect.minY, rect.maxX, rect.maxY) >= draw.level))
+            return false;
+        if (draw.level < view.maxLevel)
+        {
+            const int grid = gridSize >> draw.level;
+            const int parent = (draw.index / grid / 2) * (grid / 2) + (draw.index % grid) / 2;
+            const TileRect up = RectOf(gridSize, draw.level + 1, parent);
+            if (!CHECK(RequiredLevel(view, up.minX, up.minY, up.maxX, up.maxY) <= draw.level))
+                return false;
+            if (draw.level == 0 && !source.m_resident[draw.index])
+            {
+                // Parent quarter: the walk only descends from a resident level 1 tile
+                const int col = draw.index % grid, row = draw.index / grid;
+                if (!CHECK(draw.texture == TextureOf(1, parent)) ||
+                    !CHECK(draw.region.u0 == 0.5f * (col & 1) && draw.region.v0 == 0.5f * (row & 1)) ||
+                    !CHECK(draw.region.u1 == draw.region.u0 + 0.5f && draw.region.v1 == draw.region.v0 + 0.5f))
+                    return false;
+            }
+            else if (!CHECK(draw.texture == TextureOf(draw.level, draw.index)))
+                return false;
+        }
+
+        const int span = 1 << draw.level;
+        const int grid = gridSize >> draw.level;
+        for (int r = 0; r < span; ++r)
+            for (int c = 0; c < span; ++c)
+                ++covered[((draw.index / grid) * span + r) * gridSize + (draw.index % grid) * span + c];
+    }
+
+    int expectedMisses = 0;
+    for (int index = 0; index < gridSize * gridSize; ++index)
+    {
+        const TileRect rect = RectOf(gridSize, 0, index);
+        if (covered[index] > 1 || (covered[index] == 0 && Visible(view, rect.minX, rect.minY, rect.maxX, rect.maxY) &&
+                                   !source.m_unavailable[index]))
+        {
+            fprintf(stderr, "    tile %d covered %d times\n", index, covered[index]);
+            return false;
+        }
+    }
+    for (const ChunkPageDraw& draw : draws)
+        expectedMisses += (draw.level == 0 && !source.m_resident[draw.index]) ? 1 : 0;
+    std::vector<int> missing = source.m_missing;
+    std::sort(missing.begin(), missing.end());
+    return CHECK(std::unique(missing.begin(), missing.end()) == missing.end()) &&
+           CHECK((int)source.m_missing.size() == expectedMisses) && CHECK(walker.GetPageMisses() == expectedMisses) &&
+           CHECK(walker.GetPagesDrawn() == (int)draws.size());
+}
+
+// Streaming after the walk as MapChunkManager does it: nearest misses first, a few per frame, least recently drawn
+// evicted over the budget
+static void StreamFrame(TestPageSource& source, std::vector<int>& lastDrawn, int frame, int perFrame, int budget)
+{
+    for (int index : source.m_drawn)
+        lastDrawn[index] = frame;
+    std::vector<std::pair<float, int>> requests;
+    for (size_t i = 0; i < source.m_missing.size(); ++i)
+        requests.push_back(std::make_pair(source.m_missingDistSq[i], source.m_missing[i]));
+    std::sort(requests.begin(), requests.end());
+    for (size_t i = 0; i < requests.size() && (int)i < perFrame; ++i)
+    {
+        source.m_resident[requests[i].second] = true;
+        lastDrawn[requests[i].second] = frame;
+    }
+
+    std::vector<std::pair<int, int>> resident;
+    for (int index = 0; index < source.m_gridSize * source.m_gridSize; ++index)
+        if (source.m_resident[index])
+            resident.push_back(std::make_pair(lastDrawn[index], index));
+    std::sort(resident.begin(), resident.end());
+    for (int i = 0; i + budget < (int)resident.size() && resident[i].first < frame; ++i)
+        source.m_resident[resident[i].second] = false;
+}
+
+static void TestCameraPathReplay()
+{
+    const int gridSizes[] = { 12, 48 };
+    for (int gridSize : gridSizes)
+    {
+        ChunkPageWalker walker;
+        walker.SetLayout(gridSize, MAP_LEFT, MAP_TOP, MAP_SIZE, MAP_SIZE);
+        TestPageSource source(gridSize);
+        for (int index = 7; index < gridSize * gridSize; index += 41)
+            source.m_unavailable[index] = true;
+        std::vector<int> lastDrawn(gridSize * gridSize, -1);
+        std::vector<ChunkPageDraw> draws;
+
+        long long residentSum = 0, missSum = 0, drawSum = 0;
+        int maxMisses = 0, lastMisses = -1;
+        const int frames = 1000;
+        for (int frame = 0; frame < frames; ++frame)
+        {
+            RadarFootprint footprint;
+            const ChunkPageWalker::View view = MakeView(PathCamera(frame), gridSize, footprint);
+            WalkAll(walker, source, view, draws);
+            if (!CheckFrame(gridSize, walker, source, view, draws))
+            {
+                fprintf(stderr, "    grid %d, frame %d\n", gridSize, frame);
+                return;
+            }
+            missSum += walker.GetPageMisses();
+            drawSum += walker.GetPagesDrawn();
+            maxMisses = (std::max)(maxMisses, walker.GetPageMisses());
+            lastMisses = walker.GetPageMisses();
+
+            StreamFrame(source, lastDrawn, frame, 4, gridSize * gridSize / 4);
+            residentSum += std::count(source.m_resident.begin(), source.m_resident.end(), true);
+        }
+        printf("     grid %d: %.1f pages drawn, %.1f level 0 resident, %.2f misses per frame (max %d)\n", gridSize,
+               (double)drawSum / frames, (double)residentSum / frames, (double)missSum / frames, maxMisses);
+        // The camera holds still for the last 100 frames: everything it needs has streamed in
+        CHECK_EQ(lastMisses, 0);
+        CHECK(missSum > 0);
+    }
+}
+
+// Camera high up: the coarse level only; low: level 0 under the camera
+static void TestLevelByHeight()
+{
+    const int gridSize = 12;
+    ChunkPageWalker walker;
+    walker.SetLayout(gridSize, MAP_LEFT, MAP_TOP, MAP_SIZE, MAP_SIZE);
+    TestPageSource source(gridSize);
+    source.m_resident.assign(gridSize * gridSize, true);
+    std::vector<ChunkPageDraw> draws;
+
+    TestCamera camera = { D3DXVECTOR3(100.0f, 100.0f, 6000.0f), D3DXVECTOR3(-D3DX_PI * 0.5f, 0.0f, 0.0f), 70.0f * D3DX_PI / 180.0f };
+    RadarFootprint footprint;
+    WalkAll(walker, source, MakeView(camera, gridSize, footprint), draws);
+    CHECK(!draws.empty());
+    CHECK_EQ(walker.GetFinestLevel(), ChunkPyramid::MAX_LEVELS);
+
+    camera.pos.z = 200.0f;
+    WalkAll(walker, source, MakeView(camera, gridSize, footprint), draws);
+    CHECK_EQ(walker.GetFinestLevel(), 0);
+    CHECK_EQ(walker.GetPageMisses(), 0);
+    bool underCamera = false;
+    for (const ChunkPageDraw& draw : draws)
+        underCamera |= draw.level == 0 && fabsf(draw.centerX - 100.0f) <= draw.width * 0.5f &&
+                       fabsf(draw.centerY - 100.0f) <= draw.height * 0.5f;
+    CHECK(underCamera);
+}
+
+// Background tiles count as drawn but reach no callback; unavailable chunks are neither drawn nor missed
+static void TestBackgroundAndUnavailable()
+{
+    const int gridSize = 12;
+    ChunkPageWalker walker;
+    walker.SetLayout(gridSize, MAP_LEFT, MAP_TOP, MAP_SIZE, MAP_SIZE);
+    TestPageSource source(gridSize);
+    TestCamera camera = { D3DXVECTOR3(-2750.0f, 2750.0f, 150.0f), D3DXVECTOR3(-D3DX_PI * 0.5f, 0.0f, 0.0f), 70.0f * D3DX_PI / 180.0f };
+    RadarFootprint footprint;
+    ChunkPageWalker::View view = MakeView(camera, gridSize, footprint);
+    view.footprint = nullptr;
+    view.visibleRadius = 200.0f;
+    std::vector<ChunkPageDraw> draws;
+
+    source.m_resident[0] = true;
+    source.m_backgroundTile = 0;
+    source.m_unavailable[1] = true;
+    WalkAll(walker, source, view, draws);
+    CHECK_EQ(walker.GetSkippedDraws(), 1);
+    CHECK(std::none_of(draws.begin(), draws.end(), [](const ChunkPageDraw& d) { return d.level == 0 && d.index <= 1; }));
+    CHECK(std::find(source.m_missing.begin(), source.m_missing.end(), 1) == source.m_missing.end());
+    CHECK_EQ(walker.GetPagesDrawn(), (int)draws.size() + 1);
+}
+
+static void TestChildRegion()
+{
+    const ChunkRect cell = { 0.25f, 0.5f, 0.75f, 1.0f };
+    const ChunkRect child = ChunkPageWalker::ChildRegion(cell, 1, 0);
+    CHECK_EQ(child.u0, 0.5f);
+    CHECK_EQ(child.u1, 0.75f);
+    CHECK_EQ(child.v0, 0.5f);
+    CHECK_EQ(child.v1, 0.75f);
+}
+
+int main()
+{
+    RUN_TEST(TestCameraPathReplay);
+    RUN_TEST(TestLevelByHeight);
+    RUN_TEST(TestBackgroundAndUnavailable);
+    RUN_TEST(TestChildRegion);
+    return TEST_RESULT();
+}
@@ -0,0 +1,298 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        tests/ChunkPrefetchTest.cpp
+ *****************************************************************************/
+
+#include "TestCheck.h"
+#include "ChunkPrefetch.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+static const float PI = 3.14159265f;
+
+// CameraController::GetCachedCalculations for a player position and yaw
+static void CameraAt(float playerX, float playerY, float yaw, float offsetY, float& outX, float& outY)
+{
+    outX = playerX + offsetY * sinf(-yaw);
+    outY = playerY - offsetY * cosf(-yaw);
+}
+
+static void TestPredictPath()
+{
+    ChunkPrefetch::Sample samples[ChunkPrefetch::STEPS];
+    ChunkPrefetch::Motion motion = { 100.0f, -200.0f, 0.0f, 0.0f, 0.3f, -15.0f, 445.0f };
+    CHECK_EQ(ChunkPrefetch::PredictPath(motion, 0.5f, samples), 0);
+    motion.velX = ChunkPrefetch::MIN_SPEED * 0.5f;
+    CHECK_EQ(ChunkPrefetch::PredictPath(motion, 0.5f, samples), 0);
+    motion.velX = 30.0f;
+    motion.velY = 40.0f;
+    CHECK_EQ(ChunkPrefetch::PredictPath(motion, 0.0f, samples), 0);
+
+    // Facing the direction of travel: the camera keeps its offset, the player its velocity
+    motion.yaw = atan2f(motion.velX, motion.velY);
+    CHECK_EQ(ChunkPrefetch::PredictPath(motion, 0.8f, samples), ChunkPrefetch::STEPS);
+    for (int step = 0; step < ChunkPrefetch::STEPS; ++step)
+    {
+        const float t = 0.8f * (step + 1) / ChunkPrefetch::STEPS;
+        float x, y;
+        CameraAt(motion.playerX + motion.velX * t, motion.playerY + motion.velY * t, motion.yaw, motion.offsetY, x, y);
+        CHECK_NEAR(samples[step].seconds, t, 1e-6f);
+        CHECK_NEAR(samples[step].x, x, 1e-3f);
+        CHECK_NEAR(samples[step].y, y, 1e-3f);
+        CHECK_EQ(samples[step].z, 445.0f);
+    }
+
+    // Looking sideways: the yaw swings toward the heading, the short way round, and never past it
+    motion.velX = 0.0f;
+    motion.velY = -50.0f;           // heading +-pi
+    motion.yaw = -PI + 0.4f;
+    motion.offsetY = -100.0f;
+    CHECK_EQ(ChunkPrefetch::PredictPath(motion, 6.0f, samples), ChunkPrefetch::STEPS);
+    float lastTurn = 0.0f;
+    for (int step = 0; step < ChunkPrefetch::STEPS; ++step)
+    {
+        const float t = samples[step].seconds;
+        // Offset direction back out of the sample: (x - px, y - py) = offsetY * (sin(-yaw), -cos(-yaw))
+        const float ox = (samples[step].x - motion.playerX) / motion.offsetY;
+        const float oy = (samples[step].y - (motion.playerY + motion.velY * t)) / motion.offsetY;
+        const float yaw = -atan2f(ox, -oy);
+        const float turn = motion.yaw - yaw;    // yaw decreases toward -pi
+        CHECK(turn > lastTurn - 1e-5f);
+        CHECK(turn <= 0.4f + 1e-4f);
+        CHECK_NEAR(turn, 0.4f * (1.0f - expf(-t / ChunkPrefetch::YAW_FOLLOW_SECONDS)), 1e-3f);
+        lastTurn = turn;
+    }
+    CHECK(lastTurn > 0.39f);
+
+    // The first sample approaches the current camera as the look-ahead shrinks
+    float x, y;
+    CameraAt(motion.playerX, motion.playerY, motion.yaw, motion.offsetY, x, y);
+    ChunkPrefetch::PredictPath(motion, 1e-4f, samples);
+    CHECK_NEAR(samples[0].x, x, 1e-2f);
+    CHECK_NEAR(samples[0].y, y, 1e-2f);
+}
+
+// Recorded-style trajectories, 30 frames per second: player position, velocity and camera yaw per frame
+struct TrajectoryFrame
+{
+    float x, y, velX, velY, yaw;
+};
+
+static std::vector<TrajectoryFrame> RecordTrajectory(int kind)
+{
+    std::vector<TrajectoryFrame> frames;
+    float x = 0.0f, y = 0.0f, yaw = 0.0f;
+    const float dt = 1.0f / 30.0f;
+    for (int f = 0; f < 1200; ++f)
+    {
+        const float t = f * dt;
+        float speed, heading;
+        switch (kind)
+        {
+        case 0:  speed = 45.0f;  heading = 0.6f; break;                                    // highway
+        case 1:  speed = 30.0f;  heading = 0.35f * t; break;                               // city block loops
+        case 2:  speed = 160.0f; heading = 2.0f + 0.4f * sinf(t * 0.3f); break;            // flight
+        default: speed = (f / 150) % 2 ? 2.0f : 0.0f; heading = t; break;                 // on foot, stop and go
+        }
+        const float velX = speed * sinf(heading), velY = speed * cosf(heading);
+        // The game camera trails the heading
+        yaw += (heading - yaw) * (1.0f - expf(-dt / 0.8f));
+        TrajectoryFrame frame = { x, y, velX, velY, yaw };
+        frames.push_back(frame);
+        x = std::max(-2900.0f, std::min(2900.0f, x + velX * dt));
+        y = std::max(-2900.0f, std::min(2900.0f, y + velY * dt));
+    }
+    return frames;
+}
+
+struct ReplayResult
+{
+    int hits, late, unused;
+    int expectedHits, expectedLate, expectedUnused;
+};
+
+// Streaming as MapChunkManager runs it: visible misses first (nearest), then the predicted path, a few requests
+// per frame, each uploaded after a decode delay, least recently drawn evicted over the budget. The counters are
+// also derived from the replay's own per chunk history.
+static ReplayResult Replay(const std::vector<TrajectoryFrame>& frames, float lookAhead)
+{
+    const int GRID = 48, CHUNKS = GRID * GRID;
+    const float TILE = 6000.0f / GRID, RADIUS = 700.0f, OFFSET_Y = -15.0f, HEIGHT = 445.0f;
+    const int DECODE_FRAMES = 5, REQUESTS_PER_FRAME = 6, BUDGET = 220;
+
+    ChunkPrefetch prefetch;
+    prefetch.Reset(CHUNKS);
+    std::vector<int> readyFrame(CHUNKS, -1);        // decode in flight: uploaded at this frame
+    std::vector<bool> resident(CHUNKS, false);
+    std::vector<int> lastDrawn(CHUNKS, -1);
+    // Own bookkeeping: per residency, was the last request a prefetch, and was the chunk needed before
+    std::vector<bool> viaPrefetch(CHUNKS, false), missedSince(CHUNKS, false), drawnSince(CHUNKS, false);
+    std::vector<bool> lateOpen(CHUNKS, false);
+    ReplayResult result = {};
+
+    auto forTilesAround = [&](float cx, float cy, float radius, auto&& visit) {
+        const float reach = radius + TILE * 0.7072f;
+        const int c0 = std::max(0, (int)((cx - reach + 3000.0f) / TILE)), c1 = std::min(GRID - 1, (int)((cx + reach + 3000.0f) / TILE));
+        const int r0 = std::max(0, (int)((3000.0f - cy - reach) / TILE)), r1 = std::min(GRID - 1, (int)((3000.0f - cy + reach) / TILE));
+        for (int r = r0; r <= r1; ++r)
+            for (int c = c0; c <= c1; ++c)
+            {
+                const float dx = -3000.0f + (c + 0.5f) * TILE - cx, dy = 3000.0f - (r + 0.5f) * TILE - cy;
+                if (dx * dx + dy * dy <= reach * reach)
+                    visit(r * GRID + c, dx * dx + dy * dy);
+            }
+    };
+
+    for (int f = 0; f < (int)frames.size(); ++f)
+    {
+        // Uploads
+        for (int index = 0; index < CHUNKS; ++index)
+        {
+            if (readyFrame[index] != f)
+                continue;
+            readyFrame[index] = -1;
+            resident[index] = true;
+            lastDrawn[index] = f;
+            prefetch.NoteResident(index);
+            drawnSince[index] = false;
+            lateOpen[index] = false;
+        }
+
+        const TrajectoryFrame& frame = frames[f];
+        float camX, camY;
+        CameraAt(frame.x, frame.y, frame.yaw, OFFSET_Y, camX, camY);
+        std::vector<std::pair<float, int>> requests;
+        forTilesAround(camX, camY, RADIUS, [&](int index, float distSq) {
+            if (resident[index])
+            {
+                prefetch.NoteDrawn(index);
+                if (!drawnSince[index] && viaPrefetch[index])
+                    ++result.expectedHits;
+                drawnSince[index] = true;
+                viaPrefetch[index] = false;
+                lastDrawn[index] = f;
+                return;
+            }
+            prefetch.NoteMissing(index);
+            if (!lateOpen[index])
+                ++result.expectedLate;
+            lateOpen[index] = true;
+            viaPrefetch[index] = false;
+            if (readyFrame[index] < 0)
+                requests.push_back(std::make_pair(distSq, index));
+        });
+
+        const ChunkPrefetch::Motion motion = { frame.x, frame.y, frame.velX, frame.velY, frame.yaw, OFFSET_Y, HEIGHT };
+        ChunkPrefetch::Sample samples[ChunkPrefetch::STEPS];
+        const int sampleCount = ChunkPrefetch::PredictPath(motion, lookAhead, samples);
+        const float orderSq = (RADIUS + TILE) * (RADIUS + TILE);
+        for (int s = 0; s < sampleCount; ++s)
+            forTilesAround(samples[s].x, samples[s].y, RADIUS, [&](int index, float distSq) {
+                if (resident[index] || readyFrame[index] >= 0 || lateOpen[index])
+                    return;
+                if (std::find_if(requests.begin(), requests.end(), [index](const std::pair<float, int>& r) { return r.second == index; }) != requests.end())
+                    return;
+                requests.push_back(std::make_pair(orderSq * (s + 1) + distSq, index));
+            });
+
+        std::sort(requests.begin(), requests.end());
+        for (size_t i = 0; i < requests.size() && (int)i < REQUESTS_PER_FRAME; ++i)
+        {
+            const int index = requests[i].second;
+            readyFrame[index] = f + DECODE_FRAMES;
+            if (!lateOpen[index])
+            {
+                prefetch.NoteRequested(index);
+                viaPrefetch[index] = true;
+            }
+        }
+
+        // Eviction, least recently drawn first, never this frame's
+        std::vector<std::pair<int, int>> byAge;
+        for (int index = 0; index < CHUNKS; ++index)
+            if (resident[index])
+                byAge.push_back(std::make_pair(lastDrawn[index], index));
+        std::sort(byAge.begin(), byAge.end());
+        for (size_t i = 0; (int)(byAge.size() - i) > BUDGET && byAge[i].first < f; ++i)
+        {
+            const int index = byAge[i].second;
+            resident[index] = false;
+            prefetch.NoteUnloaded(index);
+            if (viaPrefetch[index] && !drawnSince[index])
+                ++result.expectedUnused;
+            viaPrefetch[index] = false;
+        }
+    }
+    result.hits = prefetch.GetHits();
+    result.late = prefetch.GetLate();
+    result.unused = prefetch.GetUnused();
+    return result;
+}
+
+static void TestTrajectoryReplay()
+{
+    const char* names[] = { "highway", "city loops", "flight", "on foot" };
+    for (int kind = 0; kind < 4; ++kind)
+    {
+        const std::vector<TrajectoryFrame> frames = RecordTrajectory(kind);
+        const ReplayResult off = Replay(frames, 0.0f);
+        const ReplayResult on = Replay(frames, 0.8f);
+        printf("     %-10s: no prefetch %4d late; 0.8 s look-ahead %4d hit, %4d late, %3d unused\n", names[kind], off.late,
+               on.hits, on.late, on.unused);
+
+        CHECK_EQ(on.hits, on.expectedHits);
+        CHECK_EQ(on.late, on.expectedLate);
+        CHECK_EQ(on.unused, on.expectedUnused);
+        CHECK_EQ(off.late, off.expectedLate);
+        CHECK_EQ(off.hits, 0);
+        CHECK_EQ(off.unused, 0);
+        // Moving fast enough to outrun the decode delay, the prefetch takes over from late loads
+        if (kind <= 2)
+        {
+            CHECK(on.late < off.late);
+            CHECK(on.hits > 0);
+        }
+    }
+}
+
+// Late is counted once per residency gap, and a late chunk is not a hit even if a prefetch was under way
+static void TestCounters()
+{
+    ChunkPrefetch prefetch;
+    prefetch.Reset(4);
+    prefetch.NoteRequested(0);
+    prefetch.NoteMissing(0);
+    prefetch.NoteMissing(0);
+    prefetch.NoteResident(0);
+    prefetch.NoteDrawn(0);
+    CHECK_EQ(prefetch.GetLate(), 1);
+    CHECK_EQ(prefetch.GetHits(), 0);
+
+    prefetch.NoteRequested(1);
+    prefetch.NoteResident(1);
+    prefetch.NoteDrawn(1);
+    prefetch.NoteDrawn(1);
+    CHECK_EQ(prefetch.GetHits(), 1);
+
+    prefetch.NoteRequested(2);
+    prefetch.NoteResident(2);
+    prefetch.NoteUnloaded(2);
+    prefetch.NoteUnloaded(1);
+    CHECK_EQ(prefetch.GetUnused(), 1);
+
+    prefetch.NoteUnloaded(0);
+    prefetch.NoteMissing(0);
+    CHECK_EQ(prefetch.GetLate(), 2);
+
+    prefetch.Reset(4);
+    CHECK_EQ(prefetch.GetHits() + prefetch.GetLate() + prefetch.GetUnused(), 0);
+}
+
+int main()
+{
+    RUN_TEST(TestPredictPath);
+    RUN_TEST(TestCounters);
+    RUN_TEST(TestTrajectoryReplay);
+    return TEST_RESULT();
+}
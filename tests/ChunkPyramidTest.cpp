@@ -0,0 +1,167 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        tests/ChunkPyramidTest.cpp
+ *****************************************************************************/
+
+#include "TestCheck.h"
+#include "ChunkPyramid.h"
+#include "ChunkMipChain.h"
+#include <cstring>
+#include <vector>
+
+static const int BASE_GRID = 12;
+static const int TILE_SIZE = 16;
+
+static ChunkPixels MakeBaseChunk(int index)
+{
+    ChunkPixels pixels = {};
+    pixels.width = TILE_SIZE;
+    pixels.height = TILE_SIZE;
+    pixels.pitch = TILE_SIZE * 4;
+    pixels.levels = 1;
+    pixels.format = CHUNK_FORMAT_BGRA8;
+    pixels.data.resize((size_t)TILE_SIZE * TILE_SIZE * 4);
+    uint32_t seed = 0x9E3779B9u * (uint32_t)(index + 1);
+    for (size_t i = 0; i < pixels.data.size(); ++i)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        pixels.data[i] = (uint8_t)(seed >> 24);
+    }
+    ChunkMipChain::Build(pixels);
+    return pixels;
+}
+
+// Bottom-right 4x4 base chunks are missing: coarse level 2 tile 8 has nothing to show
+static bool IsMissing(int index)
+{
+    return index == 5 || (index / BASE_GRID >= 8 && index % BASE_GRID >= 8);
+}
+
+struct Finished
+{
+    int         level;
+    int         index;
+    ChunkPixels pixels;
+};
+
+static std::vector<Finished> RunPyramid(std::vector<ChunkPixels>& bases)
+{
+    ChunkPyramid pyramid;
+    pyramid.Reset(BASE_GRID, ChunkPyramid::MAX_LEVELS);
+    bases.clear();
+    for (int i = 0; i < BASE_GRID * BASE_GRID; ++i)
+        bases.push_back(MakeBaseChunk(i));
+
+    // Column-major contribution order: tiles complete in an order unrelated to their index
+    for (int col = 0; col < BASE_GRID; ++col)
+        for (int row = 0; row < BASE_GRID; ++row)
+        {
+            const int index = row * BASE_GRID + col;
+            if (IsMissing(index))
+                pyramid.MarkMissing(index);
+            else
+                pyramid.Contribute(index, bases[index]);
+        }
+    CHECK_EQ(pyramid.GetContributedCount(), BASE_GRID * BASE_GRID);
+
+    std::vector<Finished> finished;
+    Finished done = {};
+    while (pyramid.PopCompleted(done.level, done.index, done.pixels))
+        finished.push_back(std::move(done));
+    return finished;
+}
+
+static void TestGridSizes()
+{
+    ChunkPyramid pyramid;
+    pyramid.Reset(BASE_GRID, ChunkPyramid::MAX_LEVELS);
+    CHECK_EQ(pyramid.GetLevelCount(), 2);
+    CHECK_EQ(pyramid.GetGridSize(1), 6);
+    CHECK_EQ(pyramid.GetGridSize(2), 3);
+
+    // 10 divides by 2 but not by 4: only level 1 is built
+    pyramid.Reset(10, ChunkPyramid::MAX_LEVELS);
+    CHECK_EQ(pyramid.GetLevelCount(), 1);
+}
+
+static void TestBlitOutput()
+{
+    std::vector<ChunkPixels> bases;
+    std::vector<Finished> finished = RunPyramid(bases);
+    CHECK_EQ(finished.size(), (size_t)(6 * 6 + 3 * 3));
+
+    int seen[ChunkPyramid::MAX_LEVELS + 1] = {};
+    for (const Finished& done : finished)
+    {
+        ++seen[done.level];
+        const int span = 1 << done.level;
+        const int grid = BASE_GRID >> done.level;
+        const int sub = TILE_SIZE >> done.level;
+        const int tileRow = done.index / grid;
+        const int tileCol = done.index % grid;
+
+        bool anyPresent = false;
+        for (int i = 0; i < span * span; ++i)
+            anyPresent = anyPresent || !IsMissing((tileRow * span + i / span) * BASE_GRID + tileCol * span + i % span);
+        if (!anyPresent)
+        {
+            CHECK(done.pixels.data.empty());
+            continue;
+        }
+
+        CHECK_EQ(done.pixels.width, TILE_SIZE);
+        CHECK_EQ(done.pixels.levels, ChunkMipChain::CountLevels(TILE_SIZE, TILE_SIZE));
+
+        // Each sub-square is mip level `level` of its base chunk, missing chunks stay transparent black
+        bool match = true;
+        for (int i = 0; i < span * span; ++i)
+        {
+            const int baseIndex = (tileRow * span + i / span) * BASE_GRID + tileCol * span + i % span;
+            const uint8_t* src = bases[baseIndex].data.data() + ChunkMipChain::LevelOffset(TILE_SIZE, TILE_SIZE, done.level);
+            for (int y = 0; y < sub; ++y)
+            {
+                const uint8_t* dst = done.pixels.data.data() + (size_t)((i / span) * sub + y) * done.pixels.pitch + (size_t)(i % span) * sub * 4;
+                if (IsMissing(baseIndex))
+                {
+                    for (int x = 0; x < sub * 4; ++x)
+                        match = match && dst[x] == 0;
+                }
+                else
+                {
+                    match = match && memcmp(dst, src + (size_t)y * sub * 4, (size_t)sub * 4) == 0;
+                }
+            }
+        }
+        if (!CHECK(match))
+            fprintf(stderr, "    level %d tile %d differs\n", done.level, done.index);
+    }
+    CHECK_EQ(seen[1], 36);
+    CHECK_EQ(seen[2], 9);
+}
+
+static void TestDuplicateAndForeignContributions()
+{
+    ChunkPyramid pyramid;
+    pyramid.Reset(BASE_GRID, ChunkPyramid::MAX_LEVELS);
+    ChunkPixels chunk = MakeBaseChunk(0);
+    pyramid.Contribute(0, chunk);
+    pyramid.Contribute(0, chunk);
+    pyramid.MarkMissing(0);
+    pyramid.Contribute(-1, chunk);
+    pyramid.Contribute(BASE_GRID * BASE_GRID, chunk);
+    CHECK_EQ(pyramid.GetContributedCount(), 1);
+    CHECK(pyramid.HasContributed(0));
+    CHECK(!pyramid.HasContributed(1));
+
+    int level, index;
+    ChunkPixels out;
+    CHECK(!pyramid.PopCompleted(level, index, out));
+}
+
+int main()
+{
+    RUN_TEST(TestGridSizes);
+    RUN_TEST(TestBlitOutput);
+    RUN_TEST(TestDuplicateAndForeignContributions);
+    return TEST_RESULT();
+}
@@ -0,0 +1,155 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        tests/FastMathTest.cpp
+ *****************************************************************************/
+
+#include "TestCheck.h"
+#include "FastMath.h"
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+static uint32_t s_seed = 5;
+
+static uint32_t RandomBits()
+{
+    s_seed = s_seed * 1664525u + 1013904223u;
+    return s_seed;
+}
+
+static float RandomFloat(float lo, float hi)
+{
+    return lo + (hi - lo) * (float)(RandomBits() >> 8) / 16777216.0f;
+}
+
+// Error in units of the float spacing at the exact result
+static double UlpError(float value, double exact)
+{
+    const double ulp = std::ldexp(1.0, std::ilogb((float)exact) - 23);
+    return fabs((double)value - exact) / ((exact == 0.0) ? std::ldexp(1.0, -149) : ulp);
+}
+
+static bool SameBits(float a, float b)
+{
+    return memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+// Documented bound: 1.6 ulp where the result is not near a zero crossing, 8e-8 absolute everywhere, |angle| <= 8192
+static void TestSinCosError()
+{
+    double worstUlp = 0.0, worstAbs = 0.0;
+    for (int i = 0; i < 2000000; ++i)
+    {
+        const float range = (i & 1) ? 8.0f : 8192.0f;
+        const float angle = RandomFloat(-range, range);
+        float s, c;
+        FastMath::SinCos(angle, s, c);
+        const double exactS = sin((double)angle), exactC = cos((double)angle);
+        worstAbs = std::fmax(worstAbs, std::fmax(fabs(s - exactS), fabs(c - exactC)));
+        if (fabs(exactS) >= 0.125)
+            worstUlp = std::fmax(worstUlp, UlpError(s, exactS));
+        if (fabs(exactC) >= 0.125)
+            worstUlp = std::fmax(worstUlp, UlpError(c, exactC));
+    }
+    printf("    SinCos: worst %.3f ulp, %.3g absolute\n", worstUlp, worstAbs);
+    CHECK(worstUlp <= 1.6);
+    CHECK(worstAbs <= 8e-8);
+
+    // Exact at 0, sin odd, cos even
+    float s, c;
+    FastMath::SinCos(0.0f, s, c);
+    CHECK(s == 0.0f && c == 1.0f);
+    for (int i = 0; i < 1000; ++i)
+    {
+        const float angle = RandomFloat(0.0f, 100.0f);
+        float sp, cp, sn, cn;
+        FastMath::SinCos(angle, sp, cp);
+        FastMath::SinCos(-angle, sn, cn);
+        CHECK(sn == -sp && cn == cp);
+    }
+    CHECK(FastMath::Sin(1.0f) == (FastMath::SinCos(1.0f, s, c), s));
+}
+
+// Documented bound: 3 ulp for finite inputs of any magnitude and sign
+static void TestAtan2Error()
+{
+    double worstUlp = 0.0;
+    for (int i = 0; i < 2000000; ++i)
+    {
+        // Random exponents as well as mantissas, all four quadrants
+        const float y = std::ldexp(RandomFloat(-1.0f, 1.0f), (int)(RandomBits() % 60) - 30);
+        const float x = std::ldexp(RandomFloat(-1.0f, 1.0f), (int)(RandomBits() % 60) - 30);
+        worstUlp = std::fmax(worstUlp, UlpError(FastMath::Atan2(y, x), atan2((double)y, (double)x)));
+    }
+    printf("    Atan2: worst %.3f ulp\n", worstUlp);
+    CHECK(worstUlp <= 3.0);
+
+    // Axes and signed zeros as atan2f
+    CHECK(FastMath::Atan2(0.0f, 0.0f) == 0.0f);
+    CHECK(FastMath::Atan2(0.0f, 1.0f) == 0.0f);
+    CHECK(std::signbit(FastMath::Atan2(-0.0f, 1.0f)));
+    CHECK_NEAR(FastMath::Atan2(0.0f, -1.0f), atan2(0.0, -1.0), 3e-7);
+    CHECK_NEAR(FastMath::Atan2(-0.0f, -1.0f), atan2(-0.0, -1.0), 3e-7);
+    CHECK_NEAR(FastMath::Atan2(1.0f, 0.0f), FastMath::HALF_PI, 1e-7);
+    CHECK_NEAR(FastMath::Atan2(-1.0f, 0.0f), -FastMath::HALF_PI, 1e-7);
+    CHECK_NEAR(FastMath::Atan2(1.0f, 1.0f), FastMath::PI * 0.25f, 1e-7);
+}
+
+// Batch versions give the scalar bits, counts around the 4-wide step
+static void TestBatchMatchesScalar()
+{
+    const int count = 1003;
+    std::vector<float> angles(count), y(count), x(count);
+    for (int i = 0; i < count; ++i)
+    {
+        angles[i] = RandomFloat(-8192.0f, 8192.0f) * ((i % 3 == 0) ? 0.001f : 1.0f);
+        y[i] = RandomFloat(-50.0f, 50.0f);
+        x[i] = RandomFloat(-50.0f, 50.0f);
+    }
+    angles[0] = 0.0f;
+    angles[1] = -0.0f;
+    y[2] = x[2] = 0.0f;
+    y[3] = -0.0f;
+    x[3] = -2.0f;
+    x[5] = 0.0f;
+
+    for (int n = 0; n <= count; n = (n < 16) ? n + 1 : n * 2 + 1)
+    {
+        std::vector<float> s(n + 1, 7.0f), c(n + 1, 7.0f), a(n + 1, 7.0f);
+        FastMath::SinCosBatch(angles.data(), n, s.data(), c.data());
+        FastMath::Atan2Batch(y.data(), x.data(), n, a.data());
+        bool same = s[n] == 7.0f && c[n] == 7.0f && a[n] == 7.0f;
+        for (int i = 0; i < n; ++i)
+        {
+            float es, ec;
+            FastMath::SinCos(angles[i], es, ec);
+            same = same && SameBits(s[i], es) && SameBits(c[i], ec) && SameBits(a[i], FastMath::Atan2(y[i], x[i]));
+        }
+        if (!CHECK(same))
+        {
+            fprintf(stderr, "    count %d\n", n);
+            return;
+        }
+    }
+}
+
+static void TestCircleTable()
+{
+    const FastMath::CircleTable<16>& table = FastMath::CircleTable<16>::Get();
+    CHECK(&table == &FastMath::CircleTable<16>::Get());
+    for (int i = 0; i < 16; ++i)
+    {
+        CHECK_NEAR(table.cosA[i], cos(2.0 * 3.14159265358979 * i / 16), 1e-6);
+        CHECK_NEAR(table.sinA[i], sin(2.0 * 3.14159265358979 * i / 16), 1e-6);
+    }
+    CHECK(table.cosA[16] == table.cosA[0] && table.sinA[16] == table.sinA[0]);
+}
+
+int main()
+{
+    RUN_TEST(TestSinCosError);
+    RUN_TEST(TestAtan2Error);
+    RUN_TEST(TestBatchMatchesScalar);
+    RUN_TEST(TestCircleTable);
+    return TEST_RESULT();
+}
@@ -0,0 +1,131 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        tests/PixelConvertTest.cpp
+ *****************************************************************************/
+
+#include "TestCheck.h"
+#include "PixelConvert.h"
+#include <cstring>
+#include <vector>
+
+static const PixelConvert::Path s_paths[] = { PixelConvert::PATH_SCALAR, PixelConvert::PATH_SSSE3, PixelConvert::PATH_AVX2 };
+
+static std::vector<uint8_t> MakePixels(size_t bytes, uint32_t seed)
+{
+    std::vector<uint8_t> pixels(bytes);
+    for (auto& b : pixels)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        b = (uint8_t)(seed >> 24);
+    }
+    return pixels;
+}
+
+// Straight from the definition: swap bytes 0 / 2, colour * alpha / 255 rounded half up
+static void Reference(const uint8_t* src, uint8_t* dst, int width, bool premultiply)
+{
+    for (int x = 0; x < width; ++x)
+    {
+        const uint8_t* s = src + x * 4;
+        const int a = s[3];
+        const int c[3] = { s[2], s[1], s[0] };
+        for (int i = 0; i < 3; ++i)
+            dst[x * 4 + i] = premultiply ? (uint8_t)((c[i] * a * 2 + 255) / 510) : (uint8_t)c[i];
+        dst[x * 4 + 3] = (uint8_t)a;
+    }
+}
+
+// Every colour / alpha pair through every path
+static void TestPremultiplyExhaustive()
+{
+    std::vector<uint8_t> src(256 * 256 * 4), expected(src.size()), out(src.size());
+    for (int a = 0; a < 256; ++a)
+        for (int c = 0; c < 256; ++c)
+        {
+            uint8_t* p = &src[((size_t)a * 256 + c) * 4];
+            p[0] = (uint8_t)c;
+            p[1] = (uint8_t)(255 - c);
+            p[2] = (uint8_t)(c ^ 0x5A);
+            p[3] = (uint8_t)a;
+        }
+    Reference(src.data(), expected.data(), 256 * 256, true);
+    for (PixelConvert::Path path : s_paths)
+    {
+        PixelConvert::SwapRedBlue(src.data(), 1024, out.data(), 1024, 256, 256, true, path);
+        if (!CHECK(out == expected))
+            fprintf(stderr, "    path %s\n", PixelConvert::GetPathName(path));
+    }
+}
+
+// Widths around the 4 / 8 pixel steps, pitches with padding that must stay untouched
+static void TestPathsBitExact()
+{
+    const int height = 5;
+    for (int width = 1; width <= 40; ++width)
+    {
+        const int srcPitch = width * 4 + 12;
+        const int dstPitch = width * 4 + 20;
+        const std::vector<uint8_t> src = MakePixels((size_t)srcPitch * height, width);
+        for (int premultiply = 0; premultiply < 2; ++premultiply)
+        {
+            std::vector<uint8_t> expected(dstPitch * height, 0xCD);
+            for (int y = 0; y < height; ++y)
+                Reference(&src[y * srcPitch], &expected[y * dstPitch], width, premultiply != 0);
+
+            for (PixelConvert::Path path : s_paths)
+            {
+                std::vector<uint8_t> out(dstPitch * height, 0xCD);
+                PixelConvert::SwapRedBlue(src.data(), srcPitch, out.data(), dstPitch, width, height, premultiply != 0, path);
+                if (!CHECK(out == expected))
+                {
+                    fprintf(stderr, "    width %d premultiply %d path %s\n", width, premultiply, PixelConvert::GetPathName(path));
+                    return;
+                }
+            }
+        }
+    }
+}
+
+static void TestInPlace()
+{
+    const int width = 37, height = 9, pitch = width * 4;
+    const std::vector<uint8_t> src = MakePixels((size_t)pitch * height, 99);
+    std::vector<uint8_t> expected(src.size());
+    for (int y = 0; y < height; ++y)
+        Reference(&src[y * pitch], &expected[y * pitch], width, true);
+    for (PixelConvert::Path path : s_paths)
+    {
+        std::vector<uint8_t> pixels = src;
+        PixelConvert::SwapRedBlue(pixels.data(), pitch, pixels.data(), pitch, width, height, true, path);
+        CHECK(pixels == expected);
+    }
+
+    // Swapping twice without premultiply gives the input back
+    std::vector<uint8_t> pixels = src;
+    PixelConvert::SwapRedBlue(pixels.data(), pitch, pixels.data(), pitch, width, height);
+    PixelConvert::SwapRedBlue(pixels.data(), pitch, pixels.data(), pitch, width, height);
+    CHECK(pixels == src);
+}
+
+static void TestPathSelection()
+{
+    const PixelConvert::Path best = PixelConvert::GetBestPath();
+    CHECK(best != PixelConvert::PATH_AUTO);
+    CHECK(strcmp(PixelConvert::GetPathName(PixelConvert::PATH_AUTO), PixelConvert::GetPathName(best)) == 0);
+    CHECK(strcmp(PixelConvert::GetPathName(PixelConvert::PATH_SCALAR), "scalar") == 0);
+
+    // Empty or null input: nothing written
+    uint8_t pixel[4] = { 1, 2, 3, 4 };
+    PixelConvert::SwapRedBlue(pixel, 4, pixel, 4, 0, 1);
+    PixelConvert::SwapRedBlue(nullptr, 4, pixel, 4, 1, 1);
+    CHECK(pixel[0] == 1 && pixel[2] == 3);
+}
+
+int main()
+{
+    RUN_TEST(TestPremultiplyExhaustive);
+    RUN_TEST(TestPathsBitExact);
+    RUN_TEST(TestInPlace);
+    RUN_TEST(TestPathSelection);
+    return TEST_RESULT();
+}
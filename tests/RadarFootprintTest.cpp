@@ -0,0 +1,207 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        tests/RadarFootprintTest.cpp
+ *****************************************************************************/
+
+#include "TestCheck.h"
+#include "RadarGeometry.h"
+#include "MathUtils.h"
+#include <algorithm>
+#include <vector>
+
+static const float NEAR_PLANE = 0.3f;
+static const float FAR_PLANE = 10000.0f;
+static const float SCREEN_W = 1024.0f;
+static const float SCREEN_H = 1024.0f;
+static const float ASPECT = 1080.0f / 1920.0f;
+static const float MAP_LEFT = -3000.0f;
+static const float MAP_TOP = 3000.0f;
+static const float MAP_SIZE = 6000.0f;
+
+struct TestCamera
+{
+    D3DXVECTOR3 pos;
+    D3DXVECTOR3 rot;
+    float       fov;
+};
+
+// Recorded-style camera path: a drive across the map with the radar camera behind and above the player, turning,
+// zooming out for a flight and pitching down steeply, as CameraController::GetCachedCalculations produces it
+static TestCamera PathCamera(int frame)
+{
+    const float t = frame * 0.01f;
+    const float playerX = 2400.0f * sinf(t * 0.7f);
+    const float playerY = 2400.0f * sinf(t * 0.45f + 1.0f);
+    const float yaw = t * 1.3f + 0.8f * sinf(t * 3.0f);
+    const float height = 445.0f + 1000.0f * std::max(0.0f, sinf(t * 0.3f));
+    const float pitchDeg = -26.0f - 60.0f * std::max(0.0f, sinf(t * 0.17f + 2.0f));
+    const float offsetY = -15.0f + 10.0f * sinf(t);
+
+    TestCamera camera;
+    camera.pos = D3DXVECTOR3(playerX + offsetY * sinf(-yaw), playerY - offsetY * cosf(-yaw), height);
+    camera.rot = D3DXVECTOR3(pitchDeg * D3DX_PI / 180.0f, 0.0f, -yaw);
+    camera.fov = (70.0f + 15.0f * sinf(t * 0.5f)) * D3DX_PI / 180.0f;
+    return camera;
+}
+
+static void BuildProjection(const TestCamera& camera, RadarProjection& projection)
+{
+    projection.Build(camera.pos, camera.rot, camera.fov, NEAR_PLANE, FAR_PLANE, SCREEN_W, SCREEN_H, ASPECT);
+}
+
+static bool OnScreen(const RadarProjection& projection, float x, float y, float z, float marginPx)
+{
+    float sx, sy;
+    return projection.Project(D3DXVECTOR3(x, y, z), sx, sy) && sx >= -marginPx && sx <= SCREEN_W + marginPx &&
+           sy >= -marginPx && sy <= SCREEN_H + marginPx;
+}
+
+// Ground truth for a tile: some point of a dense sample grid over it (edges included) lands on the render target
+static bool TileSeen(const RadarProjection& projection, float minX, float minY, float maxX, float maxY)
+{
+    const int samples = 48;
+    for (int j = 0; j <= samples; ++j)
+        for (int i = 0; i <= samples; ++i)
+            if (OnScreen(projection, minX + (maxX - minX) * i / samples, minY + (maxY - minY) * j / samples, 0.0f, 0.0f))
+                return true;
+    return false;
+}
+
+// Tile culling before the footprint: a tile was drawn if any of its 4 corners passed WorldToScreen
+static bool CornerTest(const TestCamera& camera, float minX, float minY, float maxX, float maxY)
+{
+    const D3DXVECTOR3 corners[4] = { { minX, minY, 0.1f }, { maxX, minY, 0.1f }, { maxX, maxY, 0.1f }, { minX, maxY, 0.1f } };
+    for (const D3DXVECTOR3& corner : corners)
+    {
+        float sx, sy;
+        if (MathUtils::WorldToScreen(corner, camera.pos, camera.rot, camera.fov, NEAR_PLANE, FAR_PLANE, SCREEN_W, SCREEN_H, sx, sy, ASPECT))
+            return true;
+    }
+    return false;
+}
+
+// Visible tile sets over the camera path at the three LOD grids: the footprint (as MapChunkManager::BuildFootprint
+// builds it) never drops a tile that shows on screen, and keeps few that do not
+static void TestTileSetsOverCameraPath()
+{
+    const int grids[] = { 12, 6, 3 };
+    int seen = 0, footprintKept = 0, footprintExtra = 0, cornerKept = 0, cornerMissed = 0;
+    for (int frame = 0; frame < 600; frame += 3)
+    {
+        const TestCamera camera = PathCamera(frame);
+        RadarProjection projection;
+        BuildProjection(camera, projection);
+        RadarFootprint footprint;
+        CHECK(RadarGeometry::BuildFootprint(projection, 0.0f, 1.0f, footprint));
+
+        for (int grid : grids)
+        {
+            const float tile = MAP_SIZE / grid;
+            for (int row = 0; row < grid; ++row)
+            {
+                for (int col = 0; col < grid; ++col)
+                {
+                    const float minX = MAP_LEFT + col * tile, maxY = MAP_TOP - row * tile;
+                    const float maxX = minX + tile, minY = maxY - tile;
+                    const bool truth = TileSeen(projection, minX, minY, maxX, maxY);
+                    const bool kept = RadarGeometry::FootprintOverlapsRect(footprint, minX, minY, maxX, maxY);
+                    const bool corner = CornerTest(camera, minX, minY, maxX, maxY);
+                    if (truth && !kept)
+                    {
+                        CHECK(kept);
+                        fprintf(stderr, "    frame %d grid %d tile %d,%d dropped\n", frame, grid, row, col);
+                    }
+                    seen += truth ? 1 : 0;
+                    footprintKept += kept ? 1 : 0;
+                    footprintExtra += (kept && !truth) ? 1 : 0;
+                    cornerKept += corner ? 1 : 0;
+                    cornerMissed += (truth && !corner) ? 1 : 0;
+                }
+            }
+        }
+    }
+    printf("    tiles on screen %d; footprint keeps %d (%d not on screen); corner test keeps %d, misses %d\n", seen,
+           footprintKept, footprintExtra, cornerKept, cornerMissed);
+    // Only the 1 pixel margin and the sampling resolution separate the footprint from the exact set
+    CHECK(footprintExtra * 50 <= seen);
+    CHECK(footprintKept < cornerKept);
+}
+
+// Steep camera low over one 2000-unit LOD tile: the whole view lies inside it and no corner is on screen
+static void TestViewInsideOneTile()
+{
+    const TestCamera camera = { D3DXVECTOR3(-2000.0f, 2000.0f, 120.0f), D3DXVECTOR3(-80.0f * D3DX_PI / 180.0f, 0.0f, 0.3f), 70.0f * D3DX_PI / 180.0f };
+    RadarProjection projection;
+    BuildProjection(camera, projection);
+    RadarFootprint footprint;
+    CHECK(RadarGeometry::BuildFootprint(projection, 0.0f, 1.0f, footprint));
+
+    const float minX = -3000.0f, minY = 1000.0f, maxX = -1000.0f, maxY = 3000.0f;
+    CHECK(!OnScreen(projection, minX, minY, 0.0f, 0.0f) && !OnScreen(projection, maxX, minY, 0.0f, 0.0f) &&
+          !OnScreen(projection, minX, maxY, 0.0f, 0.0f) && !OnScreen(projection, maxX, maxY, 0.0f, 0.0f));
+    CHECK(TileSeen(projection, minX, minY, maxX, maxY));
+    CHECK(RadarGeometry::FootprintOverlapsRect(footprint, minX, minY, maxX, maxY));
+    CHECK(footprint.minX > minX && footprint.maxX < maxX && footprint.minY > minY && footprint.maxY < maxY);
+
+    // The neighbouring tiles are off screen and culled
+    CHECK(!RadarGeometry::FootprintOverlapsRect(footprint, maxX + 1.0f, minY, maxX + 2000.0f, maxY));
+    CHECK(!RadarGeometry::FootprintOverlapsRect(footprint, minX, minY - 2000.0f, maxX, minY - 1.0f));
+}
+
+// Blip culling: points on the blip plane (z 0.2) against projection with the half-icon margin RadarRenderer
+// widens the footprint by. Contained exactly when on the widened render target, up to float rounding at the edges.
+static void TestPointsOverCameraPath()
+{
+    const float planeZ = 0.2f, marginPx = 16.0f;
+    uint32_t seed = 99;
+    int onScreen = 0, missed = 0, extra = 0;
+    for (int frame = 0; frame < 600; frame += 2)
+    {
+        const TestCamera camera = PathCamera(frame);
+        RadarProjection projection;
+        BuildProjection(camera, projection);
+        RadarFootprint footprint;
+        CHECK(RadarGeometry::BuildFootprint(projection, planeZ, marginPx, footprint));
+
+        for (int i = 0; i < 2000; ++i)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            const float x = camera.pos.x + ((seed >> 8) & 0xFFF) - 2048.0f;
+            seed = seed * 1664525u + 1013904223u;
+            const float y = camera.pos.y + ((seed >> 8) & 0xFFF) - 2048.0f;
+
+            const bool truth = OnScreen(projection, x, y, planeZ, marginPx);
+            const bool contained = RadarGeometry::FootprintContains(footprint, x, y);
+            onScreen += truth ? 1 : 0;
+            // Rounding only: a point the footprint drops must be within a pixel of the widened edge
+            if (truth && !contained && OnScreen(projection, x, y, planeZ, marginPx - 0.5f))
+                ++missed;
+            if (contained && !OnScreen(projection, x, y, planeZ, marginPx + 0.5f))
+                ++extra;
+        }
+    }
+    printf("    %d points on screen, %d dropped, %d extra\n", onScreen, missed, extra);
+    CHECK(onScreen > 50000);
+    CHECK_EQ(missed, 0);
+    CHECK_EQ(extra, 0);
+}
+
+static void TestUnbuiltProjection()
+{
+    RadarProjection projection;
+    RadarFootprint footprint;
+    CHECK(!RadarGeometry::BuildFootprint(projection, 0.0f, 0.0f, footprint));
+    CHECK(!footprint.valid);
+    // No usable projection: nothing is culled
+    CHECK(RadarGeometry::FootprintContains(footprint, 1e6f, 1e6f));
+    CHECK(RadarGeometry::FootprintOverlapsRect(footprint, 0.0f, 0.0f, 1.0f, 1.0f));
+}
+
+int main()
+{
+    RUN_TEST(TestTileSetsOverCameraPath);
+    RUN_TEST(TestViewInsideOneTile);
+    RUN_TEST(TestPointsOverCameraPath);
+    RUN_TEST(TestUnbuiltProjection);
+    return TEST_RESULT();
+}
@@ -0,0 +1,130 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        tests/RadarOrbitTest.cpp
+ *****************************************************************************/
+
+#include "TestCheck.h"
+#include "RadarGeometry.h"
+#include <vector>
+
+static uint32_t s_seed = 31;
+
+static float RandomFloat(float lo, float hi)
+{
+    s_seed = s_seed * 1664525u + 1013904223u;
+    return lo + (hi - lo) * (float)(s_seed >> 8) / 16777216.0f;
+}
+
+// PlaceBatch against the scalar Clamp / IsInside / EdgePoint of the same shape: identical inside masks, positions
+// inside left alone, the rest on the edge where the scalar functions put them (within float rounding)
+template<RadarOrbitShape Shape>
+static void CheckPlaceBatch(const RadarOrbit& orbit)
+{
+    typedef RadarOrbitOps<Shape> Ops;
+    const int count = 4000;
+    std::vector<float> x(count), y(count), inX(count), inY(count);
+    std::vector<uint8_t> isDirection(count), inside(count, 9);
+    for (int i = 0; i < count; ++i)
+    {
+        isDirection[i] = (i % 5 == 0) ? 1 : 0;
+        if (isDirection[i])
+        {
+            const float angle = RandomFloat(-D3DX_PI, D3DX_PI);
+            x[i] = cosf(angle);
+            y[i] = sinf(angle);
+        }
+        else
+        {
+            x[i] = orbit.centerX + RandomFloat(-3.0f, 3.0f) * orbit.halfX;
+            y[i] = orbit.centerY + RandomFloat(-3.0f, 3.0f) * orbit.halfY;
+        }
+    }
+    // Exactly on the edges and at the centre
+    x[1] = orbit.centerX + orbit.halfX; y[1] = orbit.centerY;
+    x[2] = orbit.centerX; y[2] = orbit.centerY - orbit.halfY;
+    x[3] = orbit.centerX; y[3] = orbit.centerY;
+    inX = x;
+    inY = y;
+
+    Ops::PlaceBatch(orbit, x.data(), y.data(), isDirection.data(), count, inside.data());
+
+    const float tolerance = 1e-3f * (orbit.halfX > orbit.halfY ? orbit.halfX : orbit.halfY);
+    double worst = 0.0;
+    for (int i = 0; i < count; ++i)
+    {
+        float expectX, expectY;
+        bool expectInside = false;
+        if (isDirection[i])
+        {
+            Ops::EdgePoint(orbit, inX[i], inY[i], expectX, expectY);
+        }
+        else
+        {
+            expectInside = Ops::IsInside(orbit, inX[i], inY[i]);
+            expectX = inX[i];
+            expectY = inY[i];
+            if (!expectInside)
+                Ops::Clamp(orbit, inX[i], inY[i], expectX, expectY);
+        }
+        if (!CHECK(inside[i] == (expectInside ? 1 : 0)))
+            return;
+        if (expectInside && !CHECK(x[i] == inX[i] && y[i] == inY[i]))
+            return;
+        worst = std::fmax(worst, std::fmax(fabs(x[i] - expectX), fabs(y[i] - expectY)));
+        // Clamped points and directions end up on the edge
+        if (!expectInside)
+        {
+            const float dx = x[i] - orbit.centerX, dy = y[i] - orbit.centerY;
+            const float r = (orbit.halfX < orbit.halfY) ? orbit.halfX : orbit.halfY;
+            const float edgeError = (Shape == ORBIT_SQUARE) ? std::fmin(fabsf(fabsf(dx) - orbit.halfX), fabsf(fabsf(dy) - orbit.halfY))
+                                                            : fabsf(sqrtf(dx * dx + dy * dy) - r);
+            if (!CHECK(edgeError <= tolerance))
+                return;
+        }
+    }
+    CHECK(worst <= tolerance);
+}
+
+static void TestCirclePlaceBatch()
+{
+    const RadarOrbit orbits[] = { { 300.0f, 800.0f, 130.0f, 130.0f }, { 0.0f, 0.0f, 90.0f, 140.0f }, { 512.0f, 512.0f, 1.0f, 1.0f } };
+    for (const RadarOrbit& orbit : orbits)
+        CheckPlaceBatch<ORBIT_CIRCLE>(orbit);
+}
+
+static void TestSquarePlaceBatch()
+{
+    const RadarOrbit orbits[] = { { 300.0f, 800.0f, 130.0f, 130.0f }, { 0.0f, 0.0f, 200.0f, 90.0f }, { 512.0f, 512.0f, 1.0f, 1.0f } };
+    for (const RadarOrbit& orbit : orbits)
+        CheckPlaceBatch<ORBIT_SQUARE>(orbit);
+}
+
+// The bool-taking wrappers pick the same specialization
+static void TestWrappersForward()
+{
+    const RadarOrbit orbit = { 100.0f, 200.0f, 80.0f, 50.0f };
+    for (int i = 0; i < 1000; ++i)
+    {
+        const float px = RandomFloat(-200.0f, 400.0f), py = RandomFloat(-100.0f, 500.0f);
+        for (int square = 0; square < 2; ++square)
+        {
+            float ax, ay, bx, by;
+            RadarGeometry::ClampToOrbit(px, py, orbit.centerX, orbit.centerY, orbit.halfX, orbit.halfY, ax, ay, square != 0);
+            if (square)
+                RadarOrbitOps<ORBIT_SQUARE>::Clamp(orbit, px, py, bx, by);
+            else
+                RadarOrbitOps<ORBIT_CIRCLE>::Clamp(orbit, px, py, bx, by);
+            CHECK(ax == bx && ay == by);
+            CHECK(RadarGeometry::IsInsideOrbit(px, py, orbit.centerX, orbit.centerY, orbit.halfX, orbit.halfY, square != 0) ==
+                  (square ? RadarOrbitOps<ORBIT_SQUARE>::IsInside(orbit, px, py) : RadarOrbitOps<ORBIT_CIRCLE>::IsInside(orbit, px, py)));
+        }
+    }
+}
+
+int main()
+{
+    RUN_TEST(TestCirclePlaceBatch);
+    RUN_TEST(TestSquarePlaceBatch);
+    RUN_TEST(TestWrappersForward);
+    return TEST_RESULT();
+}
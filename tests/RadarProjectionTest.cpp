@@ -0,0 +1,183 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        tests/RadarProjectionTest.cpp
+ *****************************************************************************/
+
+#include "TestCheck.h"
+#include "RadarProjection.h"
+#include "MathUtils.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+static uint32_t s_seed = 2024;
+
+static float RandomFloat(float lo, float hi)
+{
+    s_seed = s_seed * 1664525u + 1013904223u;
+    return lo + (hi - lo) * (float)(s_seed >> 8) / 16777216.0f;
+}
+
+// Radar camera as CameraController::GetCachedCalculations sets it up
+struct TestCamera
+{
+    D3DXVECTOR3 pos;
+    D3DXVECTOR3 rot;
+    float       fov;
+};
+
+static const float NEAR_PLANE = 0.3f;
+static const float FAR_PLANE = 10000.0f;
+static const float SCREEN_W = 1024.0f;
+static const float SCREEN_H = 1024.0f;
+static const float ASPECT = 1080.0f / 1920.0f;
+
+static TestCamera RandomCamera()
+{
+    TestCamera camera;
+    camera.pos = D3DXVECTOR3(RandomFloat(-3000.0f, 3000.0f), RandomFloat(-3000.0f, 3000.0f), RandomFloat(150.0f, 1500.0f));
+    camera.rot = D3DXVECTOR3(RandomFloat(-70.0f, -5.0f) * D3DX_PI / 180.0f, 0.0f, RandomFloat(-D3DX_PI, D3DX_PI));
+    camera.fov = RandomFloat(40.0f, 90.0f) * D3DX_PI / 180.0f;
+    return camera;
+}
+
+// Separate view and projection transforms in double, as WorldToScreen did before RadarProjection.
+// Returns clip w, screen position through out.
+static double ReferenceProject(const TestCamera& camera, const D3DXVECTOR3& p, double& outX, double& outY, bool& outVisible)
+{
+    D3DXMATRIX view, proj;
+    MathUtils::BuildRadarViewProj(camera.pos, camera.rot, camera.fov, NEAR_PLANE, FAR_PLANE, ASPECT, view, proj);
+    double v[4], c[4];
+    for (int col = 0; col < 4; ++col)
+        v[col] = p.x * (double)view.m[0][col] + p.y * (double)view.m[1][col] + p.z * (double)view.m[2][col] + view.m[3][col];
+    for (int col = 0; col < 4; ++col)
+        c[col] = v[0] * proj.m[0][col] + v[1] * proj.m[1][col] + v[2] * proj.m[2][col] + v[3] * proj.m[3][col];
+    outVisible = c[3] > 0.0 && c[2] >= 0.0 && c[2] <= c[3];
+    outX = (c[0] / c[3] + 1.0) * 0.5 * SCREEN_W;
+    outY = (1.0 - c[1] / c[3]) * 0.5 * SCREEN_H;
+    return c[3];
+}
+
+// Project and WorldToScreen against the two-step reference: within 1e-4 of the screen size (NDC 2e-4), same visibility
+static void TestProjectMatchesReference()
+{
+    double worstNdc = 0.0;
+    int visibleCount = 0;
+    for (int cam = 0; cam < 200; ++cam)
+    {
+        const TestCamera camera = RandomCamera();
+        RadarProjection projection;
+        projection.Build(camera.pos, camera.rot, camera.fov, NEAR_PLANE, FAR_PLANE, SCREEN_W, SCREEN_H, ASPECT);
+        for (int i = 0; i < 500; ++i)
+        {
+            const D3DXVECTOR3 p(camera.pos.x + RandomFloat(-4000.0f, 4000.0f), camera.pos.y + RandomFloat(-4000.0f, 4000.0f), RandomFloat(-50.0f, 300.0f));
+            double refX, refY;
+            bool refVisible;
+            const double w = ReferenceProject(camera, p, refX, refY, refVisible);
+            // Visibility at the planes themselves depends on the last bit
+            if (fabs(w) < 1.0)
+                continue;
+
+            float x = 0.0f, y = 0.0f, wx = 0.0f, wy = 0.0f;
+            const bool visible = projection.Project(p, x, y);
+            const bool wtsVisible = MathUtils::WorldToScreen(p, camera.pos, camera.rot, camera.fov, NEAR_PLANE, FAR_PLANE,
+                                                             SCREEN_W, SCREEN_H, wx, wy, ASPECT);
+            if (!CHECK(visible == refVisible && wtsVisible == visible))
+                return;
+            if (!visible)
+                continue;
+            ++visibleCount;
+            CHECK(x == wx && y == wy);
+            // Relative to the screen size, and to the distance from the centre for points far off screen
+            const double scale = std::max(1.0, std::max(fabs(refX / SCREEN_W - 0.5), fabs(refY / SCREEN_H - 0.5)) * 2.0);
+            worstNdc = std::max(worstNdc, std::max(fabs(x - refX) / SCREEN_W, fabs(y - refY) / SCREEN_H) / scale);
+        }
+    }
+    printf("    %d visible points, worst error %.3g of the screen size\n", visibleCount, worstNdc);
+    CHECK(visibleCount > 10000);
+    CHECK(worstNdc <= 1e-4);
+}
+
+static void TestRejects()
+{
+    RadarProjection unbuilt;
+    float x, y;
+    CHECK(!unbuilt.Project(D3DXVECTOR3(0.0f, 0.0f, 0.0f), x, y));
+
+    // Straight down camera: the point under it is in the centre, the camera position itself is in front of the near plane
+    TestCamera camera = { D3DXVECTOR3(100.0f, 200.0f, 500.0f), D3DXVECTOR3(-D3DX_PI * 0.5f, 0.0f, 0.0f), D3DX_PI / 3.0f };
+    RadarProjection projection;
+    projection.Build(camera.pos, camera.rot, camera.fov, NEAR_PLANE, FAR_PLANE, SCREEN_W, SCREEN_H, ASPECT);
+    CHECK(!projection.Project(camera.pos + D3DXVECTOR3(0.0f, 0.0f, 100.0f), x, y));
+    CHECK(!projection.Project(camera.pos - D3DXVECTOR3(0.0f, 0.0f, 20000.0f), x, y));
+    CHECK(projection.GetScreenWidth() == SCREEN_W && projection.GetScreenHeight() == SCREEN_H);
+}
+
+static bool SameBits(float a, float b)
+{
+    return memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+// Every path bit-identical to Project, for counts around the 4 / 8 point steps, including points on and past the
+// near / far planes, behind the camera and NaN
+static void TestBatchPathsMatchProject()
+{
+    const RadarProjection::Path paths[] = { RadarProjection::PATH_AUTO, RadarProjection::PATH_SCALAR, RadarProjection::PATH_SSE,
+                                            RadarProjection::PATH_AVX };
+    for (int cam = 0; cam < 20; ++cam)
+    {
+        const TestCamera camera = RandomCamera();
+        RadarProjection projection;
+        projection.Build(camera.pos, camera.rot, camera.fov, NEAR_PLANE, FAR_PLANE, SCREEN_W, SCREEN_H, ASPECT);
+
+        RadarProjectionBatch batch;
+        for (int i = 0; i < 53; ++i)
+        {
+            D3DXVECTOR3 p(camera.pos.x + RandomFloat(-3000.0f, 3000.0f), camera.pos.y + RandomFloat(-3000.0f, 3000.0f), RandomFloat(-50.0f, 300.0f));
+            if (i % 11 == 3)
+                p = camera.pos;
+            else if (i % 17 == 5)
+                p.x = NAN;
+            batch.Add(p);
+        }
+
+        for (int count = 0; count <= batch.GetCount(); ++count)
+        {
+            std::vector<float> expectX(count), expectY(count);
+            std::vector<uint8_t> expectVisible(count);
+            for (int i = 0; i < count; ++i)
+                expectVisible[i] = projection.Project(D3DXVECTOR3(batch.x[i], batch.y[i], batch.z[i]), expectX[i], expectY[i]) ? 1 : 0;
+
+            for (RadarProjection::Path path : paths)
+            {
+                std::vector<float> outX(count + 1, -1.0f), outY(count + 1, -1.0f);
+                std::vector<uint8_t> outVisible(count + 1, 7);
+                projection.ProjectBatch(batch.x.data(), batch.y.data(), batch.z.data(), count, outX.data(), outY.data(), outVisible.data(), path);
+                bool same = outVisible[count] == 7 && outX[count] == -1.0f;
+                for (int i = 0; i < count; ++i)
+                    same = same && outVisible[i] == expectVisible[i] &&
+                           (!expectVisible[i] || (SameBits(outX[i], expectX[i]) && SameBits(outY[i], expectY[i])));
+                if (!CHECK(same))
+                {
+                    fprintf(stderr, "    count %d path %s\n", count, RadarProjection::GetPathName(path));
+                    return;
+                }
+            }
+        }
+
+        // Batch struct: sizes follow the inputs
+        projection.ProjectBatch(batch, RadarProjection::PATH_SSE);
+        CHECK(batch.screenX.size() == 53 && batch.screenY.size() == 53 && batch.visible.size() == 53);
+    }
+
+    CHECK(RadarProjection::GetBestPath() != RadarProjection::PATH_AUTO);
+    CHECK(strcmp(RadarProjection::GetPathName(RadarProjection::PATH_SCALAR), "scalar") == 0);
+}
+
+int main()
+{
+    RUN_TEST(TestProjectMatchesReference);
+    RUN_TEST(TestRejects);
+    RUN_TEST(TestBatchPathsMatchProject);
+    return TEST_RESULT();
+}
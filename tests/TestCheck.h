@@ -0,0 +1,61 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        tests/TestCheck.h
+ *****************************************************************************/
+
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+
+// Checks for the headless tests: a failed check prints where and what and the test exits non-zero at the end
+// (TEST_RESULT), so one run lists every failure
+inline int& TestFailures()
+{
+    static int s_failures = 0;
+    return s_failures;
+}
+
+inline bool TestFail(const char* file, int line, const char* what)
+{
+    fprintf(stderr, "%s:%d: check failed: %s\n", file, line, what);
+    ++TestFailures();
+    return false;
+}
+
+#define CHECK(cond) ((cond) ? true : TestFail(__FILE__, __LINE__, #cond))
+
+#define CHECK_EQ(a, b)                                                                                     \
+    do                                                                                                     \
+    {                                                                                                      \
+        const auto checkA = (a);                                                                           \
+        const auto checkB = (b);                                                                           \
+        if (!(checkA == checkB))                                                                           \
+        {                                                                                                  \
+            TestFail(__FILE__, __LINE__, #a " == " #b);                                                    \
+            fprintf(stderr, "    %.9g vs %.9g\n", (double)checkA, (double)checkB);                         \
+        }                                                                                                  \
+    } while (0)
+
+#define CHECK_NEAR(a, b, tolerance)                                                                        \
+    do                                                                                                     \
+    {                                                                                                      \
+        const double checkA = (double)(a);                                                                 \
+        const double checkB = (double)(b);                                                                 \
+        if (!(std::fabs(checkA - checkB) <= (double)(tolerance)))                                          \
+        {                                                                                                  \
+            TestFail(__FILE__, __LINE__, #a " ~= " #b);                                                    \
+            fprintf(stderr, "    %.9g vs %.9g (tolerance %.3g)\n", checkA, checkB, (double)(tolerance));   \
+        }                                                                                                  \
+    } while (0)
+
+// Runs one test function and names it in the output
+#define RUN_TEST(test)                                                                                     \
+    do                                                                                                     \
+    {                                                                                                      \
+        const int failuresBefore = TestFailures();                                                         \
+        test();                                                                                            \
+        printf("%s %s\n", (TestFailures() == failuresBefore) ? "ok  " : "FAIL", #test);                    \
+    } while (0)
+
+#define TEST_RESULT() (TestFailures() == 0 ? 0 : 1)
@@ -0,0 +1,54 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        tests/bench/Bench.h
+ *****************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+// Timing helpers for the headless benchmarks. --quick (CTest) cuts the repetitions so a run only checks
+// that the benchmark still works.
+class Bench
+{
+public:
+    static bool IsQuick(int argc, char** argv)
+    {
+        for (int i = 1; i < argc; ++i)
+            if (strcmp(argv[i], "--quick") == 0)
+                return true;
+        return false;
+    }
+
+    static double NowMicros()
+    {
+        using Clock = std::chrono::steady_clock;
+        return std::chrono::duration<double, std::micro>(Clock::now().time_since_epoch()).count();
+    }
+
+    // Best of `runs` timings of body() in microseconds: the least disturbed run
+    template<typename F>
+    static double BestMicros(int runs, F&& body)
+    {
+        double best = 0.0;
+        for (int run = 0; run < runs; ++run)
+        {
+            const double start = NowMicros();
+            body();
+            const double elapsed = NowMicros() - start;
+            if (run == 0 || elapsed < best)
+                best = elapsed;
+        }
+        return best;
+    }
+};
+
+// Keeps a result alive so the optimizer cannot drop the work producing it
+template<typename T>
+inline void BenchKeep(const T& value)
+{
+    static volatile T s_sink;
+    s_sink = value;
+}
@@ -0,0 +1,135 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        tests/bench/BlipGridBench.cpp
+ *****************************************************************************/
+
+#include "Bench.h"
+#include "BlipGrid.h"
+#include <cmath>
+#include <vector>
+
+// One radar frame over the 6000 x 6000 map: the moving blips (one in five, vehicle speeds) are moved in the grid,
+// then the blips inside the radar footprint are found through BlipGrid::Query against testing every blip; the
+// lookup is also timed alone.
+// Store-sized populations and far past them; cell changes show what the looseness saves.
+int main(int argc, char** argv)
+{
+    const bool quick = Bench::IsQuick(argc, argv);
+    const int counts[] = { 250, 5000, 50000 };
+    const float half = 450.0f;      // footprint half size at the default zoom
+    for (int count : counts)
+    {
+        std::vector<float> x(count), y(count), dirX(count), dirY(count);
+        std::vector<uint8_t> moving(count);
+        uint32_t seed = 5;
+        auto random = [&seed](float range) {
+            seed = seed * 1664525u + 1013904223u;
+            return (float)(seed >> 8) / 16777216.0f * range;
+        };
+        for (int i = 0; i < count; ++i)
+        {
+            x[i] = random(6000.0f);
+            y[i] = random(6000.0f) - 6000.0f;
+            moving[i] = (i % 5 == 0) ? 1 : 0;
+            const float angle = random(6.2831853f), speed = 0.5f + random(2.5f);
+            dirX[i] = cosf(angle) * speed;
+            dirY[i] = sinf(angle) * speed;
+        }
+
+        const int frames = quick ? 4 : 20000000 / count + 200;
+        auto cameraX = [](int f) { return 3000.0f + 2400.0f * sinf(f * 0.003f); };
+        auto cameraY = [](int f) { return -3000.0f + 2400.0f * cosf(f * 0.0037f); };
+
+        // Moving blips bounce off the map edges so long runs stay on the map
+        BlipGrid grid;
+        std::vector<float> px, py, dx, dy;
+        auto step = [&](int i) {
+            px[i] += dx[i];
+            py[i] += dy[i];
+            if (px[i] < 0.0f || px[i] > 6000.0f)
+                dx[i] = -dx[i];
+            if (py[i] < -6000.0f || py[i] > 0.0f)
+                dy[i] = -dy[i];
+        };
+        long long cellChanges = 0, hits = 0, candidates = 0;
+        const double gridMicros = Bench::BestMicros(quick ? 1 : 3, [&] {
+            grid.Clear();
+            px = x;
+            py = y;
+            dx = dirX;
+            dy = dirY;
+            for (int i = 0; i < count; ++i)
+                grid.Insert(i, px[i], py[i]);
+            cellChanges = hits = candidates = 0;
+            for (int f = 0; f < frames; ++f)
+            {
+                for (int i = 0; i < count; i += 5)
+                {
+                    step(i);
+                    const int cell = grid.GetCell(i);
+                    grid.Move(i, px[i], py[i]);
+                    cellChanges += (grid.GetCell(i) != cell) ? 1 : 0;
+                }
+                const float minX = cameraX(f) - half, maxX = cameraX(f) + half;
+                const float minY = cameraY(f) - half, maxY = cameraY(f) + half;
+                grid.Query(minX, minY, maxX, maxY, [&](uint16_t slot) {
+                    ++candidates;
+                    hits += (px[slot] >= minX && px[slot] <= maxX && py[slot] >= minY && py[slot] <= maxY) ? 1 : 0;
+                });
+            }
+        });
+        BenchKeep(hits);
+
+        long long scanHits = 0;
+        const double scanMicros = Bench::BestMicros(quick ? 1 : 3, [&] {
+            px = x;
+            py = y;
+            dx = dirX;
+            dy = dirY;
+            scanHits = 0;
+            for (int f = 0; f < frames; ++f)
+            {
+                for (int i = 0; i < count; i += 5)
+                {
+                    step(i);
+                }
+                const float minX = cameraX(f) - half, maxX = cameraX(f) + half;
+                const float minY = cameraY(f) - half, maxY = cameraY(f) + half;
+                for (int i = 0; i < count; ++i)
+                    scanHits += (px[i] >= minX && px[i] <= maxX && py[i] >= minY && py[i] <= maxY) ? 1 : 0;
+            }
+        });
+        BenchKeep(scanHits);
+
+        // The lookups alone, blips where the last run left them
+        long long queryHits = 0, queryScanHits = 0;
+        const double queryMicros = Bench::BestMicros(quick ? 1 : 3, [&] {
+            for (int f = 0; f < frames; ++f)
+            {
+                const float minX = cameraX(f) - half, maxX = cameraX(f) + half;
+                const float minY = cameraY(f) - half, maxY = cameraY(f) + half;
+                grid.Query(minX, minY, maxX, maxY, [&](uint16_t slot) {
+                    queryHits += (px[slot] >= minX && px[slot] <= maxX && py[slot] >= minY && py[slot] <= maxY) ? 1 : 0;
+                });
+            }
+        });
+        const double queryScanMicros = Bench::BestMicros(quick ? 1 : 3, [&] {
+            for (int f = 0; f < frames; ++f)
+            {
+                const float minX = cameraX(f) - half, maxX = cameraX(f) + half;
+                const float minY = cameraY(f) - half, maxY = cameraY(f) + half;
+                for (int i = 0; i < count; ++i)
+                    queryScanHits += (px[i] >= minX && px[i] <= maxX && py[i] >= minY && py[i] <= maxY) ? 1 : 0;
+            }
+        });
+        BenchKeep(queryHits + queryScanHits);
+
+        printf("%6d blips (%d moving): grid %8.2f us/frame, scan %8.2f us/frame; %.1f in view, %.1f candidates, "
+               "%.2f%% of moves change cell%s\n",
+               count, count / 5, gridMicros / frames, scanMicros / frames, (double)hits / frames,
+               (double)candidates / frames, 100.0 * cellChanges / ((double)frames * ((count + 4) / 5)),
+               (hits == scanHits) ? "" : "  MISMATCH");
+        printf("%6s lookup only: grid %8.2f us/frame, scan %8.2f us/frame\n", "", queryMicros / frames, queryScanMicros / frames);
+    }
+    return 0;
+}
@@ -0,0 +1,168 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        tests/bench/BlipSyncBench.cpp
+ *****************************************************************************/
+
+#include "Bench.h"
+#include "BlipSlotSync.h"
+#include <vector>
+
+// Same layout as the trace stand-in in BlipSlotSyncTest
+struct BenchTrace
+{
+    uint32_t counter;
+    uint8_t  inUse;
+    uint8_t  icon;
+    uint8_t  vehicleBlip;
+    uint8_t  reserved;
+    int32_t  entity;
+    float    x;
+    float    y;
+    uint32_t colour;
+};
+
+struct BenchSource
+{
+    const D3DXVECTOR3* entities;
+
+    bool Build(int, const uint8_t* record, Blip& outBlip, bool& outFollows)
+    {
+        const BenchTrace& trace = *(const BenchTrace*)record;
+        outFollows = trace.vehicleBlip && entities[trace.entity].x >= 0.0f;
+        if (!trace.inUse)
+            return false;
+        outBlip.position = outFollows ? entities[trace.entity] : D3DXVECTOR3(trace.x, trace.y, 0.1f);
+        outBlip.iconId = outFollows ? 0 : trace.icon;
+        outBlip.size = 8.0f;
+        outBlip.color = trace.colour;
+        outBlip.enabled = true;
+        outBlip.shortRange = false;
+        return true;
+    }
+
+    BlipSlotSync::FollowResult Follow(int, const uint8_t* record, bool follows, D3DXVECTOR3& outPosition)
+    {
+        const BenchTrace& trace = *(const BenchTrace*)record;
+        if (!trace.inUse || !trace.vehicleBlip)
+            return BlipSlotSync::FOLLOW_STATIC;
+        const bool inPool = entities[trace.entity].x >= 0.0f;
+        if (inPool != follows)
+            return BlipSlotSync::FOLLOW_REBUILD;
+        if (!inPool)
+            return BlipSlotSync::FOLLOW_STATIC;
+        outPosition = entities[trace.entity];
+        return BlipSlotSync::FOLLOW_AT;
+    }
+};
+
+// A mission-heavy session: 250 trace slots (MAX_RADAR_TRACES), 175 in use, 24 of them on vehicles that drive every
+// frame and now and then leave the pool, plus a few scripted blips toggled or recoloured per frame.
+// The slot diff against clearing the store and adding every trace again each update.
+int main(int argc, char** argv)
+{
+    const bool quick = Bench::IsQuick(argc, argv);
+    const int SLOTS = 250;
+    const int VEHICLES = 24;
+    const int frames = quick ? 20 : 2000;
+
+    std::vector<BenchTrace> traces((size_t)SLOTS * frames);
+    std::vector<D3DXVECTOR3> entities((size_t)VEHICLES * frames);
+    memset(traces.data(), 0, traces.size() * sizeof(BenchTrace));
+    for (int i = 0; i < 175; ++i)
+    {
+        BenchTrace& trace = traces[i];
+        trace.counter = 1;
+        trace.inUse = 1;
+        trace.icon = (uint8_t)(2 + i % 60);
+        trace.x = 20.0f * i - 3000.0f;
+        trace.y = 3000.0f - 20.0f * i;
+        trace.colour = 0xFF000000u | (uint32_t)i;
+        if (i % 7 == 0 && i / 7 < VEHICLES)
+        {
+            trace.vehicleBlip = 1;
+            trace.entity = i / 7;
+        }
+    }
+    for (int v = 0; v < VEHICLES; ++v)
+        entities[v] = D3DXVECTOR3(100.0f * v, 50.0f * v, 10.0f);
+
+    uint32_t seed = 7;
+    auto random = [&seed](int range) {
+        seed = seed * 1664525u + 1013904223u;
+        return (int)((seed >> 8) % (uint32_t)range);
+    };
+    for (int f = 1; f < frames; ++f)
+    {
+        BenchTrace* frame = &traces[(size_t)f * SLOTS];
+        D3DXVECTOR3* frameEntities = &entities[(size_t)f * VEHICLES];
+        memcpy(frame, frame - SLOTS, SLOTS * sizeof(BenchTrace));
+        memcpy(frameEntities, frameEntities - VEHICLES, VEHICLES * sizeof(D3DXVECTOR3));
+        for (int v = 0; v < VEHICLES; ++v)
+        {
+            D3DXVECTOR3& entity = frameEntities[v];
+            if (random(300) == 0)
+                entity.x = (entity.x < 0.0f) ? (float)random(3000) : -1.0f;
+            else if (entity.x >= 0.0f)
+            {
+                entity.x += 0.5f;
+                entity.y += 0.25f;
+            }
+        }
+        for (int change = random(3); change > 0; --change)
+        {
+            BenchTrace& trace = frame[random(SLOTS)];
+            if (trace.vehicleBlip)
+                continue;
+            if (random(2) == 0)
+                trace.inUse ^= 1;
+            else
+                trace.colour ^= 0x0000FF00u;
+        }
+    }
+
+    BlipSlotSync sync;
+    BlipStore store;
+    BlipSlotSync::Stats total = {};
+    const double syncMicros = Bench::BestMicros(quick ? 1 : 5, [&] {
+        store.Clear();
+        sync.Reset(SLOTS, sizeof(BenchTrace));
+        total = BlipSlotSync::Stats();
+        for (int f = 0; f < frames; ++f)
+        {
+            BenchSource source = { &entities[(size_t)f * VEHICLES] };
+            sync.Sync((const uint8_t*)&traces[(size_t)f * SLOTS], store, source);
+            store.Compact();
+            const BlipSlotSync::Stats& stats = sync.GetStats();
+            total.added += stats.added;
+            total.removed += stats.removed;
+            total.updated += stats.updated;
+            total.untouched += stats.untouched;
+        }
+    });
+    BenchKeep(store.GetCount());
+
+    const double rebuildMicros = Bench::BestMicros(quick ? 1 : 5, [&] {
+        for (int f = 0; f < frames; ++f)
+        {
+            BenchSource source = { &entities[(size_t)f * VEHICLES] };
+            const uint8_t* frame = (const uint8_t*)&traces[(size_t)f * SLOTS];
+            store.Clear();
+            for (int i = 0; i < SLOTS; ++i)
+            {
+                Blip blip;
+                bool follows;
+                if (source.Build(i, frame + (size_t)i * sizeof(BenchTrace), blip, follows))
+                    store.Add(blip);
+            }
+        }
+    });
+    BenchKeep(store.GetCount());
+
+    // The first update adds everything in both cases; the averages skip it
+    const double updates = (double)(frames - 1);
+    printf("%d slots, %d updates: slot diff %6.2f us/update, full rebuild %6.2f us/update\n", SLOTS, frames,
+           syncMicros / frames, rebuildMicros / frames);
+    printf("per update: added %.2f  removed %.2f  updated %.2f  untouched %.2f\n", (total.added - 175) / updates,
+           total.removed / updates, total.updated / updates, (total.untouched - (SLOTS - 175)) / updates);
+    return 0;
+}
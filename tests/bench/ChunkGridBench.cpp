@@ -0,0 +1,58 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        tests/bench/ChunkGridBench.cpp
+ *****************************************************************************/
+
+#include "Bench.h"
+#include "ChunkGrid.h"
+#include <cmath>
+
+// Tiles within the camera radius per frame: distance test on every tile against the row / column range only,
+// for the 12x12 base grid and larger custom maps
+int main(int argc, char** argv)
+{
+    const bool quick = Bench::IsQuick(argc, argv);
+    const int sizes[] = { 12, 48, 192 };
+    const float radius = 1300.0f;   // ComputeVisibleRadius at the default camera, plus a tile diagonal
+    for (int size : sizes)
+    {
+        const ChunkGrid grid = { -3000.0f, 3000.0f, 6000.0f, 6000.0f, size };
+        const int frames = quick ? 4 : 2000000 / (size * size) + 100;
+        int visited = 0;
+
+        auto cameraX = [](int f) { return 2400.0f * sinf(f * 0.01f); };
+        auto cameraY = [](int f) { return 2400.0f * cosf(f * 0.013f); };
+        const double scanMicros = Bench::BestMicros(quick ? 1 : 5, [&] {
+            for (int f = 0; f < frames; ++f)
+            {
+                const float x = cameraX(f), y = cameraY(f);
+                for (int row = 0; row < size; ++row)
+                    for (int col = 0; col < size; ++col)
+                    {
+                        float cx, cy;
+                        grid.GetTileCenter(row, col, cx, cy);
+                        visited += ((cx - x) * (cx - x) + (cy - y) * (cy - y) <= radius * radius) ? 1 : 0;
+                    }
+            }
+        });
+        const double rangeMicros = Bench::BestMicros(quick ? 1 : 5, [&] {
+            for (int f = 0; f < frames; ++f)
+            {
+                const float x = cameraX(f), y = cameraY(f);
+                int rowMin, rowMax, colMin, colMax;
+                if (!grid.GetRangeInRadius(x, y, radius, rowMin, rowMax, colMin, colMax))
+                    continue;
+                for (int row = rowMin; row <= rowMax; ++row)
+                    for (int col = colMin; col <= colMax; ++col)
+                    {
+                        float cx, cy;
+                        grid.GetTileCenter(row, col, cx, cy);
+                        visited += ((cx - x) * (cx - x) + (cy - y) * (cy - y) <= radius * radius) ? 1 : 0;
+                    }
+            }
+        });
+        BenchKeep(visited);
+        printf("%3dx%-3d grid: full scan %8.2f us/frame, range %6.2f us/frame\n", size, size, scanMicros / frames, rangeMicros / frames);
+    }
+    return 0;
+}
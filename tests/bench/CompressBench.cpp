@@ -0,0 +1,84 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        tests/bench/CompressBench.cpp
+ *****************************************************************************/
+
+#include "Bench.h"
+#include "ChunkCompress.h"
+#include "ChunkMipChain.h"
+#include <cmath>
+#include <vector>
+
+static ChunkPixels MakeTile(int size, int kind)
+{
+    ChunkPixels tile = {};
+    tile.width = size;
+    tile.height = size;
+    tile.pitch = size * 4;
+    tile.levels = 1;
+    tile.format = CHUNK_FORMAT_BGRA8;
+    tile.data.resize((size_t)size * size * 4);
+    uint32_t seed = 7;
+    for (int y = 0; y < size; ++y)
+    {
+        for (int x = 0; x < size; ++x)
+        {
+            uint8_t* t = &tile.data[((size_t)y * size + x) * 4];
+            const float v = 0.5f + 0.25f * sinf(x * 0.05f) * cosf(y * 0.07f) + 0.25f * sinf((x + y) * 0.011f);
+            seed = seed * 1664525u + 1013904223u;
+            switch (kind)
+            {
+            case 0: // gradient
+                t[0] = (uint8_t)(x * 255 / size);
+                t[1] = (uint8_t)(y * 255 / size);
+                t[2] = (uint8_t)((x + y) * 255 / (2 * size));
+                t[3] = 255;
+                break;
+            case 1: // smooth terrain
+            case 2: // smooth terrain, alpha fade
+                t[0] = (uint8_t)(60 + v * 120);
+                t[1] = (uint8_t)(80 + v * 140);
+                t[2] = (uint8_t)(40 + v * 100);
+                t[3] = (kind == 2) ? (uint8_t)(255 - y * 255 / size) : 255;
+                break;
+            default: // noise, worst case
+                t[0] = (uint8_t)(seed >> 8);
+                t[1] = (uint8_t)(seed >> 16);
+                t[2] = (uint8_t)(seed >> 24);
+                t[3] = 255;
+                break;
+            }
+        }
+    }
+    return tile;
+}
+
+// DXT encode throughput on full 256x256 mip chains, and level 0 PSNR per kind of tile
+int main(int argc, char** argv)
+{
+    const bool quick = Bench::IsQuick(argc, argv);
+    const char* names[] = { "gradient", "terrain", "terrain+alpha", "noise" };
+    for (int kind = 0; kind < 4; ++kind)
+    {
+        ChunkPixels chain = MakeTile(256, kind);
+        const ChunkPixels source = chain;
+        ChunkMipChain::Build(chain);
+
+        const int repeats = quick ? 1 : 16;
+        ChunkPixels work;
+        const double micros = Bench::BestMicros(quick ? 1 : 5, [&] {
+            for (int i = 0; i < repeats; ++i)
+            {
+                work = chain;
+                ChunkCompress::Compress(work);
+            }
+        });
+        BenchKeep(work.data.back());
+
+        const float psnr = ChunkCompress::ComputePsnr(source.data.data(), 256, 256, source.pitch, work.data.data(), work.format);
+        const double texels = (double)(chain.data.size() / 4) * repeats;
+        printf("%-14s %s: %7.1f us/chain, %6.1f Mtexel/s, level 0 PSNR %5.1f dB\n", names[kind],
+               work.format == CHUNK_FORMAT_DXT5 ? "DXT5" : "DXT1", micros / repeats, texels / micros, psnr);
+    }
+    return 0;
+}
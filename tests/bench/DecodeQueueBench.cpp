@@ -0,0 +1,113 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        tests/bench/DecodeQueueBench.cpp
+ *****************************************************************************/
+
+#include "Bench.h"
+#include "ChunkDecodeQueue.h"
+#include "ChunkMipChain.h"
+#include "PixelConvert.h"
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// Main thread time per frame while every map tile is requested at once (start, d3dReset): converting inline
+// against the worker pool with a budgeted upload queue. The fake upload copies the chain like LockRect would.
+static const int TILE_SIZE = 256;
+
+class CopyUploader : public IChunkUploader
+{
+public:
+    std::vector<uint8_t> texture;
+
+    ChunkUploadResult Upload(int, const ChunkPixels& pixels) override
+    {
+        texture.assign(pixels.data.begin(), pixels.data.end());
+        return CHUNK_UPLOADED;
+    }
+    void OnDecodeFailed(int) override {}
+};
+
+static bool DecodeTile(const std::vector<uint8_t>& rgba, ChunkPixels& out)
+{
+    out.width = TILE_SIZE;
+    out.height = TILE_SIZE;
+    out.pitch = TILE_SIZE * 4;
+    out.levels = 1;
+    out.format = CHUNK_FORMAT_BGRA8;
+    out.data.resize((size_t)out.pitch * TILE_SIZE);
+    PixelConvert::SwapRedBlue(rgba.data(), out.pitch, out.data.data(), out.pitch, TILE_SIZE, TILE_SIZE);
+    return ChunkMipChain::Build(out);
+}
+
+struct FrameTimes
+{
+    double worstMicros;
+    double totalMicros;
+    int    frames;
+};
+
+static FrameTimes RunInline(const std::vector<uint8_t>& rgba, int tiles)
+{
+    CopyUploader uploader;
+    const double start = Bench::NowMicros();
+    for (int i = 0; i < tiles; ++i)
+    {
+        ChunkPixels pixels = {};
+        DecodeTile(rgba, pixels);
+        uploader.Upload(i, pixels);
+    }
+    const double elapsed = Bench::NowMicros() - start;
+    return { elapsed, elapsed, 1 };
+}
+
+static FrameTimes RunQueued(const std::vector<uint8_t>& rgba, int tiles, int uploadsPerFrame, unsigned int budgetMicros)
+{
+    ChunkDecodeQueue queue;
+    queue.Start();
+    CopyUploader uploader;
+    FrameTimes times = {};
+
+    double start = Bench::NowMicros();
+    for (int i = 0; i < tiles; ++i)
+        queue.Submit(i, [&rgba](ChunkPixels& out) { return DecodeTile(rgba, out); }, [] {});
+    int done = 0;
+    for (;;)
+    {
+        done += queue.DrainUploads(uploader, uploadsPerFrame, budgetMicros);
+        const double elapsed = Bench::NowMicros() - start;
+        times.worstMicros = (std::max)(times.worstMicros, elapsed);
+        times.totalMicros += elapsed;
+        ++times.frames;
+        if (done >= tiles)
+            break;
+
+        // Rest of a 60 fps frame, during which the workers keep decoding
+        std::this_thread::sleep_for(std::chrono::microseconds((long long)(std::max)(0.0, 16667.0 - elapsed)));
+        start = Bench::NowMicros();
+    }
+    return times;
+}
+
+int main(int argc, char** argv)
+{
+    const int tiles = Bench::IsQuick(argc, argv) ? 16 : 144;
+    std::vector<uint8_t> rgba((size_t)TILE_SIZE * TILE_SIZE * 4);
+    for (size_t i = 0; i < rgba.size(); ++i)
+        rgba[i] = (uint8_t)(i * 7 + (i >> 10));
+
+    printf("%d tiles of %dx%d, mip chain, %s pixel path\n", tiles, TILE_SIZE, TILE_SIZE,
+           PixelConvert::GetPathName(PixelConvert::GetBestPath()));
+    const FrameTimes inlineTimes = RunInline(rgba, tiles);
+    printf("inline:            1 frame, %8.0f us on the main thread\n", inlineTimes.worstMicros);
+
+    const int budgets[][2] = { { 4, 0 }, { 0, 2000 }, { 8, 1000 } };
+    for (const auto& budget : budgets)
+    {
+        const FrameTimes times = RunQueued(rgba, tiles, budget[0], (unsigned int)budget[1]);
+        printf("queue %2d / %4d us: %3d frames, worst %6.0f us, mean %6.0f us on the main thread\n", budget[0], budget[1],
+               times.frames, times.worstMicros, times.totalMicros / times.frames);
+    }
+    return 0;
+}
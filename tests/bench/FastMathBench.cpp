@@ -0,0 +1,62 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        tests/bench/FastMathBench.cpp
+ *****************************************************************************/
+
+#include "Bench.h"
+#include "FastMath.h"
+#include <vector>
+
+// Nanoseconds per value: libm sinf + cosf / atan2f against FastMath scalar and batch, on 4096 radar-range angles
+int main(int argc, char** argv)
+{
+    const bool quick = Bench::IsQuick(argc, argv);
+    const int count = 4096;
+    std::vector<float> angles(count), y(count), x(count), outA(count), outB(count);
+    for (int i = 0; i < count; ++i)
+    {
+        angles[i] = (float)((i * 7919) % 20000) * 0.001f - 10.0f;
+        y[i] = (float)((i * 131) % 2000) - 1000.0f;
+        x[i] = (float)((i * 197) % 2000) - 1000.0f;
+    }
+
+    const int repeats = quick ? 1 : 500;
+    const double values = (double)repeats * count / 1000.0;
+    auto report = [&](const char* name, double micros) { printf("%-22s %6.2f ns/value\n", name, micros / values); };
+
+    report("sinf + cosf", Bench::BestMicros(quick ? 1 : 5, [&] {
+        for (int r = 0; r < repeats; ++r)
+            for (int i = 0; i < count; ++i)
+            {
+                outA[i] = sinf(angles[i]);
+                outB[i] = cosf(angles[i]);
+            }
+    }));
+    report("FastMath::SinCos", Bench::BestMicros(quick ? 1 : 5, [&] {
+        for (int r = 0; r < repeats; ++r)
+            for (int i = 0; i < count; ++i)
+                FastMath::SinCos(angles[i], outA[i], outB[i]);
+    }));
+    report("FastMath::SinCosBatch", Bench::BestMicros(quick ? 1 : 5, [&] {
+        for (int r = 0; r < repeats; ++r)
+            FastMath::SinCosBatch(angles.data(), count, outA.data(), outB.data());
+    }));
+    BenchKeep(outA[count / 2] + outB[count / 3]);
+
+    report("atan2f", Bench::BestMicros(quick ? 1 : 5, [&] {
+        for (int r = 0; r < repeats; ++r)
+            for (int i = 0; i < count; ++i)
+                outA[i] = atan2f(y[i], x[i]);
+    }));
+    report("FastMath::Atan2", Bench::BestMicros(quick ? 1 : 5, [&] {
+        for (int r = 0; r < repeats; ++r)
+            for (int i = 0; i < count; ++i)
+                outA[i] = FastMath::Atan2(y[i], x[i]);
+    }));
+    report("FastMath::Atan2Batch", Bench::BestMicros(quick ? 1 : 5, [&] {
+        for (int r = 0; r < repeats; ++r)
+            FastMath::Atan2Batch(y.data(), x.data(), count, outA.data());
+    }));
+    BenchKeep(outA[count / 2]);
+    return 0;
+}
@@ -0,0 +1,100 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        tests/bench/FootprintBench.cpp
+ *****************************************************************************/
+
+#include "Bench.h"
+#include "RadarGeometry.h"
+#include "MathUtils.h"
+#include <vector>
+
+// Tile culling per frame over a 12x12 and 48x48 grid: four WorldToScreen corner calls per tile (before the
+// footprint) against one BuildFootprint per frame and FootprintOverlapsRect per tile; then blip point culling
+int main(int argc, char** argv)
+{
+    const bool quick = Bench::IsQuick(argc, argv);
+    const D3DXVECTOR3 cameraPos(250.0f, -1200.0f, 445.0f);
+    const D3DXVECTOR3 cameraRot(-26.0f * D3DX_PI / 180.0f, 0.0f, 0.6f);
+    const float fov = 70.0f * D3DX_PI / 180.0f;
+    const float nearPlane = 0.3f, farPlane = 10000.0f, width = 1024.0f, height = 1024.0f, aspect = 0.5625f;
+
+    const int grids[] = { 12, 48 };
+    for (int grid : grids)
+    {
+        const float tile = 6000.0f / grid;
+        const int frames = quick ? 1 : 20000 / grid;
+        int kept = 0;
+
+        const double cornerMicros = Bench::BestMicros(quick ? 1 : 5, [&] {
+            for (int f = 0; f < frames; ++f)
+                for (int row = 0; row < grid; ++row)
+                    for (int col = 0; col < grid; ++col)
+                    {
+                        const float minX = -3000.0f + col * tile, maxY = 3000.0f - row * tile;
+                        const D3DXVECTOR3 corners[4] = { { minX, maxY - tile, 0.1f }, { minX + tile, maxY - tile, 0.1f },
+                                                         { minX + tile, maxY, 0.1f }, { minX, maxY, 0.1f } };
+                        for (const D3DXVECTOR3& corner : corners)
+                        {
+                            float sx, sy;
+                            if (MathUtils::WorldToScreen(corner, cameraPos, cameraRot, fov, nearPlane, farPlane, width, height, sx, sy, aspect))
+                            {
+                                ++kept;
+                                break;
+                            }
+                        }
+                    }
+        });
+        const double footprintMicros = Bench::BestMicros(quick ? 1 : 5, [&] {
+            for (int f = 0; f < frames; ++f)
+            {
+                RadarProjection projection;
+                projection.Build(cameraPos, cameraRot, fov, nearPlane, farPlane, width, height, aspect);
+                RadarFootprint footprint;
+                RadarGeometry::BuildFootprint(projection, 0.0f, 1.0f, footprint);
+                for (int row = 0; row < grid; ++row)
+                    for (int col = 0; col < grid; ++col)
+                    {
+                        const float minX = -3000.0f + col * tile, maxY = 3000.0f - row * tile;
+                        kept += RadarGeometry::FootprintOverlapsRect(footprint, minX, maxY - tile, minX + tile, maxY) ? 1 : 0;
+                    }
+            }
+        });
+        BenchKeep(kept);
+        printf("%2dx%-2d tiles: corner WorldToScreen %8.2f us/frame, footprint %6.2f us/frame\n", grid, grid,
+               cornerMicros / frames, footprintMicros / frames);
+    }
+
+    // Blip culling: Project and a render target bounds check per blip against FootprintContains
+    RadarProjection projection;
+    projection.Build(cameraPos, cameraRot, fov, nearPlane, farPlane, width, height, aspect);
+    RadarFootprint footprint;
+    RadarGeometry::BuildFootprint(projection, 0.2f, 16.0f, footprint);
+    const int blipCounts[] = { 250, 5000 };
+    for (int count : blipCounts)
+    {
+        std::vector<D3DXVECTOR3> blips(count);
+        for (int i = 0; i < count; ++i)
+            blips[i] = D3DXVECTOR3(cameraPos.x + (float)((i * 37) % 4000) - 2000.0f, cameraPos.y + (float)((i * 91) % 4000) - 1500.0f, 0.2f);
+
+        const int frames = quick ? 1 : 2000000 / count;
+        int kept = 0;
+        const double projectMicros = Bench::BestMicros(quick ? 1 : 5, [&] {
+            for (int f = 0; f < frames; ++f)
+                for (const D3DXVECTOR3& p : blips)
+                {
+                    float sx, sy;
+                    if (projection.Project(p, sx, sy) && sx >= -16.0f && sx <= width + 16.0f && sy >= -16.0f && sy <= height + 16.0f)
+                        ++kept;
+                }
+        });
+        const double containsMicros = Bench::BestMicros(quick ? 1 : 5, [&] {
+            for (int f = 0; f < frames; ++f)
+                for (const D3DXVECTOR3& p : blips)
+                    kept += RadarGeometry::FootprintContains(footprint, p.x, p.y) ? 1 : 0;
+        });
+        BenchKeep(kept);
+        printf("%5d blips: Project + bounds %6.2f ns/blip, FootprintContains %6.2f ns/blip\n", count,
+               projectMicros * 1000.0 / ((double)frames * count), containsMicros * 1000.0 / ((double)frames * count));
+    }
+    return 0;
+}
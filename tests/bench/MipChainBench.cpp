@@ -0,0 +1,43 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        tests/bench/MipChainBench.cpp
+ *****************************************************************************/
+
+#include "Bench.h"
+#include "ChunkMipChain.h"
+#include <vector>
+
+// Mip chain throughput: level 0 megabytes filtered per second, per tile size
+int main(int argc, char** argv)
+{
+    const bool quick = Bench::IsQuick(argc, argv);
+    const int sizes[] = { 128, 256, 512, 1024 };
+    for (int size : sizes)
+    {
+        ChunkPixels tile = {};
+        tile.width = size;
+        tile.height = size;
+        tile.pitch = size * 4;
+        tile.levels = 1;
+        tile.format = CHUNK_FORMAT_BGRA8;
+        tile.data.resize((size_t)size * size * 4);
+        for (size_t i = 0; i < tile.data.size(); ++i)
+            tile.data[i] = (uint8_t)(i * 13 + (i >> 9));
+
+        const int repeats = quick ? 1 : (4096 * 4096) / (size * size);
+        ChunkPixels work = tile;
+        const double micros = Bench::BestMicros(quick ? 1 : 5, [&] {
+            for (int i = 0; i < repeats; ++i)
+            {
+                work.data.resize(tile.data.size());
+                work.levels = 1;
+                ChunkMipChain::Build(work);
+            }
+        });
+        BenchKeep(work.data.back());
+        const double megabytes = (double)tile.data.size() * repeats / (1024.0 * 1024.0);
+        printf("%4dx%-4d %2d levels: %7.1f us/tile, %6.0f MB/s of level 0\n", size, size, work.levels, micros / repeats,
+               megabytes / (micros * 1e-6));
+    }
+    return 0;
+}
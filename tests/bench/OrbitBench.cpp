@@ -0,0 +1,72 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        tests/bench/OrbitBench.cpp
+ *****************************************************************************/
+
+#include "Bench.h"
+#include "RadarGeometry.h"
+#include <vector>
+
+// Placing overlay icons on the orbit: per icon IsInsideOrbit + ClampToOrbit / PointOnOrbitEdge with the shape
+// branch, against RadarOrbitOps<Shape>::PlaceBatch over the SoA arrays. One icon in 8 is a direction.
+int main(int argc, char** argv)
+{
+    const bool quick = Bench::IsQuick(argc, argv);
+    const RadarOrbit orbit = { 300.0f, 800.0f, 130.0f, 110.0f };
+    const int counts[] = { 250, 2000 };
+    for (int count : counts)
+    {
+        std::vector<float> srcX(count), srcY(count), x(count), y(count);
+        std::vector<uint8_t> isDirection(count), inside(count);
+        for (int i = 0; i < count; ++i)
+        {
+            isDirection[i] = (i % 8 == 0) ? 1 : 0;
+            const float angle = i * 0.37f;
+            const float dist = isDirection[i] ? 1.0f : 40.0f + (float)((i * 53) % 300);
+            srcX[i] = (isDirection[i] ? 0.0f : orbit.centerX) + cosf(angle) * dist;
+            srcY[i] = (isDirection[i] ? 0.0f : orbit.centerY) + sinf(angle) * dist;
+        }
+
+        const int frames = quick ? 1 : 4000000 / count;
+        for (int square = 0; square < 2; ++square)
+        {
+            const bool useSquare = square != 0;
+            int insideCount = 0;
+            const double scalarMicros = Bench::BestMicros(quick ? 1 : 5, [&] {
+                for (int f = 0; f < frames; ++f)
+                    for (int i = 0; i < count; ++i)
+                    {
+                        if (isDirection[i])
+                        {
+                            RadarGeometry::PointOnOrbitEdge(orbit.centerX, orbit.centerY, orbit.halfX, orbit.halfY, srcX[i], srcY[i], useSquare, x[i], y[i]);
+                            continue;
+                        }
+                        if (RadarGeometry::IsInsideOrbit(srcX[i], srcY[i], orbit.centerX, orbit.centerY, orbit.halfX, orbit.halfY, useSquare))
+                        {
+                            x[i] = srcX[i];
+                            y[i] = srcY[i];
+                            ++insideCount;
+                        }
+                        else
+                            RadarGeometry::ClampToOrbit(srcX[i], srcY[i], orbit.centerX, orbit.centerY, orbit.halfX, orbit.halfY, x[i], y[i], useSquare);
+                    }
+            });
+            const double batchMicros = Bench::BestMicros(quick ? 1 : 5, [&] {
+                for (int f = 0; f < frames; ++f)
+                {
+                    x = srcX;
+                    y = srcY;
+                    if (useSquare)
+                        RadarOrbitOps<ORBIT_SQUARE>::PlaceBatch(orbit, x.data(), y.data(), isDirection.data(), count, inside.data());
+                    else
+                        RadarOrbitOps<ORBIT_CIRCLE>::PlaceBatch(orbit, x.data(), y.data(), isDirection.data(), count, inside.data());
+                }
+            });
+            BenchKeep(insideCount + inside[count / 2]);
+            printf("%4d icons %-6s: per icon %6.2f ns/icon, PlaceBatch %5.2f ns/icon (copy in included)\n", count,
+                   useSquare ? "square" : "circle", scalarMicros * 1000.0 / ((double)frames * count),
+                   batchMicros * 1000.0 / ((double)frames * count));
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,119 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        tests/bench/PageWalkBench.cpp
+ *****************************************************************************/
+
+#include "Bench.h"
+#include "ChunkPageWalker.h"
+#include "RadarGeometry.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+static const float MAP_SIZE = 6000.0f;
+static const float SCREEN = 1024.0f;
+
+// Coarse levels complete, level 0 resident as the replay streams it
+class BenchPageSource : public IChunkPageSource
+{
+public:
+    explicit BenchPageSource(int gridSize)
+        : m_resident(gridSize * gridSize, false)
+        , m_lastDrawn(gridSize * gridSize, -1)
+        , m_frame(0)
+    {
+    }
+
+    bool IsLevelComplete(int level) const override { return level >= 1 && level <= ChunkPyramid::MAX_LEVELS; }
+    ChunkPage GetPage(int level, int index) const override
+    {
+        const bool present = level > 0 || m_resident[index];
+        const ChunkPage page = { present ? (ChunkTextureId)(index + 1) : 0, { 0.0f, 0.0f, 1.0f, 1.0f }, present ? index : -1 };
+        return page;
+    }
+    bool IsChunkUnavailable(int) const override { return false; }
+    bool IsBackgroundTile(int) const override { return false; }
+    void OnChunkMissing(int index, float distSq) override { m_missing.push_back(std::make_pair(distSq, index)); }
+    void OnChunkDrawn(int index) override { m_lastDrawn[index] = m_frame; }
+
+    std::vector<bool>                  m_resident;
+    std::vector<int>                   m_lastDrawn;
+    std::vector<std::pair<float, int>> m_missing;
+    int                                m_frame;
+};
+
+// MapVirtual over a camera path (drive, climb for a flight, hold still) at the base 12x12 grid and MapPack sized
+// grids, level 0 streamed in a few chunks per frame under a budget of a quarter of the map. Walk time per frame,
+// with the resident level 0 pages and the misses (drawn from a coarser level) per frame.
+int main(int argc, char** argv)
+{
+    const bool quick = Bench::IsQuick(argc, argv);
+    const int gridSizes[] = { 12, 24, 48 };
+    for (int gridSize : gridSizes)
+    {
+        ChunkPageWalker walker;
+        walker.SetLayout(gridSize, -3000.0f, 3000.0f, MAP_SIZE, MAP_SIZE);
+        BenchPageSource source(gridSize);
+        const int budget = gridSize * gridSize / 4;
+        const int frames = quick ? 20 : 2000;
+        const int top = gridSize >> ChunkPyramid::MAX_LEVELS;
+
+        double walkMicros = 0.0;
+        long long drawn = 0, misses = 0, resident = 0, residentNow = 0;
+        int drawCount = 0;
+        auto count = [&drawCount](const ChunkPageDraw&) { ++drawCount; };
+        for (int frame = 0; frame < frames; ++frame)
+        {
+            const float t = (float)(std::min)(frame, frames * 9 / 10) * 0.01f;
+            const D3DXVECTOR3 pos(2400.0f * sinf(t * 0.7f), 2400.0f * sinf(t * 0.45f + 1.0f),
+                                  445.0f + 1500.0f * (std::max)(0.0f, sinf(t * 0.6f)));
+            const D3DXVECTOR3 rot(-(26.0f + 50.0f * (std::max)(0.0f, sinf(t * 0.17f + 2.0f))) * D3DX_PI / 180.0f, 0.0f, -t * 1.3f);
+            const float fov = 70.0f * D3DX_PI / 180.0f;
+            RadarProjection projection;
+            projection.Build(pos, rot, fov, 0.3f, 10000.0f, SCREEN, SCREEN, 1080.0f / 1920.0f);
+            RadarFootprint footprint;
+            ChunkPageWalker::View view;
+            view.cameraX = pos.x;
+            view.cameraY = pos.y;
+            view.cameraZ = pos.z;
+            view.visibleRadius = pos.z * 3.0f;
+            view.pixelSizePerDistance = 2.0f * tanf(fov * 0.5f) / SCREEN;
+            view.texelSize = MAP_SIZE / gridSize / 256.0f;
+            view.maxLevel = ChunkPyramid::MAX_LEVELS;
+            view.footprint = RadarGeometry::BuildFootprint(projection, 0.0f, 1.0f, footprint) ? &footprint : nullptr;
+
+            source.m_frame = frame;
+            source.m_missing.clear();
+            drawCount = 0;
+            const double start = Bench::NowMicros();
+            walker.Walk(source, view, 0, top - 1, 0, top - 1, count);
+            walkMicros += Bench::NowMicros() - start;
+            drawn += walker.GetPagesDrawn();
+            misses += walker.GetPageMisses();
+
+            // Nearest misses first, 4 per frame; least recently drawn evicted over the budget
+            std::sort(source.m_missing.begin(), source.m_missing.end());
+            for (size_t i = 0; i < source.m_missing.size() && i < 4; ++i)
+            {
+                source.m_resident[source.m_missing[i].second] = true;
+                source.m_lastDrawn[source.m_missing[i].second] = frame;
+                ++residentNow;
+            }
+            if (residentNow > budget)
+            {
+                std::vector<std::pair<int, int>> byAge;
+                for (int index = 0; index < gridSize * gridSize; ++index)
+                    if (source.m_resident[index])
+                        byAge.push_back(std::make_pair(source.m_lastDrawn[index], index));
+                std::sort(byAge.begin(), byAge.end());
+                for (size_t i = 0; residentNow > budget && i < byAge.size() && byAge[i].first < frame; ++i, --residentNow)
+                    source.m_resident[byAge[i].second] = false;
+            }
+            resident += residentNow;
+        }
+        BenchKeep(drawCount);
+        printf("grid %3d: walk %6.2f us/frame, %6.1f pages drawn, %7.1f level 0 resident, %5.2f misses per frame\n",
+               gridSize, walkMicros / frames, (double)drawn / frames, (double)resident / frames, (double)misses / frames);
+    }
+    return 0;
+}
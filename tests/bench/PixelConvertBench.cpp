@@ -0,0 +1,43 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        tests/bench/PixelConvertBench.cpp
+ *****************************************************************************/
+
+#include "Bench.h"
+#include "PixelConvert.h"
+#include <vector>
+
+// Red / blue swap throughput per path, plain and premultiplied: source gigabytes per second
+int main(int argc, char** argv)
+{
+    const bool quick = Bench::IsQuick(argc, argv);
+    const PixelConvert::Path paths[] = { PixelConvert::PATH_SCALAR, PixelConvert::PATH_SSSE3, PixelConvert::PATH_AVX2 };
+    const int sizes[] = { 256, 1024 };
+    printf("best path: %s\n", PixelConvert::GetPathName(PixelConvert::PATH_AUTO));
+
+    for (int size : sizes)
+    {
+        std::vector<uint8_t> src((size_t)size * size * 4), dst(src.size());
+        for (size_t i = 0; i < src.size(); ++i)
+            src[i] = (uint8_t)(i * 7 + (i >> 11));
+
+        const int repeats = quick ? 1 : (4096 * 4096) / (size * size);
+        for (int premultiply = 0; premultiply < 2; ++premultiply)
+        {
+            for (PixelConvert::Path path : paths)
+            {
+                if (path > PixelConvert::GetBestPath())
+                    continue;
+                const double micros = Bench::BestMicros(quick ? 1 : 5, [&] {
+                    for (int i = 0; i < repeats; ++i)
+                        PixelConvert::SwapRedBlue(src.data(), size * 4, dst.data(), size * 4, size, size, premultiply != 0, path);
+                });
+                BenchKeep(dst[dst.size() / 2]);
+                const double gigabytes = (double)src.size() * repeats / 1e9;
+                printf("%4dx%-4d %-6s %-11s %8.1f us/tile, %5.2f GB/s\n", size, size, PixelConvert::GetPathName(path),
+                       premultiply ? "premultiply" : "swap", micros / repeats, gigabytes / (micros * 1e-6));
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,81 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        tests/bench/ProjectionBench.cpp
+ *****************************************************************************/
+
+#include "Bench.h"
+#include "RadarProjection.h"
+#include "MathUtils.h"
+#include <vector>
+
+// Nanoseconds per projected point: WorldToScreen (camera matrices rebuilt per call, as before RadarProjection)
+// against one Build per frame and Project per point, then ProjectBatch per SIMD path
+int main(int argc, char** argv)
+{
+    const bool quick = Bench::IsQuick(argc, argv);
+    const D3DXVECTOR3 cameraPos(250.0f, -1200.0f, 445.0f);
+    const D3DXVECTOR3 cameraRot(-26.0f * D3DX_PI / 180.0f, 0.0f, 0.6f);
+    const float fov = 70.0f * D3DX_PI / 180.0f;
+
+    const int count = 250;
+    std::vector<D3DXVECTOR3> points(count);
+    for (int i = 0; i < count; ++i)
+        points[i] = D3DXVECTOR3(cameraPos.x + (float)((i * 37) % 1000) - 500.0f, cameraPos.y + (float)((i * 91) % 1000) - 300.0f, 20.0f);
+
+    const int frames = quick ? 2 : 400;
+    float sum = 0.0f;
+    const double wtsMicros = Bench::BestMicros(quick ? 1 : 5, [&] {
+        for (int f = 0; f < frames; ++f)
+            for (const D3DXVECTOR3& p : points)
+            {
+                float x, y;
+                if (MathUtils::WorldToScreen(p, cameraPos, cameraRot, fov, 0.3f, 10000.0f, 1024.0f, 1024.0f, x, y, 0.5625f))
+                    sum += x + y;
+            }
+    });
+    const double projectMicros = Bench::BestMicros(quick ? 1 : 5, [&] {
+        for (int f = 0; f < frames; ++f)
+        {
+            RadarProjection projection;
+            projection.Build(cameraPos, cameraRot, fov, 0.3f, 10000.0f, 1024.0f, 1024.0f, 0.5625f);
+            for (const D3DXVECTOR3& p : points)
+            {
+                float x, y;
+                if (projection.Project(p, x, y))
+                    sum += x + y;
+            }
+        }
+    });
+    BenchKeep(sum);
+
+    const double points1k = (double)frames * count / 1000.0;
+    printf("WorldToScreen per point:   %7.1f ns\n", wtsMicros / points1k);
+    printf("Build per frame + Project: %7.1f ns  (%d points per frame)\n", projectMicros / points1k, count);
+
+    // ProjectBatch per path: 250 = MAX_RADAR_TRACES, 2k, 20k points
+    RadarProjection projection;
+    projection.Build(cameraPos, cameraRot, fov, 0.3f, 10000.0f, 1024.0f, 1024.0f, 0.5625f);
+    const RadarProjection::Path paths[] = { RadarProjection::PATH_SCALAR, RadarProjection::PATH_SSE, RadarProjection::PATH_AVX };
+    const int batchSizes[] = { 250, 2000, 20000 };
+    for (int batchSize : batchSizes)
+    {
+        RadarProjectionBatch batch;
+        for (int i = 0; i < batchSize; ++i)
+            batch.Add(D3DXVECTOR3(cameraPos.x + (float)((i * 37) % 4000) - 2000.0f, cameraPos.y + (float)((i * 91) % 4000) - 1500.0f, 20.0f));
+
+        const int repeats = quick ? 1 : (2000000 / batchSize);
+        for (RadarProjection::Path path : paths)
+        {
+            if (path > RadarProjection::GetBestPath())
+                continue;
+            const double micros = Bench::BestMicros(quick ? 1 : 5, [&] {
+                for (int r = 0; r < repeats; ++r)
+                    projection.ProjectBatch(batch, path);
+            });
+            BenchKeep(batch.screenX[batchSize / 2]);
+            printf("ProjectBatch %5d points %-6s: %8.2f us/batch, %5.2f ns/point\n", batchSize, RadarProjection::GetPathName(path),
+                   micros / repeats, micros * 1000.0 / ((double)repeats * batchSize));
+        }
+    }
+    return 0;
+}
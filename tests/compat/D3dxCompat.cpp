@@ -0,0 +1,106 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        tests/compat/D3dxCompat.cpp
+ *****************************************************************************/
+
+#include "d3dx9.h"
+#include "RenderWare.h"
+#include <cmath>
+
+RsGlobalType RsGlobal = { 1920, 1080 };
+
+D3DXMATRIX* D3DXMatrixIdentity(D3DXMATRIX* out)
+{
+    for (int r = 0; r < 4; ++r)
+        for (int c = 0; c < 4; ++c)
+            out->m[r][c] = (r == c) ? 1.0f : 0.0f;
+    return out;
+}
+
+D3DXMATRIX* D3DXMatrixMultiply(D3DXMATRIX* out, const D3DXMATRIX* a, const D3DXMATRIX* b)
+{
+    D3DXMATRIX result;
+    for (int r = 0; r < 4; ++r)
+        for (int c = 0; c < 4; ++c)
+            result.m[r][c] = a->m[r][0] * b->m[0][c] + a->m[r][1] * b->m[1][c] + a->m[r][2] * b->m[2][c] + a->m[r][3] * b->m[3][c];
+    *out = result;
+    return out;
+}
+
+// Gauss-Jordan with partial pivoting, in double
+D3DXMATRIX* D3DXMatrixInverse(D3DXMATRIX* out, float* outDeterminant, const D3DXMATRIX* m)
+{
+    double a[4][8];
+    for (int r = 0; r < 4; ++r)
+        for (int c = 0; c < 4; ++c)
+        {
+            a[r][c] = m->m[r][c];
+            a[r][c + 4] = (r == c) ? 1.0 : 0.0;
+        }
+
+    double determinant = 1.0;
+    for (int col = 0; col < 4; ++col)
+    {
+        int pivot = col;
+        for (int r = col + 1; r < 4; ++r)
+            if (fabs(a[r][col]) > fabs(a[pivot][col]))
+                pivot = r;
+        if (fabs(a[pivot][col]) < 1e-30)
+            return nullptr;
+        if (pivot != col)
+        {
+            for (int c = 0; c < 8; ++c)
+            {
+                const double t = a[col][c];
+                a[col][c] = a[pivot][c];
+                a[pivot][c] = t;
+            }
+            determinant = -determinant;
+        }
+
+        const double p = a[col][col];
+        determinant *= p;
+        for (int c = 0; c < 8; ++c)
+            a[col][c] /= p;
+        for (int r = 0; r < 4; ++r)
+        {
+            if (r == col)
+                continue;
+            const double f = a[r][col];
+            for (int c = 0; c < 8; ++c)
+                a[r][c] -= f * a[col][c];
+        }
+    }
+
+    for (int r = 0; r < 4; ++r)
+        for (int c = 0; c < 4; ++c)
+            out->m[r][c] = (float)a[r][c + 4];
+    if (outDeterminant)
+        *outDeterminant = (float)determinant;
+    return out;
+}
+
+float D3DXVec3Dot(const D3DXVECTOR3* a, const D3DXVECTOR3* b)
+{
+    return a->x * b->x + a->y * b->y + a->z * b->z;
+}
+
+D3DXVECTOR3* D3DXVec3Cross(D3DXVECTOR3* out, const D3DXVECTOR3* a, const D3DXVECTOR3* b)
+{
+    const D3DXVECTOR3 result(a->y * b->z - a->z * b->y, a->z * b->x - a->x * b->z, a->x * b->y - a->y * b->x);
+    *out = result;
+    return out;
+}
+
+D3DXVECTOR3* D3DXVec3Normalize(D3DXVECTOR3* out, const D3DXVECTOR3* v)
+{
+    const float length = sqrtf(D3DXVec3Dot(v, v));
+    if (length <= 0.0f)
+    {
+        *out = D3DXVECTOR3(0.0f, 0.0f, 0.0f);
+        return out;
+    }
+    const float inv = 1.0f / length;
+    *out = D3DXVECTOR3(v->x * inv, v->y * inv, v->z * inv);
+    return out;
+}
@@ -0,0 +1,35 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        tests/compat/MsvcCompat.h
+ *****************************************************************************/
+
+#pragma once
+
+// MSVC CRT functions the headless sources call; force-included into every file of the headless build
+
+#include <cerrno>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdio>
+#include <strings.h>
+
+inline int fopen_s(FILE** outFile, const char* path, const char* mode)
+{
+    *outFile = fopen(path, mode);
+    return *outFile ? 0 : errno;
+}
+
+template<size_t N>
+inline int sprintf_s(char (&buffer)[N], const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    const int written = vsnprintf(buffer, N, format, args);
+    va_end(args);
+    return written;
+}
+
+inline int _stricmp(const char* a, const char* b)
+{
+    return strcasecmp(a, b);
+}
@@ -0,0 +1,16 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        tests/compat/RenderWare.h
+ *****************************************************************************/
+
+#pragma once
+
+// The game globals the headless sources read (render target size); tests set them
+
+struct RsGlobalType
+{
+    int maximumWidth;
+    int maximumHeight;
+};
+
+extern RsGlobalType RsGlobal;
@@ -0,0 +1,8 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        tests/compat/StbImage.cpp
+ *****************************************************************************/
+
+// The plugin compiles the implementation into Base64Image.cpp, which needs D3D
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
@@ -0,0 +1,139 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        tests/compat/Win32Compat.cpp
+ *****************************************************************************/
+
+#include "Windows.h"
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Views must start on the allocation granularity like on Windows, so offset handling is exercised the same way
+static const DWORD ALLOCATION_GRANULARITY = 64 * 1024;
+// 1601-01-01 to 1970-01-01 in seconds, FILETIME ticks are 100 ns
+static const long long FILETIME_EPOCH_SECONDS = 11644473600ll;
+
+struct CompatHandle
+{
+    enum Kind
+    {
+        KIND_FILE,
+        KIND_MAPPING,
+    };
+
+    Kind      kind;
+    int       fd;
+    long long size;
+};
+
+static std::mutex                s_viewMutex;
+static std::map<const void*, size_t> s_views;   // mapped base -> length, for UnmapViewOfFile
+
+HANDLE CreateFileA(const char* path, DWORD, DWORD, void*, DWORD, DWORD, HANDLE)
+{
+    const int fd = path ? open(path, O_RDONLY) : -1;
+    if (fd < 0)
+        return INVALID_HANDLE_VALUE;
+    return new CompatHandle{ CompatHandle::KIND_FILE, fd, 0 };
+}
+
+BOOL GetFileSizeEx(HANDLE file, LARGE_INTEGER* outSize)
+{
+    struct stat st;
+    if (file == INVALID_HANDLE_VALUE || fstat(((CompatHandle*)file)->fd, &st) != 0)
+        return FALSE;
+    outSize->QuadPart = (long long)st.st_size;
+    return TRUE;
+}
+
+HANDLE CreateFileMappingA(HANDLE file, void*, DWORD, DWORD, DWORD, const char*)
+{
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+        return nullptr;
+    const int fd = dup(((CompatHandle*)file)->fd);
+    if (fd < 0)
+        return nullptr;
+    return new CompatHandle{ CompatHandle::KIND_MAPPING, fd, size.QuadPart };
+}
+
+void* MapViewOfFile(HANDLE mapping, DWORD, DWORD offsetHigh, DWORD offsetLow, size_t size)
+{
+    const CompatHandle* handle = (const CompatHandle*)mapping;
+    const long long offset = ((long long)offsetHigh << 32) | offsetLow;
+    if (!handle || handle->kind != CompatHandle::KIND_MAPPING || offset % ALLOCATION_GRANULARITY != 0 || offset >= handle->size)
+        return nullptr;
+    if (size == 0)
+        size = (size_t)(handle->size - offset);
+    else if ((long long)size > handle->size - offset)
+        return nullptr;
+
+    void* base = mmap(nullptr, size, PROT_READ, MAP_SHARED, handle->fd, (off_t)offset);
+    if (base == MAP_FAILED)
+        return nullptr;
+    std::lock_guard<std::mutex> lock(s_viewMutex);
+    s_views[base] = size;
+    return base;
+}
+
+BOOL UnmapViewOfFile(LPCVOID base)
+{
+    size_t size;
+    {
+        std::lock_guard<std::mutex> lock(s_viewMutex);
+        auto it = s_views.find(base);
+        if (it == s_views.end())
+            return FALSE;
+        size = it->second;
+        s_views.erase(it);
+    }
+    return munmap((void*)base, size) == 0;
+}
+
+BOOL CloseHandle(HANDLE handle)
+{
+    if (!handle || handle == INVALID_HANDLE_VALUE)
+        return FALSE;
+    CompatHandle* compat = (CompatHandle*)handle;
+    close(compat->fd);
+    delete compat;
+    return TRUE;
+}
+
+BOOL GetFileAttributesExA(const char* path, GET_FILEEX_INFO_LEVELS, void* outInfo)
+{
+    struct stat st;
+    if (!path || stat(path, &st) != 0)
+        return FALSE;
+
+    WIN32_FILE_ATTRIBUTE_DATA* info = (WIN32_FILE_ATTRIBUTE_DATA*)outInfo;
+    *info = {};
+    const unsigned long long ticks = (unsigned long long)(st.st_mtim.tv_sec + FILETIME_EPOCH_SECONDS) * 10000000ull +
+                                     (unsigned long long)st.st_mtim.tv_nsec / 100;
+    info->ftLastWriteTime.dwLowDateTime = (DWORD)(ticks & 0xFFFFFFFFull);
+    info->ftLastWriteTime.dwHighDateTime = (DWORD)(ticks >> 32);
+    info->nFileSizeLow = (DWORD)((unsigned long long)st.st_size & 0xFFFFFFFFull);
+    info->nFileSizeHigh = (DWORD)((unsigned long long)st.st_size >> 32);
+    return TRUE;
+}
+
+BOOL MoveFileExA(const char* from, const char* to, DWORD)
+{
+    // rename replaces an existing target like MOVEFILE_REPLACE_EXISTING
+    return rename(from, to) == 0;
+}
+
+BOOL DeleteFileA(const char* path)
+{
+    return unlink(path) == 0;
+}
+
+void GetSystemInfo(SYSTEM_INFO* outInfo)
+{
+    outInfo->dwPageSize = (DWORD)sysconf(_SC_PAGESIZE);
+    outInfo->dwAllocationGranularity = ALLOCATION_GRANULARITY;
+}
@@ -0,0 +1,81 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        tests/compat/Windows.h
+ *****************************************************************************/
+
+#pragma once
+
+// The few Win32 calls the headless sources make (MappedFile, ChunkCache), on POSIX
+
+#include <cstdint>
+#include <cstring>
+
+typedef unsigned long  DWORD;
+typedef int            BOOL;
+typedef unsigned char  BYTE;
+typedef unsigned short WORD;
+typedef void*          HANDLE;
+typedef const void*    LPCVOID;
+
+#define TRUE  1
+#define FALSE 0
+#define INVALID_HANDLE_VALUE ((HANDLE)(intptr_t)-1)
+
+#define GENERIC_READ              0x80000000ul
+#define FILE_SHARE_READ           0x00000001ul
+#define OPEN_EXISTING             3
+#define FILE_ATTRIBUTE_NORMAL     0x00000080ul
+#define FILE_FLAG_SEQUENTIAL_SCAN 0x08000000ul
+#define PAGE_READONLY             0x02
+#define FILE_MAP_READ             0x0004
+#define MOVEFILE_REPLACE_EXISTING 0x00000001ul
+
+#define ZeroMemory(dst, size) memset((dst), 0, (size))
+
+union LARGE_INTEGER
+{
+    struct
+    {
+        DWORD LowPart;
+        long  HighPart;
+    };
+    long long QuadPart;
+};
+
+struct FILETIME
+{
+    DWORD dwLowDateTime;
+    DWORD dwHighDateTime;
+};
+
+struct WIN32_FILE_ATTRIBUTE_DATA
+{
+    DWORD    dwFileAttributes;
+    FILETIME ftCreationTime;
+    FILETIME ftLastAccessTime;
+    FILETIME ftLastWriteTime;
+    DWORD    nFileSizeHigh;
+    DWORD    nFileSizeLow;
+};
+
+enum GET_FILEEX_INFO_LEVELS
+{
+    GetFileExInfoStandard,
+};
+
+struct SYSTEM_INFO
+{
+    DWORD dwPageSize;
+    DWORD dwAllocationGranularity;
+};
+
+HANDLE CreateFileA(const char* path, DWORD access, DWORD share, void* security, DWORD disposition, DWORD flags, HANDLE templateFile);
+BOOL   GetFileSizeEx(HANDLE file, LARGE_INTEGER* outSize);
+HANDLE CreateFileMappingA(HANDLE file, void* security, DWORD protect, DWORD sizeHigh, DWORD sizeLow, const char* name);
+void*  MapViewOfFile(HANDLE mapping, DWORD access, DWORD offsetHigh, DWORD offsetLow, size_t size);
+BOOL   UnmapViewOfFile(LPCVOID base);
+BOOL   CloseHandle(HANDLE handle);
+BOOL   GetFileAttributesExA(const char* path, GET_FILEEX_INFO_LEVELS level, void* outInfo);
+BOOL   MoveFileExA(const char* from, const char* to, DWORD flags);
+BOOL   DeleteFileA(const char* path);
+void   GetSystemInfo(SYSTEM_INFO* outInfo);
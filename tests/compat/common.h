@@ -0,0 +1,8 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        tests/compat/common.h
+ *****************************************************************************/
+
+#pragma once
+
+#include "RenderWare.h"
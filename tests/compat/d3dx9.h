@@ -0,0 +1,66 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        tests/compat/d3dx9.h
+ *****************************************************************************/
+
+#pragma once
+
+// D3DX math the headless sources use: row-vector matrices and the vector helpers, same results as D3DX
+// up to float rounding
+
+#include "d3d9.h"
+
+#define D3DX_PI 3.141592654f
+
+struct D3DXVECTOR2
+{
+    float x, y;
+
+    D3DXVECTOR2() {}
+    D3DXVECTOR2(float fx, float fy) : x(fx), y(fy) {}
+};
+
+struct D3DXVECTOR3
+{
+    float x, y, z;
+
+    D3DXVECTOR3() {}
+    D3DXVECTOR3(float fx, float fy, float fz) : x(fx), y(fy), z(fz) {}
+
+    D3DXVECTOR3 operator+(const D3DXVECTOR3& v) const { return D3DXVECTOR3(x + v.x, y + v.y, z + v.z); }
+    D3DXVECTOR3 operator-(const D3DXVECTOR3& v) const { return D3DXVECTOR3(x - v.x, y - v.y, z - v.z); }
+    D3DXVECTOR3 operator*(float s) const { return D3DXVECTOR3(x * s, y * s, z * s); }
+};
+
+struct D3DXVECTOR4
+{
+    float x, y, z, w;
+
+    D3DXVECTOR4() {}
+    D3DXVECTOR4(float fx, float fy, float fz, float fw) : x(fx), y(fy), z(fz), w(fw) {}
+};
+
+struct D3DXMATRIX
+{
+    union
+    {
+        struct
+        {
+            float _11, _12, _13, _14;
+            float _21, _22, _23, _24;
+            float _31, _32, _33, _34;
+            float _41, _42, _43, _44;
+        };
+        float m[4][4];
+    };
+
+    D3DXMATRIX() {}
+};
+
+D3DXMATRIX*  D3DXMatrixIdentity(D3DXMATRIX* out);
+D3DXMATRIX*  D3DXMatrixMultiply(D3DXMATRIX* out, const D3DXMATRIX* a, const D3DXMATRIX* b);
+// nullptr if the matrix is singular; outDeterminant may be nullptr
+D3DXMATRIX*  D3DXMatrixInverse(D3DXMATRIX* out, float* outDeterminant, const D3DXMATRIX* m);
+float        D3DXVec3Dot(const D3DXVECTOR3* a, const D3DXVECTOR3* b);
+D3DXVECTOR3* D3DXVec3Cross(D3DXVECTOR3* out, const D3DXVECTOR3* a, const D3DXVECTOR3* b);
+D3DXVECTOR3* D3DXVec3Normalize(D3DXVECTOR3* out, const D3DXVECTOR3* v);
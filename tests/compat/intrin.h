@@ -0,0 +1,26 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        tests/compat/intrin.h
+ *****************************************************************************/
+
+#pragma once
+
+// MSVC CPUID / XGETBV intrinsics on GCC and Clang: __cpuidex comes with <cpuid.h> (GCC 11, Clang 15),
+// _xgetbv with <immintrin.h> (sources calling it are built with -mxsave)
+
+#include <cpuid.h>
+#include <immintrin.h>
+
+#undef __cpuid
+inline void __cpuid(int info[4], int leaf)
+{
+    __cpuidex(info, leaf, 0);
+}
+
+inline unsigned char _BitScanForward(unsigned long* index, unsigned long mask)
+{
+    if (!mask)
+        return 0;
+    *index = (unsigned long)__builtin_ctzl(mask);
+    return 1;
+}
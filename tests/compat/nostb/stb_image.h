@@ -0,0 +1,10 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        tests/compat/nostb/stb_image.h
+ *****************************************************************************/
+
+#pragma once
+
+// Stand-in when RADAR_STB_DIR has no stb_image.h: every image fails to decode (map pack DDS tiles still work)
+inline unsigned char* stbi_load(const char*, int*, int*, int*, int) { return nullptr; }
+inline void stbi_image_free(void*) {}
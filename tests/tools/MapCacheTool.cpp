@@ -0,0 +1,481 @@
+/*****************************************************************************
+ *  PROJECT:     Radar Trilogy SA
+ *  FILE:        tests/tools/MapCacheTool.cpp
+ *****************************************************************************/
+
+// radar_mapcache: builds, verifies and benchmarks the map tile cache (radar/map.cache, <pack>/map.cache) offline.
+// Tiles go through the same ChunkPipeline as in game, so the file is byte-identical to one the plugin writes
+// and is accepted as long as the source keeps its size and write times (the cache key).
+//
+//   radar_mapcache build  <source> [--lod] [--compress] [--atlas] [--out <file>]
+//   radar_mapcache verify <source> [same options]
+//   radar_mapcache bench  <source> [same options] [--runs <n>]
+//   radar_mapcache demo   <directory> [--grid <n>] [--size <texels>]
+//
+// <source> is a map pack directory (manifest.txt) or a map.txd. The options mirror MapLod, MapCompression and
+// MapAtlas in radar-trilogy-sa.ini; a cache built with other settings is rebuilt by the game.
+// From map.txd only 32-bit and DXT1 / DXT5 tiles can be converted (the rest needs RenderWare).
+
+#include "ChunkCache.h"
+#include "ChunkContent.h"
+#include "ChunkMipChain.h"
+#include "ChunkPipeline.h"
+#include "ChunkPyramid.h"
+#include "MapPackSource.h"
+#include "TxdNativeReader.h"
+#include "bench/Bench.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const int TXD_GRID = 12;     // MapChunkManager::MAP_CHUNKS_PER_ROW
+
+struct Options
+{
+    std::string source;
+    std::string out;
+    bool        lod = false;
+    bool        compress = false;
+    bool        atlas = false;
+    int         runs = 5;
+    bool        quick = false;
+    int         grid = 24;
+    int         size = 256;
+};
+
+// map.txd natives or map pack tiles, decoded to plain BGRA8 like MapChunkManager::SubmitDecode
+class TileSource
+{
+public:
+    bool Open(const std::string& path)
+    {
+        if (std::filesystem::is_directory(path))
+        {
+            std::string dir = path;
+            if (dir.back() != '/')
+                dir += '/';
+            if (!m_pack.Open(dir.c_str()))
+            {
+                fprintf(stderr, "%s: no readable manifest.txt\n", path.c_str());
+                return false;
+            }
+            m_grid = m_pack.GetManifest().grid;
+            m_defaultOut = m_pack.GetDirectory() + "map.cache";
+            return true;
+        }
+
+        if (!m_txd.Open(path.c_str()))
+        {
+            fprintf(stderr, "%s: not a texture dictionary\n", path.c_str());
+            return false;
+        }
+        m_txdPath = path;
+        m_grid = TXD_GRID;
+        m_defaultOut = (std::filesystem::path(path).parent_path() / "map.cache").string();
+
+        int unsupported = 0;
+        for (int index = 0; index < GetChunkCount(); ++index)
+        {
+            const TxdNativeReader::Texture* texture = FindTexture(index);
+            if (texture && !TxdNativeReader::CanDecode(*texture))
+            {
+                fprintf(stderr, "%s: %s needs RenderWare (palettized, 16-bit or DXT3)\n", path.c_str(), texture->name.c_str());
+                ++unsupported;
+            }
+        }
+        return unsupported == 0;
+    }
+
+    int GetGrid() const { return m_grid; }
+    int GetChunkCount() const { return m_grid * m_grid; }
+    const std::string& GetDefaultOut() const { return m_defaultOut; }
+
+    bool ComputeKey(int lodLevels, bool compress, int gutter, ChunkCache::Key& outKey) const
+    {
+        if (m_pack.IsOpen())
+        {
+            uint64_t size, mtime, hash;
+            if (!m_pack.ComputeStamp(size, mtime, hash))
+                return false;
+            ChunkCache::MakeKey(size, mtime, hash, lodLevels, compress, gutter, outKey);
+            return true;
+        }
+        return ChunkCache::ComputeKey(m_txdPath.c_str(), lodLevels, compress, gutter, outKey);
+    }
+
+    // Thread-safe; false for missing or undecodable tiles
+    bool Decode(int index, ChunkPixels& out) const
+    {
+        if (m_pack.IsOpen())
+            return m_pack.DecodeTile(index, out);
+        const TxdNativeReader::Texture* texture = FindTexture(index);
+        return texture && TxdNativeReader::Decode(*texture, out);
+    }
+
+private:
+    const TxdNativeReader::Texture* FindTexture(int index) const
+    {
+        char name[32];
+        sprintf_s(name, "radar%02d", index);
+        return m_txd.Find(name);
+    }
+
+    MapPackSource   m_pack;
+    TxdNativeReader m_txd;
+    std::string     m_txdPath;
+    std::string     m_defaultOut;
+    int             m_grid = 0;
+};
+
+struct PipelineResult
+{
+    std::vector<ChunkPixels> tiles[ChunkPyramid::MAX_LEVELS + 1];   // finished payloads, empty = no tile
+    int                      missing = 0;
+    double                   micros = 0.0;
+};
+
+// Decodes every chunk on all cores and finishes it the way the game does. An inactive writer records nothing.
+static void RunPipeline(const TileSource& source, const Options& options, ChunkCacheWriter& writer, bool keepTiles, PipelineResult& result)
+{
+    const double start = Bench::NowMicros();
+    const int chunkCount = source.GetChunkCount();
+    const int gutter = options.atlas ? ChunkPipeline::ATLAS_GUTTER : 0;
+
+    ChunkPyramid pyramid;
+    pyramid.Reset(source.GetGrid(), options.lod ? ChunkPyramid::MAX_LEVELS : 0);
+    pyramid.SetCompression(options.compress);
+    pyramid.SetCellOutput(gutter, ChunkPipeline::ATLAS_LEVELS);
+
+    for (auto& tiles : result.tiles)
+        tiles.clear();
+    result.tiles[0].resize((size_t)chunkCount);
+    for (int level = 1; level <= pyramid.GetLevelCount(); ++level)
+        result.tiles[level].resize((size_t)pyramid.GetTileCount(level));
+
+    std::atomic<int> next(0);
+    std::atomic<int> missing(0);
+    auto worker = [&] {
+        for (int index; (index = next++) < chunkCount;)
+        {
+            ChunkPixels pixels = {};
+            if (!source.Decode(index, pixels) || !ChunkPipeline::FinishBaseChunk(pixels, index, pyramid, writer, options.compress, gutter))
+            {
+                // Same as MapChunkManager::OnDecodeFailed
+                pyramid.MarkMissing(index);
+                writer.Skip(0, index);
+                ++missing;
+                continue;
+            }
+            if (keepTiles)
+                result.tiles[0][index] = std::move(pixels);
+        }
+    };
+    std::vector<std::thread> threads;
+    const int threadCount = (std::max)(1, (int)std::thread::hardware_concurrency());
+    for (int i = 0; i < threadCount; ++i)
+        threads.emplace_back(worker);
+    for (auto& thread : threads)
+        thread.join();
+
+    int level, index;
+    ChunkPixels pixels;
+    while (ChunkPipeline::PopCoarseTile(pyramid, writer, level, index, pixels))
+        if (keepTiles)
+            result.tiles[level][index] = std::move(pixels);
+
+    result.missing = missing;
+    result.micros = Bench::NowMicros() - start;
+}
+
+static bool MakeKey(const TileSource& source, const Options& options, ChunkCache::Key& outKey, int levelTiles[ChunkPyramid::MAX_LEVELS + 1], int& outLevels)
+{
+    // Level count as ChunkPyramid::Reset decides it: grids that do not divide evenly stop early
+    ChunkPyramid pyramid;
+    pyramid.Reset(source.GetGrid(), options.lod ? ChunkPyramid::MAX_LEVELS : 0);
+    outLevels = pyramid.GetLevelCount() + 1;
+    levelTiles[0] = source.GetChunkCount();
+    for (int level = 1; level < outLevels; ++level)
+        levelTiles[level] = pyramid.GetTileCount(level);
+
+    if (!source.ComputeKey(pyramid.GetLevelCount(), options.compress, options.atlas ? ChunkPipeline::ATLAS_GUTTER : 0, outKey))
+    {
+        fprintf(stderr, "%s: cannot compute the cache key\n", options.source.c_str());
+        return false;
+    }
+    return true;
+}
+
+static int Build(const TileSource& source, const Options& options)
+{
+    ChunkCache::Key key;
+    int levelTiles[ChunkPyramid::MAX_LEVELS + 1] = {};
+    int levels;
+    if (!MakeKey(source, options, key, levelTiles, levels))
+        return 1;
+
+    ChunkCacheWriter writer;
+    if (!writer.Begin(options.out.c_str(), key, levelTiles, levels))
+    {
+        fprintf(stderr, "%s: cannot write\n", options.out.c_str());
+        return 1;
+    }
+    PipelineResult result;
+    RunPipeline(source, options, writer, false, result);
+    if (writer.IsActive())
+    {
+        writer.Abort();
+        fprintf(stderr, "%s: not every tile was recorded, nothing written\n", options.out.c_str());
+        return 1;
+    }
+
+    uint64_t size = 0, mtime;
+    MappedFile::GetFileStamp(options.out.c_str(), size, mtime);
+    printf("%s: %d tiles (%d missing), %d coarse levels, %.1f MB in %.0f ms\n", options.out.c_str(), source.GetChunkCount(), result.missing,
+           levels - 1, (double)size / (1024.0 * 1024.0), result.micros / 1000.0);
+    return 0;
+}
+
+static bool SamePayload(const ChunkPixels& expected, const ChunkCache::Tile& tile)
+{
+    return expected.width == tile.width && expected.height == tile.height && expected.levels == tile.levels &&
+           expected.format == tile.format && expected.gutter == tile.gutter && expected.hash == tile.hash &&
+           expected.solid == tile.solid && (!tile.solid || expected.solidColor == tile.solidColor) &&
+           memcmp(expected.data.data(), tile.data, ChunkMipChain::ChainSize(tile.width, tile.height, tile.levels, tile.format)) == 0;
+}
+
+static int Verify(const TileSource& source, const Options& options)
+{
+    ChunkCache::Key key;
+    int levelTiles[ChunkPyramid::MAX_LEVELS + 1] = {};
+    int levels;
+    if (!MakeKey(source, options, key, levelTiles, levels))
+        return 1;
+
+    ChunkCache cache;
+    if (!cache.Open(options.out.c_str(), key))
+    {
+        fprintf(stderr, "%s: missing, unfinished, from another source or built with other settings\n", options.out.c_str());
+        return 1;
+    }
+
+    // Rebuilt in memory and compared tile by tile with the mapped payloads
+    ChunkCacheWriter noWriter;
+    PipelineResult result;
+    RunPipeline(source, options, noWriter, true, result);
+
+    int checked = 0, mismatched = 0;
+    for (int level = 0; level < levels; ++level)
+    {
+        for (int index = 0; index < levelTiles[level]; ++index)
+        {
+            const ChunkPixels& expected = result.tiles[level][index];
+            MappedView view;
+            ChunkCache::Tile tile;
+            const bool present = cache.Map(level, index, view, tile);
+            const bool same = present ? !expected.data.empty() && SamePayload(expected, tile) : expected.data.empty();
+            if (!same)
+            {
+                fprintf(stderr, "level %d tile %d: %s\n", level, index, present ? "differs from the source" : "missing from the cache");
+                ++mismatched;
+            }
+            ++checked;
+        }
+    }
+    printf("%s: %d tiles checked, %d differ\n", options.out.c_str(), checked, mismatched);
+    return mismatched == 0 ? 0 : 1;
+}
+
+// Startup cost with and without the cache: converting every tile vs. mapping it and copying it out
+// (the LockRect copy). Both run with the files in the OS cache.
+static int RunBench(const TileSource& source, const Options& options)
+{
+    ChunkCache::Key key;
+    int levelTiles[ChunkPyramid::MAX_LEVELS + 1] = {};
+    int levels;
+    if (!MakeKey(source, options, key, levelTiles, levels))
+        return 1;
+
+    const int runs = options.quick ? 1 : options.runs;
+    ChunkCacheWriter noWriter;
+    PipelineResult result;
+    const double convertMicros = Bench::BestMicros(runs, [&] { RunPipeline(source, options, noWriter, false, result); });
+
+    ChunkCache probe;
+    if (!probe.Open(options.out.c_str(), key))
+    {
+        fprintf(stderr, "%s: no valid cache, run build first\n", options.out.c_str());
+        return 1;
+    }
+    probe.Close();
+
+    std::vector<uint8_t> lockRect;
+    size_t bytes = 0;
+    int tiles = 0;
+    const double cacheMicros = Bench::BestMicros(runs, [&] {
+        ChunkCache cache;
+        cache.Open(options.out.c_str(), key);
+        bytes = 0;
+        tiles = 0;
+        for (int level = 0; level < levels; ++level)
+        {
+            for (int index = 0; index < levelTiles[level]; ++index)
+            {
+                MappedView view;
+                ChunkCache::Tile tile;
+                if (!cache.Map(level, index, view, tile))
+                    continue;
+                lockRect.resize(view.GetSize());
+                memcpy(lockRect.data(), tile.data, view.GetSize());
+                bytes += view.GetSize();
+                ++tiles;
+            }
+        }
+    });
+    BenchKeep(lockRect.empty() ? 0 : lockRect[0]);
+
+    printf("%d chunks, %d cached tiles, %.1f MB\n", source.GetChunkCount(), tiles, (double)bytes / (1024.0 * 1024.0));
+    printf("  convert (%u threads): %8.1f ms\n", (std::max)(1u, std::thread::hardware_concurrency()), convertMicros / 1000.0);
+    printf("  from cache:           %8.1f ms  (%.0fx)\n", cacheMicros / 1000.0, convertMicros / (cacheMicros > 0.0 ? cacheMicros : 1.0));
+    return 0;
+}
+
+static void WriteU32(uint8_t* p, uint32_t value)
+{
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+    p[2] = (uint8_t)(value >> 16);
+    p[3] = (uint8_t)(value >> 24);
+}
+
+// Synthetic A8R8G8B8 DDS pack: gradients, an ocean border of identical solid tiles and one missing tile
+static int Demo(const Options& options)
+{
+    const int grid = options.grid;
+    const int size = options.size;
+    if (grid < 1 || grid > MapPackSource::MAX_GRID || size < 4 || size > 4096)
+    {
+        fprintf(stderr, "grid must be 1..%d, size 4..4096\n", MapPackSource::MAX_GRID);
+        return 1;
+    }
+
+    const std::filesystem::path dir(options.source);
+    std::filesystem::create_directories(dir / "tiles");
+    FILE* manifest = nullptr;
+    if (fopen_s(&manifest, (dir / "manifest.txt").string().c_str(), "wb") != 0 || !manifest)
+        return 1;
+    fprintf(manifest, "grid = %d\npattern = tiles/{row:3}_{col:3}.dds\n", grid);
+    fclose(manifest);
+
+    std::vector<uint8_t> file(128 + (size_t)size * size * 4);
+    uint8_t* header = file.data();
+    WriteU32(header, 0x20534444);       // "DDS "
+    WriteU32(header + 4, 124);
+    WriteU32(header + 8, 0x100F);       // caps, height, width, pitch, pixel format
+    WriteU32(header + 12, (uint32_t)size);
+    WriteU32(header + 16, (uint32_t)size);
+    WriteU32(header + 20, (uint32_t)size * 4);
+    WriteU32(header + 76, 32);
+    WriteU32(header + 80, 0x41);        // DDPF_RGB | DDPF_ALPHAPIXELS
+    WriteU32(header + 88, 32);
+    WriteU32(header + 92, 0x00FF0000);
+    WriteU32(header + 96, 0x0000FF00);
+    WriteU32(header + 100, 0x000000FF);
+    WriteU32(header + 104, 0xFF000000);
+    WriteU32(header + 108, 0x1000);     // DDSCAPS_TEXTURE
+
+    for (int row = 0; row < grid; ++row)
+    {
+        for (int col = 0; col < grid; ++col)
+        {
+            if (row == grid / 2 && col == grid / 2)
+                continue;
+            const bool ocean = row == 0 || col == 0 || row == grid - 1 || col == grid - 1;
+            uint8_t* texel = file.data() + 128;
+            for (int y = 0; y < size; ++y)
+            {
+                for (int x = 0; x < size; ++x, texel += 4)
+                {
+                    texel[0] = ocean ? 0x90 : (uint8_t)(x * 255 / size);
+                    texel[1] = ocean ? 0x60 : (uint8_t)(y * 255 / size);
+                    texel[2] = ocean ? 0x20 : (uint8_t)((row * 37 + col * 11 + ((x ^ y) & 15)) & 0xFF);
+                    texel[3] = 0xFF;
+                }
+            }
+
+            char name[32];
+            sprintf_s(name, "%03d_%03d.dds", row, col);
+            FILE* tile = nullptr;
+            if (fopen_s(&tile, (dir / "tiles" / name).string().c_str(), "wb") != 0 || !tile)
+                return 1;
+            const bool ok = fwrite(file.data(), 1, file.size(), tile) == file.size();
+            fclose(tile);
+            if (!ok)
+                return 1;
+        }
+    }
+    printf("%s: %dx%d tiles of %dx%d\n", options.source.c_str(), grid, grid, size, size);
+    return 0;
+}
+
+static int Usage()
+{
+    fprintf(stderr,
+        "usage: radar_mapcache build|verify|bench <map pack directory | map.txd> [--lod] [--compress] [--atlas] [--out <file>] [--runs <n>] [--quick]\n"
+        "       radar_mapcache demo <directory> [--grid <n>] [--size <texels>]\n");
+    return 2;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+        return Usage();
+
+    const std::string command = argv[1];
+    Options options;
+    options.source = argv[2];
+    for (int i = 3; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--lod")
+            options.lod = true;
+        else if (arg == "--compress")
+            options.compress = true;
+        else if (arg == "--atlas")
+            options.atlas = true;
+        else if (arg == "--quick")
+            options.quick = true;
+        else if (arg == "--out" && hasValue)
+            options.out = argv[++i];
+        else if (arg == "--runs" && hasValue)
+            options.runs = (std::max)(1, atoi(argv[++i]));
+        else if (arg == "--grid" && hasValue)
+            options.grid = atoi(argv[++i]);
+        else if (arg == "--size" && hasValue)
+            options.size = atoi(argv[++i]);
+        else
+            return Usage();
+    }
+
+    if (command == "demo")
+        return Demo(options);
+
+    TileSource source;
+    if (!source.Open(options.source))
+        return 1;
+    if (options.out.empty())
+        options.out = source.GetDefaultOut();
+
+    if (command == "build")
+        return Build(source, options);
+    if (command == "verify")
+        return Verify(source, options);
+    if (command == "bench")
+        return RunBench(source, options);
+    return Usage();
+}